@@ -0,0 +1,223 @@
+#include "asset_bundle.hh"
+
+#include "asset_bundle_format.hh"
+
+#include "safeSdlCall.hh"
+
+#include "SDL_mixer.h"    // Mix_QuickLoad_RAW Mix_QuerySpec
+#include "SDL_pixels.h"   // SDL_BITSPERPIXEL SDL_BYTESPERPIXEL SDL_ISPIXELFORMAT_*
+#include "SDL_surface.h"  // SDL_CreateRGBSurfaceWithFormatFrom
+#include "SDL_ttf.h"      // TTF_OpenFontRW
+
+#include <climits>        // INT_MAX
+#include <cstdint>        // UINT32_MAX
+#include <cstring>        // memcmp memcpy
+#include <stdexcept>      // invalid_argument out_of_range runtime_error
+
+
+namespace sdl2_asset_util {
+
+using detail::BundleEntry;
+using detail::BundleHeader;
+
+AssetBundle::AssetBundle(const std::string& path) :
+    file_(path) {
+    validate(path);
+}
+
+// overflow-safe check of offset + size <= limit
+static bool inBounds(const Uint64 offset, const Uint64 size, const Uint64 limit) {
+    return offset <= limit && size <= limit - offset;
+}
+
+void AssetBundle::validate(const std::string& path) {
+    const auto fail = [&path](const std::string& reason){
+        return std::runtime_error("AssetBundle: " + path + ": " + reason);
+    };
+    BundleHeader header {};
+    if (file_.size() < sizeof(header))
+        throw fail("too small for header");
+    std::memcpy(&header, file_.data(), sizeof(header));
+    if (std::memcmp(header.magic, detail::BUNDLE_MAGIC, sizeof(header.magic)) != 0)
+        throw fail("not an asset bundle");
+    if (header.byte_order != detail::BUNDLE_BYTE_ORDER)
+        throw fail("built for other byte order");
+    if (header.version != detail::BUNDLE_VERSION)
+        throw fail("unsupported version " + std::to_string(header.version));
+    if (header.file_size != file_.size())
+        throw fail("truncated");
+    if (!inBounds(header.index_offset, Uint64(header.entry_ct) * sizeof(BundleEntry),
+                  file_.size()) ||
+        !inBounds(header.names_offset, header.names_size, file_.size())) {
+        throw fail("index out of bounds");
+    }
+
+    entry_ct_ = header.entry_ct;
+    index_offset_ = std::size_t(header.index_offset);
+    names_offset_ = std::size_t(header.names_offset);
+
+    std::string_view last_name;
+    for (std::size_t i {}; i < entry_ct_; ++i) {
+        const BundleEntry e { entry(i) };
+        if (e.name_size == 0 || !inBounds(e.name_offset, e.name_size, header.names_size))
+            throw fail("entry " + std::to_string(i) + " name out of bounds");
+        const std::string_view name { entryName(e) };
+        // sorted and unique, for binary search
+        if (i > 0 && !(last_name < name))
+            throw fail("entries not sorted by name");
+        last_name = name;
+        if (!inBounds(e.data_offset, e.data_size, file_.size()) ||
+            e.data_offset % detail::PAYLOAD_ALIGNMENT != 0) {
+            throw fail(std::string(name) + ": payload out of bounds");
+        }
+        switch (AssetType(e.type)) {
+        case AssetType::Surface: {
+            const Uint32 w { e.params[0] };
+            const Uint32 h { e.params[1] };
+            const Uint32 pitch { e.params[2] };
+            const Uint32 format { e.params[3] };
+            if (w == 0 || h == 0 || w > INT_MAX || h > INT_MAX || pitch > INT_MAX ||
+                format == SDL_PIXELFORMAT_UNKNOWN || SDL_ISPIXELFORMAT_INDEXED(format) ||
+                SDL_ISPIXELFORMAT_FOURCC(format) ||
+                Uint64(pitch) < Uint64(w) * SDL_BYTESPERPIXEL(format) ||
+                Uint64(pitch) * h > e.data_size) {
+                throw fail(std::string(name) + ": invalid surface");
+            }
+            break;
+        }
+        case AssetType::Chunk:
+            if (e.data_size > Uint64(UINT32_MAX))
+                throw fail(std::string(name) + ": chunk too large");
+            break;
+        case AssetType::Font:
+            if (e.data_size > Uint64(INT_MAX))
+                throw fail(std::string(name) + ": font too large");
+            break;
+        default:
+            throw fail(std::string(name) + ": unknown asset type");
+        }
+    }
+}
+
+BundleEntry AssetBundle::entry(std::size_t i) const {
+    BundleEntry e {};
+    // copied, as the index has no alignment guarantee for direct access
+    std::memcpy(&e, file_.data() + index_offset_ + i * sizeof(BundleEntry), sizeof(e));
+    return e;
+}
+
+std::string_view AssetBundle::entryName(const BundleEntry& e) const {
+    return std::string_view {
+        reinterpret_cast<const char*>(file_.data() + names_offset_ + e.name_offset),
+        e.name_size
+    };
+}
+
+std::size_t AssetBundle::findIndex(std::string_view name) const {
+    std::size_t low {};
+    std::size_t high { entry_ct_ };
+    while (low < high) {
+        const std::size_t mid { low + (high - low) / 2 };
+        const std::string_view mid_name { entryName(entry(mid)) };
+        if (mid_name == name)
+            return mid;
+        if (mid_name < name)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return entry_ct_;
+}
+
+BundleEntry AssetBundle::find(std::string_view name) const {
+    const std::size_t i { findIndex(name) };
+    if (i == entry_ct_)
+        throw std::out_of_range("AssetBundle: no asset named " + std::string(name));
+    return entry(i);
+}
+
+BundleEntry AssetBundle::find(std::string_view name, AssetType type) const {
+    const BundleEntry e { find(name) };
+    if (AssetType(e.type) != type)
+        throw std::invalid_argument("AssetBundle: wrong asset type for " + std::string(name));
+    return e;
+}
+
+std::vector<std::string_view> AssetBundle::names() const {
+    std::vector<std::string_view> result;
+    result.reserve(entry_ct_);
+    for (std::size_t i {}; i < entry_ct_; ++i)
+        result.push_back(entryName(entry(i)));
+    return result;
+}
+
+bool AssetBundle::contains(std::string_view name) const {
+    return findIndex(name) != entry_ct_;
+}
+
+AssetType AssetBundle::type(std::string_view name) const {
+    return AssetType(find(name).type);
+}
+
+const unsigned char* AssetBundle::data(std::string_view name) const {
+    return file_.data() + find(name).data_offset;
+}
+
+std::size_t AssetBundle::dataSize(std::string_view name) const {
+    return std::size_t(find(name).data_size);
+}
+
+sdl2_smart_ptr::unique::Surface AssetBundle::loadSurface(std::string_view name) const {
+    const BundleEntry e { find(name, AssetType::Surface) };
+    const Uint32 format { e.params[3] };
+    // the mapping is copy-on-write, so writes to pixels never reach the file
+    void* pixels { const_cast<unsigned char*>(file_.data() + e.data_offset) };
+    return sdl2_smart_ptr::make_unique(
+        safeSdlCall(SDL_CreateRGBSurfaceWithFormatFrom, "SDL_CreateRGBSurfaceWithFormatFrom",
+                    SdlRetTest<SDL_Surface*>{ [](const SDL_Surface* surface){
+                        return (surface == nullptr); } },
+                    pixels, int(e.params[0]), int(e.params[1]),
+                    int(SDL_BITSPERPIXEL(format)), int(e.params[2]), format));
+}
+
+sdl2_smart_ptr::unique::MixChunk AssetBundle::loadChunk(std::string_view name) const {
+    const BundleEntry e { find(name, AssetType::Chunk) };
+    int frequency {};
+    Uint16 format {};
+    int channels {};
+    safeSdlCall(Mix_QuerySpec, "Mix_QuerySpec",
+                SdlRetTest<int>{ [](const int ret){ return (ret == 0); } },
+                &frequency, &format, &channels);
+    if (Uint32(frequency) != e.params[0] || format != e.params[1] ||
+        Uint32(channels) != e.params[2]) {
+        throw std::runtime_error("AssetBundle: " + std::string(name) +
+                                 ": PCM format differs from audio device");
+    }
+    // Mix_QuickLoad_RAW chunks don't free or write to their buffer
+    Uint8* pcm { const_cast<Uint8*>(file_.data() + e.data_offset) };
+    return sdl2_smart_ptr::make_unique(
+        safeSdlCall(Mix_QuickLoad_RAW, "Mix_QuickLoad_RAW",
+                    SdlRetTest<Mix_Chunk*>{ [](const Mix_Chunk* chunk){
+                        return (chunk == nullptr); } },
+                    pcm, Uint32(e.data_size)));
+}
+
+sdl2_smart_ptr::unique::TtfFont AssetBundle::loadFont(std::string_view name,
+                                                      int ptsize) const {
+    const BundleEntry e { find(name, AssetType::Font) };
+    SDL_RWops* rwops {
+        safeSdlCall(SDL_RWFromConstMem, "SDL_RWFromConstMem",
+                    SdlRetTest<SDL_RWops*>{ [](const SDL_RWops* rw){
+                        return (rw == nullptr); } },
+                    static_cast<const void*>(file_.data() + e.data_offset),
+                    int(e.data_size))
+    };
+    // font closes rwops, including on failure
+    return sdl2_smart_ptr::make_unique(
+        safeSdlCall(TTF_OpenFontRW, "TTF_OpenFontRW",
+                    SdlRetTest<TTF_Font*>{ [](const TTF_Font* font){
+                        return (font == nullptr); } },
+                    rwops, 1, ptsize));
+}
+
+}  // namespace sdl2_asset_util
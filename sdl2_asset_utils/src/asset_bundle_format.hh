@@ -0,0 +1,66 @@
+#ifndef ASSET_BUNDLE_FORMAT_HH
+#define ASSET_BUNDLE_FORMAT_HH
+
+#include "SDL_stdinc.h"  // Uint32 Uint64
+
+#include <cstddef>       // size_t
+#include <type_traits>   // is_trivially_copyable_v
+
+
+namespace sdl2_asset_util {
+
+namespace detail {
+
+/*
+ * On-disk layout of asset bundles, in the builder's byte order:
+ *
+ *   BundleHeader
+ *   payloads, each starting on a PAYLOAD_ALIGNMENT boundary
+ *   BundleEntry[entry_ct], sorted by name
+ *   names, concatenated without terminators
+ *
+ * Payloads are surface pixel rows of pitch bytes in the entry's pixel format,
+ *   PCM in the entry's audio format, or font files as they were.
+ */
+
+static constexpr char BUNDLE_MAGIC[8] { 'S', 'D', 'L', '2', 'B', 'N', 'D', 'L' };
+static constexpr Uint32 BUNDLE_VERSION { 1 };
+// reads back as something else in the other byte order
+static constexpr Uint32 BUNDLE_BYTE_ORDER { 0x01020304 };
+// so that surface rows can be read with aligned SIMD loads
+static constexpr std::size_t PAYLOAD_ALIGNMENT { 64 };
+
+struct BundleHeader {
+    char magic[8];
+    Uint32 version;
+    Uint32 byte_order;
+    Uint64 file_size;
+    Uint64 index_offset;
+    Uint64 names_offset;
+    Uint64 names_size;
+    Uint32 entry_ct;
+    Uint32 reserved;
+};
+
+// params by type:
+//   Surface: w, h, pitch, SDL_PixelFormatEnum
+//   Chunk:   frequency, SDL_AudioFormat, channels, 0
+//   Font:    0, 0, 0, 0
+struct BundleEntry {
+    Uint64 name_offset;
+    Uint64 data_offset;
+    Uint64 data_size;
+    Uint32 name_size;
+    Uint32 type;
+    Uint32 params[4];
+};
+
+static_assert(sizeof(BundleHeader) == 56 && std::is_trivially_copyable_v<BundleHeader>);
+static_assert(sizeof(BundleEntry) == 48 && std::is_trivially_copyable_v<BundleEntry>);
+
+}  // namespace detail
+
+}  // namespace sdl2_asset_util
+
+
+#endif  // ASSET_BUNDLE_FORMAT_HH
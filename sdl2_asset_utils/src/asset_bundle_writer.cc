@@ -0,0 +1,145 @@
+#include "asset_bundle_writer.hh"
+
+#include "asset_bundle_format.hh"
+
+#include "safeSdlCall.hh"
+#include "sdl2_smart_ptr.hh"  // make_unique
+
+#include "SDL_pixels.h"       // SDL_ISPIXELFORMAT_*
+#include "SDL_surface.h"      // SDL_ConvertSurfaceFormat SDL_LockSurface
+
+#include <algorithm>          // sort
+#include <cstring>            // memcpy
+#include <fstream>
+#include <stdexcept>          // invalid_argument runtime_error
+#include <utility>            // move
+
+
+namespace sdl2_asset_util {
+
+using detail::BundleEntry;
+using detail::BundleHeader;
+
+void AssetBundleWriter::add(Asset asset) {
+    if (asset.name.empty())
+        throw std::invalid_argument("AssetBundleWriter: empty asset name");
+    if (!names_.insert(asset.name).second)
+        throw std::invalid_argument("AssetBundleWriter: duplicate asset name " + asset.name);
+    assets_.push_back(std::move(asset));
+}
+
+void AssetBundleWriter::addSurface(std::string name, const SDL_Surface* surface,
+                                   Uint32 format) {
+    if (surface == nullptr)
+        throw std::invalid_argument("AssetBundleWriter: null surface");
+    if (format == SDL_PIXELFORMAT_UNKNOWN || SDL_ISPIXELFORMAT_INDEXED(format) ||
+        SDL_ISPIXELFORMAT_FOURCC(format)) {
+        throw std::invalid_argument(
+            "AssetBundleWriter: " + name + ": pixel format must be packed or array");
+    }
+    // SDL_ConvertSurfaceFormat only reads its source
+    auto converted { sdl2_smart_ptr::make_unique(
+            safeSdlCall(SDL_ConvertSurfaceFormat, "SDL_ConvertSurfaceFormat",
+                        SdlRetTest<SDL_Surface*>{ [](const SDL_Surface* s){
+                            return (s == nullptr); } },
+                        const_cast<SDL_Surface*>(surface), format, Uint32(0))) };
+    if (SDL_MUSTLOCK(converted.get())) {
+        safeSdlCall(SDL_LockSurface, "SDL_LockSurface",
+                    SdlRetTest<int>{ [](const int ret){ return (ret != 0); } },
+                    converted.get());
+    }
+    const std::size_t size { std::size_t(converted->pitch) * std::size_t(converted->h) };
+    std::vector<unsigned char> pixels(size);
+    std::memcpy(pixels.data(), converted->pixels, size);
+    if (SDL_MUSTLOCK(converted.get()))
+        SDL_UnlockSurface(converted.get());
+    add(Asset {
+            std::move(name), AssetType::Surface,
+            { Uint32(converted->w), Uint32(converted->h), Uint32(converted->pitch), format },
+            std::move(pixels) });
+}
+
+void AssetBundleWriter::addChunk(std::string name, const Mix_Chunk* chunk,
+                                 int frequency, Uint16 format, int channels) {
+    if (chunk == nullptr)
+        throw std::invalid_argument("AssetBundleWriter: null chunk");
+    if (frequency <= 0 || channels <= 0)
+        throw std::invalid_argument("AssetBundleWriter: " + name + ": invalid audio format");
+    std::vector<unsigned char> pcm(chunk->abuf, chunk->abuf + chunk->alen);
+    add(Asset {
+            std::move(name), AssetType::Chunk,
+            { Uint32(frequency), Uint32(format), Uint32(channels), 0 },
+            std::move(pcm) });
+}
+
+void AssetBundleWriter::addFont(std::string name, std::vector<unsigned char> font_data) {
+    if (font_data.empty())
+        throw std::invalid_argument("AssetBundleWriter: " + name + ": empty font");
+    add(Asset { std::move(name), AssetType::Font, {}, std::move(font_data) });
+}
+
+// rounds offset up to next payload boundary
+static Uint64 alignPayload(const Uint64 offset) {
+    constexpr Uint64 align { detail::PAYLOAD_ALIGNMENT };
+    return (offset + align - 1) / align * align;
+}
+
+void AssetBundleWriter::write(const std::string& path) const {
+    // index sorted by name, for binary search on load
+    std::vector<const Asset*> sorted;
+    sorted.reserve(assets_.size());
+    for (const Asset& asset : assets_)
+        sorted.push_back(&asset);
+    std::sort(sorted.begin(), sorted.end(), [](const Asset* a, const Asset* b){
+        return a->name < b->name;
+    });
+
+    std::vector<BundleEntry> entries;
+    entries.reserve(sorted.size());
+    std::string names;
+    Uint64 offset { sizeof(BundleHeader) };
+    for (const Asset* asset : sorted) {
+        offset = alignPayload(offset);
+        BundleEntry entry {};
+        entry.name_offset = names.size();
+        entry.data_offset = offset;
+        entry.data_size = asset->data.size();
+        entry.name_size = Uint32(asset->name.size());
+        entry.type = Uint32(asset->type);
+        for (std::size_t i {}; i < asset->params.size(); ++i)
+            entry.params[i] = asset->params[i];
+        entries.push_back(entry);
+        names += asset->name;
+        offset += asset->data.size();
+    }
+
+    BundleHeader header {};
+    std::memcpy(header.magic, detail::BUNDLE_MAGIC, sizeof(header.magic));
+    header.version = detail::BUNDLE_VERSION;
+    header.byte_order = detail::BUNDLE_BYTE_ORDER;
+    header.index_offset = offset;
+    header.names_offset = offset + entries.size() * sizeof(BundleEntry);
+    header.names_size = names.size();
+    header.file_size = header.names_offset + header.names_size;
+    header.entry_ct = Uint32(entries.size());
+
+    std::ofstream file { path, std::ios::binary | std::ios::trunc };
+    if (!file)
+        throw std::runtime_error("AssetBundleWriter: could not open " + path);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    static constexpr char PADDING[detail::PAYLOAD_ALIGNMENT] {};
+    for (std::size_t i {}; i < sorted.size(); ++i) {
+        const std::streamoff pos { file.tellp() };
+        file.write(PADDING, std::streamsize(entries[i].data_offset - Uint64(pos)));
+        file.write(reinterpret_cast<const char*>(sorted[i]->data.data()),
+                   std::streamsize(sorted[i]->data.size()));
+    }
+    file.write(reinterpret_cast<const char*>(entries.data()),
+               std::streamsize(entries.size() * sizeof(BundleEntry)));
+    file.write(names.data(), std::streamsize(names.size()));
+    file.close();
+    if (!file)
+        throw std::runtime_error("AssetBundleWriter: could not write " + path);
+}
+
+}  // namespace sdl2_asset_util
@@ -0,0 +1,80 @@
+#ifndef ASSET_BUNDLE_HH
+#define ASSET_BUNDLE_HH
+
+#include "mapped_file.hh"           // MappedFile
+#include "sdl2_mixer_smart_ptr.hh"  // unique::MixChunk
+#include "sdl2_smart_ptr.hh"        // unique::Surface
+#include "sdl2_ttf_smart_ptr.hh"    // unique::TtfFont
+
+#include "SDL_stdinc.h"             // Uint32
+
+#include <cstddef>                  // size_t
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace sdl2_asset_util {
+
+enum class AssetType : Uint32 {
+    Surface = 1,
+    Chunk,
+    Font
+};
+
+namespace detail {
+
+struct BundleEntry;
+
+}  // namespace detail
+
+// Read-only view of a bundle from AssetBundleWriter or asset_bundle_builder:
+//   an index and pre-decoded payloads in one memory mapped file. Assets are
+//   made over the mapping without copying, so the bundle must outlive them.
+//   Surface pixels may be written, as the mapping is copy-on-write, but are
+//   shared by all surfaces loaded from one asset. Malformed bundles throw
+//   std::runtime_error when opened, missing names std::out_of_range, and
+//   names of another asset type std::invalid_argument.
+class AssetBundle {
+public:
+    explicit AssetBundle(const std::string& path);
+
+    std::size_t assetCount() const { return entry_ct_; }
+    // sorted
+    std::vector<std::string_view> names() const;
+    bool contains(std::string_view name) const;
+    AssetType type(std::string_view name) const;
+
+    sdl2_smart_ptr::unique::Surface loadSurface(std::string_view name) const;
+    // chunk PCM must be in the format of the open audio device, as
+    //   Mix_QuickLoad_RAW does no conversion, or std::runtime_error is thrown
+    sdl2_smart_ptr::unique::MixChunk loadChunk(std::string_view name) const;
+    sdl2_smart_ptr::unique::TtfFont loadFont(std::string_view name, int ptsize) const;
+
+    // payload of any asset, in the mapping
+    const unsigned char* data(std::string_view name) const;
+    std::size_t dataSize(std::string_view name) const;
+
+    // reads in every page of the bundle, eg on a loading thread
+    void prefetch() const { file_.prefetch(); }
+
+private:
+    detail::BundleEntry entry(std::size_t i) const;
+    std::string_view entryName(const detail::BundleEntry& entry) const;
+    // index of name, or entry_ct_ if missing
+    std::size_t findIndex(std::string_view name) const;
+    detail::BundleEntry find(std::string_view name) const;
+    detail::BundleEntry find(std::string_view name, AssetType type) const;
+    // sets index members from header, once checked
+    void validate(const std::string& path);
+
+    sdl2_memory_util::MappedFile file_;
+    std::size_t entry_ct_ {};
+    std::size_t index_offset_ {};
+    std::size_t names_offset_ {};
+};
+
+}  // namespace sdl2_asset_util
+
+
+#endif  // ASSET_BUNDLE_HH
@@ -0,0 +1,66 @@
+#ifndef ASSET_BUNDLE_WRITER_HH
+#define ASSET_BUNDLE_WRITER_HH
+
+#include "asset_bundle.hh"  // AssetType
+
+#include "SDL_mixer.h"      // Mix_Chunk
+#include "SDL_stdinc.h"     // Uint16 Uint32
+#include "SDL_surface.h"    // SDL_Surface
+
+#include <array>
+#include <cstddef>          // size_t
+#include <set>
+#include <string>
+#include <vector>
+
+
+namespace sdl2_asset_util {
+
+/*
+ * Collects decoded assets and writes them out as a bundle for AssetBundle,
+ *   eg at build time, so that decoding happens once rather than at every
+ *   startup.
+ *
+ * Assets are copied in when added, so sources can be freed straight after.
+ *   Surfaces are converted to the given pixel format, which should be the
+ *   format the program blits or uploads from, so that loading makes no
+ *   conversion either. Chunk PCM is stored as is, and must already be in the
+ *   format of the audio device the bundle will be loaded with, eg by loading
+ *   with Mix_LoadWAV once Mix_OpenAudio has been called with that format.
+ *
+ * Bundles are written in the byte order of the writing machine, and are
+ *   rejected by AssetBundle on machines of the other byte order.
+ *
+ * Empty or duplicate names, and indexed or FOURCC pixel formats, throw
+ *   std::invalid_argument. SDL and file errors throw std::runtime_error.
+ */
+class AssetBundleWriter {
+public:
+    void addSurface(std::string name, const SDL_Surface* surface, Uint32 format);
+    void addChunk(std::string name, const Mix_Chunk* chunk,
+                  int frequency, Uint16 format, int channels);
+    // font file contents, as read from disk
+    void addFont(std::string name, std::vector<unsigned char> font_data);
+
+    std::size_t assetCount() const { return assets_.size(); }
+
+    void write(const std::string& path) const;
+
+private:
+    struct Asset {
+        std::string name;
+        AssetType type;
+        std::array<Uint32, 4> params;
+        std::vector<unsigned char> data;
+    };
+
+    void add(Asset asset);
+
+    std::vector<Asset> assets_;
+    std::set<std::string> names_;
+};
+
+}  // namespace sdl2_asset_util
+
+
+#endif  // ASSET_BUNDLE_WRITER_HH
@@ -0,0 +1,351 @@
+#include <catch2/catch_version_macros.hpp>               // CATCH_VERSION_MAJOR
+#if (CATCH_VERSION_MAJOR != 3)
+  #error "tests currently only support Catch2 v3.x"
+#endif
+#include <catch2/catch_test_macros.hpp>                  // TEST_CASE, SECTION, REQUIRE
+#include <catch2/benchmark/catch_benchmark.hpp>          // BENCHMARK
+
+#include "asset_bundle.hh"
+#include "asset_bundle_writer.hh"
+#include "mapped_file.hh"
+
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_mixer.h>
+#include <SDL_ttf.h>
+
+#include <cstdint>    // uintptr_t
+#include <cstdio>     // remove
+#include <cstring>    // memcmp
+#include <fstream>
+#include <iterator>   // istreambuf_iterator
+#include <stdexcept>  // invalid_argument out_of_range runtime_error
+#include <string>
+#include <string_view>
+#include <utility>    // swap
+#include <vector>
+
+
+static std::string collectErrorQuitSdl(const std::string& func_name,
+                                       void (*lib_quit_func)() = nullptr) {
+    std::string err { SDL_GetError() };
+    SDL_ClearError();
+    if (err.size() == 0) {
+        err = "failure without setting SDL error";
+    }
+    if (lib_quit_func != nullptr) {
+        lib_quit_func();
+    }
+    SDL_Quit();
+    return func_name + ": " + err;
+}
+
+using namespace sdl2_asset_util;
+
+static const std::string BUNDLE_PATH { "asset_bundle_test.bundle" };
+static const std::string CORRUPT_PATH { "asset_bundle_test_corrupt.bundle" };
+
+// surface of distinct pixel values, in a format needing conversion to ARGB8888
+static sdl2_smart_ptr::unique::Surface testSurface(int w, int h) {
+    auto surface { sdl2_smart_ptr::make_unique(
+            SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ABGR8888)) };
+    REQUIRE(surface != nullptr);
+    for (int y {}; y < h; ++y) {
+        Uint32* row { reinterpret_cast<Uint32*>(
+                static_cast<unsigned char*>(surface->pixels) + y * surface->pitch) };
+        for (int x {}; x < w; ++x)
+            row[x] = 0xff000000 | Uint32(y * w + x) * 2654435761u >> 8;
+    }
+    return surface;
+}
+
+static std::vector<char> readFile(const std::string& path) {
+    std::ifstream file { path, std::ios::binary };
+    return { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+}
+
+static void writeFile(const std::string& path, const std::vector<char>& bytes) {
+    std::ofstream(path, std::ios::binary).write(bytes.data(), std::streamsize(bytes.size()));
+}
+
+TEST_CASE("SDL core asset bundle: surfaces",
+    "[sdl2_asset_util][SDL2][core][AssetBundle]")
+{
+    if (SDL_Init(0) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    {
+        const auto wide { testSurface(67, 5) };
+        const auto tall { testSurface(3, 40) };
+        AssetBundleWriter writer;
+        writer.addSurface("wide", wide.get(), SDL_PIXELFORMAT_ARGB8888);
+        writer.addSurface("tall", tall.get(), SDL_PIXELFORMAT_ARGB8888);
+        writer.addSurface("tall_rgb", tall.get(), SDL_PIXELFORMAT_RGB24);
+        REQUIRE(writer.assetCount() == 3);
+        writer.write(BUNDLE_PATH);
+
+        SECTION("writer rejects invalid assets")
+        {
+            REQUIRE_THROWS_AS(writer.addSurface("wide", wide.get(), SDL_PIXELFORMAT_ARGB8888),
+                              std::invalid_argument);
+            REQUIRE_THROWS_AS(writer.addSurface("", wide.get(), SDL_PIXELFORMAT_ARGB8888),
+                              std::invalid_argument);
+            REQUIRE_THROWS_AS(writer.addSurface("indexed", wide.get(), SDL_PIXELFORMAT_INDEX8),
+                              std::invalid_argument);
+            REQUIRE_THROWS_AS(writer.addSurface("yuv", wide.get(), SDL_PIXELFORMAT_YV12),
+                              std::invalid_argument);
+            REQUIRE(writer.assetCount() == 3);
+        }
+        SECTION("index")
+        {
+            const AssetBundle bundle { BUNDLE_PATH };
+            REQUIRE(bundle.assetCount() == 3);
+            const std::vector<std::string_view> names { bundle.names() };
+            REQUIRE(names == std::vector<std::string_view> { "tall", "tall_rgb", "wide" });
+            REQUIRE(bundle.contains("wide"));
+            REQUIRE(!bundle.contains("wid"));
+            REQUIRE(!bundle.contains("wide2"));
+            REQUIRE(bundle.type("tall") == AssetType::Surface);
+            REQUIRE_THROWS_AS(bundle.type("missing"), std::out_of_range);
+            REQUIRE_THROWS_AS(bundle.loadSurface("missing"), std::out_of_range);
+            REQUIRE_THROWS_AS(bundle.loadFont("wide", 12), std::invalid_argument);
+            REQUIRE_THROWS_AS(bundle.loadChunk("wide"), std::invalid_argument);
+        }
+        SECTION("surfaces load without copying or conversion")
+        {
+            const AssetBundle bundle { BUNDLE_PATH };
+            bundle.prefetch();
+            const auto loaded { bundle.loadSurface("wide") };
+            REQUIRE(loaded->w == wide->w);
+            REQUIRE(loaded->h == wide->h);
+            REQUIRE(loaded->format->format == SDL_PIXELFORMAT_ARGB8888);
+            REQUIRE(loaded->pixels == bundle.data("wide"));
+            REQUIRE(reinterpret_cast<std::uintptr_t>(loaded->pixels) % 64 == 0);
+            REQUIRE(bundle.dataSize("wide") == std::size_t(loaded->pitch * loaded->h));
+
+            const auto expected { sdl2_smart_ptr::make_unique(
+                    SDL_ConvertSurfaceFormat(wide.get(), SDL_PIXELFORMAT_ARGB8888, 0)) };
+            REQUIRE(expected != nullptr);
+            REQUIRE(loaded->pitch == expected->pitch);
+            REQUIRE(std::memcmp(loaded->pixels, expected->pixels,
+                                std::size_t(expected->pitch * expected->h)) == 0);
+
+            const auto rgb { bundle.loadSurface("tall_rgb") };
+            REQUIRE(rgb->w == 3);
+            REQUIRE(rgb->h == 40);
+            REQUIRE(rgb->format->format == SDL_PIXELFORMAT_RGB24);
+        }
+        SECTION("surfaces can be written without changing the bundle")
+        {
+            {
+                const AssetBundle bundle { BUNDLE_PATH };
+                const auto loaded { bundle.loadSurface("wide") };
+                REQUIRE(SDL_FillRect(loaded.get(), nullptr, 0x12345678) == 0);
+                REQUIRE(static_cast<const Uint32*>(loaded->pixels)[0] == 0x12345678);
+            }
+            const AssetBundle bundle { BUNDLE_PATH };
+            const auto loaded { bundle.loadSurface("wide") };
+            const auto expected { sdl2_smart_ptr::make_unique(
+                    SDL_ConvertSurfaceFormat(wide.get(), SDL_PIXELFORMAT_ARGB8888, 0)) };
+            REQUIRE(expected != nullptr);
+            REQUIRE(std::memcmp(loaded->pixels, expected->pixels,
+                                std::size_t(expected->pitch * expected->h)) == 0);
+        }
+        SECTION("malformed bundles are rejected on open")
+        {
+            const std::vector<char> bytes { readFile(BUNDLE_PATH) };
+
+            std::vector<char> bad_magic { bytes };
+            bad_magic[0] = 'X';
+            writeFile(CORRUPT_PATH, bad_magic);
+            REQUIRE_THROWS_AS(AssetBundle(CORRUPT_PATH), std::runtime_error);
+
+            std::vector<char> truncated { bytes.begin(), bytes.end() - 1 };
+            writeFile(CORRUPT_PATH, truncated);
+            REQUIRE_THROWS_AS(AssetBundle(CORRUPT_PATH), std::runtime_error);
+
+            std::vector<char> header_only { bytes.begin(), bytes.begin() + 20 };
+            writeFile(CORRUPT_PATH, header_only);
+            REQUIRE_THROWS_AS(AssetBundle(CORRUPT_PATH), std::runtime_error);
+
+            // byte order field follows magic and version
+            std::vector<char> swapped { bytes };
+            std::swap(swapped[12], swapped[15]);
+            std::swap(swapped[13], swapped[14]);
+            writeFile(CORRUPT_PATH, swapped);
+            REQUIRE_THROWS_AS(AssetBundle(CORRUPT_PATH), std::runtime_error);
+
+            // first payload size beyond end of file
+            std::vector<char> oversized { bytes };
+            const Uint64 index_offset { [&](){
+                Uint64 offset {};
+                std::memcpy(&offset, bytes.data() + 24, sizeof(offset));
+                return offset; }() };
+            const Uint64 data_size { Uint64(bytes.size()) };
+            std::memcpy(oversized.data() + index_offset + 16, &data_size, sizeof(data_size));
+            writeFile(CORRUPT_PATH, oversized);
+            REQUIRE_THROWS_AS(AssetBundle(CORRUPT_PATH), std::runtime_error);
+
+            REQUIRE_THROWS_AS(AssetBundle("no_such_bundle"), std::runtime_error);
+        }
+        SECTION("empty bundle")
+        {
+            AssetBundleWriter().write(CORRUPT_PATH);
+            const AssetBundle bundle { CORRUPT_PATH };
+            REQUIRE(bundle.assetCount() == 0);
+            REQUIRE(!bundle.contains("wide"));
+        }
+    }
+
+    std::remove(BUNDLE_PATH.c_str());
+    std::remove(CORRUPT_PATH.c_str());
+    SDL_Quit();
+}
+
+TEST_CASE("SDL_mixer asset bundle: chunks",
+    "[sdl2_asset_util][SDL2][SDL_mixer][AssetBundle]")
+{
+    if (SDL_Init(SDL_INIT_AUDIO) != 0) {
+        SKIP(collectErrorQuitSdl("SDL_Init"));
+    }
+    if (Mix_OpenAudio(44100, AUDIO_S16SYS, 2, 1024) != 0) {
+        SKIP(collectErrorQuitSdl("Mix_OpenAudio", Mix_Quit));
+    }
+    int frequency {};
+    Uint16 format {};
+    int channels {};
+    REQUIRE(Mix_QuerySpec(&frequency, &format, &channels) != 0);
+
+    {
+        std::vector<Uint8> pcm(4096);
+        for (std::size_t i {}; i < pcm.size(); ++i)
+            pcm[i] = Uint8(i * 7);
+        auto chunk { sdl2_smart_ptr::make_unique(
+                Mix_QuickLoad_RAW(pcm.data(), Uint32(pcm.size()))) };
+        REQUIRE(chunk != nullptr);
+        AssetBundleWriter writer;
+        writer.addChunk("beep", chunk.get(), frequency, format, channels);
+        writer.addChunk("other_rate", chunk.get(), frequency + 1, format, channels);
+        REQUIRE_THROWS_AS(writer.addChunk("bad", chunk.get(), 0, format, channels),
+                          std::invalid_argument);
+        writer.write(BUNDLE_PATH);
+
+        const AssetBundle bundle { BUNDLE_PATH };
+        REQUIRE(bundle.type("beep") == AssetType::Chunk);
+        const auto loaded { bundle.loadChunk("beep") };
+        REQUIRE(loaded->alen == pcm.size());
+        REQUIRE(loaded->abuf == bundle.data("beep"));
+        REQUIRE(std::memcmp(loaded->abuf, pcm.data(), pcm.size()) == 0);
+        REQUIRE(Mix_PlayChannel(-1, loaded.get(), 0) != -1);
+        Mix_HaltChannel(-1);
+
+        // Mix_QuickLoad_RAW can't convert to the device format
+        REQUIRE_THROWS_AS(bundle.loadChunk("other_rate"), std::runtime_error);
+    }
+
+    std::remove(BUNDLE_PATH.c_str());
+    Mix_CloseAudio();
+    Mix_Quit();
+    SDL_Quit();
+}
+
+TEST_CASE("SDL_ttf asset bundle: fonts",
+    "[sdl2_asset_util][SDL2][SDL_ttf][AssetBundle]")
+{
+    if (SDL_Init(0) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+    if (TTF_Init() != 0) {
+        FAIL(collectErrorQuitSdl("TTF_Init", TTF_Quit));
+    }
+
+    {
+        const sdl2_memory_util::MappedFile font_file { EXAMPLE_DATA_DIR "Courier New.ttf" };
+        AssetBundleWriter writer;
+        writer.addFont("courier", std::vector<unsigned char>(
+                           font_file.data(), font_file.data() + font_file.size()));
+        writer.addFont("garbage", std::vector<unsigned char>(100, 0xab));
+        REQUIRE_THROWS_AS(writer.addFont("empty", {}), std::invalid_argument);
+        writer.write(BUNDLE_PATH);
+
+        const AssetBundle bundle { BUNDLE_PATH };
+        REQUIRE(bundle.type("courier") == AssetType::Font);
+        REQUIRE(bundle.dataSize("courier") == font_file.size());
+        REQUIRE(std::memcmp(bundle.data("courier"), font_file.data(), font_file.size()) == 0);
+        const auto font { bundle.loadFont("courier", 16) };
+        REQUIRE(TTF_FontHeight(font.get()) > 0);
+        // more than one size from one payload
+        const auto large { bundle.loadFont("courier", 48) };
+        REQUIRE(TTF_FontHeight(large.get()) > TTF_FontHeight(font.get()));
+
+        REQUIRE_THROWS_AS(bundle.loadFont("garbage", 16), std::runtime_error);
+    }
+
+    std::remove(BUNDLE_PATH.c_str());
+    TTF_Quit();
+    SDL_Quit();
+}
+
+TEST_CASE("SDL asset bundle load time: bundle vs decoding",
+    "[.][benchmark][sdl2_asset_util][SDL2][SDL_image][SDL_mixer][SDL_ttf][AssetBundle]")
+{
+    if (SDL_Init(SDL_INIT_AUDIO) != 0) {
+        SKIP(collectErrorQuitSdl("SDL_Init"));
+    }
+    if (Mix_OpenAudio(44100, AUDIO_S16SYS, 2, 1024) != 0) {
+        SKIP(collectErrorQuitSdl("Mix_OpenAudio", Mix_Quit));
+    }
+    if (TTF_Init() != 0) {
+        FAIL(collectErrorQuitSdl("TTF_Init", TTF_Quit));
+    }
+    int frequency {};
+    Uint16 format {};
+    int channels {};
+    REQUIRE(Mix_QuerySpec(&frequency, &format, &channels) != 0);
+
+    static const std::string IMAGE_PATH { EXAMPLE_DATA_DIR "privat_parkering.jpg" };
+    static const std::string SOUND_PATH { EXAMPLE_DATA_DIR "2A.mp3" };
+    static const std::string FONT_PATH { EXAMPLE_DATA_DIR "Courier New.ttf" };
+
+    {
+        AssetBundleWriter writer;
+        {
+            auto image { sdl2_smart_ptr::make_unique(IMG_Load(IMAGE_PATH.c_str())) };
+            REQUIRE(image != nullptr);
+            writer.addSurface("image", image.get(), SDL_PIXELFORMAT_ARGB8888);
+            auto sound { sdl2_smart_ptr::make_unique(Mix_LoadWAV(SOUND_PATH.c_str())) };
+            REQUIRE(sound != nullptr);
+            writer.addChunk("sound", sound.get(), frequency, format, channels);
+            const sdl2_memory_util::MappedFile font_file { FONT_PATH };
+            writer.addFont("font", std::vector<unsigned char>(
+                               font_file.data(), font_file.data() + font_file.size()));
+        }
+        writer.write(BUNDLE_PATH);
+
+        BENCHMARK("IMG_Load, SDL_ConvertSurfaceFormat, Mix_LoadWAV and TTF_OpenFont") {
+            auto image { sdl2_smart_ptr::make_unique(IMG_Load(IMAGE_PATH.c_str())) };
+            auto converted { sdl2_smart_ptr::make_unique(
+                    SDL_ConvertSurfaceFormat(image.get(), SDL_PIXELFORMAT_ARGB8888, 0)) };
+            auto sound { sdl2_smart_ptr::make_unique(Mix_LoadWAV(SOUND_PATH.c_str())) };
+            auto font { sdl2_smart_ptr::make_unique(TTF_OpenFont(FONT_PATH.c_str(), 16)) };
+            return converted != nullptr && sound != nullptr && font != nullptr;
+        };
+        BENCHMARK("AssetBundle open and loads") {
+            const AssetBundle bundle { BUNDLE_PATH };
+            auto image { bundle.loadSurface("image") };
+            auto sound { bundle.loadChunk("sound") };
+            auto font { bundle.loadFont("font", 16) };
+            return image != nullptr && sound != nullptr && font != nullptr;
+        };
+        SDL_Log("AssetBundle: %zu bytes for %zu assets",
+                sdl2_memory_util::MappedFile(BUNDLE_PATH).size(), writer.assetCount());
+    }
+
+    std::remove(BUNDLE_PATH.c_str());
+    TTF_Quit();
+    Mix_CloseAudio();
+    Mix_Quit();
+    IMG_Quit();
+    SDL_Quit();
+}
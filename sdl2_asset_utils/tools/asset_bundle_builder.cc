@@ -0,0 +1,216 @@
+/*
+ * asset_bundle_builder: decodes images, sounds and fonts into an asset bundle
+ *   for sdl2_asset_util::AssetBundle, eg as a build step.
+ *
+ * usage: asset_bundle_builder [-p pixel_format] [-f frequency]
+ *            [-a U8|S16|S32|F32] [-c channels] output file...
+ *
+ * Assets are named by their path as given. Images (.bmp .gif .jpg .jpeg .png
+ *   .tga .tif .tiff .webp) are stored in pixel_format (default ARGB8888);
+ *   sounds (.wav .ogg .mp3 .flac .voc) as PCM in the given audio format
+ *   (default 44100 Hz S16 stereo), which must match the format the program
+ *   opens its audio device with; and fonts (.ttf .otf) as they are.
+ */
+
+#include "asset_bundle_writer.hh"
+#include "mapped_file.hh"
+
+#include "safeSdlCall.hh"
+#include "sdl2_mixer_smart_ptr.hh"
+
+#include "SDL.h"
+#include "SDL_image.h"
+#include "SDL_mixer.h"
+
+#include <algorithm>  // transform
+#include <cctype>     // tolower
+#include <cstdlib>    // EXIT_SUCCESS EXIT_FAILURE
+#include <exception>
+#include <iostream>
+#include <set>
+#include <stdexcept>  // invalid_argument
+#include <string>
+#include <vector>
+
+
+using sdl2_asset_util::AssetBundleWriter;
+
+static const std::set<std::string> IMAGE_EXTENSIONS {
+    ".bmp", ".gif", ".jpg", ".jpeg", ".png", ".tga", ".tif", ".tiff", ".webp"
+};
+static const std::set<std::string> SOUND_EXTENSIONS {
+    ".wav", ".ogg", ".mp3", ".flac", ".voc"
+};
+static const std::set<std::string> FONT_EXTENSIONS {
+    ".ttf", ".otf"
+};
+
+// formats that can be stored, named as by SDL_GetPixelFormatName without prefix
+static constexpr Uint32 PIXEL_FORMATS[] {
+    SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ABGR8888,
+    SDL_PIXELFORMAT_RGBA8888, SDL_PIXELFORMAT_BGRA8888,
+    SDL_PIXELFORMAT_XRGB8888, SDL_PIXELFORMAT_XBGR8888,
+    SDL_PIXELFORMAT_RGB24, SDL_PIXELFORMAT_BGR24,
+    SDL_PIXELFORMAT_RGB565
+};
+
+struct Options {
+    Uint32 pixel_format { SDL_PIXELFORMAT_ARGB8888 };
+    int frequency { 44100 };
+    Uint16 audio_format { AUDIO_S16SYS };
+    int channels { 2 };
+    std::string output;
+    std::vector<std::string> inputs;
+};
+
+static void usage(const char* name) {
+    std::cerr << "usage: " << name << " [-p pixel_format] [-f frequency]"
+        " [-a U8|S16|S32|F32] [-c channels] output file...\n";
+}
+
+static Uint32 parsePixelFormat(const std::string& name) {
+    const std::string prefix { "SDL_PIXELFORMAT_" };
+    for (const Uint32 format : PIXEL_FORMATS) {
+        const std::string format_name { SDL_GetPixelFormatName(format) };
+        if (name == format_name || prefix + name == format_name)
+            return format;
+    }
+    throw std::invalid_argument("unsupported pixel format " + name);
+}
+
+static Uint16 parseAudioFormat(const std::string& name) {
+    if (name == "U8")
+        return AUDIO_U8;
+    if (name == "S16")
+        return AUDIO_S16SYS;
+    if (name == "S32")
+        return AUDIO_S32SYS;
+    if (name == "F32")
+        return AUDIO_F32SYS;
+    throw std::invalid_argument("unsupported audio format " + name);
+}
+
+static Options parseOptions(int argc, char* argv[]) {
+    Options options;
+    int i { 1 };
+    for (; i < argc && argv[i][0] == '-'; ++i) {
+        const std::string flag { argv[i] };
+        if (i + 1 == argc)
+            throw std::invalid_argument(flag + " requires a value");
+        const std::string value { argv[++i] };
+        if (flag == "-p")
+            options.pixel_format = parsePixelFormat(value);
+        else if (flag == "-f")
+            options.frequency = std::stoi(value);
+        else if (flag == "-a")
+            options.audio_format = parseAudioFormat(value);
+        else if (flag == "-c")
+            options.channels = std::stoi(value);
+        else
+            throw std::invalid_argument("unknown option " + flag);
+    }
+    if (argc - i < 2)
+        throw std::invalid_argument("expected output and at least one input");
+    options.output = argv[i++];
+    for (; i < argc; ++i)
+        options.inputs.emplace_back(argv[i]);
+    return options;
+}
+
+static std::string extension(const std::string& path) {
+    const std::size_t dot { path.rfind('.') };
+    if (dot == std::string::npos)
+        return {};
+    std::string ext { path.substr(dot) };
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                   [](unsigned char c){ return char(std::tolower(c)); });
+    return ext;
+}
+
+static void addImage(AssetBundleWriter& writer, const std::string& path,
+                     const Options& options) {
+    auto surface { sdl2_smart_ptr::make_unique(
+            safeSdlCall(IMG_Load, "IMG_Load",
+                        SdlRetTest<SDL_Surface*>{ [](const SDL_Surface* s){
+                            return (s == nullptr); } },
+                        path.c_str())) };
+    writer.addSurface(path, surface.get(), options.pixel_format);
+}
+
+static void addSound(AssetBundleWriter& writer, const std::string& path) {
+    // loaded chunks are converted to the open device's format
+    int frequency {};
+    Uint16 format {};
+    int channels {};
+    safeSdlCall(Mix_QuerySpec, "Mix_QuerySpec",
+                SdlRetTest<int>{ [](const int ret){ return (ret == 0); } },
+                &frequency, &format, &channels);
+    auto chunk { sdl2_smart_ptr::make_unique(
+            safeSdlCall(Mix_LoadWAV, "Mix_LoadWAV",
+                        SdlRetTest<Mix_Chunk*>{ [](const Mix_Chunk* c){
+                            return (c == nullptr); } },
+                        path.c_str())) };
+    writer.addChunk(path, chunk.get(), frequency, format, channels);
+}
+
+static void addFont(AssetBundleWriter& writer, const std::string& path) {
+    const sdl2_memory_util::MappedFile file { path };
+    writer.addFont(path, std::vector<unsigned char>(file.data(), file.data() + file.size()));
+}
+
+static void build(const Options& options) {
+    AssetBundleWriter writer;
+    bool audio_open { false };
+    for (const std::string& path : options.inputs) {
+        const std::string ext { extension(path) };
+        if (IMAGE_EXTENSIONS.count(ext) != 0) {
+            addImage(writer, path, options);
+        } else if (SOUND_EXTENSIONS.count(ext) != 0) {
+            if (!audio_open) {
+                // no audio output is needed, only conversion
+                SDL_setenv("SDL_AUDIODRIVER", "dummy", 0);
+                safeSdlCall(Mix_OpenAudio, "Mix_OpenAudio",
+                            SdlRetTest<int>{ [](const int ret){ return (ret != 0); } },
+                            options.frequency, options.audio_format, options.channels,
+                            1024);
+                audio_open = true;
+            }
+            addSound(writer, path);
+        } else if (FONT_EXTENSIONS.count(ext) != 0) {
+            addFont(writer, path);
+        } else {
+            throw std::invalid_argument(path + ": unknown asset type");
+        }
+        std::cout << path << '\n';
+    }
+    writer.write(options.output);
+    if (audio_open)
+        Mix_CloseAudio();
+    std::cout << options.output << ": " << writer.assetCount() << " assets\n";
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        options = parseOptions(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << argv[0] << ": " << e.what() << '\n';
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    int exit_code { EXIT_SUCCESS };
+    try {
+        // Mix_OpenAudio starts the audio subsystem, only if there are sounds
+        safeSdlCall(SDL_Init, "SDL_Init",
+                    SdlRetTest<int>{ [](const int ret){ return (ret != 0); } },
+                    Uint32(0));
+        build(options);
+    } catch (const std::exception& e) {
+        std::cerr << argv[0] << ": " << e.what() << '\n';
+        exit_code = EXIT_FAILURE;
+    }
+    Mix_Quit();
+    IMG_Quit();
+    SDL_Quit();
+    return exit_code;
+}
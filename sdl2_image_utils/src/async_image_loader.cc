@@ -0,0 +1,197 @@
+#include "async_image_loader.hh"
+
+#include "SDL_cpuinfo.h"  // SDL_GetCPUCount
+#include "SDL_error.h"    // SDL_GetError
+#include "SDL_image.h"    // IMG_Load
+
+#include <algorithm>      // max
+#include <utility>        // move
+
+
+namespace sdl2_image_util {
+
+bool AsyncImageLoader::LowerPriority::operator()(const RequestPtr& a,
+                                                 const RequestPtr& b) const {
+    if (a->priority != b->priority)
+        return a->priority < b->priority;
+    // ids are issued in ascending order, so among equals, newer is lower
+    return a->id > b->id;
+}
+
+AsyncImageLoader::AsyncImageLoader(unsigned worker_ct) {
+    if (worker_ct == 0)
+        worker_ct = unsigned(std::max(SDL_GetCPUCount() - 1, 1));
+    workers_.reserve(worker_ct);
+    for (unsigned i {}; i < worker_ct; ++i)
+        workers_.emplace_back(&AsyncImageLoader::decodeLoop, this);
+}
+
+AsyncImageLoader::~AsyncImageLoader() {
+    {
+        std::lock_guard<std::mutex> lock { mtx_ };
+        stopping_ = true;
+    }
+    decode_cv_.notify_all();
+    for (auto& worker : workers_)
+        worker.join();
+}
+
+AsyncImageLoader::RequestId
+AsyncImageLoader::request(std::string path, Callback on_done,
+                          int priority, Group group) {
+    auto req { std::make_shared<Request>() };
+    req->path = std::move(path);
+    req->on_done = std::move(on_done);
+    req->priority = priority;
+    req->group = group;
+    {
+        std::lock_guard<std::mutex> lock { mtx_ };
+        req->id = next_id_++;
+        live_.emplace(req->id, req);
+        decode_queue_.push(req);
+        ++stats_.requested;
+    }
+    decode_cv_.notify_one();
+    return req->id;
+}
+
+bool AsyncImageLoader::cancel(RequestId id) {
+    std::lock_guard<std::mutex> lock { mtx_ };
+    auto it { live_.find(id) };
+    if (it == live_.end())
+        return false;
+    // queued entries are discarded lazily when popped
+    it->second->cancelled.store(true, std::memory_order_release);
+    live_.erase(it);
+    ++stats_.cancelled;
+    return true;
+}
+
+std::size_t AsyncImageLoader::cancelGroup(Group group) {
+    std::lock_guard<std::mutex> lock { mtx_ };
+    std::size_t cancelled_ct {};
+    for (auto it { live_.begin() }; it != live_.end(); ) {
+        if (it->second->group != group) {
+            ++it;
+            continue;
+        }
+        it->second->cancelled.store(true, std::memory_order_release);
+        it = live_.erase(it);
+        ++cancelled_ct;
+    }
+    stats_.cancelled += cancelled_ct;
+    return cancelled_ct;
+}
+
+void AsyncImageLoader::decodeLoop() {
+    for (;;) {
+        RequestPtr req;
+        {
+            std::unique_lock<std::mutex> lock { mtx_ };
+            decode_cv_.wait(lock, [this](){
+                return stopping_ || !decode_queue_.empty();
+            });
+            if (stopping_)
+                return;
+            req = decode_queue_.top();
+            decode_queue_.pop();
+        }
+        if (req->cancelled.load(std::memory_order_acquire))
+            continue;
+
+        SDL_Surface* surface { IMG_Load(req->path.c_str()) };
+        // SDL error string is thread local, so must be collected here
+        if (surface == nullptr) {
+            std::string err { IMG_GetError() };
+            if (err.size() == 0)
+                err = "failure without setting SDL error";
+            req->error = "IMG_Load: " + err;
+        } else {
+            req->surface = sdl2_smart_ptr::make_unique(surface);
+        }
+
+        std::lock_guard<std::mutex> lock { mtx_ };
+        // if cancelled during decode, surface is freed with last reference
+        if (!req->cancelled.load(std::memory_order_acquire))
+            upload_queue_.push(std::move(req));
+    }
+}
+
+std::size_t AsyncImageLoader::pumpUploads(SDL_Renderer* renderer,
+                                          const UploadBudget& budget) {
+    using clock = std::chrono::steady_clock;
+    const auto start { clock::now() };
+    std::size_t uploaded_ct {};
+    std::size_t uploaded_bytes {};
+
+    for (;;) {
+        RequestPtr req;
+        std::size_t bytes {};
+        {
+            std::lock_guard<std::mutex> lock { mtx_ };
+            // discard cancelled requests before checking budget
+            while (!upload_queue_.empty() &&
+                   upload_queue_.top()->cancelled.load(std::memory_order_acquire))
+                upload_queue_.pop();
+            if (upload_queue_.empty())
+                break;
+            const auto& next { upload_queue_.top() };
+            if (next->surface)
+                bytes = std::size_t(next->surface->pitch) *
+                    std::size_t(next->surface->h);
+            if (uploaded_ct > 0 && uploaded_bytes + bytes > budget.bytes)
+                break;
+            req = next;
+            upload_queue_.pop();
+            live_.erase(req->id);
+        }
+
+        Result result { req->id, std::move(req->path), nullptr,
+                        std::move(req->error) };
+        if (req->surface) {
+            SDL_Texture* texture {
+                SDL_CreateTextureFromSurface(renderer, req->surface.get())
+            };
+            req->surface.reset();
+            if (texture == nullptr) {
+                std::string err { SDL_GetError() };
+                if (err.size() == 0)
+                    err = "failure without setting SDL error";
+                result.error = "SDL_CreateTextureFromSurface: " + err;
+            } else {
+                result.texture = sdl2_smart_ptr::make_shared(texture);
+                ++uploaded_ct;
+                uploaded_bytes += bytes;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock { mtx_ };
+            if (result.texture) {
+                ++stats_.uploaded;
+                stats_.uploaded_bytes += bytes;
+            } else {
+                ++stats_.failed;
+            }
+        }
+        if (req->on_done)
+            req->on_done(result);
+
+        // cast before comparing, as microseconds::max() overflows nanoseconds
+        if (std::chrono::duration_cast<std::chrono::microseconds>(
+                clock::now() - start) >= budget.time)
+            break;
+    }
+    return uploaded_ct;
+}
+
+std::size_t AsyncImageLoader::pending() const {
+    std::lock_guard<std::mutex> lock { mtx_ };
+    return live_.size();
+}
+
+AsyncImageLoader::Stats AsyncImageLoader::stats() const {
+    std::lock_guard<std::mutex> lock { mtx_ };
+    return stats_;
+}
+
+}  // namespace sdl2_image_util
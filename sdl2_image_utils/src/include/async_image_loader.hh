@@ -0,0 +1,126 @@
+#ifndef ASYNC_IMAGE_LOADER_HH
+#define ASYNC_IMAGE_LOADER_HH
+
+#include "sdl2_smart_ptr.hh"  // unique::Surface shared::Texture
+
+#include "SDL_render.h"       // SDL_Renderer
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>            // size_t
+#include <cstdint>            // uint32_t uint64_t SIZE_MAX
+#include <functional>         // function
+#include <memory>
+#include <mutex>
+#include <queue>              // priority_queue
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+
+namespace sdl2_image_util {
+
+/*
+ * Decodes image files with IMG_Load on a pool of worker threads, then converts
+ *   the decoded surfaces to textures on the render thread, a few at a time.
+ *
+ * An SDL_Renderer may only be used by the thread that created it, so texture
+ *   creation only happens in pumpUploads(), which is meant to be called once
+ *   per frame. Each call stays within the given UploadBudget, except that at
+ *   least one surface is always uploaded so that loading keeps progressing.
+ *   Result callbacks are also only ever run from pumpUploads().
+ *
+ * IMG_Init should be called for the expected formats before any requests are
+ *   made, and the loader destroyed before IMG_Quit/SDL_Quit.
+ */
+class AsyncImageLoader {
+public:
+    using RequestId = std::uint64_t;
+    // arbitrary tag for cancelling related requests together, eg by scene
+    using Group     = std::uint32_t;
+
+    struct Result {
+        RequestId id;
+        std::string path;
+        sdl2_smart_ptr::shared::Texture texture;  // nullptr on failure
+        std::string error;                        // empty on success
+    };
+    using Callback = std::function<void(const Result&)>;
+
+    struct UploadBudget {
+        std::chrono::microseconds time { std::chrono::microseconds::max() };
+        std::size_t bytes { SIZE_MAX };  // counted as surface pitch * h
+    };
+
+    struct Stats {
+        std::uint64_t requested {};
+        std::uint64_t cancelled {};
+        std::uint64_t failed {};
+        std::uint64_t uploaded {};
+        std::uint64_t uploaded_bytes {};
+    };
+
+    // worker_ct of 0 uses SDL_GetCPUCount, leaving one core to the render thread
+    explicit AsyncImageLoader(unsigned worker_ct = 0);
+    ~AsyncImageLoader();
+
+    AsyncImageLoader(const AsyncImageLoader&) = delete;
+    AsyncImageLoader& operator=(const AsyncImageLoader&) = delete;
+
+    // requests with higher priority are decoded and uploaded first, otherwise
+    //   requests are served in order
+    RequestId request(std::string path, Callback on_done,
+                      int priority = 0, Group group = 0);
+    // cancelled requests never run their callback; returns false if request
+    //   was already completed or cancelled
+    bool cancel(RequestId id);
+    // returns count of requests cancelled
+    std::size_t cancelGroup(Group group);
+
+    // render thread only; returns count of textures created
+    std::size_t pumpUploads(SDL_Renderer* renderer, const UploadBudget& budget);
+
+    // count of requests not yet completed or cancelled
+    std::size_t pending() const;
+    Stats stats() const;
+    unsigned workerCount() const { return unsigned(workers_.size()); }
+
+private:
+    struct Request {
+        RequestId id;
+        std::string path;
+        Callback on_done;
+        int priority;
+        Group group;
+        std::atomic<bool> cancelled {};
+        sdl2_smart_ptr::unique::Surface surface;
+        std::string error;
+    };
+    using RequestPtr = std::shared_ptr<Request>;
+
+    // std::priority_queue pops greatest element first
+    struct LowerPriority {
+        bool operator()(const RequestPtr& a, const RequestPtr& b) const;
+    };
+    using RequestQueue =
+        std::priority_queue<RequestPtr, std::vector<RequestPtr>, LowerPriority>;
+
+    void decodeLoop();
+
+    mutable std::mutex mtx_;
+    std::condition_variable decode_cv_;
+    RequestQueue decode_queue_;
+    RequestQueue upload_queue_;
+    std::unordered_map<RequestId, RequestPtr> live_;
+    RequestId next_id_ { 1 };
+    bool stopping_ {};
+    Stats stats_;
+    std::vector<std::thread> workers_;
+};
+
+}  // namespace sdl2_image_util
+
+
+#endif  // ASYNC_IMAGE_LOADER_HH
@@ -0,0 +1,69 @@
+#ifndef PIXEL_KERNELS_HH
+#define PIXEL_KERNELS_HH
+
+#include "sdl2_smart_ptr.hh"  // unique::Surface
+#include "simd_level.hh"     // SimdLevel
+
+#include "SDL_rect.h"         // SDL_Rect
+#include "SDL_stdinc.h"       // Uint8 Uint32
+#include "SDL_surface.h"      // SDL_Surface
+
+#include <cstddef>            // size_t
+
+
+namespace sdl2_image_util {
+
+// kernels are built for Scalar, Sse41 and Avx2, with bit-identical results
+//   at every level
+using sdl2_thread_util::SimdLevel;
+using sdl2_thread_util::SIMD_LEVEL_CT;
+using sdl2_thread_util::simdLevelName;
+
+// highest level supported by both build and CPU, detected once
+SimdLevel bestSimdLevel();
+bool simdLevelSupported(SimdLevel level);
+
+// Row kernels of count packed pixels. src and dst may be the same row,
+//   except for expandRgb24Row, but must not otherwise overlap. Unsupported
+//   levels throw std::invalid_argument.
+
+// ARGB8888 <-> ABGR8888, swapping the low and third bytes of each pixel
+void swapRedBlueRow(const Uint32* src, Uint32* dst, std::size_t count,
+                    SimdLevel level = bestSimdLevel());
+// 3 bytes per pixel to 4, with opaque alpha last in memory, so RGB24 ->
+//   RGBA32 or BGR24 -> BGRA32
+void expandRgb24Row(const Uint8* src, Uint32* dst, std::size_t count,
+                    SimdLevel level = bestSimdLevel());
+// color * alpha / 255, truncated, bit-exact with SDL2 SDL_PremultiplyAlpha
+void premultiplyAlphaRow(const Uint32* src, Uint32* dst, std::size_t count,
+                         SimdLevel level = bestSimdLevel());
+// color * 255 / alpha, rounded and clamped, with transparent pixels zeroed
+void unpremultiplyAlphaRow(const Uint32* src, Uint32* dst, std::size_t count,
+                           SimdLevel level = bestSimdLevel());
+// non-premultiplied src over dst, with SDL_BLENDMODE_BLEND arithmetic of
+//   SDL's scalar 8888 blitters: color (s * a + d * (256 - a)) >> 8, alpha
+//   a + (d * (255 - a) >> 8), and fully opaque or transparent src exact
+void blendRow(const Uint32* src, Uint32* dst, std::size_t count,
+              SimdLevel level = bestSimdLevel());
+
+// surface versions of the row kernels, locking surfaces as needed
+
+// new surface in format, using row kernels for ARGB8888 <-> ABGR8888,
+//   RGB24 -> RGBA32 and BGR24 -> BGRA32, and SDL_ConvertSurfaceFormat otherwise
+sdl2_smart_ptr::unique::Surface convertSurface(SDL_Surface* src, Uint32 format,
+                                               SimdLevel level = bestSimdLevel());
+// in place; surface must be ARGB8888 or ABGR8888
+void premultiplyAlpha(SDL_Surface* surface, SimdLevel level = bestSimdLevel());
+void unpremultiplyAlpha(SDL_Surface* surface, SimdLevel level = bestSimdLevel());
+// blends src_rect of src onto dst at dst_rect x and y, clipped as
+//   SDL_BlitSurface does (including to dst clip_rect), with final blit area
+//   written back to dst_rect if not null. Surfaces must both be ARGB8888 or
+//   both ABGR8888, and rect arguments may be null for whole surfaces.
+void blitBlended(SDL_Surface* src, const SDL_Rect* src_rect,
+                 SDL_Surface* dst, SDL_Rect* dst_rect,
+                 SimdLevel level = bestSimdLevel());
+
+}  // namespace sdl2_image_util
+
+
+#endif  // PIXEL_KERNELS_HH
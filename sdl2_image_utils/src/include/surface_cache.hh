@@ -0,0 +1,154 @@
+#ifndef SURFACE_CACHE_HH
+#define SURFACE_CACHE_HH
+
+#include "job_system.hh"      // JobSystem
+#include "sdl2_smart_ptr.hh"  // unique::Surface
+
+#include "SDL_blendmode.h"    // SDL_BlendMode
+#include "SDL_stdinc.h"       // Uint32
+#include "SDL_surface.h"      // SDL_Surface
+
+#include <chrono>
+#include <cstddef>            // size_t
+#include <cstdint>            // uint64_t
+#include <list>
+#include <memory>             // unique_ptr
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace sdl2_image_util {
+
+/*
+ * Keeps decoded surfaces by key, holding those not used recently compressed
+ *   in memory with an LZ4-style codec that favors decoding speed, so that
+ *   many surfaces can stay at hand at a fraction of their size.
+ *
+ * trim() compresses entries idle for longer than max_idle, if given, and then
+ *   least recently used ones until their memory use is within the memory
+ *   target. It is also called by insert(), but not by get(), so that every
+ *   surface used in a frame stays valid until trim() is called after it, eg
+ *   once per frame. Pointers returned by get() are therefore valid until the
+ *   next insert(), erase() or trim().
+ *
+ * Pixel buffers of compressed entries are kept until the next trim(), to
+ *   decompress entries of the same size into without allocating, so
+ *   memoryUsage() can exceed the target by the buffers freed in one frame.
+ *
+ * Pixels are split into blocks compressed and decompressed independently, in
+ *   parallel if given a JobSystem, with rows matched against the two above
+ *   them. Decompression is bound by the count of matches: on one core a
+ *   1920x1080 UI-like surface takes a few milliseconds, so keeping within
+ *   about 1ms a frame needs a JobSystem with several workers. Surfaces with
+ *   indexed or FOURCC formats, whose palettes or planes would not be kept,
+ *   are rejected with std::invalid_argument. Only pixels, format, blend mode
+ *   and color key are kept through compression.
+ *
+ * Not thread safe.
+ */
+class SurfaceCache {
+public:
+    struct Stats {
+        std::uint64_t hits {};            // get() of uncompressed entries
+        std::uint64_t misses {};          // get() of missing keys
+        std::uint64_t compressions {};
+        std::uint64_t decompressions {};
+        std::size_t entry_ct {};
+        std::size_t compressed_ct {};
+        std::size_t resident_bytes {};    // pixels of uncompressed entries
+        std::size_t compressed_bytes {};  // compressed entries as stored
+        std::size_t pooled_bytes {};      // spare pixel buffers
+        // uncompressed over compressed size, of entries compressed now
+        double compression_ratio {};
+        std::chrono::nanoseconds mean_decompress_time {};
+        std::chrono::nanoseconds max_decompress_time {};
+    };
+
+    // max_idle of 0 compresses entries only to keep within memory_target
+    explicit SurfaceCache(std::size_t memory_target,
+                          std::chrono::milliseconds max_idle = {},
+                          sdl2_thread_util::JobSystem* jobs = nullptr);
+
+    SurfaceCache(const SurfaceCache&) = delete;
+    SurfaceCache& operator=(const SurfaceCache&) = delete;
+
+    // replaces any entry with the same key
+    void insert(const std::string& key, sdl2_smart_ptr::unique::Surface surface);
+    // nullptr if missing; marks entry as most recently used
+    SDL_Surface* get(const std::string& key);
+    bool erase(const std::string& key);
+    bool contains(const std::string& key) const;
+    // throws std::out_of_range if missing
+    bool isCompressed(const std::string& key) const;
+    std::size_t size() const { return entries_.size(); }
+
+    // all pixels and compressed data held, including spare buffers
+    std::size_t memoryUsage() const;
+    std::size_t memoryTarget() const { return memory_target_; }
+    void trim();
+
+    Stats stats() const;
+
+private:
+    struct SimdFree {
+        void operator()(unsigned char* p) const;
+    };
+    using PixelBuffer = std::unique_ptr<unsigned char, SimdFree>;
+
+    struct SpareBuffer {
+        std::size_t size;
+        PixelBuffer buffer;
+        // kept through a trim() already, so freed by the next one
+        bool stale;
+    };
+
+    struct Entry {
+        // null while compressed
+        sdl2_smart_ptr::unique::Surface surface;
+        // pixels under surface, if made by decompression
+        PixelBuffer buffer;
+        int w {};
+        int h {};
+        int pitch {};
+        Uint32 format {};
+        SDL_BlendMode blend_mode {};
+        bool has_color_key {};
+        Uint32 color_key {};
+        // compressed blocks, and offset of the end of each in compressed
+        std::vector<unsigned char> compressed;
+        std::vector<std::size_t> block_ends;
+        std::chrono::steady_clock::time_point last_used;
+        std::list<std::string>::iterator lru_pos;
+    };
+
+    static std::size_t pixelSize(const Entry& entry);
+    void compress(Entry& entry);
+    void decompress(Entry& entry);
+    PixelBuffer takeBuffer(std::size_t size);
+    void poolBuffer(PixelBuffer buffer, std::size_t size);
+
+    std::size_t memory_target_;
+    std::chrono::milliseconds max_idle_;
+    sdl2_thread_util::JobSystem* jobs_;
+
+    std::unordered_map<std::string, Entry> entries_;
+    // most recently used first
+    std::list<std::string> lru_;
+    // for decompression, oldest first
+    std::vector<SpareBuffer> pool_;
+
+    std::size_t compressed_ct_ {};
+    std::size_t resident_bytes_ {};
+    std::size_t compressed_bytes_ {};
+    std::size_t compressed_raw_bytes_ {};
+    std::size_t pooled_bytes_ {};
+    // counts and max_decompress_time; rest is filled in by stats()
+    Stats stats_;
+    std::chrono::nanoseconds decompress_time_ {};
+};
+
+}  // namespace sdl2_image_util
+
+
+#endif  // SURFACE_CACHE_HH
@@ -0,0 +1,55 @@
+#ifndef SURFACE_RESAMPLER_HH
+#define SURFACE_RESAMPLER_HH
+
+#include "pixel_kernels.hh"   // SimdLevel bestSimdLevel
+
+#include "job_system.hh"      // JobSystem
+#include "sdl2_smart_ptr.hh"  // unique::Surface
+
+#include "SDL_surface.h"      // SDL_Surface
+
+#include <cstddef>            // size_t
+#include <vector>
+
+
+namespace sdl2_image_util {
+
+enum class ResampleFilter {
+    // area average, sharpest without ringing for downscaling
+    Box,
+    // triangle, or bilinear when upscaling
+    Bilinear,
+    // windowed sinc, sharpest overall but may ring around hard edges
+    Lanczos3
+};
+constexpr std::size_t RESAMPLE_FILTER_CT { 3 };
+
+// Resampling of 32-bit surfaces, filtering over every source pixel covered
+//   when downscaling, unlike SDL_BlitScaled. Separable 14-bit fixed point
+//   passes, split by rows across jobs if given; identical results at every
+//   SIMD level and job count. Other than 8 bits per channel formats are
+//   converted first. Channels are filtered as stored, so premultiply straight
+//   alpha first. Reductions of 2x or more (4x for other than Box) between
+//   even sizes are first halved by 2x2 box filtering, as mipChain, leaving a
+//   short filter. Invalid sizes throw std::invalid_argument.
+sdl2_smart_ptr::unique::Surface resizeSurface(
+    SDL_Surface* src, int w, int h, ResampleFilter filter = ResampleFilter::Lanczos3,
+    sdl2_thread_util::JobSystem* jobs = nullptr, SimdLevel level = bestSimdLevel());
+
+// largest size fitting within max_w x max_h with the aspect ratio of src,
+//   never upscaling
+sdl2_smart_ptr::unique::Surface thumbnailSurface(
+    SDL_Surface* src, int max_w, int max_h, ResampleFilter filter = ResampleFilter::Box,
+    sdl2_thread_util::JobSystem* jobs = nullptr, SimdLevel level = bestSimdLevel());
+
+// mipmap levels below src, each 2x2 box filtered and half the size of the
+//   last rounded down, until 1x1 or max_levels (0 for no limit); made a few
+//   levels at a time from bands of rows, reading src once
+std::vector<sdl2_smart_ptr::unique::Surface> mipChain(
+    SDL_Surface* src, std::size_t max_levels = 0,
+    sdl2_thread_util::JobSystem* jobs = nullptr, SimdLevel level = bestSimdLevel());
+
+}  // namespace sdl2_image_util
+
+
+#endif  // SURFACE_RESAMPLER_HH
@@ -0,0 +1,283 @@
+#include "lz_codec.hh"
+
+#include "SDL_stdinc.h"  // Uint32 Uint64
+
+#include <algorithm>     // min
+#include <cstring>       // memcpy
+
+
+namespace sdl2_image_util {
+
+namespace lz {
+
+static constexpr std::size_t MIN_MATCH { 4 };
+// matches end before the last LAST_LITERALS bytes, and start before the last
+//   MATCH_START_LIMIT, so that 4 and 8-byte reads while matching stay in bounds
+static constexpr std::size_t LAST_LITERALS { 5 };
+static constexpr std::size_t MATCH_START_LIMIT { 12 };
+static constexpr std::size_t MAX_OFFSET { 65535 };
+// 16KiB table, small enough for the stack of any worker thread
+static constexpr unsigned HASH_BITS { 12 };
+// search step grows by one every 2^SKIP_SHIFT misses, to get through
+//   incompressible data quickly
+static constexpr unsigned SKIP_SHIFT { 6 };
+// length nibble value meaning more length bytes follow
+static constexpr std::size_t RUN_MASK { 15 };
+// when there is room, copies are made in chunks of this size, overwriting
+//   up to a chunk of bytes after them that are written again later
+static constexpr std::size_t FAST_COPY_SIZE { 16 };
+
+static Uint32 read32(const unsigned char* p) {
+    Uint32 value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static Uint64 read64(const unsigned char* p) {
+    Uint64 value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static std::size_t hash(const Uint32 value) {
+    return std::size_t((value * 2654435761u) >> (32 - HASH_BITS));
+}
+
+std::size_t compressBound(std::size_t size) {
+    return size + size / 255 + 16;
+}
+
+// length past a RUN_MASK nibble, as bytes of 255 and a remainder
+static unsigned char* writeLength(unsigned char* op, std::size_t length) {
+    for (; length >= 255; length -= 255)
+        *op++ = 255;
+    *op++ = static_cast<unsigned char>(length);
+    return op;
+}
+
+static unsigned char* writeLiterals(unsigned char* op, const unsigned char* literals,
+                                    std::size_t literal_len, std::size_t match_code) {
+    *op++ = static_cast<unsigned char>((std::min(literal_len, RUN_MASK) << 4) |
+                                       std::min(match_code, RUN_MASK));
+    if (literal_len >= RUN_MASK)
+        op = writeLength(op, literal_len - RUN_MASK);
+    std::memcpy(op, literals, literal_len);
+    return op + literal_len;
+}
+
+static unsigned char* writeSequence(unsigned char* op, const unsigned char* literals,
+                                    std::size_t literal_len, std::size_t offset,
+                                    std::size_t match_len) {
+    const std::size_t match_code { match_len - MIN_MATCH };
+    op = writeLiterals(op, literals, literal_len, match_code);
+    *op++ = static_cast<unsigned char>(offset & 0xff);
+    *op++ = static_cast<unsigned char>(offset >> 8);
+    if (match_code >= RUN_MASK)
+        op = writeLength(op, match_code - RUN_MASK);
+    return op;
+}
+
+// end of match of ip with the bytes distance before it, or nullptr if there
+//   is none of at least MIN_MATCH bytes
+static const unsigned char* matchEnd(const unsigned char* src, const unsigned char* ip,
+                                     std::size_t distance,
+                                     const unsigned char* match_limit) {
+    if (distance == 0 || distance > MAX_OFFSET || distance > std::size_t(ip - src))
+        return nullptr;
+    const unsigned char* match { ip - distance };
+    if (read32(match) != read32(ip))
+        return nullptr;
+    const unsigned char* end { ip + MIN_MATCH };
+    match += MIN_MATCH;
+    while (end + sizeof(Uint64) <= match_limit && read64(end) == read64(match)) {
+        end += sizeof(Uint64);
+        match += sizeof(Uint64);
+    }
+    while (end < match_limit && *end == *match) {
+        ++end;
+        ++match;
+    }
+    return end;
+}
+
+std::size_t compress(const unsigned char* src, std::size_t size, unsigned char* dst,
+                     std::size_t stride) {
+    unsigned char* op { dst };
+    const unsigned char* anchor { src };
+    if (size > MATCH_START_LIMIT) {
+        // positions in src, all initially matching the first bytes
+        Uint32 table[std::size_t(1) << HASH_BITS] {};
+        const unsigned char* const match_limit { src + size - LAST_LITERALS };
+        const unsigned char* const start_limit { src + size - MATCH_START_LIMIT };
+        const unsigned char* ip { src + 1 };
+        while (true) {
+            std::size_t offset {};
+            const unsigned char* end { nullptr };
+            for (unsigned step_ct { 1u << SKIP_SHIFT }; ip <= start_limit;
+                 ip += step_ct++ >> SKIP_SHIFT) {
+                const std::size_t h { hash(read32(ip)) };
+                const std::size_t table_distance { std::size_t(ip - src) - table[h] };
+                table[h] = Uint32(ip - src);
+                // longest of the hash table's match and those at stride and
+                //   twice it, which the table misses where short repeats
+                //   hide longer ones
+                for (const std::size_t distance : { table_distance, stride, stride * 2 }) {
+                    const unsigned char* const distance_end {
+                        matchEnd(src, ip, distance, match_limit) };
+                    if (distance_end != nullptr && (end == nullptr || distance_end > end)) {
+                        offset = distance;
+                        end = distance_end;
+                    }
+                }
+                if (end != nullptr)
+                    break;
+            }
+            if (end == nullptr)
+                break;
+            // extend back over pending literals
+            while (ip > anchor && std::size_t(ip - src) > offset &&
+                   ip[-1] == *(ip - 1 - offset)) {
+                --ip;
+            }
+            op = writeSequence(op, anchor, std::size_t(ip - anchor), offset,
+                               std::size_t(end - ip));
+            ip = anchor = end;
+            if (ip > start_limit)
+                break;
+            // so that bytes skipped over by the match can start the next one
+            table[hash(read32(ip - 2))] = Uint32(ip - 2 - src);
+        }
+    }
+    // last sequence is literals only
+    op = writeLiterals(op, anchor, std::size_t(src + size - anchor), 0);
+    return std::size_t(op - dst);
+}
+
+static bool readLength(const unsigned char*& ip, const unsigned char* iend,
+                       std::size_t& length) {
+    unsigned char byte;
+    do {
+        if (ip == iend)
+            return false;
+        byte = *ip++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+// copies size bytes in chunks, at least one, so that the loop is skipped
+//   for most literal runs; dst must have FAST_COPY_SIZE bytes of room after
+//   them, and src must not overlap dst within a chunk
+static void wildCopy(unsigned char* dst, const unsigned char* src, std::size_t size) {
+    std::size_t copied {};
+    do {
+        std::memcpy(dst + copied, src + copied, FAST_COPY_SIZE);
+        copied += FAST_COPY_SIZE;
+    } while (copied < size);
+}
+
+// offset may be less than match_len, making the match a repeating pattern of
+//   its first offset bytes; short matches are copied byte by byte, which reads
+//   each byte only after it is written, and long ones in growing multiples of
+//   offset that never overlap their source
+static void copyMatch(unsigned char* op, std::size_t offset, std::size_t match_len) {
+    const unsigned char* match { op - offset };
+    if (offset >= match_len) {
+        std::memcpy(op, match, match_len);
+        return;
+    }
+    if (match_len <= 2 * FAST_COPY_SIZE) {
+        for (std::size_t i {}; i < match_len; ++i)
+            op[i] = match[i];
+        return;
+    }
+    std::memcpy(op, match, offset);
+    for (std::size_t copied { offset }; copied < match_len; ) {
+        const std::size_t n { std::min(copied, match_len - copied) };
+        std::memcpy(op + copied, op, n);
+        copied += n;
+    }
+}
+
+// for each offset less than FAST_COPY_SIZE, the index within offset of each
+//   byte of a chunk, and the largest multiple of offset within a chunk
+struct RepeatTables {
+    unsigned char index[FAST_COPY_SIZE][FAST_COPY_SIZE] {};
+    std::size_t step[FAST_COPY_SIZE] {};
+};
+static constexpr RepeatTables REPEAT_TABLES { []{
+    RepeatTables tables {};
+    for (std::size_t offset { 1 }; offset < FAST_COPY_SIZE; ++offset) {
+        for (std::size_t i {}; i < FAST_COPY_SIZE; ++i)
+            tables.index[offset][i] = static_cast<unsigned char>(i % offset);
+        tables.step[offset] = FAST_COPY_SIZE - FAST_COPY_SIZE % offset;
+    }
+    return tables;
+}() };
+
+// offset less than FAST_COPY_SIZE, with room as for wildCopy: the match
+//   repeats its first offset bytes, so they are spread over a chunk, which is
+//   written in steps of the largest multiple of offset within it
+static void repeatPattern(unsigned char* op, std::size_t offset, std::size_t match_len) {
+    const unsigned char* match { op - offset };
+    const unsigned char* index { REPEAT_TABLES.index[offset] };
+    unsigned char pattern[FAST_COPY_SIZE];
+    for (std::size_t i {}; i < FAST_COPY_SIZE; ++i)
+        pattern[i] = match[index[i]];
+    const std::size_t step { REPEAT_TABLES.step[offset] };
+    for (std::size_t copied {}; copied < match_len; copied += step)
+        std::memcpy(op + copied, pattern, FAST_COPY_SIZE);
+}
+
+bool decompress(const unsigned char* src, std::size_t src_size,
+                unsigned char* dst, std::size_t dst_size) {
+    const unsigned char* ip { src };
+    const unsigned char* const iend { src + src_size };
+    unsigned char* op { dst };
+    unsigned char* const oend { dst + dst_size };
+    while (ip < iend) {
+        const unsigned token { *ip++ };
+
+        std::size_t literal_len { token >> 4 };
+        if (literal_len == RUN_MASK && !readLength(ip, iend, literal_len))
+            return false;
+        if (literal_len > std::size_t(iend - ip) || literal_len > std::size_t(oend - op))
+            return false;
+        if (std::size_t(iend - ip) >= literal_len + FAST_COPY_SIZE &&
+            std::size_t(oend - op) >= literal_len + FAST_COPY_SIZE) {
+            wildCopy(op, ip, literal_len);
+        } else {
+            std::memcpy(op, ip, literal_len);
+        }
+        ip += literal_len;
+        op += literal_len;
+        // last sequence
+        if (ip == iend)
+            break;
+
+        if (iend - ip < 2)
+            return false;
+        const std::size_t offset { std::size_t(ip[0]) | std::size_t(ip[1]) << 8 };
+        ip += 2;
+        std::size_t match_len { token & RUN_MASK };
+        if (match_len == RUN_MASK && !readLength(ip, iend, match_len))
+            return false;
+        match_len += MIN_MATCH;
+        if (offset == 0 || offset > std::size_t(op - dst) ||
+            match_len > std::size_t(oend - op)) {
+            return false;
+        }
+        if (std::size_t(oend - op) < match_len + FAST_COPY_SIZE)
+            copyMatch(op, offset, match_len);
+        else if (offset >= FAST_COPY_SIZE)
+            wildCopy(op, op - offset, match_len);
+        else
+            repeatPattern(op, offset, match_len);
+        op += match_len;
+    }
+    return op == oend;
+}
+
+}  // namespace lz
+
+}  // namespace sdl2_image_util
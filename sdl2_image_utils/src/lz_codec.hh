@@ -0,0 +1,43 @@
+#ifndef LZ_CODEC_HH
+#define LZ_CODEC_HH
+
+#include <cstddef>  // size_t
+
+
+/*
+ * Byte-oriented LZ77 codec in the manner of the LZ4 block format, used by
+ *   surface_cache.cc to keep cold surfaces compressed. It favors decoding
+ *   speed over ratio: sequences are a token byte of literal and match length
+ *   nibbles, extended by 255-valued bytes, the literals, and a 16-bit little
+ *   endian match offset, and matches are found greedily through a hash table
+ *   of 4-byte prefixes and at a stride given by the caller. Input is
+ *   compressed as one block, so callers split large inputs themselves to
+ *   compress or decompress parts in parallel.
+ */
+
+namespace sdl2_image_util {
+
+namespace lz {
+
+// largest compressed size of size bytes
+std::size_t compressBound(std::size_t size);
+
+// compresses size bytes of src to dst, which must hold compressBound(size)
+//   bytes; returns compressed size. stride, if not 0, is a distance at which
+//   repeats are likely, such as the pitch of rows of pixels: matches there
+//   and at twice it are tried along with the hash table's, taking the longest
+std::size_t compress(const unsigned char* src, std::size_t size, unsigned char* dst,
+                     std::size_t stride = 0);
+
+// decompresses src to exactly dst_size bytes of dst; returns false if src is
+//   malformed or decompresses to another size, without reading or writing
+//   out of bounds
+bool decompress(const unsigned char* src, std::size_t src_size,
+                unsigned char* dst, std::size_t dst_size);
+
+}  // namespace lz
+
+}  // namespace sdl2_image_util
+
+
+#endif  // LZ_CODEC_HH
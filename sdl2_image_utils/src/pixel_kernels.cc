@@ -0,0 +1,282 @@
+#include "pixel_kernels.hh"
+#include "pixel_kernels_simd.hh"
+#include "surface_access.hh"  // SurfaceLock surfaceRow
+
+#include "safeSdlCall.hh"
+
+#include "SDL_pixels.h"   // SDL_PIXELFORMAT_*
+
+#include <algorithm>      // min
+#include <array>
+#include <cstddef>        // size_t
+#include <stdexcept>      // invalid_argument
+#include <string>
+
+
+namespace sdl2_image_util {
+
+template<typename Src>
+using SimdKernel = std::size_t (*)(const Src* src, Uint32* dst, std::size_t count);
+
+// null kernels leave all pixels to scalar
+struct RowKernels {
+    SimdKernel<Uint32> swap_red_blue {};
+    SimdKernel<Uint8>  expand_rgb24 {};
+    SimdKernel<Uint32> premultiply_alpha {};
+    SimdKernel<Uint32> unpremultiply_alpha {};
+    SimdKernel<Uint32> blend {};
+};
+
+static std::array<RowKernels, SIMD_LEVEL_CT> makeRowKernels() {
+    std::array<RowKernels, SIMD_LEVEL_CT> kernels {};
+#ifdef SDL2_IMAGE_UTILS_HAVE_SSE41
+    kernels[std::size_t(SimdLevel::Sse41)] = RowKernels {
+        sse41::swapRedBlueRow, sse41::expandRgb24Row, sse41::premultiplyAlphaRow,
+        sse41::unpremultiplyAlphaRow, sse41::blendRow
+    };
+#endif
+#ifdef SDL2_IMAGE_UTILS_HAVE_AVX2
+    kernels[std::size_t(SimdLevel::Avx2)] = RowKernels {
+        avx2::swapRedBlueRow, avx2::expandRgb24Row, avx2::premultiplyAlphaRow,
+        avx2::unpremultiplyAlphaRow, avx2::blendRow
+    };
+#endif
+    return kernels;
+}
+
+// levels with kernels in this build
+static constexpr unsigned BUILT_SIMD_LEVELS {
+    sdl2_thread_util::simdLevelBit(SimdLevel::Scalar)
+#ifdef SDL2_IMAGE_UTILS_HAVE_SSE41
+    | sdl2_thread_util::simdLevelBit(SimdLevel::Sse41)
+#endif
+#ifdef SDL2_IMAGE_UTILS_HAVE_AVX2
+    | sdl2_thread_util::simdLevelBit(SimdLevel::Avx2)
+#endif
+};
+
+bool simdLevelSupported(SimdLevel level) {
+    return sdl2_thread_util::simdLevelSupported(level, BUILT_SIMD_LEVELS);
+}
+
+SimdLevel bestSimdLevel() {
+    static const SimdLevel best { sdl2_thread_util::bestSimdLevel(BUILT_SIMD_LEVELS) };
+    return best;
+}
+
+static const RowKernels& rowKernels(SimdLevel level, const char* func_name) {
+    static const std::array<RowKernels, SIMD_LEVEL_CT> kernels { makeRowKernels() };
+    if (!simdLevelSupported(level)) {
+        throw std::invalid_argument(std::string(func_name) + ": " +
+                                    simdLevelName(level) + " not supported");
+    }
+    return kernels[std::size_t(level)];
+}
+
+static Uint32 swapRedBlue(const Uint32 pixel) {
+    return (pixel & 0xFF00FF00) | ((pixel >> 16) & 0xFF) | ((pixel & 0xFF) << 16);
+}
+
+static Uint32 premultiply(const Uint32 pixel) {
+    const Uint32 a { pixel >> 24 };
+    Uint32 result { pixel & 0xFF000000 };
+    for (unsigned shift {}; shift < 24; shift += 8)
+        result |= ((((pixel >> shift) & 0xFF) * a) / 255) << shift;
+    return result;
+}
+
+static Uint32 unpremultiply(const Uint32 pixel) {
+    const Uint32 a { pixel >> 24 };
+    if (a == 0)
+        return 0;
+    // separate float operations, to round the same as SIMD kernels
+    const float scale { 255.0f / float(a) };
+    Uint32 result { pixel & 0xFF000000 };
+    for (unsigned shift {}; shift < 24; shift += 8) {
+        float c { float((pixel >> shift) & 0xFF) * scale };
+        c = c + 0.5f;
+        result |= std::min(Uint32(c), Uint32(255)) << shift;
+    }
+    return result;
+}
+
+static Uint32 blend(const Uint32 src, const Uint32 dst) {
+    const Uint32 a { src >> 24 };
+    if (a == 0)
+        return dst;
+    if (a == 255)
+        return src;
+    Uint32 result { ((a * 256 + (dst >> 24) * (255 - a)) >> 8) << 24 };
+    for (unsigned shift {}; shift < 24; shift += 8) {
+        const Uint32 s { (src >> shift) & 0xFF };
+        const Uint32 d { (dst >> shift) & 0xFF };
+        result |= ((s * a + d * (256 - a)) >> 8) << shift;
+    }
+    return result;
+}
+
+void swapRedBlueRow(const Uint32* src, Uint32* dst, std::size_t count, SimdLevel level) {
+    const auto kernel { rowKernels(level, "swapRedBlueRow").swap_red_blue };
+    for (std::size_t i { kernel ? kernel(src, dst, count) : 0 }; i < count; ++i)
+        dst[i] = swapRedBlue(src[i]);
+}
+
+void expandRgb24Row(const Uint8* src, Uint32* dst, std::size_t count, SimdLevel level) {
+    const auto kernel { rowKernels(level, "expandRgb24Row").expand_rgb24 };
+    Uint8* dst_bytes { reinterpret_cast<Uint8*>(dst) };
+    for (std::size_t i { kernel ? kernel(src, dst, count) : 0 }; i < count; ++i) {
+        dst_bytes[i * 4]     = src[i * 3];
+        dst_bytes[i * 4 + 1] = src[i * 3 + 1];
+        dst_bytes[i * 4 + 2] = src[i * 3 + 2];
+        dst_bytes[i * 4 + 3] = 0xFF;
+    }
+}
+
+void premultiplyAlphaRow(const Uint32* src, Uint32* dst, std::size_t count,
+                         SimdLevel level) {
+    const auto kernel { rowKernels(level, "premultiplyAlphaRow").premultiply_alpha };
+    for (std::size_t i { kernel ? kernel(src, dst, count) : 0 }; i < count; ++i)
+        dst[i] = premultiply(src[i]);
+}
+
+void unpremultiplyAlphaRow(const Uint32* src, Uint32* dst, std::size_t count,
+                           SimdLevel level) {
+    const auto kernel { rowKernels(level, "unpremultiplyAlphaRow").unpremultiply_alpha };
+    for (std::size_t i { kernel ? kernel(src, dst, count) : 0 }; i < count; ++i)
+        dst[i] = unpremultiply(src[i]);
+}
+
+void blendRow(const Uint32* src, Uint32* dst, std::size_t count, SimdLevel level) {
+    const auto kernel { rowKernels(level, "blendRow").blend };
+    for (std::size_t i { kernel ? kernel(src, dst, count) : 0 }; i < count; ++i)
+        dst[i] = blend(src[i], dst[i]);
+}
+
+static bool isPacked8888(const Uint32 format) {
+    return format == SDL_PIXELFORMAT_ARGB8888 || format == SDL_PIXELFORMAT_ABGR8888;
+}
+
+sdl2_smart_ptr::unique::Surface convertSurface(SDL_Surface* src, Uint32 format,
+                                               SimdLevel level) {
+    if (src == nullptr)
+        throw std::invalid_argument("convertSurface: src must not be null");
+    const Uint32 src_format { src->format->format };
+    const bool swap { isPacked8888(src_format) && isPacked8888(format) &&
+                      src_format != format };
+    const bool expand {
+        (src_format == SDL_PIXELFORMAT_RGB24 && format == SDL_PIXELFORMAT_RGBA32) ||
+        (src_format == SDL_PIXELFORMAT_BGR24 && format == SDL_PIXELFORMAT_BGRA32) };
+    // color keys become transparency in SDL conversion
+    if ((!swap && !expand) || SDL_HasColorKey(src) == SDL_TRUE) {
+        return sdl2_smart_ptr::make_unique(
+            safeSdlCall(SDL_ConvertSurfaceFormat, "SDL_ConvertSurfaceFormat",
+                        SdlRetTest<SDL_Surface*>{
+                            [](const SDL_Surface* ret){ return (ret == nullptr); } },
+                        src, format, Uint32(0)));
+    }
+
+    sdl2_smart_ptr::unique::Surface dst { sdl2_smart_ptr::make_unique(
+        safeSdlCall(SDL_CreateRGBSurfaceWithFormat, "SDL_CreateRGBSurfaceWithFormat",
+                    SdlRetTest<SDL_Surface*>{
+                        [](const SDL_Surface* ret){ return (ret == nullptr); } },
+                    Uint32(0), src->w, src->h, 32, format)) };
+    SurfaceLock lock { src };
+    const std::size_t w { std::size_t(src->w) };
+    for (int y {}; y < src->h; ++y) {
+        if (swap) {
+            swapRedBlueRow(surfaceRow<const Uint32>(src, 0, y),
+                           surfaceRow<Uint32>(dst.get(), 0, y), w, level);
+        } else {
+            expandRgb24Row(surfaceRow<const Uint8>(src, 0, y),
+                           surfaceRow<Uint32>(dst.get(), 0, y), w, level);
+        }
+    }
+    return dst;
+}
+
+using RowKernel = void (*)(const Uint32* src, Uint32* dst, std::size_t count,
+                           SimdLevel level);
+
+static void transformInPlace(SDL_Surface* surface, RowKernel kernel, SimdLevel level,
+                             const char* func_name) {
+    if (surface == nullptr)
+        throw std::invalid_argument(std::string(func_name) + ": surface must not be null");
+    if (!isPacked8888(surface->format->format)) {
+        throw std::invalid_argument(std::string(func_name) +
+                                    ": surface must be ARGB8888 or ABGR8888");
+    }
+    SurfaceLock lock { surface };
+    for (int y {}; y < surface->h; ++y) {
+        Uint32* row { surfaceRow<Uint32>(surface, 0, y) };
+        kernel(row, row, std::size_t(surface->w), level);
+    }
+}
+
+void premultiplyAlpha(SDL_Surface* surface, SimdLevel level) {
+    transformInPlace(surface, premultiplyAlphaRow, level, "premultiplyAlpha");
+}
+
+void unpremultiplyAlpha(SDL_Surface* surface, SimdLevel level) {
+    transformInPlace(surface, unpremultiplyAlphaRow, level, "unpremultiplyAlpha");
+}
+
+void blitBlended(SDL_Surface* src, const SDL_Rect* src_rect,
+                 SDL_Surface* dst, SDL_Rect* dst_rect, SimdLevel level) {
+    if (src == nullptr || dst == nullptr)
+        throw std::invalid_argument("blitBlended: surfaces must not be null");
+    if (!isPacked8888(src->format->format) ||
+        src->format->format != dst->format->format) {
+        throw std::invalid_argument(
+            "blitBlended: surfaces must both be ARGB8888 or both ABGR8888");
+    }
+    // check before locking, as SDL_UpperBlit does
+    rowKernels(level, "blitBlended");
+
+    // clip to src, then dst clip rect, as in SDL_UpperBlit
+    SDL_Rect area { 0, 0, src->w, src->h };
+    int dst_x { dst_rect ? dst_rect->x : 0 };
+    int dst_y { dst_rect ? dst_rect->y : 0 };
+    if (src_rect != nullptr) {
+        area = *src_rect;
+        if (area.x < 0) {
+            area.w += area.x;
+            dst_x -= area.x;
+            area.x = 0;
+        }
+        area.w = std::min(area.w, src->w - area.x);
+        if (area.y < 0) {
+            area.h += area.y;
+            dst_y -= area.y;
+            area.y = 0;
+        }
+        area.h = std::min(area.h, src->h - area.y);
+    }
+    const SDL_Rect& clip { dst->clip_rect };
+    if (clip.x > dst_x) {
+        area.w -= clip.x - dst_x;
+        area.x += clip.x - dst_x;
+        dst_x = clip.x;
+    }
+    area.w = std::min(area.w, clip.x + clip.w - dst_x);
+    if (clip.y > dst_y) {
+        area.h -= clip.y - dst_y;
+        area.y += clip.y - dst_y;
+        dst_y = clip.y;
+    }
+    area.h = std::min(area.h, clip.y + clip.h - dst_y);
+
+    const bool empty { area.w <= 0 || area.h <= 0 };
+    if (dst_rect != nullptr)
+        *dst_rect = SDL_Rect { dst_x, dst_y, empty ? 0 : area.w, empty ? 0 : area.h };
+    if (empty)
+        return;
+
+    SurfaceLock src_lock { src };
+    SurfaceLock dst_lock { dst };
+    for (int row {}; row < area.h; ++row) {
+        blendRow(surfaceRow<const Uint32>(src, area.x, area.y + row),
+                 surfaceRow<Uint32>(dst, dst_x, dst_y + row), std::size_t(area.w), level);
+    }
+}
+
+}  // namespace sdl2_image_util
@@ -0,0 +1,187 @@
+#include "pixel_kernels_simd.hh"
+
+#include <immintrin.h>  // AVX2 intrinsics
+
+
+namespace sdl2_image_util {
+
+namespace avx2 {
+
+// AVX2 byte shuffles, unpacks and packs work within each 128-bit lane, so
+//   kernels mirror the SSE4.1 ones with lanes holding 4 pixels each
+
+static constexpr std::size_t PIXELS_PER_VECTOR { 8 };
+
+static __m256i load(const Uint32* src) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+}
+
+static void store(Uint32* dst, const __m256i v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), v);
+}
+
+std::size_t swapRedBlueRow(const Uint32* src, Uint32* dst, std::size_t count) {
+    const __m256i swap { _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7,
+                                          10, 9, 8, 11, 14, 13, 12, 15,
+                                          2, 1, 0, 3, 6, 5, 4, 7,
+                                          10, 9, 8, 11, 14, 13, 12, 15) };
+    std::size_t i {};
+    for (; i + PIXELS_PER_VECTOR <= count; i += PIXELS_PER_VECTOR)
+        store(dst + i, _mm256_shuffle_epi8(load(src + i), swap));
+    return i;
+}
+
+std::size_t expandRgb24Row(const Uint8* src, Uint32* dst, std::size_t count) {
+    const __m256i expand { _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1,
+                                            6, 7, 8, -1, 9, 10, 11, -1,
+                                            0, 1, 2, -1, 3, 4, 5, -1,
+                                            6, 7, 8, -1, 9, 10, 11, -1) };
+    const __m256i opaque { _mm256_set1_epi32(int(0xFF000000)) };
+    std::size_t i {};
+    // 12 bytes of pixels per lane, with the second lane's load reading 4
+    //   bytes past the 8 pixels used
+    for (; i + 10 <= count; i += PIXELS_PER_VECTOR) {
+        const Uint8* rgb { src + i * 3 };
+        const __m128i lo { _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb)) };
+        const __m128i hi { _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + 12)) };
+        const __m256i both { _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1) };
+        store(dst + i, _mm256_or_si256(_mm256_shuffle_epi8(both, expand), opaque));
+    }
+    return i;
+}
+
+static __m256i premultiplyHalf(const __m256i channels) {
+    __m256i alpha { _mm256_shufflelo_epi16(channels, _MM_SHUFFLE(3, 3, 3, 3)) };
+    alpha = _mm256_shufflehi_epi16(alpha, _MM_SHUFFLE(3, 3, 3, 3));
+    alpha = _mm256_blend_epi16(alpha, _mm256_set1_epi16(255), 0x88);
+    const __m256i product { _mm256_mullo_epi16(channels, alpha) };
+    return _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(product, _mm256_set1_epi16(1)),
+                                              _mm256_srli_epi16(product, 8)), 8);
+}
+
+std::size_t premultiplyAlphaRow(const Uint32* src, Uint32* dst, std::size_t count) {
+    const __m256i zero { _mm256_setzero_si256() };
+    std::size_t i {};
+    for (; i + PIXELS_PER_VECTOR <= count; i += PIXELS_PER_VECTOR) {
+        const __m256i pixels { load(src + i) };
+        const __m256i lo { premultiplyHalf(_mm256_unpacklo_epi8(pixels, zero)) };
+        const __m256i hi { premultiplyHalf(_mm256_unpackhi_epi8(pixels, zero)) };
+        store(dst + i, _mm256_packus_epi16(lo, hi));
+    }
+    return i;
+}
+
+std::size_t unpremultiplyAlphaRow(const Uint32* src, Uint32* dst, std::size_t count) {
+    const __m256i byte_mask { _mm256_set1_epi32(0xFF) };
+    const __m256i max { _mm256_set1_epi32(255) };
+    const __m256 max_f { _mm256_set1_ps(255.0f) };
+    const __m256 half { _mm256_set1_ps(0.5f) };
+    std::size_t i {};
+    for (; i + PIXELS_PER_VECTOR <= count; i += PIXELS_PER_VECTOR) {
+        const __m256i pixels { load(src + i) };
+        const __m256i alpha { _mm256_srli_epi32(pixels, 24) };
+        const __m256 scale { _mm256_div_ps(max_f, _mm256_cvtepi32_ps(alpha)) };
+        __m256i result { _mm256_slli_epi32(alpha, 24) };
+        for (int shift {}; shift < 24; shift += 8) {
+            const __m256i c { _mm256_and_si256(
+                    _mm256_srl_epi32(pixels, _mm_cvtsi32_si128(shift)), byte_mask) };
+            __m256 f { _mm256_mul_ps(_mm256_cvtepi32_ps(c), scale) };
+            f = _mm256_add_ps(f, half);
+            const __m256i v { _mm256_min_epu32(_mm256_cvttps_epi32(f), max) };
+            result = _mm256_or_si256(result, _mm256_sll_epi32(v, _mm_cvtsi32_si128(shift)));
+        }
+        const __m256i transparent { _mm256_cmpeq_epi32(alpha, _mm256_setzero_si256()) };
+        store(dst + i, _mm256_andnot_si256(transparent, result));
+    }
+    return i;
+}
+
+static void blendWeights(const __m256i src_channels, __m256i& lo, __m256i& hi) {
+    __m256i alpha { _mm256_shufflelo_epi16(src_channels, _MM_SHUFFLE(3, 3, 3, 3)) };
+    alpha = _mm256_shufflehi_epi16(alpha, _MM_SHUFFLE(3, 3, 3, 3));
+    const __m256i inverse { _mm256_sub_epi16(_mm256_set1_epi16(256), alpha) };
+    const __m256i alpha_inverse { _mm256_sub_epi16(_mm256_set1_epi16(255), alpha) };
+    const __m256i alpha_256 { _mm256_set1_epi16(256) };
+    lo = _mm256_blend_epi16(_mm256_unpacklo_epi16(alpha, inverse),
+                            _mm256_unpacklo_epi16(alpha_256, alpha_inverse), 0xC0);
+    hi = _mm256_blend_epi16(_mm256_unpackhi_epi16(alpha, inverse),
+                            _mm256_unpackhi_epi16(alpha_256, alpha_inverse), 0xC0);
+}
+
+static __m256i blendHalf(const __m256i src_channels, const __m256i dst_channels) {
+    __m256i weights_lo;
+    __m256i weights_hi;
+    blendWeights(src_channels, weights_lo, weights_hi);
+    const __m256i lo { _mm256_madd_epi16(_mm256_unpacklo_epi16(src_channels, dst_channels),
+                                         weights_lo) };
+    const __m256i hi { _mm256_madd_epi16(_mm256_unpackhi_epi16(src_channels, dst_channels),
+                                         weights_hi) };
+    return _mm256_packs_epi32(_mm256_srli_epi32(lo, 8), _mm256_srli_epi32(hi, 8));
+}
+
+std::size_t blendRow(const Uint32* src, Uint32* dst, std::size_t count) {
+    const __m256i zero { _mm256_setzero_si256() };
+    const __m256i alpha_mask { _mm256_set1_epi32(int(0xFF000000)) };
+    std::size_t i {};
+    for (; i + PIXELS_PER_VECTOR <= count; i += PIXELS_PER_VECTOR) {
+        const __m256i s { load(src + i) };
+        const __m256i d { load(dst + i) };
+        const __m256i lo { blendHalf(_mm256_unpacklo_epi8(s, zero),
+                                     _mm256_unpacklo_epi8(d, zero)) };
+        const __m256i hi { blendHalf(_mm256_unpackhi_epi8(s, zero),
+                                     _mm256_unpackhi_epi8(d, zero)) };
+        __m256i result { _mm256_packus_epi16(lo, hi) };
+        const __m256i alpha { _mm256_and_si256(s, alpha_mask) };
+        result = _mm256_blendv_epi8(result, d, _mm256_cmpeq_epi32(alpha, zero));
+        result = _mm256_blendv_epi8(result, s, _mm256_cmpeq_epi32(alpha, alpha_mask));
+        store(dst + i, result);
+    }
+    return i;
+}
+
+std::size_t convolveColumns(const Uint32* const* rows, const Sint16* weights,
+                            std::size_t tap_ct, Uint32* dst, std::size_t count) {
+    const __m256i zero { _mm256_setzero_si256() };
+    const __m256i rounding { _mm256_set1_epi32(1 << (RESAMPLE_WEIGHT_BITS - 1)) };
+    std::size_t x {};
+    for (; x + PIXELS_PER_VECTOR <= count; x += PIXELS_PER_VECTOR) {
+        // sums of pixels 0 and 4, 1 and 5, 2 and 6, 3 and 7
+        __m256i p0 { rounding };
+        __m256i p1 { rounding };
+        __m256i p2 { rounding };
+        __m256i p3 { rounding };
+        for (std::size_t k {}; k < tap_ct; k += 2) {
+            const bool pair { k + 1 < tap_ct };
+            const __m256i r0 { load(rows[k] + x) };
+            const __m256i r1 { pair ? load(rows[k + 1] + x) : zero };
+            const Sint16 w0 { weights[k] };
+            const Sint16 w1 { pair ? weights[k + 1] : Sint16(0) };
+            const __m256i pair_weights { _mm256_setr_epi16(w0, w1, w0, w1, w0, w1, w0, w1,
+                                                           w0, w1, w0, w1, w0, w1, w0, w1) };
+            const __m256i lo0 { _mm256_unpacklo_epi8(r0, zero) };
+            const __m256i lo1 { _mm256_unpacklo_epi8(r1, zero) };
+            const __m256i hi0 { _mm256_unpackhi_epi8(r0, zero) };
+            const __m256i hi1 { _mm256_unpackhi_epi8(r1, zero) };
+            p0 = _mm256_add_epi32(p0, _mm256_madd_epi16(_mm256_unpacklo_epi16(lo0, lo1),
+                                                        pair_weights));
+            p1 = _mm256_add_epi32(p1, _mm256_madd_epi16(_mm256_unpackhi_epi16(lo0, lo1),
+                                                        pair_weights));
+            p2 = _mm256_add_epi32(p2, _mm256_madd_epi16(_mm256_unpacklo_epi16(hi0, hi1),
+                                                        pair_weights));
+            p3 = _mm256_add_epi32(p3, _mm256_madd_epi16(_mm256_unpackhi_epi16(hi0, hi1),
+                                                        pair_weights));
+        }
+        const __m256i packed {
+            _mm256_packus_epi16(
+                _mm256_packs_epi32(_mm256_srai_epi32(p0, RESAMPLE_WEIGHT_BITS),
+                                   _mm256_srai_epi32(p1, RESAMPLE_WEIGHT_BITS)),
+                _mm256_packs_epi32(_mm256_srai_epi32(p2, RESAMPLE_WEIGHT_BITS),
+                                   _mm256_srai_epi32(p3, RESAMPLE_WEIGHT_BITS))) };
+        store(dst + x, packed);
+    }
+    return x;
+}
+
+}  // namespace avx2
+
+}  // namespace sdl2_image_util
@@ -0,0 +1,64 @@
+#ifndef PIXEL_KERNELS_SIMD_HH
+#define PIXEL_KERNELS_SIMD_HH
+
+#include "SDL_stdinc.h"  // Uint8 Uint32 Sint16
+
+#include <cstddef>       // size_t
+
+
+/*
+ * Per instruction set row kernels, each compiled in its own translation unit
+ *   with the matching compiler flags, see src/CMakeLists.txt. They process as
+ *   many whole vectors as fit in count, returning the number of pixels done,
+ *   and leave the rest to the scalar kernels in pixel_kernels.cc.
+ *
+ * Resampling kernels are used by surface_resampler.cc:
+ *   - halveRow: dst_count 2x2 box averages of pixels 2i and 2i + 1 of row0
+ *     and row1, rounded
+ *   - convolveRow: dst[i] is the sum of src[first[i] + k] times
+ *     weights[i * tap_ct + k] for k < tap_ct
+ *   - convolveColumns: dst[x] is the sum of rows[k][x] times weights[k] for
+ *     k < tap_ct
+ *   with weights in fixed point of RESAMPLE_WEIGHT_BITS, and sums rounded and
+ *   clamped to 0-255 per channel. AVX2 builds only add convolveColumns, using
+ *   SSE4.1 kernels for the others.
+ */
+
+namespace sdl2_image_util {
+
+static constexpr int RESAMPLE_WEIGHT_BITS { 14 };
+
+namespace sse41 {
+
+std::size_t swapRedBlueRow(const Uint32* src, Uint32* dst, std::size_t count);
+std::size_t expandRgb24Row(const Uint8* src, Uint32* dst, std::size_t count);
+std::size_t premultiplyAlphaRow(const Uint32* src, Uint32* dst, std::size_t count);
+std::size_t unpremultiplyAlphaRow(const Uint32* src, Uint32* dst, std::size_t count);
+std::size_t blendRow(const Uint32* src, Uint32* dst, std::size_t count);
+
+std::size_t halveRow(const Uint32* row0, const Uint32* row1, Uint32* dst,
+                     std::size_t dst_count);
+std::size_t convolveRow(const Uint32* src, Uint32* dst, std::size_t dst_count,
+                        const int* first, const Sint16* weights, std::size_t tap_ct);
+std::size_t convolveColumns(const Uint32* const* rows, const Sint16* weights,
+                            std::size_t tap_ct, Uint32* dst, std::size_t count);
+
+}  // namespace sse41
+
+namespace avx2 {
+
+std::size_t swapRedBlueRow(const Uint32* src, Uint32* dst, std::size_t count);
+std::size_t expandRgb24Row(const Uint8* src, Uint32* dst, std::size_t count);
+std::size_t premultiplyAlphaRow(const Uint32* src, Uint32* dst, std::size_t count);
+std::size_t unpremultiplyAlphaRow(const Uint32* src, Uint32* dst, std::size_t count);
+std::size_t blendRow(const Uint32* src, Uint32* dst, std::size_t count);
+
+std::size_t convolveColumns(const Uint32* const* rows, const Sint16* weights,
+                            std::size_t tap_ct, Uint32* dst, std::size_t count);
+
+}  // namespace avx2
+
+}  // namespace sdl2_image_util
+
+
+#endif  // PIXEL_KERNELS_SIMD_HH
@@ -0,0 +1,244 @@
+#include "pixel_kernels_simd.hh"
+
+#include <smmintrin.h>  // SSE4.1 intrinsics
+
+
+namespace sdl2_image_util {
+
+namespace sse41 {
+
+static constexpr std::size_t PIXELS_PER_VECTOR { 4 };
+
+static __m128i load(const Uint32* src) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+}
+
+static void store(Uint32* dst, const __m128i v) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), v);
+}
+
+std::size_t swapRedBlueRow(const Uint32* src, Uint32* dst, std::size_t count) {
+    const __m128i swap { _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7,
+                                       10, 9, 8, 11, 14, 13, 12, 15) };
+    std::size_t i {};
+    for (; i + PIXELS_PER_VECTOR <= count; i += PIXELS_PER_VECTOR)
+        store(dst + i, _mm_shuffle_epi8(load(src + i), swap));
+    return i;
+}
+
+std::size_t expandRgb24Row(const Uint8* src, Uint32* dst, std::size_t count) {
+    // -1 zeroes alpha bytes for or with opaque alpha
+    const __m128i expand { _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1,
+                                         6, 7, 8, -1, 9, 10, 11, -1) };
+    const __m128i opaque { _mm_set1_epi32(int(0xFF000000)) };
+    std::size_t i {};
+    // each 16 byte load reads 4 bytes past the 4 pixels used
+    for (; i + 6 <= count; i += PIXELS_PER_VECTOR) {
+        const __m128i rgb { _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3)) };
+        store(dst + i, _mm_or_si128(_mm_shuffle_epi8(rgb, expand), opaque));
+    }
+    return i;
+}
+
+// 8 16-bit channels of 2 pixels times their alpha, with alpha lanes times 255
+static __m128i premultiplyHalf(const __m128i channels) {
+    __m128i alpha { _mm_shufflelo_epi16(channels, _MM_SHUFFLE(3, 3, 3, 3)) };
+    alpha = _mm_shufflehi_epi16(alpha, _MM_SHUFFLE(3, 3, 3, 3));
+    alpha = _mm_blend_epi16(alpha, _mm_set1_epi16(255), 0x88);
+    const __m128i product { _mm_mullo_epi16(channels, alpha) };
+    // product / 255, truncated, exact for all products of 8-bit values
+    return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(product, _mm_set1_epi16(1)),
+                                        _mm_srli_epi16(product, 8)), 8);
+}
+
+std::size_t premultiplyAlphaRow(const Uint32* src, Uint32* dst, std::size_t count) {
+    const __m128i zero { _mm_setzero_si128() };
+    std::size_t i {};
+    for (; i + PIXELS_PER_VECTOR <= count; i += PIXELS_PER_VECTOR) {
+        const __m128i pixels { load(src + i) };
+        const __m128i lo { premultiplyHalf(_mm_unpacklo_epi8(pixels, zero)) };
+        const __m128i hi { premultiplyHalf(_mm_unpackhi_epi8(pixels, zero)) };
+        store(dst + i, _mm_packus_epi16(lo, hi));
+    }
+    return i;
+}
+
+std::size_t unpremultiplyAlphaRow(const Uint32* src, Uint32* dst, std::size_t count) {
+    const __m128i byte_mask { _mm_set1_epi32(0xFF) };
+    const __m128i max { _mm_set1_epi32(255) };
+    const __m128 max_f { _mm_set1_ps(255.0f) };
+    const __m128 half { _mm_set1_ps(0.5f) };
+    std::size_t i {};
+    for (; i + PIXELS_PER_VECTOR <= count; i += PIXELS_PER_VECTOR) {
+        const __m128i pixels { load(src + i) };
+        const __m128i alpha { _mm_srli_epi32(pixels, 24) };
+        // infinite for transparent pixels, which are masked to 0 below
+        const __m128 scale { _mm_div_ps(max_f, _mm_cvtepi32_ps(alpha)) };
+        __m128i result { _mm_slli_epi32(alpha, 24) };
+        for (int shift {}; shift < 24; shift += 8) {
+            const __m128i c { _mm_and_si128(_mm_srl_epi32(pixels, _mm_cvtsi32_si128(shift)),
+                                            byte_mask) };
+            __m128 f { _mm_mul_ps(_mm_cvtepi32_ps(c), scale) };
+            f = _mm_add_ps(f, half);
+            // out of range conversions give 0x80000000, clamped to 255
+            const __m128i v { _mm_min_epu32(_mm_cvttps_epi32(f), max) };
+            result = _mm_or_si128(result, _mm_sll_epi32(v, _mm_cvtsi32_si128(shift)));
+        }
+        const __m128i transparent { _mm_cmpeq_epi32(alpha, _mm_setzero_si128()) };
+        store(dst + i, _mm_andnot_si128(transparent, result));
+    }
+    return i;
+}
+
+// weights for pairs of 16-bit src and dst channels of 2 pixels: a and 256 - a
+//   for colors, 256 and 255 - a for alpha
+static void blendWeights(const __m128i src_channels, __m128i& lo, __m128i& hi) {
+    __m128i alpha { _mm_shufflelo_epi16(src_channels, _MM_SHUFFLE(3, 3, 3, 3)) };
+    alpha = _mm_shufflehi_epi16(alpha, _MM_SHUFFLE(3, 3, 3, 3));
+    const __m128i inverse { _mm_sub_epi16(_mm_set1_epi16(256), alpha) };
+    const __m128i alpha_inverse { _mm_sub_epi16(_mm_set1_epi16(255), alpha) };
+    const __m128i alpha_256 { _mm_set1_epi16(256) };
+    lo = _mm_blend_epi16(_mm_unpacklo_epi16(alpha, inverse),
+                         _mm_unpacklo_epi16(alpha_256, alpha_inverse), 0xC0);
+    hi = _mm_blend_epi16(_mm_unpackhi_epi16(alpha, inverse),
+                         _mm_unpackhi_epi16(alpha_256, alpha_inverse), 0xC0);
+}
+
+// 2 blended pixels as 8 16-bit channels
+static __m128i blendHalf(const __m128i src_channels, const __m128i dst_channels) {
+    __m128i weights_lo;
+    __m128i weights_hi;
+    blendWeights(src_channels, weights_lo, weights_hi);
+    // s * w0 + d * w1 for each channel, in 32 bits
+    const __m128i lo { _mm_madd_epi16(_mm_unpacklo_epi16(src_channels, dst_channels),
+                                      weights_lo) };
+    const __m128i hi { _mm_madd_epi16(_mm_unpackhi_epi16(src_channels, dst_channels),
+                                      weights_hi) };
+    return _mm_packs_epi32(_mm_srli_epi32(lo, 8), _mm_srli_epi32(hi, 8));
+}
+
+std::size_t blendRow(const Uint32* src, Uint32* dst, std::size_t count) {
+    const __m128i zero { _mm_setzero_si128() };
+    const __m128i alpha_mask { _mm_set1_epi32(int(0xFF000000)) };
+    std::size_t i {};
+    for (; i + PIXELS_PER_VECTOR <= count; i += PIXELS_PER_VECTOR) {
+        const __m128i s { load(src + i) };
+        const __m128i d { load(dst + i) };
+        const __m128i lo { blendHalf(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero)) };
+        const __m128i hi { blendHalf(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero)) };
+        __m128i result { _mm_packus_epi16(lo, hi) };
+        // transparent src leaves dst, opaque src replaces it
+        const __m128i alpha { _mm_and_si128(s, alpha_mask) };
+        result = _mm_blendv_epi8(result, d, _mm_cmpeq_epi32(alpha, zero));
+        result = _mm_blendv_epi8(result, s, _mm_cmpeq_epi32(alpha, alpha_mask));
+        store(dst + i, result);
+    }
+    return i;
+}
+
+std::size_t halveRow(const Uint32* row0, const Uint32* row1, Uint32* dst,
+                     std::size_t dst_count) {
+    const __m128i zero { _mm_setzero_si128() };
+    const __m128i two { _mm_set1_epi16(2) };
+    std::size_t i {};
+    for (; i + PIXELS_PER_VECTOR <= dst_count; i += PIXELS_PER_VECTOR) {
+        const __m128i a0 { load(row0 + i * 2) };
+        const __m128i a1 { load(row0 + i * 2 + PIXELS_PER_VECTOR) };
+        const __m128i b0 { load(row1 + i * 2) };
+        const __m128i b1 { load(row1 + i * 2 + PIXELS_PER_VECTOR) };
+        // 16-bit channel sums of vertical pairs, 2 source pixels each
+        const __m128i s0 { _mm_add_epi16(_mm_unpacklo_epi8(a0, zero),
+                                         _mm_unpacklo_epi8(b0, zero)) };
+        const __m128i s1 { _mm_add_epi16(_mm_unpackhi_epi8(a0, zero),
+                                         _mm_unpackhi_epi8(b0, zero)) };
+        const __m128i s2 { _mm_add_epi16(_mm_unpacklo_epi8(a1, zero),
+                                         _mm_unpacklo_epi8(b1, zero)) };
+        const __m128i s3 { _mm_add_epi16(_mm_unpackhi_epi8(a1, zero),
+                                         _mm_unpackhi_epi8(b1, zero)) };
+        // then horizontal pairs, 2 destination pixels each
+        const __m128i h0 { _mm_add_epi16(_mm_unpacklo_epi64(s0, s1),
+                                         _mm_unpackhi_epi64(s0, s1)) };
+        const __m128i h1 { _mm_add_epi16(_mm_unpacklo_epi64(s2, s3),
+                                         _mm_unpackhi_epi64(s2, s3)) };
+        store(dst + i, _mm_packus_epi16(_mm_srli_epi16(_mm_add_epi16(h0, two), 2),
+                                        _mm_srli_epi16(_mm_add_epi16(h1, two), 2)));
+    }
+    return i;
+}
+
+// 32-bit channel sums to 4 pixels, by shifting out weight fraction and
+//   saturating to 0-255
+static __m128i packSums(const __m128i p0, const __m128i p1, const __m128i p2,
+                        const __m128i p3) {
+    return _mm_packus_epi16(
+        _mm_packs_epi32(_mm_srai_epi32(p0, RESAMPLE_WEIGHT_BITS),
+                        _mm_srai_epi32(p1, RESAMPLE_WEIGHT_BITS)),
+        _mm_packs_epi32(_mm_srai_epi32(p2, RESAMPLE_WEIGHT_BITS),
+                        _mm_srai_epi32(p3, RESAMPLE_WEIGHT_BITS)));
+}
+
+std::size_t convolveRow(const Uint32* src, Uint32* dst, std::size_t dst_count,
+                        const int* first, const Sint16* weights, std::size_t tap_ct) {
+    // channels of 2 adjacent pixels as 16-bit pairs, for madd with 2 weights
+    const __m128i pair_channels { _mm_setr_epi8(0, -1, 4, -1, 1, -1, 5, -1,
+                                                2, -1, 6, -1, 3, -1, 7, -1) };
+    const __m128i rounding { _mm_set1_epi32(1 << (RESAMPLE_WEIGHT_BITS - 1)) };
+    for (std::size_t i {}; i < dst_count; ++i) {
+        const Uint32* taps { src + first[i] };
+        const Sint16* w { weights + i * tap_ct };
+        __m128i sum { rounding };
+        std::size_t k {};
+        for (; k + 2 <= tap_ct; k += 2) {
+            const __m128i pixels {
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(taps + k)) };
+            const __m128i pair_weights { _mm_setr_epi16(w[k], w[k + 1], w[k], w[k + 1],
+                                                        w[k], w[k + 1], w[k], w[k + 1]) };
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_shuffle_epi8(pixels, pair_channels),
+                                                    pair_weights));
+        }
+        if (k < tap_ct) {
+            const __m128i pixel { _mm_cvtsi32_si128(int(taps[k])) };
+            const __m128i pair_weights { _mm_setr_epi16(w[k], 0, w[k], 0, w[k], 0, w[k], 0) };
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_shuffle_epi8(pixel, pair_channels),
+                                                    pair_weights));
+        }
+        dst[i] = Uint32(_mm_cvtsi128_si32(packSums(sum, sum, sum, sum)));
+    }
+    return dst_count;
+}
+
+std::size_t convolveColumns(const Uint32* const* rows, const Sint16* weights,
+                            std::size_t tap_ct, Uint32* dst, std::size_t count) {
+    const __m128i zero { _mm_setzero_si128() };
+    const __m128i rounding { _mm_set1_epi32(1 << (RESAMPLE_WEIGHT_BITS - 1)) };
+    std::size_t x {};
+    for (; x + PIXELS_PER_VECTOR <= count; x += PIXELS_PER_VECTOR) {
+        // one sum per pixel
+        __m128i p0 { rounding };
+        __m128i p1 { rounding };
+        __m128i p2 { rounding };
+        __m128i p3 { rounding };
+        for (std::size_t k {}; k < tap_ct; k += 2) {
+            const bool pair { k + 1 < tap_ct };
+            const __m128i r0 { load(rows[k] + x) };
+            const __m128i r1 { pair ? load(rows[k + 1] + x) : zero };
+            const Sint16 w0 { weights[k] };
+            const Sint16 w1 { pair ? weights[k + 1] : Sint16(0) };
+            const __m128i pair_weights { _mm_setr_epi16(w0, w1, w0, w1, w0, w1, w0, w1) };
+            const __m128i lo0 { _mm_unpacklo_epi8(r0, zero) };
+            const __m128i lo1 { _mm_unpacklo_epi8(r1, zero) };
+            const __m128i hi0 { _mm_unpackhi_epi8(r0, zero) };
+            const __m128i hi1 { _mm_unpackhi_epi8(r1, zero) };
+            p0 = _mm_add_epi32(p0, _mm_madd_epi16(_mm_unpacklo_epi16(lo0, lo1), pair_weights));
+            p1 = _mm_add_epi32(p1, _mm_madd_epi16(_mm_unpackhi_epi16(lo0, lo1), pair_weights));
+            p2 = _mm_add_epi32(p2, _mm_madd_epi16(_mm_unpacklo_epi16(hi0, hi1), pair_weights));
+            p3 = _mm_add_epi32(p3, _mm_madd_epi16(_mm_unpackhi_epi16(hi0, hi1), pair_weights));
+        }
+        store(dst + x, packSums(p0, p1, p2, p3));
+    }
+    return x;
+}
+
+}  // namespace sse41
+
+}  // namespace sdl2_image_util
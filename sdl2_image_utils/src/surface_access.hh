@@ -0,0 +1,53 @@
+#ifndef SURFACE_ACCESS_HH
+#define SURFACE_ACCESS_HH
+
+#include "safeSdlCall.hh"
+
+#include "SDL_stdinc.h"   // Uint8
+#include "SDL_surface.h"  // SDL_Surface SDL_MUSTLOCK SDL_LockSurface
+
+#include <cstddef>        // ptrdiff_t
+
+
+/*
+ * Helpers for reading and writing surface pixels directly, shared by
+ *   pixel_kernels.cc and surface_resampler.cc.
+ */
+
+namespace sdl2_image_util {
+
+// locks surface for its lifetime, if surface needs it
+class SurfaceLock {
+public:
+    explicit SurfaceLock(SDL_Surface* surface) :
+        surface_(SDL_MUSTLOCK(surface) ? surface : nullptr) {
+        if (surface_ != nullptr) {
+            safeSdlCall(SDL_LockSurface, "SDL_LockSurface",
+                        SdlRetTest<int>{ [](const int ret){ return (ret != 0); } },
+                        surface_);
+        }
+    }
+    ~SurfaceLock() {
+        if (surface_ != nullptr)
+            SDL_UnlockSurface(surface_);
+    }
+
+    SurfaceLock(const SurfaceLock&) = delete;
+    SurfaceLock& operator=(const SurfaceLock&) = delete;
+
+private:
+    SDL_Surface* surface_;
+};
+
+// pixel x of row y
+template<typename Pixel>
+Pixel* surfaceRow(SDL_Surface* surface, int x, int y) {
+    return reinterpret_cast<Pixel*>(static_cast<Uint8*>(surface->pixels) +
+                                    std::ptrdiff_t(y) * surface->pitch +
+                                    std::ptrdiff_t(x) * surface->format->BytesPerPixel);
+}
+
+}  // namespace sdl2_image_util
+
+
+#endif  // SURFACE_ACCESS_HH
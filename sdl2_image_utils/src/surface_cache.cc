@@ -0,0 +1,305 @@
+#include "surface_cache.hh"
+
+#include "lz_codec.hh"
+#include "surface_access.hh"  // SurfaceLock
+
+#include "safeSdlCall.hh"
+
+#include "SDL_cpuinfo.h"      // SDL_SIMDAlloc SDL_SIMDFree
+#include "SDL_pixels.h"       // SDL_BITSPERPIXEL SDL_ISPIXELFORMAT_*
+
+#include <algorithm>          // min
+#include <atomic>
+#include <cstring>            // memcpy
+#include <functional>         // function
+#include <stdexcept>          // invalid_argument out_of_range runtime_error
+#include <utility>            // move
+
+
+namespace sdl2_image_util {
+
+// large enough for the codec's 64KiB match window, small enough that a
+//   1080p surface splits into dozens of blocks to spread over jobs
+static constexpr std::size_t BLOCK_SIZE { 128 * 1024 };
+// spare buffers kept at once, oldest freed first
+static constexpr std::size_t POOL_MAX_BUFFERS { 4 };
+
+// calls func for all blocks [0, block_ct), one per job if jobs not null
+static void forBlocks(sdl2_thread_util::JobSystem* jobs, std::size_t block_ct,
+                      const std::function<void(std::size_t, std::size_t)>& func) {
+    if (jobs == nullptr || block_ct < 2)
+        func(0, block_ct);
+    else
+        jobs->parallelFor(0, block_ct, 1, func);
+}
+
+void SurfaceCache::SimdFree::operator()(unsigned char* p) const {
+    SDL_SIMDFree(p);
+}
+
+SurfaceCache::SurfaceCache(std::size_t memory_target, std::chrono::milliseconds max_idle,
+                           sdl2_thread_util::JobSystem* jobs) :
+    memory_target_(memory_target), max_idle_(max_idle), jobs_(jobs) {
+    if (max_idle.count() < 0)
+        throw std::invalid_argument("SurfaceCache: max_idle must not be negative");
+}
+
+std::size_t SurfaceCache::pixelSize(const Entry& entry) {
+    return std::size_t(entry.pitch) * std::size_t(entry.h);
+}
+
+void SurfaceCache::insert(const std::string& key, sdl2_smart_ptr::unique::Surface surface) {
+    if (surface == nullptr)
+        throw std::invalid_argument("SurfaceCache: null surface");
+    const Uint32 format { surface->format->format };
+    if (SDL_ISPIXELFORMAT_INDEXED(format) || SDL_ISPIXELFORMAT_FOURCC(format)) {
+        throw std::invalid_argument(
+            "SurfaceCache: " + key + ": pixel format must be packed or array");
+    }
+    erase(key);
+    lru_.push_front(key);
+    Entry& entry { entries_[key] };
+    entry.w = surface->w;
+    entry.h = surface->h;
+    entry.pitch = surface->pitch;
+    entry.format = format;
+    entry.surface = std::move(surface);
+    entry.last_used = std::chrono::steady_clock::now();
+    entry.lru_pos = lru_.begin();
+    resident_bytes_ += pixelSize(entry);
+    trim();
+}
+
+SDL_Surface* SurfaceCache::get(const std::string& key) {
+    const auto it { entries_.find(key) };
+    if (it == entries_.end()) {
+        ++stats_.misses;
+        return nullptr;
+    }
+    Entry& entry { it->second };
+    if (entry.surface == nullptr)
+        decompress(entry);
+    else
+        ++stats_.hits;
+    lru_.splice(lru_.begin(), lru_, entry.lru_pos);
+    entry.last_used = std::chrono::steady_clock::now();
+    return entry.surface.get();
+}
+
+bool SurfaceCache::erase(const std::string& key) {
+    const auto it { entries_.find(key) };
+    if (it == entries_.end())
+        return false;
+    Entry& entry { it->second };
+    const std::size_t size { pixelSize(entry) };
+    if (entry.surface != nullptr) {
+        resident_bytes_ -= size;
+        entry.surface.reset();
+        if (entry.buffer != nullptr)
+            poolBuffer(std::move(entry.buffer), size);
+    } else {
+        compressed_bytes_ -= entry.compressed.size();
+        compressed_raw_bytes_ -= size;
+        --compressed_ct_;
+    }
+    lru_.erase(entry.lru_pos);
+    entries_.erase(it);
+    return true;
+}
+
+bool SurfaceCache::contains(const std::string& key) const {
+    return entries_.find(key) != entries_.end();
+}
+
+bool SurfaceCache::isCompressed(const std::string& key) const {
+    const auto it { entries_.find(key) };
+    if (it == entries_.end())
+        throw std::out_of_range("SurfaceCache: no surface with key " + key);
+    return it->second.surface == nullptr;
+}
+
+std::size_t SurfaceCache::memoryUsage() const {
+    return resident_bytes_ + compressed_bytes_ + pooled_bytes_;
+}
+
+void SurfaceCache::trim() {
+    // buffers not reused since the last trim
+    for (auto it { pool_.begin() }; it != pool_.end(); ) {
+        if (it->stale) {
+            pooled_bytes_ -= it->size;
+            it = pool_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (max_idle_.count() > 0) {
+        const auto idle_since { std::chrono::steady_clock::now() - max_idle_ };
+        for (auto it { lru_.rbegin() }; it != lru_.rend(); ++it) {
+            Entry& entry { entries_.find(*it)->second };
+            // rest were used more recently
+            if (entry.last_used > idle_since)
+                break;
+            if (entry.surface != nullptr)
+                compress(entry);
+        }
+    }
+    for (auto it { lru_.rbegin() };
+         it != lru_.rend() && resident_bytes_ + compressed_bytes_ > memory_target_; ++it) {
+        Entry& entry { entries_.find(*it)->second };
+        if (entry.surface != nullptr)
+            compress(entry);
+    }
+    for (SpareBuffer& spare : pool_)
+        spare.stale = true;
+}
+
+SurfaceCache::Stats SurfaceCache::stats() const {
+    Stats stats { stats_ };
+    stats.entry_ct = entries_.size();
+    stats.compressed_ct = compressed_ct_;
+    stats.resident_bytes = resident_bytes_;
+    stats.compressed_bytes = compressed_bytes_;
+    stats.pooled_bytes = pooled_bytes_;
+    if (compressed_bytes_ > 0)
+        stats.compression_ratio = double(compressed_raw_bytes_) / double(compressed_bytes_);
+    if (stats_.decompressions > 0) {
+        stats.mean_decompress_time =
+            decompress_time_ / std::chrono::nanoseconds::rep(stats_.decompressions);
+    }
+    return stats;
+}
+
+void SurfaceCache::compress(Entry& entry) {
+    SDL_Surface* surface { entry.surface.get() };
+    // kept for surfaces made by decompression
+    safeSdlCall(SDL_GetSurfaceBlendMode, "SDL_GetSurfaceBlendMode",
+                SdlRetTest<int>{ [](const int ret){ return (ret != 0); } },
+                surface, &entry.blend_mode);
+    entry.has_color_key = (SDL_HasColorKey(surface) == SDL_TRUE);
+    if (entry.has_color_key) {
+        safeSdlCall(SDL_GetColorKey, "SDL_GetColorKey",
+                    SdlRetTest<int>{ [](const int ret){ return (ret != 0); } },
+                    surface, &entry.color_key);
+    }
+
+    const std::size_t size { pixelSize(entry) };
+    const std::size_t block_ct { (size + BLOCK_SIZE - 1) / BLOCK_SIZE };
+    std::vector<std::vector<unsigned char>> blocks(block_ct);
+    {
+        SurfaceLock lock { surface };
+        const unsigned char* pixels { static_cast<const unsigned char*>(surface->pixels) };
+        forBlocks(jobs_, block_ct, [&](std::size_t begin, std::size_t end){
+            for (std::size_t i { begin }; i < end; ++i) {
+                const unsigned char* raw { pixels + i * BLOCK_SIZE };
+                const std::size_t raw_size { std::min(BLOCK_SIZE, size - i * BLOCK_SIZE) };
+                std::vector<unsigned char>& block { blocks[i] };
+                block.resize(lz::compressBound(raw_size));
+                // rows of pixels often repeat those above
+                const std::size_t block_size {
+                    lz::compress(raw, raw_size, block.data(), std::size_t(entry.pitch)) };
+                // incompressible blocks are stored as is, known by their size
+                if (block_size >= raw_size)
+                    block.assign(raw, raw + raw_size);
+                else
+                    block.resize(block_size);
+            }
+        });
+    }
+    std::size_t compressed_size {};
+    for (const std::vector<unsigned char>& block : blocks)
+        compressed_size += block.size();
+    entry.compressed.reserve(compressed_size);
+    entry.block_ends.reserve(block_ct);
+    for (const std::vector<unsigned char>& block : blocks) {
+        entry.compressed.insert(entry.compressed.end(), block.begin(), block.end());
+        entry.block_ends.push_back(entry.compressed.size());
+    }
+
+    entry.surface.reset();
+    if (entry.buffer != nullptr)
+        poolBuffer(std::move(entry.buffer), size);
+    resident_bytes_ -= size;
+    compressed_bytes_ += entry.compressed.size();
+    compressed_raw_bytes_ += size;
+    ++compressed_ct_;
+    ++stats_.compressions;
+}
+
+void SurfaceCache::decompress(Entry& entry) {
+    const auto start { std::chrono::steady_clock::now() };
+    const std::size_t size { pixelSize(entry) };
+    PixelBuffer buffer { takeBuffer(size) };
+    std::atomic<bool> corrupt { false };
+    forBlocks(jobs_, entry.block_ends.size(), [&](std::size_t begin, std::size_t end){
+        for (std::size_t i { begin }; i < end; ++i) {
+            const std::size_t block_begin { i == 0 ? 0 : entry.block_ends[i - 1] };
+            const std::size_t block_size { entry.block_ends[i] - block_begin };
+            const unsigned char* block { entry.compressed.data() + block_begin };
+            unsigned char* raw { buffer.get() + i * BLOCK_SIZE };
+            const std::size_t raw_size { std::min(BLOCK_SIZE, size - i * BLOCK_SIZE) };
+            if (block_size == raw_size)
+                std::memcpy(raw, block, raw_size);
+            else if (!lz::decompress(block, block_size, raw, raw_size))
+                corrupt.store(true);
+        }
+    });
+    if (corrupt.load())
+        throw std::runtime_error("SurfaceCache: compressed surface is corrupt");
+
+    auto surface { sdl2_smart_ptr::make_unique(
+            safeSdlCall(SDL_CreateRGBSurfaceWithFormatFrom, "SDL_CreateRGBSurfaceWithFormatFrom",
+                        SdlRetTest<SDL_Surface*>{ [](const SDL_Surface* ret){
+                            return (ret == nullptr); } },
+                        static_cast<void*>(buffer.get()), entry.w, entry.h,
+                        int(SDL_BITSPERPIXEL(entry.format)), entry.pitch, entry.format)) };
+    safeSdlCall(SDL_SetSurfaceBlendMode, "SDL_SetSurfaceBlendMode",
+                SdlRetTest<int>{ [](const int ret){ return (ret != 0); } },
+                surface.get(), entry.blend_mode);
+    if (entry.has_color_key) {
+        safeSdlCall(SDL_SetColorKey, "SDL_SetColorKey",
+                    SdlRetTest<int>{ [](const int ret){ return (ret != 0); } },
+                    surface.get(), int(SDL_TRUE), entry.color_key);
+    }
+    entry.surface = std::move(surface);
+    entry.buffer = std::move(buffer);
+
+    compressed_bytes_ -= entry.compressed.size();
+    compressed_raw_bytes_ -= size;
+    --compressed_ct_;
+    resident_bytes_ += size;
+    // swapped out rather than cleared, to free their memory
+    std::vector<unsigned char>().swap(entry.compressed);
+    std::vector<std::size_t>().swap(entry.block_ends);
+
+    const std::chrono::nanoseconds elapsed { std::chrono::steady_clock::now() - start };
+    decompress_time_ += elapsed;
+    stats_.max_decompress_time = std::max(stats_.max_decompress_time, elapsed);
+    ++stats_.decompressions;
+}
+
+SurfaceCache::PixelBuffer SurfaceCache::takeBuffer(std::size_t size) {
+    for (auto it { pool_.begin() }; it != pool_.end(); ++it) {
+        if (it->size == size) {
+            PixelBuffer buffer { std::move(it->buffer) };
+            pooled_bytes_ -= size;
+            pool_.erase(it);
+            return buffer;
+        }
+    }
+    // aligned for SIMD, like pixels of surfaces SDL allocates
+    return PixelBuffer { static_cast<unsigned char*>(
+            safeSdlCall(SDL_SIMDAlloc, "SDL_SIMDAlloc",
+                        SdlRetTest<void*>{ [](const void* ret){ return (ret == nullptr); } },
+                        size)) };
+}
+
+void SurfaceCache::poolBuffer(PixelBuffer buffer, std::size_t size) {
+    if (pool_.size() == POOL_MAX_BUFFERS) {
+        pooled_bytes_ -= pool_.front().size;
+        pool_.erase(pool_.begin());
+    }
+    pool_.push_back(SpareBuffer { size, std::move(buffer), false });
+    pooled_bytes_ += size;
+}
+
+}  // namespace sdl2_image_util
@@ -0,0 +1,388 @@
+#include "surface_resampler.hh"
+#include "pixel_kernels_simd.hh"
+#include "surface_access.hh"  // SurfaceLock surfaceRow
+
+#include "safeSdlCall.hh"
+
+#include "SDL_pixels.h"       // SDL_PIXELFORMAT_*
+
+#include <algorithm>          // min max clamp
+#include <cmath>              // abs floor ceil lround sin
+#include <functional>
+#include <stdexcept>          // invalid_argument
+#include <string>
+#include <utility>            // move
+
+
+namespace sdl2_image_util {
+
+namespace unique = sdl2_smart_ptr::unique;
+
+// levels made per band of rows, so 16 rows of the base level per row of the
+//   last, keeping bands of large sources within L2 cache
+static constexpr std::size_t MIP_LEVELS_PER_PASS { 4 };
+
+static constexpr int WEIGHT_ONE { 1 << RESAMPLE_WEIGHT_BITS };
+static constexpr int ROUNDING { WEIGHT_ONE / 2 };
+
+// null kernels leave all pixels to scalar
+struct ResampleKernels {
+    std::size_t (*halve_row)(const Uint32* row0, const Uint32* row1, Uint32* dst,
+                             std::size_t dst_count) {};
+    std::size_t (*convolve_row)(const Uint32* src, Uint32* dst, std::size_t dst_count,
+                                const int* first, const Sint16* weights,
+                                std::size_t tap_ct) {};
+    std::size_t (*convolve_columns)(const Uint32* const* rows, const Sint16* weights,
+                                    std::size_t tap_ct, Uint32* dst,
+                                    std::size_t count) {};
+};
+
+static ResampleKernels resampleKernels(SimdLevel level, const char* func_name) {
+    if (!simdLevelSupported(level)) {
+        throw std::invalid_argument(std::string(func_name) + ": " +
+                                    simdLevelName(level) + " not supported");
+    }
+    ResampleKernels kernels {};
+    switch (level) {
+#ifdef SDL2_IMAGE_UTILS_HAVE_AVX2
+    case SimdLevel::Avx2:
+        kernels = { sse41::halveRow, sse41::convolveRow, avx2::convolveColumns };
+        break;
+#endif
+#ifdef SDL2_IMAGE_UTILS_HAVE_SSE41
+    case SimdLevel::Sse41:
+        kernels = { sse41::halveRow, sse41::convolveRow, sse41::convolveColumns };
+        break;
+#endif
+    default:
+        break;
+    }
+    return kernels;
+}
+
+static bool isResampleFormat(const Uint32 format) {
+    switch (format) {
+    case SDL_PIXELFORMAT_ARGB8888:
+    case SDL_PIXELFORMAT_ABGR8888:
+    case SDL_PIXELFORMAT_RGBA8888:
+    case SDL_PIXELFORMAT_BGRA8888:
+    case SDL_PIXELFORMAT_RGB888:
+    case SDL_PIXELFORMAT_BGR888:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// src if already in a format resampled directly, or converted copy of it
+static SDL_Surface* resampleSource(SDL_Surface* src, unique::Surface& converted,
+                                   SimdLevel level, const char* func_name) {
+    if (src == nullptr)
+        throw std::invalid_argument(std::string(func_name) + ": src must not be null");
+    if (src->w <= 0 || src->h <= 0)
+        throw std::invalid_argument(std::string(func_name) + ": src must not be empty");
+    const Uint32 format { src->format->format };
+    if (isResampleFormat(format))
+        return src;
+    converted = convertSurface(
+        src, format == SDL_PIXELFORMAT_RGB24 ? Uint32(SDL_PIXELFORMAT_RGBA32) :
+             format == SDL_PIXELFORMAT_BGR24 ? Uint32(SDL_PIXELFORMAT_BGRA32) :
+             Uint32(SDL_PIXELFORMAT_ARGB8888),
+        level);
+    return converted.get();
+}
+
+static unique::Surface createSurface(int w, int h, Uint32 format) {
+    return sdl2_smart_ptr::make_unique(
+        safeSdlCall(SDL_CreateRGBSurfaceWithFormat, "SDL_CreateRGBSurfaceWithFormat",
+                    SdlRetTest<SDL_Surface*>{
+                        [](const SDL_Surface* ret){ return (ret == nullptr); } },
+                    Uint32(0), w, h, 32, format));
+}
+
+// calls func for all rows [0, row_ct), in parallel chunks if jobs not null
+static void forRows(sdl2_thread_util::JobSystem* jobs, int row_ct,
+                    const std::function<void(std::size_t, std::size_t)>& func) {
+    if (jobs == nullptr)
+        func(0, std::size_t(row_ct));
+    else
+        jobs->parallelFor(0, std::size_t(row_ct), 0, func);
+}
+
+static Uint32 average(const Uint32 a, const Uint32 b, const Uint32 c, const Uint32 d) {
+    Uint32 result {};
+    for (unsigned shift {}; shift < 32; shift += 8) {
+        const Uint32 sum { ((a >> shift) & 0xFF) + ((b >> shift) & 0xFF) +
+                           ((c >> shift) & 0xFF) + ((d >> shift) & 0xFF) };
+        result |= ((sum + 2) >> 2) << shift;
+    }
+    return result;
+}
+
+static void halveRow(const ResampleKernels& kernels, const Uint32* row0, const Uint32* row1,
+                     int src_w, Uint32* dst, std::size_t dst_w) {
+    if (src_w == 1) {
+        dst[0] = average(row0[0], row0[0], row1[0], row1[0]);
+        return;
+    }
+    std::size_t i { kernels.halve_row ? kernels.halve_row(row0, row1, dst, dst_w) : 0 };
+    for (; i < dst_w; ++i)
+        dst[i] = average(row0[i * 2], row0[i * 2 + 1], row1[i * 2], row1[i * 2 + 1]);
+}
+
+// fixed point weights of source pixels for each destination pixel on one axis
+struct Contributions {
+    // first of tap_ct source pixels, always within source
+    std::vector<int> first;
+    // tap_ct per destination pixel, summing to WEIGHT_ONE
+    std::vector<Sint16> weights;
+    std::size_t tap_ct {};
+};
+
+static double filterSupport(ResampleFilter filter) {
+    switch (filter) {
+    case ResampleFilter::Box:
+        return 0.5;
+    case ResampleFilter::Bilinear:
+        return 1.0;
+    case ResampleFilter::Lanczos3:
+        return 3.0;
+    }
+    return 0.0;
+}
+
+static double sinc(const double x) {
+    static constexpr double PI { 3.14159265358979323846 };
+    return x == 0.0 ? 1.0 : std::sin(PI * x) / (PI * x);
+}
+
+static double filterWeight(ResampleFilter filter, const double x) {
+    switch (filter) {
+    case ResampleFilter::Box:
+        return (x > -0.5 && x <= 0.5) ? 1.0 : 0.0;
+    case ResampleFilter::Bilinear:
+        return std::max(1.0 - std::abs(x), 0.0);
+    case ResampleFilter::Lanczos3:
+        return std::abs(x) < 3.0 ? sinc(x) * sinc(x / 3.0) : 0.0;
+    }
+    return 0.0;
+}
+
+static Contributions makeContributions(int src_size, int dst_size, ResampleFilter filter) {
+    const double scale { double(src_size) / double(dst_size) };
+    // widened when downscaling, so every source pixel contributes
+    const double filter_scale { std::max(scale, 1.0) };
+    const double support { filterSupport(filter) * filter_scale };
+
+    Contributions contributions;
+    contributions.tap_ct = std::min(std::size_t(std::ceil(support)) * 2 + 1,
+                                    std::size_t(src_size));
+    const std::size_t tap_ct { contributions.tap_ct };
+    contributions.first.resize(std::size_t(dst_size));
+    contributions.weights.assign(std::size_t(dst_size) * tap_ct, 0);
+    std::vector<double> weights(tap_ct);
+    for (int i {}; i < dst_size; ++i) {
+        const double center { (i + 0.5) * scale };
+        const int begin { std::max(int(std::floor(center - support + 0.5)), 0) };
+        const int end { std::min(int(std::floor(center + support + 0.5)), src_size) };
+        double total {};
+        for (int j { begin }; j < end; ++j) {
+            double& weight { weights[std::size_t(j - begin)] };
+            weight = filterWeight(filter, (j + 0.5 - center) / filter_scale);
+            total += weight;
+        }
+        if (total == 0.0) {
+            weights[0] = 1.0;
+            total = 1.0;
+        }
+
+        // window moved back from right edge if needed, to stay within source
+        const int first { std::min(begin, src_size - int(tap_ct)) };
+        contributions.first[std::size_t(i)] = first;
+        Sint16* fixed { &contributions.weights[std::size_t(i) * tap_ct] };
+        int fixed_total {};
+        std::size_t largest { std::size_t(begin - first) };
+        for (int j { begin }; j < end; ++j) {
+            const std::size_t k { std::size_t(j - first) };
+            fixed[k] = Sint16(std::lround(weights[std::size_t(j - begin)] / total * WEIGHT_ONE));
+            fixed_total += fixed[k];
+            if (fixed[k] > fixed[largest])
+                largest = k;
+        }
+        // rounding error to largest weight, so that flat areas stay exact
+        fixed[largest] = Sint16(fixed[largest] + WEIGHT_ONE - fixed_total);
+    }
+    return contributions;
+}
+
+static Uint32 packSums(const int (&sums)[4]) {
+    Uint32 result {};
+    for (unsigned channel {}; channel < 4; ++channel) {
+        result |= Uint32(std::clamp(sums[channel] >> RESAMPLE_WEIGHT_BITS, 0, 255)) <<
+            (channel * 8);
+    }
+    return result;
+}
+
+static void convolveRow(const ResampleKernels& kernels, const Uint32* src, Uint32* dst,
+                        const Contributions& horizontal) {
+    const std::size_t dst_w { horizontal.first.size() };
+    const std::size_t tap_ct { horizontal.tap_ct };
+    std::size_t i { kernels.convolve_row ?
+        kernels.convolve_row(src, dst, dst_w, horizontal.first.data(),
+                             horizontal.weights.data(), tap_ct) : 0 };
+    for (; i < dst_w; ++i) {
+        int sums[4] { ROUNDING, ROUNDING, ROUNDING, ROUNDING };
+        const Uint32* taps { src + horizontal.first[i] };
+        const Sint16* weights { &horizontal.weights[i * tap_ct] };
+        for (std::size_t k {}; k < tap_ct; ++k) {
+            for (unsigned channel {}; channel < 4; ++channel)
+                sums[channel] += weights[k] * int((taps[k] >> (channel * 8)) & 0xFF);
+        }
+        dst[i] = packSums(sums);
+    }
+}
+
+static void convolveColumns(const ResampleKernels& kernels, const Uint32* const* rows,
+                            const Sint16* weights, std::size_t tap_ct,
+                            Uint32* dst, std::size_t dst_w) {
+    std::size_t x { kernels.convolve_columns ?
+        kernels.convolve_columns(rows, weights, tap_ct, dst, dst_w) : 0 };
+    for (; x < dst_w; ++x) {
+        int sums[4] { ROUNDING, ROUNDING, ROUNDING, ROUNDING };
+        for (std::size_t k {}; k < tap_ct; ++k) {
+            for (unsigned channel {}; channel < 4; ++channel)
+                sums[channel] += weights[k] * int((rows[k][x] >> (channel * 8)) & 0xFF);
+        }
+        dst[x] = packSums(sums);
+    }
+}
+
+// fills levels, the first half the size of source and each after half the
+//   last rounded down, a few levels at a time from bands of rows, reading
+//   source once
+static void halveLevels(const ResampleKernels& kernels, SDL_Surface* source,
+                        const std::vector<unique::Surface>& levels,
+                        sdl2_thread_util::JobSystem* jobs) {
+    for (std::size_t pass_begin {}; pass_begin < levels.size();
+         pass_begin += MIP_LEVELS_PER_PASS) {
+        const std::size_t pass_end { std::min(levels.size(), pass_begin + MIP_LEVELS_PER_PASS) };
+        SDL_Surface* base { pass_begin == 0 ? source : levels[pass_begin - 1].get() };
+        const int last_h { levels[pass_end - 1]->h };
+        // bands of last level rows, and the rows of levels above they are made
+        //   from; the last band also takes rows left over from odd heights
+        forRows(jobs, last_h, [&](std::size_t begin, std::size_t end){
+            const bool last_band { end == std::size_t(last_h) };
+            SDL_Surface* above { base };
+            for (std::size_t i { pass_begin }; i < pass_end; ++i) {
+                SDL_Surface* below { levels[i].get() };
+                const std::size_t shift { pass_end - 1 - i };
+                const int y_end { last_band ? below->h : int(end << shift) };
+                for (int y { int(begin << shift) }; y < y_end; ++y) {
+                    halveRow(kernels,
+                             surfaceRow<const Uint32>(above, 0, std::min(y * 2, above->h - 1)),
+                             surfaceRow<const Uint32>(above, 0, std::min(y * 2 + 1, above->h - 1)),
+                             above->w, surfaceRow<Uint32>(below, 0, y), std::size_t(below->w));
+                }
+                above = below;
+            }
+        });
+    }
+}
+
+// times source can be halved by 2x2 box filtering before filter is applied,
+//   leaving filter at least a 2x reduction unless it is Box itself; only while
+//   both sizes are even, so that no source pixels are dropped
+static int halvingCount(int src_w, int src_h, int w, int h, ResampleFilter filter) {
+    const int gap { filter == ResampleFilter::Box ? 2 : 4 };
+    int count {};
+    while (src_w % 2 == 0 && src_h % 2 == 0 && src_w / gap >= w && src_h / gap >= h) {
+        src_w /= 2;
+        src_h /= 2;
+        ++count;
+    }
+    return count;
+}
+
+unique::Surface resizeSurface(SDL_Surface* src, int w, int h, ResampleFilter filter,
+                              sdl2_thread_util::JobSystem* jobs, SimdLevel level) {
+    if (w <= 0 || h <= 0)
+        throw std::invalid_argument("resizeSurface: w and h must be positive");
+    const ResampleKernels kernels { resampleKernels(level, "resizeSurface") };
+    unique::Surface converted;
+    SDL_Surface* source { resampleSource(src, converted, level, "resizeSurface") };
+    SurfaceLock lock { source };
+
+    // large reductions are halved first, which costs far less per source
+    //   pixel than a filter spanning the whole ratio, leaving a short filter
+    std::vector<unique::Surface> halved;
+    for (int i { halvingCount(source->w, source->h, w, h, filter) }; i > 0; --i) {
+        const SDL_Surface* above { halved.empty() ? source : halved.back().get() };
+        halved.push_back(createSurface(above->w / 2, above->h / 2, source->format->format));
+    }
+    if (!halved.empty()) {
+        halveLevels(kernels, source, halved, jobs);
+        source = halved.back().get();
+        if (source->w == w && source->h == h)
+            return std::move(halved.back());
+    }
+
+    unique::Surface dst { createSurface(w, h, source->format->format) };
+    const Contributions horizontal { makeContributions(source->w, w, filter) };
+    const Contributions vertical { makeContributions(source->h, h, filter) };
+    const std::size_t dst_w { std::size_t(w) };
+
+    // horizontal pass of every source row, then vertical pass of those
+    std::vector<Uint32> between(dst_w * std::size_t(source->h));
+    forRows(jobs, source->h, [&](std::size_t begin, std::size_t end){
+        for (std::size_t y { begin }; y < end; ++y) {
+            convolveRow(kernels, surfaceRow<const Uint32>(source, 0, int(y)),
+                        &between[y * dst_w], horizontal);
+        }
+    });
+    forRows(jobs, h, [&](std::size_t begin, std::size_t end){
+        std::vector<const Uint32*> rows(vertical.tap_ct);
+        for (std::size_t y { begin }; y < end; ++y) {
+            for (std::size_t k {}; k < rows.size(); ++k)
+                rows[k] = &between[(std::size_t(vertical.first[y]) + k) * dst_w];
+            convolveColumns(kernels, rows.data(), &vertical.weights[y * vertical.tap_ct],
+                            vertical.tap_ct, surfaceRow<Uint32>(dst.get(), 0, int(y)), dst_w);
+        }
+    });
+    return dst;
+}
+
+unique::Surface thumbnailSurface(SDL_Surface* src, int max_w, int max_h,
+                                 ResampleFilter filter,
+                                 sdl2_thread_util::JobSystem* jobs, SimdLevel level) {
+    if (max_w <= 0 || max_h <= 0)
+        throw std::invalid_argument("thumbnailSurface: max_w and max_h must be positive");
+    if (src == nullptr || src->w <= 0 || src->h <= 0)
+        throw std::invalid_argument("thumbnailSurface: src must not be null or empty");
+    const double scale { std::min({ 1.0, double(max_w) / src->w, double(max_h) / src->h }) };
+    const int w { std::clamp(int(std::lround(src->w * scale)), 1, max_w) };
+    const int h { std::clamp(int(std::lround(src->h * scale)), 1, max_h) };
+    return resizeSurface(src, w, h, filter, jobs, level);
+}
+
+std::vector<unique::Surface> mipChain(SDL_Surface* src, std::size_t max_levels,
+                                      sdl2_thread_util::JobSystem* jobs, SimdLevel level) {
+    const ResampleKernels kernels { resampleKernels(level, "mipChain") };
+    unique::Surface converted;
+    SDL_Surface* source { resampleSource(src, converted, level, "mipChain") };
+
+    std::vector<unique::Surface> levels;
+    int w { source->w };
+    int h { source->h };
+    while ((w > 1 || h > 1) && (max_levels == 0 || levels.size() < max_levels)) {
+        w = std::max(1, w / 2);
+        h = std::max(1, h / 2);
+        levels.push_back(createSurface(w, h, source->format->format));
+    }
+
+    SurfaceLock lock { source };
+    halveLevels(kernels, source, levels, jobs);
+    return levels;
+}
+
+}  // namespace sdl2_image_util
@@ -0,0 +1,151 @@
+#include <catch2/catch_version_macros.hpp>               // CATCH_VERSION_MAJOR
+#if (CATCH_VERSION_MAJOR != 3)
+  #error "tests currently only support Catch2 v3.x"
+#endif
+#include <catch2/catch_test_macros.hpp>                  // TEST_CASE, SECTION, REQUIRE
+
+#include "async_image_loader.hh"
+
+#include <SDL.h>
+#include <SDL_image.h>
+
+#include <string>
+#include <vector>
+
+
+static std::string collectErrorQuitSdlImg(const std::string& func_name) {
+    std::string err { SDL_GetError() };
+    SDL_ClearError();
+    if (err.size() == 0) {
+        err = "failure without setting SDL error";
+    }
+    IMG_Quit();
+    SDL_Quit();
+    return func_name + ": " + err;
+}
+
+using namespace sdl2_image_util;
+
+// pumps uploads until result_ct results are collected or timeout
+static void pumpUntil(AsyncImageLoader& loader, SDL_Renderer* renderer,
+                      const std::vector<AsyncImageLoader::Result>& results,
+                      const std::size_t result_ct,
+                      const AsyncImageLoader::UploadBudget& budget = {}) {
+    const Uint64 deadline { SDL_GetTicks64() + 10000 };
+    while (results.size() < result_ct && SDL_GetTicks64() < deadline) {
+        loader.pumpUploads(renderer, budget);
+        SDL_Delay(1);
+    }
+}
+
+TEST_CASE("SDL_image async loading: AsyncImageLoader",
+    "[sdl2_image_util][SDL2][SDL_image][AsyncImageLoader]")
+{
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        FAIL(collectErrorQuitSdlImg("SDL_Init"));
+    }
+
+    if (IMG_Init(IMG_INIT_JPG) != IMG_INIT_JPG) {
+        FAIL(collectErrorQuitSdlImg("IMG_Init"));
+    }
+
+    SDL_Window* window {
+        SDL_CreateWindow("test_window", 0, 0, 1, 1, SDL_WINDOW_HIDDEN)
+    };
+    if (window == nullptr) {
+        FAIL(collectErrorQuitSdlImg("SDL_CreateWindow"));
+    }
+
+    SDL_Renderer* renderer {
+        SDL_CreateRenderer(window, -1, 0)
+    };
+    if (renderer == nullptr) {
+        SDL_DestroyWindow(window);
+        FAIL(collectErrorQuitSdlImg("SDL_CreateRenderer"));
+    }
+
+    const std::string image_path { EXAMPLE_DATA_DIR "privat_parkering.jpg" };
+    std::vector<AsyncImageLoader::Result> results;
+    auto collect_result {
+        [&results](const AsyncImageLoader::Result& result){
+            results.push_back(result);
+        }
+    };
+
+    {
+        AsyncImageLoader loader { 2 };
+        REQUIRE(loader.workerCount() == 2);
+
+        SECTION("decoded image is uploaded as texture")
+        {
+            const auto id { loader.request(image_path, collect_result) };
+            pumpUntil(loader, renderer, results, 1);
+            REQUIRE(results.size() == 1);
+            REQUIRE(results[0].id == id);
+            REQUIRE(results[0].error.empty());
+            REQUIRE(results[0].texture != nullptr);
+
+            SDL_Surface* surface { IMG_Load(image_path.c_str()) };
+            REQUIRE(surface != nullptr);
+            int w {}, h {};
+            REQUIRE(SDL_QueryTexture(results[0].texture.get(),
+                                     nullptr, nullptr, &w, &h) == 0);
+            REQUIRE(w == surface->w);
+            REQUIRE(h == surface->h);
+            SDL_FreeSurface(surface);
+
+            REQUIRE(loader.pending() == 0);
+            REQUIRE(loader.stats().uploaded == 1);
+        }
+        SECTION("decode failure is reported")
+        {
+            loader.request("", collect_result);
+            pumpUntil(loader, renderer, results, 1);
+            REQUIRE(results.size() == 1);
+            REQUIRE(results[0].texture == nullptr);
+            REQUIRE(results[0].error.find("IMG_Load: ") == 0);
+            REQUIRE(loader.stats().failed == 1);
+        }
+        SECTION("cancelled requests never complete")
+        {
+            const auto id { loader.request(image_path, collect_result) };
+            loader.request(image_path, collect_result, 0, 7);
+            loader.request(image_path, collect_result, 0, 7);
+            REQUIRE(loader.cancel(id));
+            REQUIRE_FALSE(loader.cancel(id));
+            REQUIRE(loader.cancelGroup(7) == 2);
+            REQUIRE(loader.pending() == 0);
+
+            for (int i {}; i < 100; ++i) {
+                loader.pumpUploads(renderer, {});
+                SDL_Delay(1);
+            }
+            REQUIRE(results.empty());
+            REQUIRE(loader.stats().cancelled == 3);
+        }
+        SECTION("byte budget limits uploads per pump")
+        {
+            for (int i {}; i < 3; ++i)
+                loader.request(image_path, collect_result);
+
+            AsyncImageLoader::UploadBudget budget;
+            budget.bytes = 1;
+            const Uint64 deadline { SDL_GetTicks64() + 10000 };
+            while (results.size() < 3 && SDL_GetTicks64() < deadline) {
+                // one oversized upload is always allowed to guarantee progress
+                REQUIRE(loader.pumpUploads(renderer, budget) <= 1);
+                SDL_Delay(1);
+            }
+            REQUIRE(results.size() == 3);
+            for (const auto& result : results)
+                REQUIRE(result.texture != nullptr);
+        }
+    }
+
+    // textures must be released before their renderer
+    results.clear();
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    IMG_Quit();
+    SDL_Quit();
+}
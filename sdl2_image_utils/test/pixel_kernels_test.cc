@@ -0,0 +1,357 @@
+#include <catch2/catch_version_macros.hpp>               // CATCH_VERSION_MAJOR
+#if (CATCH_VERSION_MAJOR != 3)
+  #error "tests currently only support Catch2 v3.x"
+#endif
+#include <catch2/catch_test_macros.hpp>                  // TEST_CASE, SECTION, REQUIRE
+#include <catch2/benchmark/catch_benchmark.hpp>          // BENCHMARK
+
+#include "pixel_kernels.hh"
+
+#include "sdl2_smart_ptr.hh"  // unique::Surface make_unique
+
+#include <SDL.h>
+#include <SDL_image.h>
+
+#include <cstdlib>    // abs
+#include <cstring>    // memcpy
+#include <stdexcept>  // invalid_argument
+#include <string>
+#include <vector>
+
+
+static std::string collectErrorQuitSdl(const std::string& func_name) {
+    std::string err { SDL_GetError() };
+    SDL_ClearError();
+    if (err.size() == 0) {
+        err = "failure without setting SDL error";
+    }
+    SDL_Quit();
+    return func_name + ": " + err;
+}
+
+using namespace sdl2_image_util;
+using namespace sdl2_smart_ptr;
+
+static const SimdLevel ALL_SIMD_LEVELS[SIMD_LEVEL_CT] {
+    SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Sse41, SimdLevel::Avx2
+};
+
+// deterministic pixels, with every 5th and 7th fully transparent and opaque
+//   to exercise blend special cases
+static std::vector<Uint32> testPixels(std::size_t count, Uint32 seed = 1) {
+    std::vector<Uint32> pixels(count);
+    for (std::size_t i {}; i < count; ++i) {
+        seed = seed * 1664525 + 1013904223;
+        pixels[i] = seed;
+        if (i % 5 == 0)
+            pixels[i] &= 0x00FFFFFF;
+        else if (i % 7 == 0)
+            pixels[i] |= 0xFF000000;
+    }
+    return pixels;
+}
+
+static void fillSurface(SDL_Surface* surface, Uint32 seed) {
+    const std::size_t row_bytes { std::size_t(surface->w * surface->format->BytesPerPixel) };
+    for (int y {}; y < surface->h; ++y) {
+        const std::vector<Uint32> pixels { testPixels(row_bytes / 4 + 1, seed + Uint32(y)) };
+        std::memcpy(static_cast<Uint8*>(surface->pixels) + y * surface->pitch,
+                    pixels.data(), row_bytes);
+    }
+}
+
+// largest difference of any byte in the pixels of two same size surfaces
+static int maxByteDifference(const SDL_Surface* a, const SDL_Surface* b) {
+    int max_diff {};
+    const int row_bytes { a->w * a->format->BytesPerPixel };
+    for (int y {}; y < a->h; ++y) {
+        const Uint8* row_a { static_cast<const Uint8*>(a->pixels) + y * a->pitch };
+        const Uint8* row_b { static_cast<const Uint8*>(b->pixels) + y * b->pitch };
+        for (int x {}; x < row_bytes; ++x) {
+            const int diff { std::abs(int(row_a[x]) - int(row_b[x])) };
+            max_diff = diff > max_diff ? diff : max_diff;
+        }
+    }
+    return max_diff;
+}
+
+static unique::Surface createSurface(int w, int h, Uint32 format) {
+    unique::Surface surface { make_unique(
+        SDL_CreateRGBSurfaceWithFormat(0, w, h, SDL_BITSPERPIXEL(format), format)) };
+    REQUIRE(surface != nullptr);
+    return surface;
+}
+
+TEST_CASE("SDL pixel row kernels: SIMD levels match scalar",
+    "[sdl2_image_util][SDL2][surface][pixel_kernels]")
+{
+    REQUIRE(simdLevelSupported(SimdLevel::Scalar));
+    REQUIRE(simdLevelSupported(bestSimdLevel()));
+    for (const SimdLevel level : ALL_SIMD_LEVELS) {
+        if (!simdLevelSupported(level)) {
+            std::vector<Uint32> pixels(8);
+            REQUIRE_THROWS_AS(swapRedBlueRow(pixels.data(), pixels.data(), 8, level),
+                              std::invalid_argument);
+        }
+    }
+
+    // all counts up to a few vectors, so every tail length is covered
+    for (std::size_t count {}; count < 40; ++count) {
+        const std::vector<Uint32> src { testPixels(count, Uint32(count)) };
+        const std::vector<Uint32> dst_init { testPixels(count, Uint32(count) + 1000) };
+        const std::vector<Uint8> rgb24 { [&src](){
+            std::vector<Uint8> bytes(src.size() * 3);
+            if (!bytes.empty())
+                std::memcpy(bytes.data(), src.data(), bytes.size());
+            return bytes;
+        }() };
+
+        std::vector<Uint32> swapped(count);
+        std::vector<Uint32> expanded(count);
+        std::vector<Uint32> premultiplied(count);
+        std::vector<Uint32> unpremultiplied(count);
+        std::vector<Uint32> blended { dst_init };
+        swapRedBlueRow(src.data(), swapped.data(), count, SimdLevel::Scalar);
+        expandRgb24Row(rgb24.data(), expanded.data(), count, SimdLevel::Scalar);
+        premultiplyAlphaRow(src.data(), premultiplied.data(), count, SimdLevel::Scalar);
+        unpremultiplyAlphaRow(src.data(), unpremultiplied.data(), count, SimdLevel::Scalar);
+        blendRow(src.data(), blended.data(), count, SimdLevel::Scalar);
+
+        for (const SimdLevel level : ALL_SIMD_LEVELS) {
+            if (level == SimdLevel::Scalar || !simdLevelSupported(level))
+                continue;
+            INFO(simdLevelName(level) << ", " << count << " pixels");
+            std::vector<Uint32> result(count);
+            swapRedBlueRow(src.data(), result.data(), count, level);
+            REQUIRE(result == swapped);
+            expandRgb24Row(rgb24.data(), result.data(), count, level);
+            REQUIRE(result == expanded);
+            premultiplyAlphaRow(src.data(), result.data(), count, level);
+            REQUIRE(result == premultiplied);
+            unpremultiplyAlphaRow(src.data(), result.data(), count, level);
+            REQUIRE(result == unpremultiplied);
+            result = dst_init;
+            blendRow(src.data(), result.data(), count, level);
+            REQUIRE(result == blended);
+
+            // in place
+            result = src;
+            swapRedBlueRow(result.data(), result.data(), count, level);
+            REQUIRE(result == swapped);
+        }
+    }
+
+    SECTION("every color and alpha pair")
+    {
+        std::vector<Uint32> src(256 * 256);
+        for (Uint32 a {}; a < 256; ++a) {
+            for (Uint32 c {}; c < 256; ++c)
+                src[a * 256 + c] = (a << 24) | (c << 16) | ((255 - c) << 8) | c;
+        }
+        std::vector<Uint32> premultiplied(src.size());
+        std::vector<Uint32> unpremultiplied(src.size());
+        premultiplyAlphaRow(src.data(), premultiplied.data(), src.size(), SimdLevel::Scalar);
+        unpremultiplyAlphaRow(src.data(), unpremultiplied.data(), src.size(),
+                              SimdLevel::Scalar);
+        for (Uint32 i {}; i < src.size(); ++i)
+            REQUIRE(((premultiplied[i] >> 16) & 0xFF) == (i % 256) * (i / 256) / 255);
+
+        for (const SimdLevel level : ALL_SIMD_LEVELS) {
+            if (!simdLevelSupported(level))
+                continue;
+            INFO(simdLevelName(level));
+            std::vector<Uint32> result(src.size());
+            premultiplyAlphaRow(src.data(), result.data(), src.size(), level);
+            REQUIRE(result == premultiplied);
+            unpremultiplyAlphaRow(src.data(), result.data(), src.size(), level);
+            REQUIRE(result == unpremultiplied);
+            // premultiplied colors come back to within rounding of alpha
+            unpremultiplyAlphaRow(premultiplied.data(), result.data(), src.size(), level);
+            for (Uint32 i { 256 }; i < src.size(); ++i) {
+                const int a { int(i / 256) };
+                REQUIRE(std::abs(int((result[i] >> 16) & 0xFF) - int(i % 256)) <= 255 / a + 1);
+            }
+        }
+    }
+}
+
+TEST_CASE("SDL surface pixel kernels: results match SDL",
+    "[sdl2_image_util][SDL2][surface][pixel_kernels]")
+{
+    if (SDL_Init(0) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    {
+        // odd width, so rows end with tails shorter than a vector
+        unique::Surface argb { createSurface(37, 13, SDL_PIXELFORMAT_ARGB8888) };
+        fillSurface(argb.get(), 7);
+
+        SECTION("invalid arguments")
+        {
+            unique::Surface rgb { createSurface(8, 8, SDL_PIXELFORMAT_RGB24) };
+            unique::Surface abgr { createSurface(8, 8, SDL_PIXELFORMAT_ABGR8888) };
+            REQUIRE_THROWS_AS(convertSurface(nullptr, SDL_PIXELFORMAT_ARGB8888),
+                              std::invalid_argument);
+            REQUIRE_THROWS_AS(premultiplyAlpha(rgb.get()), std::invalid_argument);
+            REQUIRE_THROWS_AS(blitBlended(argb.get(), nullptr, abgr.get(), nullptr),
+                              std::invalid_argument);
+        }
+        SECTION("format conversion")
+        {
+            unique::Surface rgb { createSurface(37, 13, SDL_PIXELFORMAT_RGB24) };
+            fillSurface(rgb.get(), 11);
+            unique::Surface sdl_abgr { make_unique(
+                SDL_ConvertSurfaceFormat(argb.get(), SDL_PIXELFORMAT_ABGR8888, 0)) };
+            unique::Surface sdl_rgba { make_unique(
+                SDL_ConvertSurfaceFormat(rgb.get(), SDL_PIXELFORMAT_RGBA32, 0)) };
+            REQUIRE(sdl_abgr != nullptr);
+            REQUIRE(sdl_rgba != nullptr);
+
+            for (const SimdLevel level : ALL_SIMD_LEVELS) {
+                if (!simdLevelSupported(level))
+                    continue;
+                INFO(simdLevelName(level));
+                unique::Surface abgr { convertSurface(argb.get(), SDL_PIXELFORMAT_ABGR8888,
+                                                      level) };
+                REQUIRE(abgr->format->format == SDL_PIXELFORMAT_ABGR8888);
+                REQUIRE(maxByteDifference(abgr.get(), sdl_abgr.get()) == 0);
+                unique::Surface rgba { convertSurface(rgb.get(), SDL_PIXELFORMAT_RGBA32,
+                                                      level) };
+                REQUIRE(maxByteDifference(rgba.get(), sdl_rgba.get()) == 0);
+            }
+            // other pairs fall back to SDL
+            unique::Surface rgb_again { convertSurface(sdl_rgba.get(), SDL_PIXELFORMAT_RGB24) };
+            REQUIRE(rgb_again->format->format == SDL_PIXELFORMAT_RGB24);
+            REQUIRE(maxByteDifference(rgb_again.get(), rgb.get()) == 0);
+        }
+        SECTION("premultiplied alpha")
+        {
+            unique::Surface sdl_premultiplied { createSurface(37, 13, SDL_PIXELFORMAT_ARGB8888) };
+            REQUIRE(SDL_PremultiplyAlpha(argb->w, argb->h,
+                                         SDL_PIXELFORMAT_ARGB8888, argb->pixels, argb->pitch,
+                                         SDL_PIXELFORMAT_ARGB8888, sdl_premultiplied->pixels,
+                                         sdl_premultiplied->pitch) == 0);
+
+            for (const SimdLevel level : ALL_SIMD_LEVELS) {
+                if (!simdLevelSupported(level))
+                    continue;
+                INFO(simdLevelName(level));
+                // same format, so a copy made by SDL
+                unique::Surface premultiplied { convertSurface(argb.get(),
+                                                               SDL_PIXELFORMAT_ARGB8888) };
+                premultiplyAlpha(premultiplied.get(), level);
+                REQUIRE(maxByteDifference(premultiplied.get(), sdl_premultiplied.get()) == 0);
+
+                // unpremultiplying rounds to nearest, so the round trip may come out 1 lower
+                unpremultiplyAlpha(premultiplied.get(), level);
+                premultiplyAlpha(premultiplied.get(), level);
+                REQUIRE(maxByteDifference(premultiplied.get(), sdl_premultiplied.get()) <= 1);
+            }
+        }
+        SECTION("alpha blended blits")
+        {
+            unique::Surface sdl_dst { createSurface(40, 20, SDL_PIXELFORMAT_ARGB8888) };
+            fillSurface(sdl_dst.get(), 13);
+            REQUIRE(SDL_SetSurfaceBlendMode(argb.get(), SDL_BLENDMODE_BLEND) == 0);
+            const SDL_Rect src_rect { -3, 2, 30, 20 };
+            SDL_Rect sdl_dst_rect { 15, -1, 0, 0 };
+            REQUIRE(SDL_BlitSurface(argb.get(), &src_rect, sdl_dst.get(), &sdl_dst_rect) == 0);
+
+            for (const SimdLevel level : ALL_SIMD_LEVELS) {
+                if (!simdLevelSupported(level))
+                    continue;
+                INFO(simdLevelName(level));
+                unique::Surface dst { createSurface(40, 20, SDL_PIXELFORMAT_ARGB8888) };
+                fillSurface(dst.get(), 13);
+                SDL_Rect dst_rect { 15, -1, 0, 0 };
+                blitBlended(argb.get(), &src_rect, dst.get(), &dst_rect, level);
+                REQUIRE(dst_rect.x == sdl_dst_rect.x);
+                REQUIRE(dst_rect.y == sdl_dst_rect.y);
+                REQUIRE(dst_rect.w == sdl_dst_rect.w);
+                REQUIRE(dst_rect.h == sdl_dst_rect.h);
+                // SDL's own blitters round differently by CPU
+                REQUIRE(maxByteDifference(dst.get(), sdl_dst.get()) <= 2);
+            }
+        }
+    }
+
+    SDL_Quit();
+}
+
+TEST_CASE("SDL pixel kernel throughput: SIMD levels vs SDL",
+    "[.][benchmark][sdl2_image_util][SDL2][surface][pixel_kernels]")
+{
+    if (SDL_Init(0) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    {
+        unique::Surface image { make_unique(IMG_Load(EXAMPLE_DATA_DIR "privat_parkering.jpg")) };
+        if (image == nullptr) {
+            FAIL(collectErrorQuitSdl("IMG_Load"));
+        }
+        unique::Surface rgb { make_unique(
+            SDL_ConvertSurfaceFormat(image.get(), SDL_PIXELFORMAT_RGB24, 0)) };
+        REQUIRE(rgb != nullptr);
+        unique::Surface argb { make_unique(
+            SDL_ConvertSurfaceFormat(image.get(), SDL_PIXELFORMAT_ARGB8888, 0)) };
+        REQUIRE(argb != nullptr);
+        // alpha gradient, so blends aren't all opaque copies
+        for (int y {}; y < argb->h; ++y) {
+            Uint32* row { reinterpret_cast<Uint32*>(
+                static_cast<Uint8*>(argb->pixels) + y * argb->pitch) };
+            for (int x {}; x < argb->w; ++x)
+                row[x] = (row[x] & 0x00FFFFFF) | (Uint32(x * 255 / argb->w) << 24);
+        }
+        REQUIRE(SDL_SetSurfaceBlendMode(argb.get(), SDL_BLENDMODE_BLEND) == 0);
+        unique::Surface dst { createSurface(argb->w, argb->h, SDL_PIXELFORMAT_ARGB8888) };
+        unique::Surface premultiplied { createSurface(argb->w, argb->h,
+                                                      SDL_PIXELFORMAT_ARGB8888) };
+
+        BENCHMARK("SDL_ConvertSurfaceFormat RGB24 -> RGBA32") {
+            return unique::Surface { make_unique(
+                SDL_ConvertSurfaceFormat(rgb.get(), SDL_PIXELFORMAT_RGBA32, 0)) };
+        };
+        BENCHMARK("SDL_ConvertSurfaceFormat ARGB8888 -> ABGR8888") {
+            return unique::Surface { make_unique(
+                SDL_ConvertSurfaceFormat(argb.get(), SDL_PIXELFORMAT_ABGR8888, 0)) };
+        };
+        BENCHMARK("SDL_PremultiplyAlpha") {
+            return SDL_PremultiplyAlpha(argb->w, argb->h,
+                                        SDL_PIXELFORMAT_ARGB8888, argb->pixels, argb->pitch,
+                                        SDL_PIXELFORMAT_ARGB8888, premultiplied->pixels,
+                                        premultiplied->pitch);
+        };
+        BENCHMARK("SDL_BlitSurface blended") {
+            return SDL_BlitSurface(argb.get(), nullptr, dst.get(), nullptr);
+        };
+
+        for (const SimdLevel level : ALL_SIMD_LEVELS) {
+            if (!simdLevelSupported(level))
+                continue;
+            const std::string name { simdLevelName(level) };
+            BENCHMARK("convertSurface RGB24 -> RGBA32, " + name) {
+                return convertSurface(rgb.get(), SDL_PIXELFORMAT_RGBA32, level);
+            };
+            BENCHMARK("convertSurface ARGB8888 -> ABGR8888, " + name) {
+                return convertSurface(argb.get(), SDL_PIXELFORMAT_ABGR8888, level);
+            };
+            BENCHMARK("premultiplyAlphaRow, " + name) {
+                for (int y {}; y < argb->h; ++y) {
+                    premultiplyAlphaRow(
+                        reinterpret_cast<const Uint32*>(
+                            static_cast<const Uint8*>(argb->pixels) + y * argb->pitch),
+                        reinterpret_cast<Uint32*>(
+                            static_cast<Uint8*>(premultiplied->pixels) + y * premultiplied->pitch),
+                        std::size_t(argb->w), level);
+                }
+            };
+            BENCHMARK("blitBlended, " + name) {
+                blitBlended(argb.get(), nullptr, dst.get(), nullptr, level);
+            };
+        }
+    }
+
+    SDL_Quit();
+}
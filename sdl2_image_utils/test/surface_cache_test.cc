@@ -0,0 +1,308 @@
+#include <catch2/catch_version_macros.hpp>               // CATCH_VERSION_MAJOR
+#if (CATCH_VERSION_MAJOR != 3)
+  #error "tests currently only support Catch2 v3.x"
+#endif
+#include <catch2/catch_test_macros.hpp>                  // TEST_CASE, SECTION, REQUIRE
+#include <catch2/benchmark/catch_benchmark.hpp>          // BENCHMARK
+
+#include "surface_cache.hh"
+
+#include "job_system.hh"
+#include "sdl2_smart_ptr.hh"  // unique::Surface make_unique
+
+#include <SDL.h>
+
+#include <chrono>
+#include <cstring>    // memcmp
+#include <stdexcept>  // invalid_argument out_of_range
+#include <string>
+
+
+static std::string collectErrorQuitSdl(const std::string& func_name) {
+    std::string err { SDL_GetError() };
+    SDL_ClearError();
+    if (err.size() == 0) {
+        err = "failure without setting SDL error";
+    }
+    SDL_Quit();
+    return func_name + ": " + err;
+}
+
+using namespace sdl2_image_util;
+using namespace sdl2_smart_ptr;
+using sdl2_thread_util::JobSystem;
+
+static Uint32& pixel(SDL_Surface* surface, int x, int y) {
+    return reinterpret_cast<Uint32*>(
+        static_cast<Uint8*>(surface->pixels) + y * surface->pitch)[x];
+}
+
+// flat panels, banded gradients and sparse noise, like UI art
+static unique::Surface uiSurface(int w, int h, Uint32 seed = 1) {
+    unique::Surface surface { make_unique(
+        SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ARGB8888)) };
+    REQUIRE(surface != nullptr);
+    for (int y {}; y < h; ++y) {
+        for (int x {}; x < w; ++x) {
+            seed = seed * 1664525 + 1013904223;
+            const bool panel { ((x / 64) + (y / 64)) % 2 == 0 };
+            Uint32 value { 0xFF000000 | (panel ? 0x203040 :
+                (Uint32(x / 8 * 8 * 255 / w) << 16) | (Uint32(y * 255 / h) << 8)) };
+            if ((seed >> 24) < 4)
+                value ^= seed & 0xFFFFFF;
+            pixel(surface.get(), x, y) = value;
+        }
+    }
+    return surface;
+}
+
+static unique::Surface noiseSurface(int w, int h) {
+    unique::Surface surface { make_unique(
+        SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ARGB8888)) };
+    REQUIRE(surface != nullptr);
+    Uint32 seed { 7 };
+    for (int y {}; y < h; ++y) {
+        for (int x {}; x < w; ++x) {
+            seed = seed * 1664525 + 1013904223;
+            pixel(surface.get(), x, y) = seed;
+        }
+    }
+    return surface;
+}
+
+static bool samePixels(SDL_Surface* a, SDL_Surface* b) {
+    if (a->w != b->w || a->h != b->h || a->format->format != b->format->format)
+        return false;
+    const std::size_t row_size { std::size_t(a->w) * a->format->BytesPerPixel };
+    for (int y {}; y < a->h; ++y) {
+        if (std::memcmp(static_cast<Uint8*>(a->pixels) + y * a->pitch,
+                        static_cast<Uint8*>(b->pixels) + y * b->pitch, row_size) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static std::size_t pixelSize(const unique::Surface& surface) {
+    return std::size_t(surface->pitch) * std::size_t(surface->h);
+}
+
+TEST_CASE("SDL surface cache: SurfaceCache",
+    "[sdl2_image_util][SDL2][surface][SurfaceCache]")
+{
+    if (SDL_Init(0) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    {
+        const std::size_t size { pixelSize(uiSurface(300, 200)) };
+
+        SECTION("invalid arguments")
+        {
+            REQUIRE_THROWS_AS(SurfaceCache(size, std::chrono::milliseconds { -1 }),
+                              std::invalid_argument);
+            SurfaceCache cache { size };
+            REQUIRE_THROWS_AS(cache.insert("null", nullptr), std::invalid_argument);
+            unique::Surface indexed { make_unique(
+                SDL_CreateRGBSurfaceWithFormat(0, 8, 8, 8, SDL_PIXELFORMAT_INDEX8)) };
+            REQUIRE(indexed != nullptr);
+            REQUIRE_THROWS_AS(cache.insert("indexed", std::move(indexed)),
+                              std::invalid_argument);
+            REQUIRE_THROWS_AS(cache.isCompressed("missing"), std::out_of_range);
+            REQUIRE(cache.get("missing") == nullptr);
+            REQUIRE(cache.stats().misses == 1);
+            REQUIRE(!cache.erase("missing"));
+        }
+        SECTION("entries within target stay uncompressed")
+        {
+            SurfaceCache cache { 3 * size };
+            unique::Surface a { uiSurface(300, 200) };
+            SDL_Surface* a_ptr { a.get() };
+            cache.insert("a", std::move(a));
+            cache.insert("b", uiSurface(300, 200, 2));
+            cache.insert("c", uiSurface(300, 200, 3));
+            REQUIRE(cache.size() == 3);
+            REQUIRE(!cache.isCompressed("a"));
+            REQUIRE(cache.get("a") == a_ptr);
+            REQUIRE(cache.memoryUsage() == 3 * size);
+            const SurfaceCache::Stats stats { cache.stats() };
+            REQUIRE(stats.hits == 1);
+            REQUIRE(stats.compressions == 0);
+            REQUIRE(stats.compression_ratio == 0.0);
+        }
+        SECTION("least recently used entries are compressed to meet target")
+        {
+            SurfaceCache cache { size * 5 / 2 };
+            cache.insert("a", uiSurface(300, 200, 1));
+            cache.insert("b", uiSurface(300, 200, 2));
+            cache.insert("c", uiSurface(300, 200, 3));
+            REQUIRE(cache.isCompressed("a"));
+            REQUIRE(!cache.isCompressed("b"));
+            REQUIRE(!cache.isCompressed("c"));
+            REQUIRE(cache.get("b") != nullptr);
+            cache.insert("d", uiSurface(300, 200, 4));
+            REQUIRE(cache.isCompressed("a"));
+            REQUIRE(!cache.isCompressed("b"));
+            REQUIRE(cache.isCompressed("c"));
+            REQUIRE(!cache.isCompressed("d"));
+
+            const SurfaceCache::Stats stats { cache.stats() };
+            REQUIRE(stats.entry_ct == 4);
+            REQUIRE(stats.compressed_ct == 2);
+            REQUIRE(stats.resident_bytes == 2 * size);
+            REQUIRE(stats.resident_bytes + stats.compressed_bytes <= cache.memoryTarget());
+            REQUIRE(stats.compression_ratio > 4.0);
+        }
+        SECTION("decompressed surfaces match, with blend mode and color key")
+        {
+            const unique::Surface expected { uiSurface(300, 200) };
+            const unique::Surface expected_noise { noiseSurface(300, 200) };
+
+            JobSystem jobs { 2 };
+            for (JobSystem* jobs_ptr : { static_cast<JobSystem*>(nullptr), &jobs }) {
+                // everything compressed once inserted
+                SurfaceCache cache { 0, {}, jobs_ptr };
+                unique::Surface surface { uiSurface(300, 200) };
+                REQUIRE(SDL_SetSurfaceBlendMode(surface.get(), SDL_BLENDMODE_ADD) == 0);
+                REQUIRE(SDL_SetColorKey(surface.get(), SDL_TRUE, 0xFF203040) == 0);
+                cache.insert("ui", std::move(surface));
+                cache.insert("noise", noiseSurface(300, 200));
+                REQUIRE(cache.isCompressed("ui"));
+                REQUIRE(cache.isCompressed("noise"));
+
+                SDL_Surface* ui { cache.get("ui") };
+                REQUIRE(ui != nullptr);
+                REQUIRE(!cache.isCompressed("ui"));
+                REQUIRE(samePixels(ui, expected.get()));
+                SDL_BlendMode blend_mode {};
+                REQUIRE(SDL_GetSurfaceBlendMode(ui, &blend_mode) == 0);
+                REQUIRE(blend_mode == SDL_BLENDMODE_ADD);
+                Uint32 color_key {};
+                REQUIRE(SDL_GetColorKey(ui, &color_key) == 0);
+                REQUIRE(color_key == 0xFF203040);
+
+                // noise is stored uncompressed
+                REQUIRE(samePixels(cache.get("noise"), expected_noise.get()));
+                REQUIRE(cache.stats().decompressions == 2);
+                REQUIRE(cache.stats().max_decompress_time.count() > 0);
+
+                // changes to pixels are kept through compression
+                pixel(ui, 5, 5) = 0x12345678;
+                cache.trim();
+                REQUIRE(cache.isCompressed("ui"));
+                REQUIRE(pixel(cache.get("ui"), 5, 5) == 0x12345678);
+            }
+        }
+        SECTION("odd sizes")
+        {
+            SurfaceCache cache { 0 };
+            unique::Surface tiny { make_unique(
+                SDL_CreateRGBSurfaceWithFormat(0, 3, 1, 24, SDL_PIXELFORMAT_RGB24)) };
+            REQUIRE(tiny != nullptr);
+            cache.insert("tiny", std::move(tiny));
+            REQUIRE(cache.isCompressed("tiny"));
+            SDL_Surface* loaded { cache.get("tiny") };
+            REQUIRE(loaded->w == 3);
+            REQUIRE(loaded->format->format == SDL_PIXELFORMAT_RGB24);
+
+            // several blocks, the last partial
+            const unique::Surface expected { uiSurface(1000, 301) };
+            cache.insert("large", uiSurface(1000, 301));
+            REQUIRE(samePixels(cache.get("large"), expected.get()));
+        }
+        SECTION("idle entries are compressed regardless of target")
+        {
+            SurfaceCache cache { 10 * size, std::chrono::milliseconds { 20 } };
+            cache.insert("idle", uiSurface(300, 200));
+            cache.insert("used", uiSurface(300, 200, 2));
+            SDL_Delay(40);
+            REQUIRE(cache.get("used") != nullptr);
+            cache.trim();
+            REQUIRE(cache.isCompressed("idle"));
+            REQUIRE(!cache.isCompressed("used"));
+        }
+        SECTION("pixel buffers are reused until the next trim")
+        {
+            SurfaceCache cache { size * 3 / 2 };
+            cache.insert("a", uiSurface(300, 200, 1));
+            cache.insert("b", uiSurface(300, 200, 2));
+            REQUIRE(cache.isCompressed("a"));
+            // a decompresses into a new buffer, b's pixels were SDL's
+            REQUIRE(cache.get("a") != nullptr);
+            cache.trim();
+            REQUIRE(cache.isCompressed("b"));
+            REQUIRE(cache.stats().pooled_bytes == 0);
+            // b into a new buffer, and a's goes spare
+            REQUIRE(cache.get("b") != nullptr);
+            cache.trim();
+            REQUIRE(cache.stats().pooled_bytes == size);
+            REQUIRE(cache.memoryUsage() > cache.memoryTarget());
+            // a into its old buffer
+            REQUIRE(cache.get("a") != nullptr);
+            REQUIRE(cache.stats().pooled_bytes == 0);
+            cache.trim();
+            REQUIRE(cache.stats().pooled_bytes == size);
+            cache.trim();
+            REQUIRE(cache.stats().pooled_bytes == 0);
+        }
+        SECTION("erase")
+        {
+            SurfaceCache cache { size * 3 / 2 };
+            cache.insert("a", uiSurface(300, 200, 1));
+            cache.insert("b", uiSurface(300, 200, 2));
+            // replaced
+            cache.insert("b", uiSurface(300, 200, 3));
+            REQUIRE(cache.size() == 2);
+            REQUIRE(cache.erase("a"));
+            REQUIRE(!cache.contains("a"));
+            REQUIRE(cache.erase("b"));
+            REQUIRE(cache.size() == 0);
+            const SurfaceCache::Stats stats { cache.stats() };
+            REQUIRE(stats.resident_bytes == 0);
+            REQUIRE(stats.compressed_bytes == 0);
+            REQUIRE(stats.compressed_ct == 0);
+        }
+    }
+
+    SDL_Quit();
+}
+
+TEST_CASE("SDL surface cache decompression latency: 1080p",
+    "[.][benchmark][sdl2_image_util][SDL2][surface][SurfaceCache]")
+{
+    if (SDL_Init(0) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    {
+        JobSystem jobs {};
+        for (JobSystem* jobs_ptr : { static_cast<JobSystem*>(nullptr), &jobs }) {
+            const std::string name { jobs_ptr == nullptr ? "1 thread" :
+                std::to_string(jobs.workerCount()) + " workers" };
+            unique::Surface a { uiSurface(1920, 1080, 1) };
+            const std::size_t size { pixelSize(a) };
+            // one resident at a time, the other compressed by each trim
+            SurfaceCache cache { size * 3 / 2, {}, jobs_ptr };
+            cache.insert("a", std::move(a));
+            cache.insert("b", uiSurface(1920, 1080, 2));
+            bool use_a { true };
+            BENCHMARK("1920x1080 get and trim, " + name) {
+                SDL_Surface* surface { cache.get(use_a ? "a" : "b") };
+                cache.trim();
+                use_a = !use_a;
+                return surface;
+            };
+            const SurfaceCache::Stats stats { cache.stats() };
+            // 1ms target, met only with enough cores
+            SDL_Log("SurfaceCache 1920x1080, %s (%d cores): compression ratio %.1f, "
+                    "decompression mean %.3fms max %.3fms, %s 1ms target", name.c_str(),
+                    SDL_GetCPUCount(), stats.compression_ratio,
+                    double(stats.mean_decompress_time.count()) / 1e6,
+                    double(stats.max_decompress_time.count()) / 1e6,
+                    stats.max_decompress_time <= std::chrono::milliseconds(1) ?
+                    "within" : "over");
+        }
+    }
+
+    SDL_Quit();
+}
@@ -0,0 +1,401 @@
+#include <catch2/catch_version_macros.hpp>               // CATCH_VERSION_MAJOR
+#if (CATCH_VERSION_MAJOR != 3)
+  #error "tests currently only support Catch2 v3.x"
+#endif
+#include <catch2/catch_test_macros.hpp>                  // TEST_CASE, SECTION, REQUIRE
+#include <catch2/benchmark/catch_benchmark.hpp>          // BENCHMARK
+
+#include "surface_resampler.hh"
+
+#include "job_system.hh"
+#include "sdl2_smart_ptr.hh"  // unique::Surface make_unique
+
+#include <SDL.h>
+
+#include <algorithm>  // min max
+#include <chrono>
+#include <cstdlib>    // abs
+#include <stdexcept>  // invalid_argument
+#include <string>
+#include <utility>    // pair
+#include <vector>
+
+
+static std::string collectErrorQuitSdl(const std::string& func_name) {
+    std::string err { SDL_GetError() };
+    SDL_ClearError();
+    if (err.size() == 0) {
+        err = "failure without setting SDL error";
+    }
+    SDL_Quit();
+    return func_name + ": " + err;
+}
+
+using namespace sdl2_image_util;
+using namespace sdl2_smart_ptr;
+using sdl2_thread_util::JobSystem;
+
+static const SimdLevel ALL_SIMD_LEVELS[SIMD_LEVEL_CT] {
+    SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Sse41, SimdLevel::Avx2
+};
+static const ResampleFilter ALL_FILTERS[RESAMPLE_FILTER_CT] {
+    ResampleFilter::Box, ResampleFilter::Bilinear, ResampleFilter::Lanczos3
+};
+
+static Uint32& pixel(SDL_Surface* surface, int x, int y) {
+    return reinterpret_cast<Uint32*>(
+        static_cast<Uint8*>(surface->pixels) + y * surface->pitch)[x];
+}
+
+// noise plus gradients, so that filters differ
+static unique::Surface testSurface(int w, int h, Uint32 format = SDL_PIXELFORMAT_ARGB8888) {
+    unique::Surface surface { make_unique(
+        SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, format)) };
+    REQUIRE(surface != nullptr);
+    Uint32 seed { 1 };
+    for (int y {}; y < h; ++y) {
+        for (int x {}; x < w; ++x) {
+            seed = seed * 1664525 + 1013904223;
+            pixel(surface.get(), x, y) = (seed & 0xFF0000FF) |
+                (Uint32(x * 255 / w) << 16) | (Uint32(y * 255 / h) << 8);
+        }
+    }
+    return surface;
+}
+
+static bool samePixels(SDL_Surface* a, SDL_Surface* b) {
+    if (a->w != b->w || a->h != b->h || a->format->format != b->format->format)
+        return false;
+    for (int y {}; y < a->h; ++y) {
+        for (int x {}; x < a->w; ++x) {
+            if (pixel(a, x, y) != pixel(b, x, y))
+                return false;
+        }
+    }
+    return true;
+}
+
+static Uint32 average(Uint32 a, Uint32 b, Uint32 c, Uint32 d) {
+    Uint32 result {};
+    for (unsigned shift {}; shift < 32; shift += 8) {
+        result |= ((((a >> shift) & 0xFF) + ((b >> shift) & 0xFF) + ((c >> shift) & 0xFF) +
+                    ((d >> shift) & 0xFF) + 2) / 4) << shift;
+    }
+    return result;
+}
+
+// straightforward 2x2 box filter of above, with last row and column clamped
+static bool isMipOf(SDL_Surface* below, SDL_Surface* above) {
+    for (int y {}; y < below->h; ++y) {
+        const int y0 { std::min(y * 2, above->h - 1) };
+        const int y1 { std::min(y * 2 + 1, above->h - 1) };
+        for (int x {}; x < below->w; ++x) {
+            const int x0 { std::min(x * 2, above->w - 1) };
+            const int x1 { std::min(x * 2 + 1, above->w - 1) };
+            if (pixel(below, x, y) != average(pixel(above, x0, y0), pixel(above, x1, y0),
+                                              pixel(above, x0, y1), pixel(above, x1, y1))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+TEST_CASE("SDL surface resampling: resizeSurface",
+    "[sdl2_image_util][SDL2][surface][resizeSurface]")
+{
+    if (SDL_Init(0) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    {
+        JobSystem jobs { 3 };
+        unique::Surface src { testSurface(123, 77) };
+
+        SECTION("invalid arguments")
+        {
+            REQUIRE_THROWS_AS(resizeSurface(nullptr, 10, 10), std::invalid_argument);
+            REQUIRE_THROWS_AS(resizeSurface(src.get(), 0, 10), std::invalid_argument);
+            REQUIRE_THROWS_AS(thumbnailSurface(src.get(), 10, -1), std::invalid_argument);
+        }
+        SECTION("flat colors stay exact")
+        {
+            unique::Surface flat { testSurface(33, 17) };
+            SDL_FillRect(flat.get(), nullptr, 0x80C04020);
+            for (const ResampleFilter filter : ALL_FILTERS) {
+                for (const auto& [w, h] : { std::pair{ 10, 5 }, std::pair{ 70, 40 } }) {
+                    unique::Surface dst { resizeSurface(flat.get(), w, h, filter) };
+                    for (int y {}; y < h; ++y) {
+                        for (int x {}; x < w; ++x)
+                            REQUIRE(pixel(dst.get(), x, y) == 0x80C04020);
+                    }
+                }
+            }
+        }
+        SECTION("same results at every SIMD level and with jobs")
+        {
+            unique::Surface small { testSurface(40, 30) };
+            for (const ResampleFilter filter : ALL_FILTERS) {
+                unique::Surface down { resizeSurface(src.get(), 50, 31, filter, nullptr,
+                                                     SimdLevel::Scalar) };
+                unique::Surface up { resizeSurface(small.get(), 97, 61, filter, nullptr,
+                                                   SimdLevel::Scalar) };
+                REQUIRE(down->w == 50);
+                REQUIRE(down->h == 31);
+                for (const SimdLevel level : ALL_SIMD_LEVELS) {
+                    if (!simdLevelSupported(level))
+                        continue;
+                    INFO(simdLevelName(level));
+                    unique::Surface level_down {
+                        resizeSurface(src.get(), 50, 31, filter, &jobs, level) };
+                    unique::Surface level_up {
+                        resizeSurface(small.get(), 97, 61, filter, &jobs, level) };
+                    REQUIRE(samePixels(level_down.get(), down.get()));
+                    REQUIRE(samePixels(level_up.get(), up.get()));
+                }
+            }
+        }
+        SECTION("box filter averages areas")
+        {
+            unique::Surface even { testSurface(122, 76) };
+            unique::Surface half { resizeSurface(even.get(), 61, 38, ResampleFilter::Box) };
+            // rounded once per pass
+            for (int y {}; y < half->h; ++y) {
+                for (int x {}; x < half->w; ++x) {
+                    const Uint32 expected { average(
+                        pixel(even.get(), x * 2, y * 2), pixel(even.get(), x * 2 + 1, y * 2),
+                        pixel(even.get(), x * 2, y * 2 + 1),
+                        pixel(even.get(), x * 2 + 1, y * 2 + 1)) };
+                    for (unsigned shift {}; shift < 32; shift += 8) {
+                        REQUIRE(std::abs(int((pixel(half.get(), x, y) >> shift) & 0xFF) -
+                                         int((expected >> shift) & 0xFF)) <= 1);
+                    }
+                }
+            }
+        }
+        SECTION("large reductions are halved first")
+        {
+            unique::Surface large { testSurface(160, 96) };
+            // exact 4x box reduction is two mip levels
+            const std::vector<unique::Surface> levels { mipChain(large.get(), 2) };
+            unique::Surface quarter {
+                resizeSurface(large.get(), 40, 24, ResampleFilter::Box) };
+            REQUIRE(samePixels(quarter.get(), levels[1].get()));
+            for (const ResampleFilter filter : ALL_FILTERS) {
+                // halved once or twice, then filtered
+                unique::Surface down { resizeSurface(large.get(), 30, 20, filter, nullptr,
+                                                     SimdLevel::Scalar) };
+                REQUIRE(down->w == 30);
+                REQUIRE(down->h == 20);
+                for (const SimdLevel level : ALL_SIMD_LEVELS) {
+                    if (!simdLevelSupported(level))
+                        continue;
+                    INFO(simdLevelName(level));
+                    unique::Surface level_down {
+                        resizeSurface(large.get(), 30, 20, filter, &jobs, level) };
+                    REQUIRE(samePixels(level_down.get(), down.get()));
+                }
+            }
+        }
+        SECTION("other formats are converted")
+        {
+            unique::Surface rgb { make_unique(
+                SDL_ConvertSurfaceFormat(src.get(), SDL_PIXELFORMAT_RGB24, 0)) };
+            REQUIRE(rgb != nullptr);
+            unique::Surface dst { resizeSurface(rgb.get(), 20, 20) };
+            REQUIRE(dst->format->format == SDL_PIXELFORMAT_RGBA32);
+        }
+        SECTION("thumbnails keep aspect ratio")
+        {
+            unique::Surface wide { testSurface(200, 100) };
+            unique::Surface thumbnail { thumbnailSurface(wide.get(), 50, 50) };
+            REQUIRE(thumbnail->w == 50);
+            REQUIRE(thumbnail->h == 25);
+            thumbnail = thumbnailSurface(wide.get(), 400, 400);
+            REQUIRE(thumbnail->w == 200);
+            REQUIRE(thumbnail->h == 100);
+        }
+    }
+
+    SDL_Quit();
+}
+
+TEST_CASE("SDL surface mipmaps: mipChain",
+    "[sdl2_image_util][SDL2][surface][mipChain]")
+{
+    if (SDL_Init(0) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    {
+        JobSystem jobs { 3 };
+
+        SECTION("levels halve down to 1x1")
+        {
+            unique::Surface src { testSurface(37, 20) };
+            const std::vector<unique::Surface> levels { mipChain(src.get()) };
+            REQUIRE(levels.size() == 5);
+            REQUIRE(levels[0]->w == 18);
+            REQUIRE(levels[0]->h == 10);
+            REQUIRE(levels[3]->w == 2);
+            REQUIRE(levels[3]->h == 1);
+            REQUIRE(levels[4]->w == 1);
+            REQUIRE(levels[4]->h == 1);
+            REQUIRE(isMipOf(levels[0].get(), src.get()));
+            for (std::size_t i { 1 }; i < levels.size(); ++i)
+                REQUIRE(isMipOf(levels[i].get(), levels[i - 1].get()));
+
+            REQUIRE(mipChain(src.get(), 2).size() == 2);
+
+            unique::Surface column { testSurface(1, 8) };
+            const std::vector<unique::Surface> column_levels { mipChain(column.get()) };
+            REQUIRE(column_levels.size() == 3);
+            REQUIRE(isMipOf(column_levels[0].get(), column.get()));
+        }
+        SECTION("same results at every SIMD level and with jobs")
+        {
+            // enough levels for multiple passes, with odd sizes
+            unique::Surface src { testSurface(301, 203) };
+            const std::vector<unique::Surface> expected { mipChain(src.get(), 0, nullptr,
+                                                                   SimdLevel::Scalar) };
+            REQUIRE(expected.size() == 8);
+            REQUIRE(isMipOf(expected[0].get(), src.get()));
+            for (std::size_t i { 1 }; i < expected.size(); ++i)
+                REQUIRE(isMipOf(expected[i].get(), expected[i - 1].get()));
+
+            for (const SimdLevel level : ALL_SIMD_LEVELS) {
+                if (!simdLevelSupported(level))
+                    continue;
+                INFO(simdLevelName(level));
+                const std::vector<unique::Surface> levels { mipChain(src.get(), 0, &jobs, level) };
+                REQUIRE(levels.size() == expected.size());
+                for (std::size_t i {}; i < levels.size(); ++i)
+                    REQUIRE(samePixels(levels[i].get(), expected[i].get()));
+            }
+        }
+    }
+
+    SDL_Quit();
+}
+
+TEST_CASE("SDL surface resampling throughput: vs SDL_BlitScaled and SDL_SoftStretchLinear",
+    "[.][benchmark][sdl2_image_util][SDL2][surface][resizeSurface]")
+{
+    if (SDL_Init(0) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    {
+        JobSystem jobs {};
+        unique::Surface src { testSurface(3840, 2160) };
+        REQUIRE(SDL_SetSurfaceBlendMode(src.get(), SDL_BLENDMODE_NONE) == 0);
+        unique::Surface scaled { make_unique(
+            SDL_CreateRGBSurfaceWithFormat(0, 960, 540, 32, SDL_PIXELFORMAT_ARGB8888)) };
+        REQUIRE(scaled != nullptr);
+
+        const auto blit_scaled { [&src, &scaled](){
+            return SDL_BlitScaled(src.get(), nullptr, scaled.get(), nullptr);
+        } };
+        const auto blit_scaled_mips { [&src](){
+            // each level from the last, as SDL_BlitScaled only samples
+            std::vector<unique::Surface> levels;
+            SDL_Surface* above { src.get() };
+            while (above->w > 1 || above->h > 1) {
+                levels.push_back(make_unique(SDL_CreateRGBSurfaceWithFormat(
+                    0, std::max(1, above->w / 2), std::max(1, above->h / 2), 32,
+                    SDL_PIXELFORMAT_ARGB8888)));
+                SDL_SetSurfaceBlendMode(above, SDL_BLENDMODE_NONE);
+                SDL_BlitScaled(above, nullptr, levels.back().get(), nullptr);
+                above = levels.back().get();
+            }
+            return levels;
+        } };
+
+        BENCHMARK("3840x2160 -> 960x540, SDL_BlitScaled") {
+            return blit_scaled();
+        };
+        for (const ResampleFilter filter : ALL_FILTERS) {
+            const std::string name {
+                filter == ResampleFilter::Box ? "box" :
+                filter == ResampleFilter::Bilinear ? "bilinear" : "Lanczos3" };
+            BENCHMARK("3840x2160 -> 960x540, resizeSurface " + name) {
+                return resizeSurface(src.get(), 960, 540, filter, &jobs);
+            };
+        }
+        BENCHMARK("3840x2160 mip chain, SDL_BlitScaled") {
+            return blit_scaled_mips();
+        };
+        BENCHMARK("3840x2160 mip chain, mipChain") {
+            return mipChain(src.get(), 0, &jobs);
+        };
+
+        // Catch2 reports times; log speedups directly, on one thread and with
+        //   jobs, as the SDL functions are single threaded
+        static constexpr int RUN_CT { 5 };
+        const auto seconds { [](const auto& func){
+            const auto start { std::chrono::steady_clock::now() };
+            for (int run {}; run < RUN_CT; ++run)
+                func();
+            const std::chrono::duration<double> elapsed {
+                std::chrono::steady_clock::now() - start };
+            return elapsed.count();
+        } };
+        const auto log_speedups { [&](const char* name, double sdl_s, const auto& func){
+            const double single_s { seconds([&](){ func(nullptr); }) };
+            const double jobs_s { seconds([&](){ func(&jobs); }) };
+            SDL_Log("%s: %.2fx on one thread, %.2fx with %d workers",
+                    name, sdl_s / single_s, sdl_s / jobs_s, jobs.workerCount());
+        } };
+        SDL_Log("surface resampling speedups (%s, %d cores):",
+                simdLevelName(bestSimdLevel()), SDL_GetCPUCount());
+
+        // SDL_BlitScaled reads only the nearest source pixel, so does far
+        //   less work than any filter
+        log_speedups("3840x2160 -> 960x540 resizeSurface box vs SDL_BlitScaled",
+                     seconds(blit_scaled), [&](JobSystem* job_system){
+                         resizeSurface(src.get(), 960, 540, ResampleFilter::Box, job_system);
+                     });
+        log_speedups("3840x2160 mipChain vs SDL_BlitScaled", seconds(blit_scaled_mips),
+                     [&](JobSystem* job_system){ mipChain(src.get(), 0, job_system); });
+
+#if SDL_VERSION_ATLEAST(2, 0, 16)
+        // like for like when upscaling, where both interpolate 2x2 pixels;
+        //   when downscaling, SDL_SoftStretchLinear still reads only 2x2
+        unique::Surface half { resizeSurface(src.get(), 1920, 1080, ResampleFilter::Box) };
+        unique::Surface full { make_unique(
+            SDL_CreateRGBSurfaceWithFormat(0, 3840, 2160, 32, SDL_PIXELFORMAT_ARGB8888)) };
+        REQUIRE(full != nullptr);
+        const auto stretch_up { [&half, &full](){
+            return SDL_SoftStretchLinear(half.get(), nullptr, full.get(), nullptr);
+        } };
+        const auto stretch_down { [&src, &scaled](){
+            return SDL_SoftStretchLinear(src.get(), nullptr, scaled.get(), nullptr);
+        } };
+        REQUIRE(stretch_up() == 0);
+        REQUIRE(stretch_down() == 0);
+
+        BENCHMARK("1920x1080 -> 3840x2160, SDL_SoftStretchLinear") {
+            return stretch_up();
+        };
+        BENCHMARK("1920x1080 -> 3840x2160, resizeSurface bilinear") {
+            return resizeSurface(half.get(), 3840, 2160, ResampleFilter::Bilinear, &jobs);
+        };
+        BENCHMARK("3840x2160 -> 960x540, SDL_SoftStretchLinear") {
+            return stretch_down();
+        };
+
+        log_speedups("1920x1080 -> 3840x2160 resizeSurface bilinear vs SDL_SoftStretchLinear",
+                     seconds(stretch_up), [&](JobSystem* job_system){
+                         resizeSurface(half.get(), 3840, 2160, ResampleFilter::Bilinear,
+                                       job_system);
+                     });
+        log_speedups("3840x2160 -> 960x540 resizeSurface bilinear vs SDL_SoftStretchLinear",
+                     seconds(stretch_down), [&](JobSystem* job_system){
+                         resizeSurface(src.get(), 960, 540, ResampleFilter::Bilinear,
+                                       job_system);
+                     });
+#endif
+    }
+
+    SDL_Quit();
+}
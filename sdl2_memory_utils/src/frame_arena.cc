@@ -0,0 +1,95 @@
+#include "frame_arena.hh"
+
+#include "safeSdlCall.hh"
+
+#include "SDL_pixels.h"   // SDL_BYTESPERPIXEL SDL_BITSPERPIXEL SDL_ISPIXELFORMAT_FOURCC
+#include "SDL_surface.h"  // SDL_CreateRGBSurfaceWithFormatFrom
+
+#include <algorithm>      // max
+#include <cstdint>        // uintptr_t
+#include <stdexcept>      // invalid_argument
+
+
+namespace sdl2_memory_util {
+
+FrameArena::FrameArena(std::size_t block_size) : block_size_(block_size) {
+    if (block_size_ == 0)
+        throw std::invalid_argument("FrameArena: block_size must be positive");
+}
+
+void* FrameArena::allocate(std::size_t size, std::size_t alignment) {
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+        throw std::invalid_argument("FrameArena: alignment must be a power of 2");
+    if (size > std::numeric_limits<std::size_t>::max() - alignment)
+        throw std::bad_array_new_length();
+    Buffer& buffer { buffers_[current_] };
+    while (true) {
+        if (buffer.block_index == buffer.blocks.size()) {
+            // worst case padding included, as block start is only
+            //   alignof(max_align_t) aligned
+            const std::size_t new_size { std::max(block_size_, size + alignment - 1) };
+            buffer.blocks.push_back(
+                Block{ std::make_unique<unsigned char[]>(new_size), new_size });
+        }
+        Block& block { buffer.blocks[buffer.block_index] };
+        const std::uintptr_t start {
+            reinterpret_cast<std::uintptr_t>(block.data.get()) + buffer.offset };
+        const std::size_t padding { (alignment - start % alignment) % alignment };
+        if (buffer.offset + padding + size <= block.size) {
+            buffer.offset += padding + size;
+            buffer.used += padding + size;
+            peak_used_ = std::max(peak_used_, buffer.used);
+            return block.data.get() + (buffer.offset - size);
+        }
+        // abandon rest of block for this frame
+        ++buffer.block_index;
+        buffer.offset = 0;
+    }
+}
+
+sdl2_smart_ptr::unique::Surface FrameArena::createScratchSurface(int w, int h, Uint32 format) {
+    if (w <= 0 || h <= 0)
+        throw std::invalid_argument("FrameArena: scratch surface must not be empty");
+    if (SDL_ISPIXELFORMAT_FOURCC(format))
+        throw std::invalid_argument("FrameArena: scratch surface must use a packed format");
+    // SDL_BYTESPERPIXEL is 0 below 8 bits, where pixels share bytes
+    const std::size_t bits { SDL_BITSPERPIXEL(format) };
+    const std::size_t row_size { bits < 8 ? (std::size_t(w) * bits + 7) / 8 :
+                                            std::size_t(w) * SDL_BYTESPERPIXEL(format) };
+    // rows aligned for SIMD like SDL_SIMDAlloc-ed buffers
+    const std::size_t pitch {
+        (row_size + SURFACE_ALIGNMENT - 1) / SURFACE_ALIGNMENT * SURFACE_ALIGNMENT };
+    if (pitch > std::size_t(std::numeric_limits<int>::max()))
+        throw std::invalid_argument("FrameArena: scratch surface too wide");
+    void* pixels { allocate(pitch * std::size_t(h), SURFACE_ALIGNMENT) };
+    return sdl2_smart_ptr::make_unique(
+        safeSdlCall(SDL_CreateRGBSurfaceWithFormatFrom,
+                    "SDL_CreateRGBSurfaceWithFormatFrom",
+                    SdlRetTest<SDL_Surface*>{
+                        [](const SDL_Surface* ret){ return (ret == nullptr); } },
+                    pixels, w, h, int(SDL_BITSPERPIXEL(format)), int(pitch), format));
+}
+
+void FrameArena::nextFrame() {
+    current_ = 1 - current_;
+    Buffer& buffer { buffers_[current_] };
+    buffer.block_index = 0;
+    buffer.offset = 0;
+    buffer.used = 0;
+}
+
+void FrameArena::present(SDL_Renderer* renderer) {
+    SDL_RenderPresent(renderer);
+    nextFrame();
+}
+
+std::size_t FrameArena::capacity() const {
+    std::size_t total {};
+    for (const Buffer& buffer : buffers_) {
+        for (const Block& block : buffer.blocks)
+            total += block.size;
+    }
+    return total;
+}
+
+}  // namespace sdl2_memory_util
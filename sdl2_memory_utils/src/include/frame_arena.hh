@@ -0,0 +1,139 @@
+#ifndef FRAME_ARENA_HH
+#define FRAME_ARENA_HH
+
+#include "sdl2_smart_ptr.hh"  // unique::Surface
+
+#include "SDL_render.h"       // SDL_Renderer
+#include "SDL_stdinc.h"       // Uint32
+
+#include <array>
+#include <cstddef>            // size_t max_align_t
+#include <limits>             // numeric_limits
+#include <memory>             // unique_ptr
+#include <new>                // bad_array_new_length
+#include <type_traits>        // is_trivially_destructible_v
+#include <vector>
+
+
+namespace sdl2_memory_util {
+
+/*
+ * Bump allocator for data that lives for a frame, such as SDL_Vertex and
+ *   SDL_Rect arrays and scratch surfaces. Allocating advances an offset, and
+ *   nothing is freed individually; instead nextFrame() (or present(), which
+ *   calls SDL_RenderPresent first) switches to the other of two buffers and
+ *   rewinds it. Data therefore stays valid through the following frame, for
+ *   renderers still reading it after SDL_RenderPresent returns, and is
+ *   reused in the frame after that.
+ *
+ * Buffers grow by adding blocks when a frame outgrows them, and keep them,
+ *   so after the first few frames no heap allocation happens at all. Only
+ *   trivially destructible types should be placed in the arena, as no
+ *   destructors are run.
+ *
+ * Not thread-safe; use one arena per thread.
+ */
+class FrameArena {
+public:
+    static constexpr std::size_t DEFAULT_BLOCK_SIZE { 1 << 20 };
+    static constexpr std::size_t SURFACE_ALIGNMENT { 64 };
+
+    explicit FrameArena(std::size_t block_size = DEFAULT_BLOCK_SIZE);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // throws std::invalid_argument if alignment is not a power of 2
+    void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+    // uninitialized
+    template<typename T>
+    T* allocateArray(std::size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>,
+                      "FrameArena does not run destructors");
+        if (count > std::numeric_limits<std::size_t>::max() / sizeof(T))
+            throw std::bad_array_new_length();
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // surface using arena memory for its pixels, valid until the frame after
+    //   next; surface itself must be freed by then
+    sdl2_smart_ptr::unique::Surface createScratchSurface(int w, int h, Uint32 format);
+
+    void nextFrame();
+    // SDL_RenderPresent, then nextFrame()
+    void present(SDL_Renderer* renderer);
+
+    // in current frame
+    std::size_t bytesUsed() const { return buffers_[current_].used; }
+    // most used in any frame
+    std::size_t peakBytesUsed() const { return peak_used_; }
+    // of both buffers
+    std::size_t capacity() const;
+
+private:
+    struct Block {
+        std::unique_ptr<unsigned char[]> data;
+        std::size_t size {};
+    };
+
+    struct Buffer {
+        std::vector<Block> blocks;
+        std::size_t block_index {};
+        std::size_t offset {};
+        std::size_t used {};
+    };
+
+    const std::size_t block_size_;
+    std::array<Buffer, 2> buffers_;
+    std::size_t current_ {};
+    std::size_t peak_used_ {};
+};
+
+/*
+ * Standard library allocator adapter drawing from a FrameArena, eg for
+ *   FrameVector<SDL_Vertex> vertices { FrameAllocator<SDL_Vertex>{ arena } }.
+ *   deallocate() is a no-op, so containers must not outlive the next frame's
+ *   reset of their buffer.
+ */
+template<typename T>
+class FrameAllocator {
+public:
+    using value_type = T;
+
+    explicit FrameAllocator(FrameArena& arena) : arena_(&arena) {}
+
+    template<typename U>
+    FrameAllocator(const FrameAllocator<U>& other) : arena_(other.arena()) {}
+
+    T* allocate(std::size_t n) {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+            throw std::bad_array_new_length();
+        return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, std::size_t) {}
+
+    FrameArena* arena() const { return arena_; }
+
+private:
+    FrameArena* arena_;
+};
+
+template<typename T, typename U>
+bool operator==(const FrameAllocator<T>& a, const FrameAllocator<U>& b) {
+    return a.arena() == b.arena();
+}
+
+template<typename T, typename U>
+bool operator!=(const FrameAllocator<T>& a, const FrameAllocator<U>& b) {
+    return !(a == b);
+}
+
+template<typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+}  // namespace sdl2_memory_util
+
+
+#endif  // FRAME_ARENA_HH
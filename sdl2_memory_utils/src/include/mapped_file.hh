@@ -0,0 +1,59 @@
+#ifndef MAPPED_FILE_HH
+#define MAPPED_FILE_HH
+
+#include "SDL_rwops.h"  // SDL_RWops
+
+#include <cstddef>      // size_t
+#include <string>
+
+
+namespace sdl2_memory_util {
+
+/*
+ * Copy-on-write memory map of a whole file, with mmap on POSIX systems and
+ *   MapViewOfFile on Windows. Loaders reading through openRWops() then share
+ *   the page cache rather than copying the file into their own buffers, and
+ *   pages are only read from disk as they are touched, which prefetch() can
+ *   do ahead of time on a background thread. Writing to a page, eg through a
+ *   surface made over it, gives this process its own copy of that page and
+ *   never changes the file.
+ *
+ * Opening and mapping failures are thrown as std::runtime_error. Empty files
+ *   map to a null data() of size 0.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const unsigned char* data() const { return data_; }
+    // copy-on-write, so writes stay in this process
+    unsigned char* data() { return data_; }
+    std::size_t size() const { return size_; }
+    explicit operator bool() const { return data_ != nullptr; }
+
+    // advises the OS of upcoming reads, then touches every page, so that
+    //   later reads don't wait on disk; blocks until done
+    void prefetch() const;
+
+    // SDL_RWFromConstMem over the whole mapping, which must outlive it; free
+    //   with SDL_RWclose, or pass freesrc to loaders
+    SDL_RWops* openRWops() const;
+
+private:
+    void unmap() noexcept;
+
+    unsigned char* data_ {};
+    std::size_t size_ {};
+};
+
+}  // namespace sdl2_memory_util
+
+
+#endif  // MAPPED_FILE_HH
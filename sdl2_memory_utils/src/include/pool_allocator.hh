@@ -0,0 +1,126 @@
+#ifndef POOL_ALLOCATOR_HH
+#define POOL_ALLOCATOR_HH
+
+#include <array>
+#include <cstddef>  // size_t
+#include <cstdint>  // int64_t uint32_t uint64_t
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+namespace sdl2_memory_util {
+
+struct SizeClassStats {
+    // largest allocation served by class; 0 for large allocations
+    std::size_t block_size {};
+    std::int64_t allocs {};
+    std::int64_t frees {};
+    std::int64_t live {};
+    // requested bytes of live allocations
+    std::int64_t bytes {};
+    std::int64_t peak_bytes {};
+};
+
+/*
+ * malloc-compatible allocator that serves requests of up to 4080 bytes from
+ *   16 size classes of 16-byte aligned blocks carved from 64KiB slabs, and
+ *   larger requests from malloc, 64-byte aligned for SIMD.
+ *
+ * Each thread keeps a cache of free blocks per class, refilled from and
+ *   returned to shared per-class free lists in batches, so most allocations
+ *   and frees take no lock. Blocks may be freed on any thread. Slabs are kept
+ *   for reuse until the allocator is destroyed, which must happen only after
+ *   all its blocks are freed.
+ *
+ * Counters are written only by their owning thread; peaks are sampled every
+ *   4096 allocations per thread and by every call to stats().
+ */
+class PoolAllocator {
+public:
+    static constexpr std::size_t SIZE_CLASS_CT { 16 };
+    static constexpr std::size_t SMALL_ALIGNMENT { 16 };
+    static constexpr std::size_t LARGE_ALIGNMENT { 64 };
+
+    PoolAllocator();
+    ~PoolAllocator();
+
+    PoolAllocator(const PoolAllocator&) = delete;
+    PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+    // same contracts as malloc, calloc, realloc and free, including
+    //   returning nullptr on failure
+    void* allocate(std::size_t size);
+    void* allocateZeroed(std::size_t count, std::size_t size);
+    void* reallocate(void* ptr, std::size_t size);
+    void deallocate(void* ptr);
+
+    // size classes in ascending order, then large allocations
+    std::vector<SizeClassStats> stats() const;
+    // one line per class used at least once
+    std::string statsReport() const;
+    // bytes held in slabs, whether allocated or free
+    std::size_t slabBytes() const;
+
+private:
+    struct ThreadCache;
+    friend struct ThreadCacheRegistration;
+
+    struct CentralList {
+        mutable std::mutex mutex;
+        void* free_head {};
+        std::vector<void*> slabs;
+    };
+
+    struct Totals {
+        std::int64_t allocs {};
+        std::int64_t frees {};
+        std::int64_t bytes_allocated {};
+        std::int64_t bytes_freed {};
+    };
+
+    // nullptr if a cache for calling thread could not be allocated
+    ThreadCache* threadCache();
+    void* allocateLarge(ThreadCache* cache, std::size_t size);
+    // central list access and counting for threads without a cache, eg
+    //   while their thread_local objects are destroyed
+    void* allocateFromCentral(std::size_t size_class);
+    void freeToCentral(void* block, std::size_t size_class);
+    void recordUncached(std::size_t size_class, std::int64_t allocs,
+                        std::int64_t frees, std::int64_t bytes);
+    // moves up to cache's batch size of blocks from central list into cache
+    bool refill(ThreadCache& cache, std::size_t size_class);
+    // moves one batch of blocks from cache to central list
+    void drain(ThreadCache& cache, std::size_t size_class);
+    // returns all of cache's blocks and counts, called on thread exit
+    void releaseThreadCache(ThreadCache* cache);
+    // caches_mutex_ must be held; also raises peaks to current values
+    std::vector<SizeClassStats> statsLocked() const;
+
+    const std::uint64_t id_;
+    std::array<CentralList, SIZE_CLASS_CT> central_;
+
+    mutable std::mutex caches_mutex_;
+    std::vector<ThreadCache*> caches_;
+    std::array<Totals, SIZE_CLASS_CT + 1> retired_ {};
+    mutable std::array<std::int64_t, SIZE_CLASS_CT + 1> peak_bytes_ {};
+};
+
+/*
+ * Routes SDL_malloc/SDL_calloc/SDL_realloc/SDL_free through a process-wide
+ *   PoolAllocator with SDL_SetMemoryFunctions. As SDL cannot free memory
+ *   with a different allocator than made it, install must be called before
+ *   any other SDL function (including SDL_Init), and uninstall only after
+ *   SDL_Quit with no SDL allocations outstanding, if ever. Throws
+ *   std::runtime_error if SDL rejects the functions.
+ */
+void installSdlPoolAllocator();
+void uninstallSdlPoolAllocator();
+bool sdlPoolAllocatorInstalled();
+// never destroyed, as SDL may free memory during static destruction
+PoolAllocator& sdlPoolAllocator();
+
+}  // namespace sdl2_memory_util
+
+
+#endif  // POOL_ALLOCATOR_HH
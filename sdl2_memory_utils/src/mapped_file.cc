@@ -0,0 +1,165 @@
+#include "mapped_file.hh"
+
+#include "safeSdlCall.hh"
+
+#ifdef _WIN32
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  include <windows.h>  // CreateFileA CreateFileMappingA MapViewOfFile
+#else
+#  include <fcntl.h>     // open
+#  include <sys/mman.h>  // mmap munmap posix_madvise
+#  include <sys/stat.h>  // fstat
+#  include <unistd.h>    // close sysconf
+#  include <cerrno>
+#  include <cstring>     // strerror
+#endif
+
+#include <climits>       // INT_MAX
+#include <stdexcept>     // runtime_error
+#include <utility>       // exchange
+
+
+namespace sdl2_memory_util {
+
+#ifdef _WIN32
+
+static std::runtime_error mapError(const std::string& func_name, const std::string& path) {
+    return std::runtime_error("MappedFile: " + func_name + " failed for " + path +
+                              ", error " + std::to_string(GetLastError()));
+}
+
+MappedFile::MappedFile(const std::string& path) {
+    HANDLE file { CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr) };
+    if (file == INVALID_HANDLE_VALUE)
+        throw mapError("CreateFileA", path);
+    LARGE_INTEGER size {};
+    if (!GetFileSizeEx(file, &size)) {
+        const std::runtime_error err { mapError("GetFileSizeEx", path) };
+        CloseHandle(file);
+        throw err;
+    }
+    if (size.QuadPart == 0) {
+        CloseHandle(file);
+        return;
+    }
+    // view keeps mapping open, which keeps file open; copy-on-write, so
+    //   writes to the view never reach the file
+    HANDLE mapping { CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr) };
+    CloseHandle(file);
+    if (mapping == nullptr)
+        throw mapError("CreateFileMappingA", path);
+    void* view { MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0) };
+    CloseHandle(mapping);
+    if (view == nullptr)
+        throw mapError("MapViewOfFile", path);
+    data_ = static_cast<unsigned char*>(view);
+    size_ = std::size_t(size.QuadPart);
+}
+
+void MappedFile::unmap() noexcept {
+    if (data_ != nullptr)
+        UnmapViewOfFile(data_);
+}
+
+static std::size_t pageSize() {
+    SYSTEM_INFO info {};
+    GetSystemInfo(&info);
+    return std::size_t(info.dwPageSize);
+}
+
+static void adviseWillNeed(const unsigned char*, std::size_t) {}
+
+#else
+
+static std::runtime_error mapError(const std::string& func_name, const std::string& path) {
+    return std::runtime_error("MappedFile: " + func_name + " failed for " + path + ": " +
+                              std::strerror(errno));
+}
+
+MappedFile::MappedFile(const std::string& path) {
+    const int fd { ::open(path.c_str(), O_RDONLY | O_CLOEXEC) };
+    if (fd == -1)
+        throw mapError("open", path);
+    struct stat st {};
+    if (::fstat(fd, &st) == -1) {
+        const std::runtime_error err { mapError("fstat", path) };
+        ::close(fd);
+        throw err;
+    }
+    if (st.st_size == 0) {
+        ::close(fd);
+        return;
+    }
+    // private writable mapping is copy-on-write, so writes never reach the
+    //   file, and untouched pages stay shared with the page cache
+    void* addr { ::mmap(nullptr, std::size_t(st.st_size), PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE, fd, 0) };
+    const int mmap_errno { errno };
+    // mapping stays valid after close
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        errno = mmap_errno;
+        throw mapError("mmap", path);
+    }
+    data_ = static_cast<unsigned char*>(addr);
+    size_ = std::size_t(st.st_size);
+}
+
+void MappedFile::unmap() noexcept {
+    if (data_ != nullptr)
+        ::munmap(data_, size_);
+}
+
+static std::size_t pageSize() {
+    return std::size_t(::sysconf(_SC_PAGESIZE));
+}
+
+static void adviseWillNeed(const unsigned char* data, std::size_t size) {
+    // only a hint, so failure is harmless
+    ::posix_madvise(const_cast<unsigned char*>(data), size, POSIX_MADV_WILLNEED);
+}
+
+#endif  // _WIN32
+
+MappedFile::~MappedFile() {
+    unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept :
+    data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+}
+
+void MappedFile::prefetch() const {
+    if (data_ == nullptr)
+        return;
+    adviseWillNeed(data_, size_);
+    const std::size_t page_size { pageSize() };
+    // volatile, so reads are not optimized away
+    const volatile unsigned char* bytes { data_ };
+    unsigned char sum {};
+    for (std::size_t offset {}; offset < size_; offset += page_size)
+        sum = static_cast<unsigned char>(sum + bytes[offset]);
+    static_cast<void>(sum);
+}
+
+SDL_RWops* MappedFile::openRWops() const {
+    if (size_ > std::size_t(INT_MAX))
+        throw std::runtime_error("MappedFile: too large for SDL_RWFromConstMem");
+    return safeSdlCall(SDL_RWFromConstMem, "SDL_RWFromConstMem",
+                       SdlRetTest<SDL_RWops*>{ [](const SDL_RWops* rwops){
+                           return (rwops == nullptr); } },
+                       static_cast<const void*>(data_), int(size_));
+}
+
+}  // namespace sdl2_memory_util
@@ -0,0 +1,540 @@
+#include "pool_allocator.hh"
+
+#include "safeSdlCall.hh"
+
+#include "SDL_stdinc.h"  // SDL_GetMemoryFunctions SDL_SetMemoryFunctions
+
+#include <algorithm>     // clamp find remove_if
+#include <atomic>
+#include <cstdint>       // uintptr_t SIZE_MAX
+#include <cstdlib>       // malloc free
+#include <cstring>       // memcpy memset
+#include <new>           // nothrow
+#include <sstream>
+
+
+namespace sdl2_memory_util {
+
+static constexpr std::array<std::size_t, PoolAllocator::SIZE_CLASS_CT> BLOCK_SIZES {
+    32, 48, 64, 80, 96, 128, 160, 192, 256, 320, 384, 512, 768, 1024, 2048, 4096
+};
+static constexpr std::size_t LARGE_CLASS { PoolAllocator::SIZE_CLASS_CT };
+static constexpr std::size_t MAX_BLOCK_SIZE { 4096 };
+static constexpr std::size_t SLAB_SIZE { 64 * 1024 };
+// allocations per thread between automatic peak samples
+static constexpr unsigned PEAK_SAMPLE_INTERVAL { 4096 };
+
+// precedes every allocation; free blocks reuse its space as free list link
+struct alignas(PoolAllocator::SMALL_ALIGNMENT) BlockHeader {
+    std::uint32_t size_class;
+    // large allocations: distance from start of malloc-ed buffer to payload
+    std::uint32_t offset;
+    std::size_t size;
+};
+
+static constexpr std::size_t HEADER_SIZE { sizeof(BlockHeader) };
+static constexpr std::size_t MAX_SMALL_SIZE { MAX_BLOCK_SIZE - HEADER_SIZE };
+
+// size class of each block size in SMALL_ALIGNMENT steps
+static constexpr std::array<std::uint8_t, MAX_BLOCK_SIZE / 16 + 1> makeClassTable() {
+    std::array<std::uint8_t, MAX_BLOCK_SIZE / 16 + 1> table {};
+    std::size_t size_class {};
+    for (std::size_t i {}; i < table.size(); ++i) {
+        while (BLOCK_SIZES[size_class] < i * 16)
+            ++size_class;
+        table[i] = std::uint8_t(size_class);
+    }
+    return table;
+}
+
+static constexpr auto CLASS_TABLE { makeClassTable() };
+
+static std::size_t sizeClassOf(std::size_t size) {
+    return CLASS_TABLE[(size + HEADER_SIZE + 15) / 16];
+}
+
+// blocks moved between thread cache and central list at a time
+static std::size_t batchSize(std::size_t size_class) {
+    return std::clamp<std::size_t>(16384 / BLOCK_SIZES[size_class], 4, 64);
+}
+
+static void*& nextFree(void* block) { return *static_cast<void**>(block); }
+
+static BlockHeader* headerOf(void* ptr) {
+    return reinterpret_cast<BlockHeader*>(static_cast<char*>(ptr) - HEADER_SIZE);
+}
+
+struct PoolAllocator::ThreadCache {
+    // atomic only so other threads can read while owning thread writes
+    struct Counter {
+        std::atomic<std::int64_t> allocs {};
+        std::atomic<std::int64_t> frees {};
+        std::atomic<std::int64_t> bytes_allocated {};
+        std::atomic<std::int64_t> bytes_freed {};
+    };
+
+    static void add(std::atomic<std::int64_t>& counter, std::int64_t n) {
+        // single writer, so no read-modify-write needed
+        counter.store(counter.load(std::memory_order_relaxed) + n,
+                      std::memory_order_relaxed);
+    }
+
+    // returns true when peaks are due to be sampled
+    bool recordAlloc(std::size_t size_class, std::size_t size) {
+        add(counters[size_class].allocs, 1);
+        add(counters[size_class].bytes_allocated, std::int64_t(size));
+        if (--allocs_until_sample != 0)
+            return false;
+        allocs_until_sample = PEAK_SAMPLE_INTERVAL;
+        return true;
+    }
+
+    void recordFree(std::size_t size_class, std::size_t size) {
+        add(counters[size_class].frees, 1);
+        add(counters[size_class].bytes_freed, std::int64_t(size));
+    }
+
+    void recordResize(std::size_t size_class, std::size_t old_size, std::size_t size) {
+        add(counters[size_class].bytes_freed, std::int64_t(old_size));
+        add(counters[size_class].bytes_allocated, std::int64_t(size));
+    }
+
+    std::array<void*, SIZE_CLASS_CT> free_heads {};
+    std::array<std::size_t, SIZE_CLASS_CT> free_cts {};
+    std::array<Counter, SIZE_CLASS_CT + 1> counters;
+    unsigned allocs_until_sample { PEAK_SAMPLE_INTERVAL };
+};
+
+// Registry of live allocators, so that exiting threads only return their
+//   caches to allocators not yet destroyed. Never destroyed, as threads may
+//   exit during static destruction.
+static std::atomic<std::uint64_t> next_allocator_id { 1 };
+
+static std::mutex& allocatorsMutex() {
+    static std::mutex* mutex { new std::mutex };
+    return *mutex;
+}
+
+static std::vector<std::uint64_t>& liveAllocatorIds() {
+    static std::vector<std::uint64_t>* ids { new std::vector<std::uint64_t> };
+    return *ids;
+}
+
+static bool allocatorLive(std::uint64_t id) {
+    const auto& ids { liveAllocatorIds() };
+    return std::find(ids.begin(), ids.end(), id) != ids.end();
+}
+
+// per-thread caches of each allocator used by thread
+struct ThreadCacheRegistration {
+    struct Entry {
+        std::uint64_t allocator_id;
+        PoolAllocator* allocator;
+        PoolAllocator::ThreadCache* cache;
+    };
+
+    ~ThreadCacheRegistration();
+
+    std::vector<Entry> entries;
+    // most recently used entry
+    std::uint64_t last_id {};
+    PoolAllocator::ThreadCache* last_cache {};
+};
+
+static thread_local ThreadCacheRegistration tls_registration;
+// trivially destructible, so still readable while other thread_local objects
+//   are destroyed, which may free memory after tls_registration is gone
+static thread_local bool tls_registration_destroyed {};
+
+ThreadCacheRegistration::~ThreadCacheRegistration() {
+    tls_registration_destroyed = true;
+    std::lock_guard<std::mutex> lock { allocatorsMutex() };
+    for (const Entry& entry : entries) {
+        if (allocatorLive(entry.allocator_id))
+            entry.allocator->releaseThreadCache(entry.cache);
+    }
+}
+
+PoolAllocator::PoolAllocator() : id_(next_allocator_id++) {
+    std::lock_guard<std::mutex> lock { allocatorsMutex() };
+    liveAllocatorIds().push_back(id_);
+}
+
+PoolAllocator::~PoolAllocator() {
+    {
+        std::lock_guard<std::mutex> lock { allocatorsMutex() };
+        auto& ids { liveAllocatorIds() };
+        ids.erase(std::find(ids.begin(), ids.end(), id_));
+    }
+    for (ThreadCache* cache : caches_)
+        delete cache;
+    for (CentralList& list : central_) {
+        for (void* slab : list.slabs)
+            std::free(slab);
+    }
+}
+
+PoolAllocator::ThreadCache* PoolAllocator::threadCache() {
+    if (tls_registration_destroyed)
+        return nullptr;
+    ThreadCacheRegistration& registration { tls_registration };
+    if (registration.last_id == id_)
+        return registration.last_cache;
+    for (const auto& entry : registration.entries) {
+        if (entry.allocator_id == id_) {
+            registration.last_id = id_;
+            registration.last_cache = entry.cache;
+            return entry.cache;
+        }
+    }
+
+    ThreadCache* cache { new (std::nothrow) ThreadCache };
+    if (cache == nullptr)
+        return nullptr;
+    try {
+        std::lock_guard<std::mutex> lock { allocatorsMutex() };
+        // drop entries of destroyed allocators
+        auto& entries { registration.entries };
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                     [](const ThreadCacheRegistration::Entry& entry){
+                                         return !allocatorLive(entry.allocator_id);
+                                     }), entries.end());
+        entries.push_back({ id_, this, cache });
+        try {
+            std::lock_guard<std::mutex> caches_lock { caches_mutex_ };
+            caches_.push_back(cache);
+        } catch (...) {
+            entries.pop_back();
+            throw;
+        }
+    } catch (...) {
+        delete cache;
+        return nullptr;
+    }
+    registration.last_id = id_;
+    registration.last_cache = cache;
+    return cache;
+}
+
+// list's mutex must be held
+static bool addSlab(std::size_t size_class, void*& free_head, std::vector<void*>& slabs) {
+    void* slab { std::malloc(SLAB_SIZE) };
+    if (slab == nullptr)
+        return false;
+    try {
+        slabs.push_back(slab);
+    } catch (...) {
+        std::free(slab);
+        return false;
+    }
+    // link blocks in address order, so that first allocations are adjacent
+    const std::size_t block_size { BLOCK_SIZES[size_class] };
+    for (std::size_t i { SLAB_SIZE / block_size }; i-- > 0; ) {
+        void* block { static_cast<char*>(slab) + i * block_size };
+        nextFree(block) = free_head;
+        free_head = block;
+    }
+    return true;
+}
+
+bool PoolAllocator::refill(ThreadCache& cache, std::size_t size_class) {
+    CentralList& list { central_[size_class] };
+    std::lock_guard<std::mutex> lock { list.mutex };
+    if (list.free_head == nullptr && !addSlab(size_class, list.free_head, list.slabs))
+        return false;
+    for (std::size_t i {}; i < batchSize(size_class) && list.free_head != nullptr; ++i) {
+        void* block { list.free_head };
+        list.free_head = nextFree(block);
+        nextFree(block) = cache.free_heads[size_class];
+        cache.free_heads[size_class] = block;
+        ++cache.free_cts[size_class];
+    }
+    return true;
+}
+
+void PoolAllocator::drain(ThreadCache& cache, std::size_t size_class) {
+    CentralList& list { central_[size_class] };
+    std::lock_guard<std::mutex> lock { list.mutex };
+    for (std::size_t i {}; i < batchSize(size_class); ++i) {
+        void* block { cache.free_heads[size_class] };
+        cache.free_heads[size_class] = nextFree(block);
+        --cache.free_cts[size_class];
+        nextFree(block) = list.free_head;
+        list.free_head = block;
+    }
+}
+
+void* PoolAllocator::allocateFromCentral(std::size_t size_class) {
+    CentralList& list { central_[size_class] };
+    std::lock_guard<std::mutex> lock { list.mutex };
+    if (list.free_head == nullptr && !addSlab(size_class, list.free_head, list.slabs))
+        return nullptr;
+    void* block { list.free_head };
+    list.free_head = nextFree(block);
+    return block;
+}
+
+void PoolAllocator::recordUncached(std::size_t size_class, std::int64_t allocs,
+                                   std::int64_t frees, std::int64_t bytes) {
+    std::lock_guard<std::mutex> lock { caches_mutex_ };
+    retired_[size_class].allocs += allocs;
+    retired_[size_class].frees += frees;
+    if (bytes > 0)
+        retired_[size_class].bytes_allocated += bytes;
+    else
+        retired_[size_class].bytes_freed -= bytes;
+}
+
+void PoolAllocator::freeToCentral(void* block, std::size_t size_class) {
+    CentralList& list { central_[size_class] };
+    std::lock_guard<std::mutex> lock { list.mutex };
+    nextFree(block) = list.free_head;
+    list.free_head = block;
+}
+
+void PoolAllocator::releaseThreadCache(ThreadCache* cache) {
+    {
+        std::lock_guard<std::mutex> lock { caches_mutex_ };
+        for (std::size_t i {}; i < retired_.size(); ++i) {
+            const ThreadCache::Counter& counter { cache->counters[i] };
+            retired_[i].allocs += counter.allocs.load(std::memory_order_relaxed);
+            retired_[i].frees += counter.frees.load(std::memory_order_relaxed);
+            retired_[i].bytes_allocated +=
+                counter.bytes_allocated.load(std::memory_order_relaxed);
+            retired_[i].bytes_freed += counter.bytes_freed.load(std::memory_order_relaxed);
+        }
+        caches_.erase(std::find(caches_.begin(), caches_.end(), cache));
+    }
+    for (std::size_t size_class {}; size_class < SIZE_CLASS_CT; ++size_class) {
+        while (cache->free_heads[size_class] != nullptr) {
+            void* block { cache->free_heads[size_class] };
+            cache->free_heads[size_class] = nextFree(block);
+            freeToCentral(block, size_class);
+        }
+    }
+    delete cache;
+}
+
+void* PoolAllocator::allocateLarge(ThreadCache* cache, std::size_t size) {
+    if (size > SIZE_MAX - HEADER_SIZE - LARGE_ALIGNMENT)
+        return nullptr;
+    char* buffer { static_cast<char*>(std::malloc(size + HEADER_SIZE + LARGE_ALIGNMENT - 1)) };
+    if (buffer == nullptr)
+        return nullptr;
+    const std::uintptr_t payload {
+        (reinterpret_cast<std::uintptr_t>(buffer) + HEADER_SIZE + LARGE_ALIGNMENT - 1) &
+        ~std::uintptr_t(LARGE_ALIGNMENT - 1)
+    };
+    void* ptr { reinterpret_cast<void*>(payload) };
+    new (headerOf(ptr)) BlockHeader{
+        std::uint32_t(LARGE_CLASS),
+        std::uint32_t(payload - reinterpret_cast<std::uintptr_t>(buffer)), size };
+    if (cache == nullptr) {
+        recordUncached(LARGE_CLASS, 1, 0, std::int64_t(size));
+    } else if (cache->recordAlloc(LARGE_CLASS, size)) {
+        std::lock_guard<std::mutex> lock { caches_mutex_ };
+        statsLocked();
+    }
+    return ptr;
+}
+
+void* PoolAllocator::allocate(std::size_t size) {
+    if (size == 0)
+        size = 1;
+    ThreadCache* cache { threadCache() };
+    if (size > MAX_SMALL_SIZE)
+        return allocateLarge(cache, size);
+    const std::size_t size_class { sizeClassOf(size) };
+    if (cache == nullptr) {
+        void* block { allocateFromCentral(size_class) };
+        if (block == nullptr)
+            return nullptr;
+        new (block) BlockHeader{ std::uint32_t(size_class), 0, size };
+        recordUncached(size_class, 1, 0, std::int64_t(size));
+        return static_cast<char*>(block) + HEADER_SIZE;
+    }
+    if (cache->free_heads[size_class] == nullptr && !refill(*cache, size_class))
+        return nullptr;
+    void* block { cache->free_heads[size_class] };
+    cache->free_heads[size_class] = nextFree(block);
+    --cache->free_cts[size_class];
+    new (block) BlockHeader{ std::uint32_t(size_class), 0, size };
+    if (cache->recordAlloc(size_class, size)) {
+        std::lock_guard<std::mutex> lock { caches_mutex_ };
+        statsLocked();
+    }
+    return static_cast<char*>(block) + HEADER_SIZE;
+}
+
+void* PoolAllocator::allocateZeroed(std::size_t count, std::size_t size) {
+    if (size != 0 && count > SIZE_MAX / size)
+        return nullptr;
+    void* ptr { allocate(count * size) };
+    if (ptr != nullptr)
+        std::memset(ptr, 0, count * size);
+    return ptr;
+}
+
+void PoolAllocator::deallocate(void* ptr) {
+    if (ptr == nullptr)
+        return;
+    BlockHeader* header { headerOf(ptr) };
+    const std::size_t size_class { header->size_class };
+    ThreadCache* cache { threadCache() };
+    if (cache == nullptr)
+        recordUncached(size_class, 0, 1, -std::int64_t(header->size));
+    else
+        cache->recordFree(size_class, header->size);
+    if (size_class == LARGE_CLASS) {
+        std::free(static_cast<char*>(ptr) - header->offset);
+        return;
+    }
+    void* block { header };
+    if (cache == nullptr) {
+        freeToCentral(block, size_class);
+        return;
+    }
+    nextFree(block) = cache->free_heads[size_class];
+    cache->free_heads[size_class] = block;
+    if (++cache->free_cts[size_class] > 2 * batchSize(size_class))
+        drain(*cache, size_class);
+}
+
+void* PoolAllocator::reallocate(void* ptr, std::size_t size) {
+    if (ptr == nullptr)
+        return allocate(size);
+    if (size == 0)
+        size = 1;
+    BlockHeader* header { headerOf(ptr) };
+    const std::size_t size_class { header->size_class };
+    // resize in place if still in same class
+    const bool fits { size_class == LARGE_CLASS ?
+        size > MAX_SMALL_SIZE && size <= header->size :
+        size + HEADER_SIZE <= BLOCK_SIZES[size_class] };
+    if (fits) {
+        ThreadCache* cache { threadCache() };
+        if (cache == nullptr) {
+            recordUncached(size_class, 0, 0, -std::int64_t(header->size));
+            recordUncached(size_class, 0, 0, std::int64_t(size));
+        } else {
+            cache->recordResize(size_class, header->size, size);
+        }
+        header->size = size;
+        return ptr;
+    }
+    void* new_ptr { allocate(size) };
+    if (new_ptr == nullptr)
+        return nullptr;
+    std::memcpy(new_ptr, ptr, std::min(size, header->size));
+    deallocate(ptr);
+    return new_ptr;
+}
+
+std::vector<SizeClassStats> PoolAllocator::statsLocked() const {
+    std::vector<SizeClassStats> all_stats;
+    all_stats.reserve(SIZE_CLASS_CT + 1);
+    for (std::size_t i {}; i <= SIZE_CLASS_CT; ++i) {
+        Totals totals { retired_[i] };
+        for (const ThreadCache* cache : caches_) {
+            const ThreadCache::Counter& counter { cache->counters[i] };
+            totals.allocs += counter.allocs.load(std::memory_order_relaxed);
+            totals.frees += counter.frees.load(std::memory_order_relaxed);
+            totals.bytes_allocated += counter.bytes_allocated.load(std::memory_order_relaxed);
+            totals.bytes_freed += counter.bytes_freed.load(std::memory_order_relaxed);
+        }
+        SizeClassStats stats;
+        stats.block_size = i == LARGE_CLASS ? 0 : BLOCK_SIZES[i] - HEADER_SIZE;
+        stats.allocs = totals.allocs;
+        stats.frees = totals.frees;
+        stats.live = totals.allocs - totals.frees;
+        stats.bytes = totals.bytes_allocated - totals.bytes_freed;
+        peak_bytes_[i] = std::max(peak_bytes_[i], stats.bytes);
+        stats.peak_bytes = peak_bytes_[i];
+        all_stats.push_back(stats);
+    }
+    return all_stats;
+}
+
+std::vector<SizeClassStats> PoolAllocator::stats() const {
+    std::lock_guard<std::mutex> lock { caches_mutex_ };
+    return statsLocked();
+}
+
+std::string PoolAllocator::statsReport() const {
+    std::ostringstream report;
+    for (const auto& stats : this->stats()) {
+        if (stats.allocs == 0)
+            continue;
+        if (stats.block_size == 0)
+            report << "large: ";
+        else
+            report << "<= " << stats.block_size << " bytes: ";
+        report << stats.allocs << " allocs, " << stats.live << " live, " <<
+            stats.bytes << " bytes (peak " << stats.peak_bytes << ")\n";
+    }
+    return report.str();
+}
+
+std::size_t PoolAllocator::slabBytes() const {
+    std::size_t slab_ct {};
+    for (const auto& list : central_) {
+        std::lock_guard<std::mutex> lock { list.mutex };
+        slab_ct += list.slabs.size();
+    }
+    return slab_ct * SLAB_SIZE;
+}
+
+// functions replaced by installSdlPoolAllocator
+static SDL_malloc_func previous_malloc {};
+static SDL_calloc_func previous_calloc {};
+static SDL_realloc_func previous_realloc {};
+static SDL_free_func previous_free {};
+static bool installed {};
+
+static void* SDLCALL poolMalloc(size_t size) {
+    return sdlPoolAllocator().allocate(size);
+}
+
+static void* SDLCALL poolCalloc(size_t count, size_t size) {
+    return sdlPoolAllocator().allocateZeroed(count, size);
+}
+
+static void* SDLCALL poolRealloc(void* ptr, size_t size) {
+    return sdlPoolAllocator().reallocate(ptr, size);
+}
+
+static void SDLCALL poolFree(void* ptr) {
+    sdlPoolAllocator().deallocate(ptr);
+}
+
+static const SdlRetTest<int> sdl_int_test {
+    [](const int ret){ return (ret != 0); }
+};
+
+PoolAllocator& sdlPoolAllocator() {
+    static PoolAllocator* allocator { new PoolAllocator };
+    return *allocator;
+}
+
+void installSdlPoolAllocator() {
+    if (installed)
+        return;
+    sdlPoolAllocator();
+    SDL_GetMemoryFunctions(&previous_malloc, &previous_calloc,
+                           &previous_realloc, &previous_free);
+    safeSdlCall(SDL_SetMemoryFunctions, "SDL_SetMemoryFunctions", sdl_int_test,
+                poolMalloc, poolCalloc, poolRealloc, poolFree);
+    installed = true;
+}
+
+void uninstallSdlPoolAllocator() {
+    if (!installed)
+        return;
+    safeSdlCall(SDL_SetMemoryFunctions, "SDL_SetMemoryFunctions", sdl_int_test,
+                previous_malloc, previous_calloc, previous_realloc, previous_free);
+    installed = false;
+}
+
+bool sdlPoolAllocatorInstalled() { return installed; }
+
+}  // namespace sdl2_memory_util
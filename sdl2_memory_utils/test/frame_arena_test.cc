@@ -0,0 +1,189 @@
+#include <catch2/catch_version_macros.hpp>               // CATCH_VERSION_MAJOR
+#if (CATCH_VERSION_MAJOR != 3)
+  #error "tests currently only support Catch2 v3.x"
+#endif
+#include <catch2/catch_test_macros.hpp>                  // TEST_CASE, SECTION, REQUIRE
+#include <catch2/benchmark/catch_benchmark.hpp>          // BENCHMARK
+
+#include "frame_arena.hh"
+
+#include <SDL.h>
+
+#include <cstdint>   // uintptr_t uint32_t
+#include <cstring>   // memset
+#include <iterator>  // begin end
+#include <stdexcept> // invalid_argument
+#include <string>
+#include <vector>
+
+static std::string collectErrorQuitSdl(const std::string& func_name) {
+    std::string err { SDL_GetError() };
+    SDL_ClearError();
+    if (err.size() == 0) {
+        err = "failure without setting SDL error";
+    }
+    SDL_Quit();
+    return func_name + ": " + err;
+}
+
+using namespace sdl2_memory_util;
+using namespace sdl2_smart_ptr;
+
+static bool aligned(const void* ptr, std::size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+}
+
+TEST_CASE("SDL core per-frame linear allocation: FrameArena",
+    "[sdl2_memory_util][SDL2][core][FrameArena]")
+{
+    if (SDL_Init(0) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    {
+        FrameArena arena { 4096 };
+
+        SECTION("alignment")
+        {
+            const std::size_t alignments[] { 1, 2, 8, 16, 64, 256 };
+            for (const std::size_t alignment : alignments) {
+                void* ptr { arena.allocate(3, alignment) };
+                REQUIRE(aligned(ptr, alignment));
+            }
+            REQUIRE_THROWS_AS(arena.allocate(8, 3), std::invalid_argument);
+            REQUIRE_THROWS_AS(arena.allocate(8, 0), std::invalid_argument);
+            REQUIRE(aligned(arena.allocateArray<SDL_Vertex>(7), alignof(SDL_Vertex)));
+        }
+        SECTION("growth past block size")
+        {
+            std::vector<char*> ptrs;
+            for (std::size_t i {}; i < 10; ++i) {
+                auto* ptr { static_cast<char*>(arena.allocate(1000, 1)) };
+                std::memset(ptr, int(i), 1000);
+                ptrs.push_back(ptr);
+            }
+            void* large { arena.allocate(20000) };
+            std::memset(large, 0xff, 20000);
+            for (std::size_t i {}; i < ptrs.size(); ++i)
+                REQUIRE(ptrs[i][999] == char(i));
+            REQUIRE(arena.bytesUsed() >= 30000);
+            REQUIRE(arena.capacity() >= arena.bytesUsed());
+        }
+        SECTION("double buffering")
+        {
+            auto* first { arena.allocateArray<std::uint32_t>(100) };
+            for (std::uint32_t i {}; i < 100; ++i)
+                first[i] = i;
+            const std::size_t first_used { arena.bytesUsed() };
+
+            // data survives one frame, while other buffer is used
+            arena.nextFrame();
+            REQUIRE(arena.bytesUsed() == 0);
+            auto* second { arena.allocateArray<std::uint32_t>(100) };
+            REQUIRE(second != first);
+            std::memset(second, 0, 100 * sizeof(std::uint32_t));
+            REQUIRE(first[99] == 99);
+
+            // then its buffer is reused without growing
+            const std::size_t capacity { arena.capacity() };
+            arena.nextFrame();
+            REQUIRE(arena.allocateArray<std::uint32_t>(100) == first);
+            REQUIRE(arena.bytesUsed() == first_used);
+            REQUIRE(arena.capacity() == capacity);
+            REQUIRE(arena.peakBytesUsed() >= first_used);
+        }
+        SECTION("FrameVector")
+        {
+            FrameVector<SDL_Vertex> vertices { FrameAllocator<SDL_Vertex>{ arena } };
+            for (int i {}; i < 1000; ++i)
+                vertices.push_back(SDL_Vertex{ { float(i), 0.0f }, { 255, 255, 255, 255 },
+                                               { 0.0f, 0.0f } });
+            REQUIRE(vertices.size() == 1000);
+            REQUIRE(vertices[999].position.x == 999.0f);
+            // growth leaves old storage in arena
+            REQUIRE(arena.bytesUsed() > 1000 * sizeof(SDL_Vertex));
+
+            FrameAllocator<int> rebound { vertices.get_allocator() };
+            REQUIRE(rebound == vertices.get_allocator());
+            FrameArena other_arena;
+            REQUIRE(rebound != FrameAllocator<int>{ other_arena });
+        }
+        SECTION("scratch surfaces")
+        {
+            unique::Surface surface { arena.createScratchSurface(30, 20, SDL_PIXELFORMAT_RGBA32) };
+            REQUIRE(surface != nullptr);
+            REQUIRE(surface->w == 30);
+            REQUIRE(surface->h == 20);
+            REQUIRE(surface->format->format == SDL_PIXELFORMAT_RGBA32);
+            REQUIRE(surface->pitch % int(FrameArena::SURFACE_ALIGNMENT) == 0);
+            REQUIRE(aligned(surface->pixels, FrameArena::SURFACE_ALIGNMENT));
+            REQUIRE(SDL_FillRect(surface.get(), nullptr, 0xffffffff) == 0);
+            REQUIRE(arena.bytesUsed() >= std::size_t(surface->pitch) * 20);
+
+            // sub-byte formats round rows up to whole bytes
+            for (const Uint32 format : { SDL_PIXELFORMAT_INDEX1MSB, SDL_PIXELFORMAT_INDEX4LSB }) {
+                const std::size_t before { arena.bytesUsed() };
+                unique::Surface indexed { arena.createScratchSurface(30, 20, format) };
+                REQUIRE(indexed != nullptr);
+                REQUIRE(indexed->pitch >= (30 * int(SDL_BITSPERPIXEL(format)) + 7) / 8);
+                REQUIRE(arena.bytesUsed() - before >= std::size_t(indexed->pitch) * 20);
+                // SDL_FillRect rejects sub-byte formats
+                std::memset(indexed->pixels, 0xff, std::size_t(indexed->pitch) * 20);
+            }
+
+            REQUIRE_THROWS_AS(arena.createScratchSurface(0, 20, SDL_PIXELFORMAT_RGBA32),
+                              std::invalid_argument);
+            REQUIRE_THROWS_AS(arena.createScratchSurface(30, 20, SDL_PIXELFORMAT_YV12),
+                              std::invalid_argument);
+        }
+    }
+
+    SDL_Quit();
+}
+
+// Approximates a sprite-heavy frame: 2500 quads of 4 vertices and 6 indices
+template<typename VertexVector, typename IndexVector>
+static std::size_t buildFrame(VertexVector& vertices, IndexVector& indices) {
+    static constexpr int QUAD_CT { 2500 };
+    for (int i {}; i < QUAD_CT; ++i) {
+        const float x { float(i % 50) * 16.0f };
+        const float y { float(i / 50) * 16.0f };
+        const SDL_Color color { 255, 255, 255, 255 };
+        vertices.push_back(SDL_Vertex{ { x, y }, color, { 0.0f, 0.0f } });
+        vertices.push_back(SDL_Vertex{ { x + 16.0f, y }, color, { 1.0f, 0.0f } });
+        vertices.push_back(SDL_Vertex{ { x + 16.0f, y + 16.0f }, color, { 1.0f, 1.0f } });
+        vertices.push_back(SDL_Vertex{ { x, y + 16.0f }, color, { 0.0f, 1.0f } });
+        const int base { i * 4 };
+        const int quad[] { base, base + 1, base + 2, base, base + 2, base + 3 };
+        indices.insert(indices.end(), std::begin(quad), std::end(quad));
+    }
+    return vertices.size() + indices.size();
+}
+
+TEST_CASE("SDL core per-frame linear allocation throughput: FrameArena",
+    "[.][benchmark][sdl2_memory_util][SDL2][core][FrameArena]")
+{
+    if (SDL_Init(0) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    {
+        FrameArena arena;
+
+        BENCHMARK("10000 vertices per frame, std::vector") {
+            std::vector<SDL_Vertex> vertices;
+            std::vector<int> indices;
+            return buildFrame(vertices, indices);
+        };
+        BENCHMARK("10000 vertices per frame, FrameVector") {
+            arena.nextFrame();
+            FrameVector<SDL_Vertex> vertices { FrameAllocator<SDL_Vertex>{ arena } };
+            FrameVector<int> indices { FrameAllocator<int>{ arena } };
+            return buildFrame(vertices, indices);
+        };
+        SDL_Log("FrameArena peak bytes per frame: %zu, capacity: %zu",
+                arena.peakBytesUsed(), arena.capacity());
+    }
+
+    SDL_Quit();
+}
@@ -0,0 +1,112 @@
+#include <catch2/catch_version_macros.hpp>               // CATCH_VERSION_MAJOR
+#if (CATCH_VERSION_MAJOR != 3)
+  #error "tests currently only support Catch2 v3.x"
+#endif
+#include <catch2/catch_test_macros.hpp>                  // TEST_CASE, SECTION, REQUIRE
+
+#include "mapped_file.hh"
+
+#include <SDL.h>
+
+#include <cstdio>     // remove
+#include <cstring>    // memcmp
+#include <fstream>
+#include <stdexcept>  // runtime_error
+#include <string>
+#include <utility>    // move
+#include <vector>
+
+static std::string collectErrorQuitSdl(const std::string& func_name) {
+    std::string err { SDL_GetError() };
+    SDL_ClearError();
+    if (err.size() == 0) {
+        err = "failure without setting SDL error";
+    }
+    SDL_Quit();
+    return func_name + ": " + err;
+}
+
+using namespace sdl2_memory_util;
+
+static const std::string TEST_PATH { "mapped_file_test.bin" };
+static const std::string EMPTY_PATH { "mapped_file_test_empty.bin" };
+
+// several pages of non-repeating bytes
+static std::vector<char> testBytes() {
+    std::vector<char> bytes(3 * 4096 + 123);
+    unsigned seed { 1 };
+    for (char& byte : bytes) {
+        seed = seed * 1664525 + 1013904223;
+        byte = char(seed >> 24);
+    }
+    return bytes;
+}
+
+TEST_CASE("SDL core file mapping: MappedFile",
+    "[sdl2_memory_util][SDL2][core][MappedFile]")
+{
+    if (SDL_Init(0) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    const std::vector<char> bytes { testBytes() };
+    std::ofstream(TEST_PATH, std::ios::binary).write(bytes.data(), std::streamsize(bytes.size()));
+    std::ofstream(EMPTY_PATH, std::ios::binary);
+
+    {
+        SECTION("contents")
+        {
+            MappedFile file { TEST_PATH };
+            REQUIRE(file);
+            REQUIRE(file.size() == bytes.size());
+            REQUIRE(std::memcmp(file.data(), bytes.data(), bytes.size()) == 0);
+            file.prefetch();
+        }
+        SECTION("reading through RWops")
+        {
+            MappedFile file { TEST_PATH };
+            SDL_RWops* rwops { file.openRWops() };
+            REQUIRE(SDL_RWsize(rwops) == Sint64(bytes.size()));
+            std::vector<char> read(bytes.size());
+            REQUIRE(SDL_RWread(rwops, read.data(), 1, read.size()) == read.size());
+            REQUIRE(read == bytes);
+            SDL_RWclose(rwops);
+        }
+        SECTION("empty and missing files")
+        {
+            MappedFile empty { EMPTY_PATH };
+            REQUIRE(!empty);
+            REQUIRE(empty.size() == 0);
+            empty.prefetch();
+            REQUIRE_THROWS_AS(MappedFile("no_such_file.bin"), std::runtime_error);
+        }
+        SECTION("writes are copy-on-write")
+        {
+            {
+                MappedFile file { TEST_PATH };
+                file.data()[0] = static_cast<unsigned char>(~bytes[0]);
+                file.data()[bytes.size() - 1] = 0;
+                REQUIRE(file.data()[0] == static_cast<unsigned char>(~bytes[0]));
+                MappedFile other { TEST_PATH };
+                REQUIRE(std::memcmp(other.data(), bytes.data(), bytes.size()) == 0);
+            }
+            MappedFile file { TEST_PATH };
+            REQUIRE(std::memcmp(file.data(), bytes.data(), bytes.size()) == 0);
+        }
+        SECTION("move")
+        {
+            MappedFile file { TEST_PATH };
+            const unsigned char* data { file.data() };
+            MappedFile moved { std::move(file) };
+            REQUIRE(!file);
+            REQUIRE(moved.data() == data);
+            file = std::move(moved);
+            REQUIRE(file.data() == data);
+            REQUIRE(file.size() == bytes.size());
+        }
+    }
+
+    std::remove(TEST_PATH.c_str());
+    std::remove(EMPTY_PATH.c_str());
+    SDL_Quit();
+}
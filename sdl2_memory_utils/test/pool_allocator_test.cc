@@ -0,0 +1,269 @@
+#include <catch2/catch_version_macros.hpp>               // CATCH_VERSION_MAJOR
+#if (CATCH_VERSION_MAJOR != 3)
+  #error "tests currently only support Catch2 v3.x"
+#endif
+#include <catch2/catch_test_macros.hpp>                  // TEST_CASE, SECTION, REQUIRE
+#include <catch2/benchmark/catch_benchmark.hpp>          // BENCHMARK
+
+#include "pool_allocator.hh"
+
+#include "sdl2_smart_ptr.hh"  // unique::Thread make_unique
+
+#include <SDL.h>
+
+#include <cstdint>   // uintptr_t uint8_t
+#include <cstdlib>   // malloc free
+#include <cstring>   // memset
+#include <string>
+#include <vector>
+
+static std::string collectErrorQuitSdl(const std::string& func_name) {
+    std::string err { SDL_GetError() };
+    SDL_ClearError();
+    if (err.size() == 0) {
+        err = "failure without setting SDL error";
+    }
+    SDL_Quit();
+    return func_name + ": " + err;
+}
+
+using namespace sdl2_memory_util;
+using namespace sdl2_smart_ptr;
+
+static bool aligned(const void* ptr, std::size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+}
+
+static std::int64_t totalLive(const PoolAllocator& allocator) {
+    std::int64_t live {};
+    for (const auto& stats : allocator.stats())
+        live += stats.live;
+    return live;
+}
+
+// allocates on one thread, for main thread to free
+struct CrossThreadArgs {
+    PoolAllocator* allocator;
+    std::vector<void*> blocks;
+};
+
+static int allocateBlocksThread(void* data) {
+    auto* args { static_cast<CrossThreadArgs*>(data) };
+    for (std::size_t i {}; i < 1000; ++i) {
+        void* ptr { args->allocator->allocate(16 + i % 512) };
+        std::memset(ptr, 0xab, 16);
+        args->blocks.push_back(ptr);
+    }
+    return 0;
+}
+
+static int churnBlocksThread(void* data) {
+    auto* allocator { static_cast<PoolAllocator*>(data) };
+    std::vector<void*> blocks;
+    for (int round {}; round < 20; ++round) {
+        for (std::size_t i {}; i < 500; ++i)
+            blocks.push_back(allocator->allocate(8 + (i * 37) % 3000));
+        for (void* ptr : blocks)
+            allocator->deallocate(ptr);
+        blocks.clear();
+    }
+    return 0;
+}
+
+TEST_CASE("SDL core size-class allocation: PoolAllocator",
+    "[sdl2_memory_util][SDL2][core][PoolAllocator]")
+{
+    if (SDL_Init(0) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    {
+        PoolAllocator allocator;
+
+        SECTION("alignment and size classes")
+        {
+            std::vector<void*> blocks;
+            const std::size_t sizes[] { 1, 15, 16, 17, 100, 1000, 4080, 4081, 100000 };
+            for (const std::size_t size : sizes) {
+                void* ptr { allocator.allocate(size) };
+                REQUIRE(ptr != nullptr);
+                REQUIRE(aligned(ptr, size > 4080 ? PoolAllocator::LARGE_ALIGNMENT :
+                                                  PoolAllocator::SMALL_ALIGNMENT));
+                std::memset(ptr, 0x5a, size);
+                blocks.push_back(ptr);
+            }
+            const auto stats { allocator.stats() };
+            REQUIRE(stats.size() == PoolAllocator::SIZE_CLASS_CT + 1);
+            REQUIRE(stats.front().allocs == 3);  // 1, 15 and 16 bytes
+            REQUIRE(stats.back().block_size == 0);
+            REQUIRE(stats.back().live == 2);
+            REQUIRE(stats.back().bytes == 4081 + 100000);
+            REQUIRE(allocator.slabBytes() > 0);
+            for (void* ptr : blocks)
+                allocator.deallocate(ptr);
+            allocator.deallocate(nullptr);
+            REQUIRE(totalLive(allocator) == 0);
+            REQUIRE(allocator.stats().back().peak_bytes == 4081 + 100000);
+            REQUIRE_FALSE(allocator.statsReport().empty());
+        }
+        SECTION("freed blocks are reused")
+        {
+            void* a { allocator.allocate(40) };
+            allocator.deallocate(a);
+            REQUIRE(allocator.allocate(40) == a);
+            allocator.deallocate(a);
+        }
+        SECTION("calloc and realloc")
+        {
+            auto* zeroed { static_cast<std::uint8_t*>(allocator.allocateZeroed(10, 100)) };
+            REQUIRE(zeroed != nullptr);
+            bool all_zero { true };
+            for (std::size_t i {}; i < 1000; ++i)
+                all_zero = all_zero && zeroed[i] == 0;
+            REQUIRE(all_zero);
+            REQUIRE(allocator.allocateZeroed(SIZE_MAX, 2) == nullptr);
+
+            // grows through small classes into large and back
+            for (std::size_t i {}; i < 1000; ++i)
+                zeroed[i] = std::uint8_t(i);
+            void* ptr { zeroed };
+            const std::size_t sizes[] { 1000, 1010, 3000, 20000, 2000 };
+            for (const std::size_t size : sizes)
+                ptr = allocator.reallocate(ptr, size);
+            auto* bytes { static_cast<std::uint8_t*>(ptr) };
+            bool preserved { true };
+            for (std::size_t i {}; i < 1000; ++i)
+                preserved = preserved && bytes[i] == std::uint8_t(i);
+            REQUIRE(preserved);
+            allocator.deallocate(allocator.reallocate(nullptr, 10));
+            allocator.deallocate(ptr);
+            REQUIRE(totalLive(allocator) == 0);
+        }
+        SECTION("blocks freed on other threads")
+        {
+            CrossThreadArgs args { &allocator, {} };
+            {
+                unique::Thread thread { make_unique(
+                    SDL_CreateThread(allocateBlocksThread, "allocateBlocksThread", &args)) };
+                REQUIRE(thread != nullptr);
+            }
+            REQUIRE(args.blocks.size() == 1000);
+            for (void* ptr : args.blocks)
+                allocator.deallocate(ptr);
+            REQUIRE(totalLive(allocator) == 0);
+
+            std::vector<unique::Thread> threads;
+            for (int i {}; i < 4; ++i) {
+                threads.push_back(make_unique(
+                    SDL_CreateThread(churnBlocksThread, "churnBlocksThread", &allocator)));
+                REQUIRE(threads.back() != nullptr);
+            }
+            threads.clear();
+            REQUIRE(totalLive(allocator) == 0);
+            REQUIRE(allocator.stats()[0].allocs + allocator.stats()[1].allocs > 0);
+        }
+    }
+
+    SDL_Quit();
+}
+
+TEST_CASE("SDL core allocator hooks: installSdlPoolAllocator",
+    "[sdl2_memory_util][SDL2][core][PoolAllocator]")
+{
+    // must not allocate with SDL between install and uninstall, as SDL may
+    //   already hold memory from previous tests
+    SDL_malloc_func stock_malloc {};
+    SDL_calloc_func stock_calloc {};
+    SDL_realloc_func stock_realloc {};
+    SDL_free_func stock_free {};
+    SDL_GetMemoryFunctions(&stock_malloc, &stock_calloc, &stock_realloc, &stock_free);
+
+    const std::int64_t allocs_before { sdlPoolAllocator().stats()[1].allocs };
+    installSdlPoolAllocator();
+    REQUIRE(sdlPoolAllocatorInstalled());
+    void* ptr { SDL_malloc(20) };
+    REQUIRE(ptr != nullptr);
+    SDL_free(ptr);
+    uninstallSdlPoolAllocator();
+    REQUIRE_FALSE(sdlPoolAllocatorInstalled());
+    REQUIRE(sdlPoolAllocator().stats()[1].allocs - allocs_before == 1);
+
+    SDL_malloc_func restored_malloc {};
+    SDL_calloc_func restored_calloc {};
+    SDL_realloc_func restored_realloc {};
+    SDL_free_func restored_free {};
+    SDL_GetMemoryFunctions(&restored_malloc, &restored_calloc, &restored_realloc,
+                           &restored_free);
+    REQUIRE(restored_malloc == stock_malloc);
+    REQUIRE(restored_free == stock_free);
+}
+
+// Approximates the allocations SDL makes loading a scene's assets: per
+//   asset a surface, pixel format, RWops, name and pixels, with a palette
+//   for every fourth, all freed again on unload.
+template<typename Alloc, typename Free>
+static std::size_t loadUnloadScene(std::vector<void*>& blocks, Alloc alloc, Free free) {
+    static constexpr std::size_t ASSET_CT { 500 };
+    for (std::size_t i {}; i < ASSET_CT; ++i) {
+        blocks.push_back(alloc(96));                        // SDL_Surface
+        blocks.push_back(alloc(56));                        // SDL_PixelFormat
+        blocks.push_back(alloc(120));                       // SDL_RWops
+        blocks.push_back(alloc(24 + i % 40));               // asset name
+        blocks.push_back(alloc(std::size_t(32 << (i % 4)) * 64 * 4));  // pixels
+        if (i % 4 == 0)
+            blocks.push_back(alloc(1040));                  // SDL_Palette colors
+    }
+    const std::size_t block_ct { blocks.size() };
+    for (void* ptr : blocks)
+        free(ptr);
+    blocks.clear();
+    return block_ct;
+}
+
+TEST_CASE("SDL core size-class allocation throughput: PoolAllocator",
+    "[.][benchmark][sdl2_memory_util][SDL2][core][PoolAllocator]")
+{
+    if (SDL_Init(0) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    {
+        PoolAllocator allocator;
+        std::vector<void*> blocks;
+        blocks.reserve(4096);
+
+        BENCHMARK("scene load/unload, 500 assets, malloc") {
+            return loadUnloadScene(blocks,
+                                   [](std::size_t size){ return std::malloc(size); },
+                                   [](void* ptr){ std::free(ptr); });
+        };
+        BENCHMARK("scene load/unload, 500 assets, PoolAllocator") {
+            return loadUnloadScene(blocks,
+                                   [&allocator](std::size_t size){
+                                       return allocator.allocate(size);
+                                   },
+                                   [&allocator](void* ptr){ allocator.deallocate(ptr); });
+        };
+        BENCHMARK("10000 small alloc/free pairs, malloc") {
+            std::size_t sum {};
+            for (std::size_t i {}; i < 10000; ++i) {
+                void* ptr { std::malloc(16 + i % 256) };
+                sum += reinterpret_cast<std::uintptr_t>(ptr) & 0xff;
+                std::free(ptr);
+            }
+            return sum;
+        };
+        BENCHMARK("10000 small alloc/free pairs, PoolAllocator") {
+            std::size_t sum {};
+            for (std::size_t i {}; i < 10000; ++i) {
+                void* ptr { allocator.allocate(16 + i % 256) };
+                sum += reinterpret_cast<std::uintptr_t>(ptr) & 0xff;
+                allocator.deallocate(ptr);
+            }
+            return sum;
+        };
+        SDL_Log("%s", allocator.statsReport().c_str());
+    }
+
+    SDL_Quit();
+}
@@ -0,0 +1,162 @@
+#include "audio_kernels.hh"
+#include "audio_kernels_simd.hh"
+
+#include <algorithm>      // clamp max
+#include <array>
+#include <cmath>          // fabs nearbyint
+#include <cstddef>        // size_t
+#include <cstdlib>        // abs
+#include <stdexcept>      // invalid_argument
+#include <string>
+
+
+namespace sdl2_mixer_util {
+
+// null kernels leave all samples to scalar
+struct BufferKernels {
+    std::size_t (*gain_f32)(float*, std::size_t, float, float) {};
+    std::size_t (*gain_s16)(Sint16*, std::size_t, float, float) {};
+    std::size_t (*mix_f32)(const float*, float*, std::size_t, float) {};
+    std::size_t (*mix_s16)(const Sint16*, Sint16*, std::size_t, float) {};
+    std::size_t (*peak_f32)(const float*, std::size_t, float&) {};
+    std::size_t (*peak_s16)(const Sint16*, std::size_t, int&) {};
+};
+
+static std::array<BufferKernels, SIMD_LEVEL_CT> makeBufferKernels() {
+    std::array<BufferKernels, SIMD_LEVEL_CT> kernels {};
+#ifdef SDL2_MIXER_UTILS_HAVE_SSE2
+    kernels[std::size_t(SimdLevel::Sse2)] = BufferKernels {
+        sse2::gainF32, sse2::gainS16, sse2::mixF32, sse2::mixS16,
+        sse2::peakF32, sse2::peakS16
+    };
+#endif
+#ifdef SDL2_MIXER_UTILS_HAVE_AVX2
+    kernels[std::size_t(SimdLevel::Avx2)] = BufferKernels {
+        avx2::gainF32, avx2::gainS16, avx2::mixF32, avx2::mixS16,
+        avx2::peakF32, avx2::peakS16
+    };
+#endif
+    return kernels;
+}
+
+// levels with kernels in this build
+static constexpr unsigned BUILT_SIMD_LEVELS {
+    sdl2_thread_util::simdLevelBit(SimdLevel::Scalar)
+#ifdef SDL2_MIXER_UTILS_HAVE_SSE2
+    | sdl2_thread_util::simdLevelBit(SimdLevel::Sse2)
+#endif
+#ifdef SDL2_MIXER_UTILS_HAVE_AVX2
+    | sdl2_thread_util::simdLevelBit(SimdLevel::Avx2)
+#endif
+};
+
+bool simdLevelSupported(SimdLevel level) {
+    return sdl2_thread_util::simdLevelSupported(level, BUILT_SIMD_LEVELS);
+}
+
+SimdLevel bestSimdLevel() {
+    static const SimdLevel best { sdl2_thread_util::bestSimdLevel(BUILT_SIMD_LEVELS) };
+    return best;
+}
+
+static const BufferKernels& bufferKernels(SimdLevel level, const char* func_name) {
+    static const std::array<BufferKernels, SIMD_LEVEL_CT> kernels { makeBufferKernels() };
+    if (!simdLevelSupported(level)) {
+        throw std::invalid_argument(std::string(func_name) + ": " +
+                                    simdLevelName(level) + " not supported");
+    }
+    return kernels[std::size_t(level)];
+}
+
+static void checkGain(const float gain, const char* func_name) {
+    // also rejects NaN
+    if (!(std::fabs(gain) <= MAX_GAIN))
+        throw std::invalid_argument(std::string(func_name) + ": gain beyond MAX_GAIN");
+}
+
+static Sint16 saturate(const int sample) {
+    return Sint16(std::clamp(sample, -32768, 32767));
+}
+
+// rounded to nearest even, as SIMD conversions are in the default rounding mode
+static int scaled(const Sint16 sample, const float gain) {
+    return int(std::nearbyint(float(sample) * gain));
+}
+
+static void gainF32(float* samples, std::size_t count, float even_gain, float odd_gain,
+                    SimdLevel level, const char* func_name) {
+    checkGain(even_gain, func_name);
+    checkGain(odd_gain, func_name);
+    const auto kernel { bufferKernels(level, func_name).gain_f32 };
+    for (std::size_t i { kernel ? kernel(samples, count, even_gain, odd_gain) : 0 };
+         i < count; ++i) {
+        samples[i] *= (i % 2 == 0) ? even_gain : odd_gain;
+    }
+}
+
+static void gainS16(Sint16* samples, std::size_t count, float even_gain, float odd_gain,
+                    SimdLevel level, const char* func_name) {
+    checkGain(even_gain, func_name);
+    checkGain(odd_gain, func_name);
+    const auto kernel { bufferKernels(level, func_name).gain_s16 };
+    for (std::size_t i { kernel ? kernel(samples, count, even_gain, odd_gain) : 0 };
+         i < count; ++i) {
+        samples[i] = saturate(scaled(samples[i], (i % 2 == 0) ? even_gain : odd_gain));
+    }
+}
+
+void applyGain(float* samples, std::size_t count, float gain, SimdLevel level) {
+    gainF32(samples, count, gain, gain, level, "applyGain");
+}
+
+void applyGain(Sint16* samples, std::size_t count, float gain, SimdLevel level) {
+    gainS16(samples, count, gain, gain, level, "applyGain");
+}
+
+void applyStereoGain(float* samples, std::size_t count, float left_gain, float right_gain,
+                     SimdLevel level) {
+    gainF32(samples, count, left_gain, right_gain, level, "applyStereoGain");
+}
+
+void applyStereoGain(Sint16* samples, std::size_t count, float left_gain, float right_gain,
+                     SimdLevel level) {
+    gainS16(samples, count, left_gain, right_gain, level, "applyStereoGain");
+}
+
+void mixInto(const float* src, float* dst, std::size_t count, float gain,
+             SimdLevel level) {
+    checkGain(gain, "mixInto");
+    const auto kernel { bufferKernels(level, "mixInto").mix_f32 };
+    for (std::size_t i { kernel ? kernel(src, dst, count, gain) : 0 }; i < count; ++i) {
+        // separate operations, so that no compiler fuses them into one
+        //   multiply-add rounded differently than SIMD kernels
+        const float s { src[i] * gain };
+        dst[i] = dst[i] + s;
+    }
+}
+
+void mixInto(const Sint16* src, Sint16* dst, std::size_t count, float gain,
+             SimdLevel level) {
+    checkGain(gain, "mixInto");
+    const auto kernel { bufferKernels(level, "mixInto").mix_s16 };
+    for (std::size_t i { kernel ? kernel(src, dst, count, gain) : 0 }; i < count; ++i)
+        dst[i] = saturate(int(dst[i]) + scaled(src[i], gain));
+}
+
+float peakLevel(const float* samples, std::size_t count, SimdLevel level) {
+    const auto kernel { bufferKernels(level, "peakLevel").peak_f32 };
+    float peak {};
+    for (std::size_t i { kernel ? kernel(samples, count, peak) : 0 }; i < count; ++i)
+        peak = std::max(peak, std::fabs(samples[i]));
+    return peak;
+}
+
+float peakLevel(const Sint16* samples, std::size_t count, SimdLevel level) {
+    const auto kernel { bufferKernels(level, "peakLevel").peak_s16 };
+    int peak {};
+    for (std::size_t i { kernel ? kernel(samples, count, peak) : 0 }; i < count; ++i)
+        peak = std::max(peak, std::abs(int(samples[i])));
+    return float(peak) / 32768.0f;
+}
+
+}  // namespace sdl2_mixer_util
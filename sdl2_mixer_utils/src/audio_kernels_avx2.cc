@@ -0,0 +1,121 @@
+#include "audio_kernels_simd.hh"
+
+#include <immintrin.h>  // AVX2 intrinsics
+
+#include <algorithm>    // max
+
+
+namespace sdl2_mixer_util {
+
+namespace avx2 {
+
+static constexpr std::size_t FLOATS_PER_VECTOR { 8 };
+static constexpr std::size_t SINT16S_PER_VECTOR { 16 };
+
+static __m256i loadS16(const Sint16* src) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+}
+
+static void storeS16(Sint16* dst, const __m256i v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), v);
+}
+
+// sign extending Sint16 -> int32 of low or high 8 samples
+static __m256i lowToInt32(const __m256i v) {
+    return _mm256_cvtepi16_epi32(_mm256_castsi256_si128(v));
+}
+
+static __m256i highToInt32(const __m256i v) {
+    return _mm256_cvtepi16_epi32(_mm256_extracti128_si256(v, 1));
+}
+
+// packs works within 128-bit lanes, so samples are put back in order after
+static __m256i packS16(const __m256i lo, const __m256i hi) {
+    return _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+std::size_t gainF32(float* samples, std::size_t count, float even_gain, float odd_gain) {
+    const __m256 gains { _mm256_setr_ps(even_gain, odd_gain, even_gain, odd_gain,
+                                        even_gain, odd_gain, even_gain, odd_gain) };
+    std::size_t i {};
+    for (; i + FLOATS_PER_VECTOR <= count; i += FLOATS_PER_VECTOR)
+        _mm256_storeu_ps(samples + i, _mm256_mul_ps(_mm256_loadu_ps(samples + i), gains));
+    return i;
+}
+
+std::size_t gainS16(Sint16* samples, std::size_t count, float even_gain, float odd_gain) {
+    const __m256 gains { _mm256_setr_ps(even_gain, odd_gain, even_gain, odd_gain,
+                                        even_gain, odd_gain, even_gain, odd_gain) };
+    std::size_t i {};
+    for (; i + SINT16S_PER_VECTOR <= count; i += SINT16S_PER_VECTOR) {
+        const __m256i v { loadS16(samples + i) };
+        const __m256 lo { _mm256_mul_ps(_mm256_cvtepi32_ps(lowToInt32(v)), gains) };
+        const __m256 hi { _mm256_mul_ps(_mm256_cvtepi32_ps(highToInt32(v)), gains) };
+        storeS16(samples + i, packS16(_mm256_cvtps_epi32(lo), _mm256_cvtps_epi32(hi)));
+    }
+    return i;
+}
+
+std::size_t mixF32(const float* src, float* dst, std::size_t count, float gain) {
+    const __m256 g { _mm256_set1_ps(gain) };
+    std::size_t i {};
+    for (; i + FLOATS_PER_VECTOR <= count; i += FLOATS_PER_VECTOR) {
+        const __m256 scaled { _mm256_mul_ps(_mm256_loadu_ps(src + i), g) };
+        _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), scaled));
+    }
+    return i;
+}
+
+std::size_t mixS16(const Sint16* src, Sint16* dst, std::size_t count, float gain) {
+    const __m256 g { _mm256_set1_ps(gain) };
+    std::size_t i {};
+    for (; i + SINT16S_PER_VECTOR <= count; i += SINT16S_PER_VECTOR) {
+        const __m256i s { loadS16(src + i) };
+        const __m256i d { loadS16(dst + i) };
+        const __m256i lo { _mm256_add_epi32(
+                _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(lowToInt32(s)), g)),
+                lowToInt32(d)) };
+        const __m256i hi { _mm256_add_epi32(
+                _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(highToInt32(s)), g)),
+                highToInt32(d)) };
+        storeS16(dst + i, packS16(lo, hi));
+    }
+    return i;
+}
+
+std::size_t peakF32(const float* samples, std::size_t count, float& peak) {
+    const __m256 abs_mask { _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF)) };
+    __m256 peaks { _mm256_set1_ps(peak) };
+    std::size_t i {};
+    for (; i + FLOATS_PER_VECTOR <= count; i += FLOATS_PER_VECTOR) {
+        // NaN magnitudes as first operand are ignored, as by the scalar kernel
+        peaks = _mm256_max_ps(_mm256_and_ps(_mm256_loadu_ps(samples + i), abs_mask), peaks);
+    }
+    alignas(32) float lanes[FLOATS_PER_VECTOR];
+    _mm256_store_ps(lanes, peaks);
+    for (const float lane : lanes)
+        peak = std::max(peak, lane);
+    return i;
+}
+
+std::size_t peakS16(const Sint16* samples, std::size_t count, int& peak) {
+    __m256i highs { _mm256_setzero_si256() };
+    __m256i lows { _mm256_setzero_si256() };
+    std::size_t i {};
+    for (; i + SINT16S_PER_VECTOR <= count; i += SINT16S_PER_VECTOR) {
+        const __m256i v { loadS16(samples + i) };
+        highs = _mm256_max_epi16(highs, v);
+        lows = _mm256_min_epi16(lows, v);
+    }
+    alignas(32) Sint16 high_lanes[SINT16S_PER_VECTOR];
+    alignas(32) Sint16 low_lanes[SINT16S_PER_VECTOR];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(high_lanes), highs);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(low_lanes), lows);
+    for (std::size_t lane {}; lane < SINT16S_PER_VECTOR; ++lane)
+        peak = std::max({ peak, int(high_lanes[lane]), -int(low_lanes[lane]) });
+    return i;
+}
+
+}  // namespace avx2
+
+}  // namespace sdl2_mixer_util
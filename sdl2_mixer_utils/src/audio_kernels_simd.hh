@@ -0,0 +1,46 @@
+#ifndef AUDIO_KERNELS_SIMD_HH
+#define AUDIO_KERNELS_SIMD_HH
+
+#include "SDL_stdinc.h"  // Sint16
+
+#include <cstddef>       // size_t
+
+
+/*
+ * Per instruction set buffer kernels, each compiled in its own translation
+ *   unit with the matching compiler flags, see src/CMakeLists.txt. They
+ *   process as many whole vectors as fit in count, returning the number of
+ *   samples done, and leave the rest to the scalar kernels in
+ *   audio_kernels.cc. Gain kernels take separate gains for even and odd
+ *   samples, so that one kernel serves both mono gain and stereo balance,
+ *   and peak kernels raise peak to the largest magnitude seen.
+ */
+
+namespace sdl2_mixer_util {
+
+namespace sse2 {
+
+std::size_t gainF32(float* samples, std::size_t count, float even_gain, float odd_gain);
+std::size_t gainS16(Sint16* samples, std::size_t count, float even_gain, float odd_gain);
+std::size_t mixF32(const float* src, float* dst, std::size_t count, float gain);
+std::size_t mixS16(const Sint16* src, Sint16* dst, std::size_t count, float gain);
+std::size_t peakF32(const float* samples, std::size_t count, float& peak);
+std::size_t peakS16(const Sint16* samples, std::size_t count, int& peak);
+
+}  // namespace sse2
+
+namespace avx2 {
+
+std::size_t gainF32(float* samples, std::size_t count, float even_gain, float odd_gain);
+std::size_t gainS16(Sint16* samples, std::size_t count, float even_gain, float odd_gain);
+std::size_t mixF32(const float* src, float* dst, std::size_t count, float gain);
+std::size_t mixS16(const Sint16* src, Sint16* dst, std::size_t count, float gain);
+std::size_t peakF32(const float* samples, std::size_t count, float& peak);
+std::size_t peakS16(const Sint16* samples, std::size_t count, int& peak);
+
+}  // namespace avx2
+
+}  // namespace sdl2_mixer_util
+
+
+#endif  // AUDIO_KERNELS_SIMD_HH
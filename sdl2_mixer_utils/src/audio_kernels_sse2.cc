@@ -0,0 +1,116 @@
+#include "audio_kernels_simd.hh"
+
+#include <emmintrin.h>  // SSE2 intrinsics
+
+#include <algorithm>    // max
+
+
+namespace sdl2_mixer_util {
+
+namespace sse2 {
+
+static constexpr std::size_t FLOATS_PER_VECTOR { 4 };
+static constexpr std::size_t SINT16S_PER_VECTOR { 8 };
+
+static __m128i loadS16(const Sint16* src) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+}
+
+static void storeS16(Sint16* dst, const __m128i v) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), v);
+}
+
+// sign extending Sint16 -> float of low or high 4 samples
+static __m128 lowToFloat(const __m128i v) {
+    return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16));
+}
+
+static __m128 highToFloat(const __m128i v) {
+    return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16));
+}
+
+// cvtps rounds to nearest even (default MXCSR), and packs saturates
+static __m128i toS16(const __m128 lo, const __m128 hi) {
+    return _mm_packs_epi32(_mm_cvtps_epi32(lo), _mm_cvtps_epi32(hi));
+}
+
+std::size_t gainF32(float* samples, std::size_t count, float even_gain, float odd_gain) {
+    const __m128 gains { _mm_setr_ps(even_gain, odd_gain, even_gain, odd_gain) };
+    std::size_t i {};
+    for (; i + FLOATS_PER_VECTOR <= count; i += FLOATS_PER_VECTOR)
+        _mm_storeu_ps(samples + i, _mm_mul_ps(_mm_loadu_ps(samples + i), gains));
+    return i;
+}
+
+std::size_t gainS16(Sint16* samples, std::size_t count, float even_gain, float odd_gain) {
+    const __m128 gains { _mm_setr_ps(even_gain, odd_gain, even_gain, odd_gain) };
+    std::size_t i {};
+    for (; i + SINT16S_PER_VECTOR <= count; i += SINT16S_PER_VECTOR) {
+        const __m128i v { loadS16(samples + i) };
+        storeS16(samples + i, toS16(_mm_mul_ps(lowToFloat(v), gains),
+                                    _mm_mul_ps(highToFloat(v), gains)));
+    }
+    return i;
+}
+
+std::size_t mixF32(const float* src, float* dst, std::size_t count, float gain) {
+    const __m128 g { _mm_set1_ps(gain) };
+    std::size_t i {};
+    for (; i + FLOATS_PER_VECTOR <= count; i += FLOATS_PER_VECTOR) {
+        const __m128 scaled { _mm_mul_ps(_mm_loadu_ps(src + i), g) };
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), scaled));
+    }
+    return i;
+}
+
+std::size_t mixS16(const Sint16* src, Sint16* dst, std::size_t count, float gain) {
+    const __m128 g { _mm_set1_ps(gain) };
+    std::size_t i {};
+    for (; i + SINT16S_PER_VECTOR <= count; i += SINT16S_PER_VECTOR) {
+        const __m128i s { loadS16(src + i) };
+        const __m128i d { loadS16(dst + i) };
+        const __m128i lo { _mm_add_epi32(_mm_cvtps_epi32(_mm_mul_ps(lowToFloat(s), g)),
+                                         _mm_srai_epi32(_mm_unpacklo_epi16(d, d), 16)) };
+        const __m128i hi { _mm_add_epi32(_mm_cvtps_epi32(_mm_mul_ps(highToFloat(s), g)),
+                                         _mm_srai_epi32(_mm_unpackhi_epi16(d, d), 16)) };
+        storeS16(dst + i, _mm_packs_epi32(lo, hi));
+    }
+    return i;
+}
+
+std::size_t peakF32(const float* samples, std::size_t count, float& peak) {
+    const __m128 abs_mask { _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF)) };
+    __m128 peaks { _mm_set1_ps(peak) };
+    std::size_t i {};
+    for (; i + FLOATS_PER_VECTOR <= count; i += FLOATS_PER_VECTOR) {
+        // NaN magnitudes as first operand are ignored, as by the scalar kernel
+        peaks = _mm_max_ps(_mm_and_ps(_mm_loadu_ps(samples + i), abs_mask), peaks);
+    }
+    alignas(16) float lanes[FLOATS_PER_VECTOR];
+    _mm_store_ps(lanes, peaks);
+    for (const float lane : lanes)
+        peak = std::max(peak, lane);
+    return i;
+}
+
+std::size_t peakS16(const Sint16* samples, std::size_t count, int& peak) {
+    __m128i highs { _mm_setzero_si128() };
+    __m128i lows { _mm_setzero_si128() };
+    std::size_t i {};
+    for (; i + SINT16S_PER_VECTOR <= count; i += SINT16S_PER_VECTOR) {
+        const __m128i v { loadS16(samples + i) };
+        highs = _mm_max_epi16(highs, v);
+        lows = _mm_min_epi16(lows, v);
+    }
+    alignas(16) Sint16 high_lanes[SINT16S_PER_VECTOR];
+    alignas(16) Sint16 low_lanes[SINT16S_PER_VECTOR];
+    _mm_store_si128(reinterpret_cast<__m128i*>(high_lanes), highs);
+    _mm_store_si128(reinterpret_cast<__m128i*>(low_lanes), lows);
+    for (std::size_t lane {}; lane < SINT16S_PER_VECTOR; ++lane)
+        peak = std::max({ peak, int(high_lanes[lane]), -int(low_lanes[lane]) });
+    return i;
+}
+
+}  // namespace sse2
+
+}  // namespace sdl2_mixer_util
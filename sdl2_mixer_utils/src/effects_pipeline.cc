@@ -0,0 +1,234 @@
+#include "effects_pipeline.hh"
+
+#include "safeSdlCall.hh"
+
+#include "SDL_mixer.h"  // Mix_QuerySpec Mix_RegisterEffect Mix_SetPostMix MIX_CHANNEL_POST
+#include "SDL_timer.h"  // SDL_GetPerformanceCounter SDL_GetPerformanceFrequency
+
+#include <algorithm>    // max min
+#include <cmath>        // pow
+#include <stdexcept>    // invalid_argument
+#include <string>
+
+
+namespace sdl2_mixer_util {
+
+// hook_ values other than channels
+static constexpr int DETACHED { MIX_CHANNEL_POST - 1 };
+static constexpr int POST_MIX { MIX_CHANNEL_POST - 2 };
+
+// gain changes are spread across this many steps of each buffer
+static constexpr std::size_t RAMP_STEP_CT { 8 };
+// limiter gain reduction recovers 20 dB per second
+static constexpr float LIMITER_RELEASE_PER_SECOND { 10.0f };
+static constexpr float MIN_LIMIT { 0.001f };
+
+static void checkSpec(const int frequency, const SDL_AudioFormat format, const int channels,
+                      const SimdLevel level) {
+    if (frequency < 1 || channels < 1)
+        throw std::invalid_argument("EffectsPipeline: frequency and channels must be positive");
+    if (format != AUDIO_S16SYS && format != AUDIO_F32SYS)
+        throw std::invalid_argument("EffectsPipeline: format must be AUDIO_S16SYS or AUDIO_F32SYS");
+    if (!simdLevelSupported(level)) {
+        throw std::invalid_argument(std::string("EffectsPipeline: ") +
+                                    simdLevelName(level) + " not supported");
+    }
+}
+
+// NaN to lowest
+static float clampParameter(const float value, const float lowest, const float highest) {
+    return (value >= lowest) ? std::min(value, highest) : lowest;
+}
+
+EffectsPipeline::EffectsPipeline(SimdLevel level) :
+    frequency_(), format_(), channels_(), level_(level), hook_(DETACHED) {
+    safeSdlCall(Mix_QuerySpec, "Mix_QuerySpec",
+                SdlRetTest<int>{ [](const int ret){ return (ret == 0); } },
+                &frequency_, &format_, &channels_);
+    checkSpec(frequency_, format_, channels_, level_);
+}
+
+EffectsPipeline::EffectsPipeline(int frequency, SDL_AudioFormat format, int channels,
+                                 SimdLevel level) :
+    frequency_(frequency), format_(format), channels_(channels), level_(level),
+    hook_(DETACHED) {
+    checkSpec(frequency_, format_, channels_, level_);
+}
+
+EffectsPipeline::~EffectsPipeline() {
+    detach();
+}
+
+void EffectsPipeline::attach(int channel) {
+    detach();
+    // set first, as the channel could finish and call effectDone before
+    //   Mix_RegisterEffect returns
+    hook_.store(channel);
+    try {
+        safeSdlCall(Mix_RegisterEffect, "Mix_RegisterEffect",
+                    SdlRetTest<int>{ [](const int ret){ return (ret == 0); } },
+                    channel, effect, effectDone, static_cast<void*>(this));
+    } catch (...) {
+        hook_.store(DETACHED);
+        throw;
+    }
+}
+
+void EffectsPipeline::attachPostMix() {
+    detach();
+    hook_.store(POST_MIX);
+    Mix_SetPostMix(postMix, this);
+}
+
+void EffectsPipeline::detach() {
+    // both lock out the audio callback, so process() is not running once
+    //   they return
+    const int hook { hook_.exchange(DETACHED) };
+    if (hook == POST_MIX) {
+        Mix_SetPostMix(nullptr, nullptr);
+    } else if (hook != DETACHED) {
+        // fails harmlessly if SDL_mixer removed the effect meanwhile
+        Mix_UnregisterEffect(hook, effect);
+    }
+}
+
+bool EffectsPipeline::attached() const {
+    return hook_.load() != DETACHED;
+}
+
+void EffectsPipeline::postMix(void* udata, Uint8* stream, int len) {
+    static_cast<EffectsPipeline*>(udata)->process(stream, len);
+}
+
+void EffectsPipeline::effect(int /*channel*/, void* stream, int len, void* udata) {
+    static_cast<EffectsPipeline*>(udata)->process(stream, len);
+}
+
+void EffectsPipeline::effectDone(int channel, void* udata) {
+    // also called when the effect is unregistered, by which point hook_ has
+    //   already changed
+    int expected { channel };
+    static_cast<EffectsPipeline*>(udata)->hook_.compare_exchange_strong(expected, DETACHED);
+}
+
+void EffectsPipeline::setGain(float gain) {
+    gain_.store(clampParameter(gain, 0.0f, MAX_GAIN), std::memory_order_relaxed);
+}
+
+void EffectsPipeline::setDuck(float gain) {
+    duck_.store(clampParameter(gain, 0.0f, 1.0f), std::memory_order_relaxed);
+}
+
+void EffectsPipeline::setPan(float pan) {
+    pan_.store(clampParameter(pan, -1.0f, 1.0f), std::memory_order_relaxed);
+}
+
+void EffectsPipeline::setLimit(float ceiling) {
+    ceiling_.store(clampParameter(ceiling, MIN_LIMIT, 1.0f), std::memory_order_relaxed);
+}
+
+float EffectsPipeline::takePeak() {
+    return peak_.exchange(0.0f, std::memory_order_relaxed);
+}
+
+EffectsPipeline::Timing EffectsPipeline::timing() const {
+    return Timing {
+        last_fraction_.load(std::memory_order_relaxed),
+        max_fraction_.load(std::memory_order_relaxed),
+        buffer_ct_.load(std::memory_order_relaxed)
+    };
+}
+
+void EffectsPipeline::resetTiming() {
+    last_fraction_.store(0.0f, std::memory_order_relaxed);
+    max_fraction_.store(0.0f, std::memory_order_relaxed);
+    buffer_ct_.store(0, std::memory_order_relaxed);
+}
+
+// raises a value that may be concurrently lowered by another thread
+static void raiseTo(std::atomic<float>& value, const float raised) {
+    float current { value.load(std::memory_order_relaxed) };
+    while (raised > current &&
+           !value.compare_exchange_weak(current, raised, std::memory_order_relaxed)) {}
+}
+
+void EffectsPipeline::process(void* stream, int len) noexcept {
+    const Uint64 start { SDL_GetPerformanceCounter() };
+    if (stream == nullptr || len <= 0)
+        return;
+    std::size_t count {};
+    if (format_ == AUDIO_F32SYS) {
+        count = std::size_t(len) / sizeof(float);
+        processSamples(static_cast<float*>(stream), count);
+    } else {
+        count = std::size_t(len) / sizeof(Sint16);
+        processSamples(static_cast<Sint16*>(stream), count);
+    }
+    recordTiming(start, count / std::size_t(channels_));
+}
+
+template<typename Sample>
+void EffectsPipeline::processSamples(Sample* samples, std::size_t count) noexcept {
+    const std::size_t channel_ct { std::size_t(channels_) };
+    const std::size_t frame_ct { count / channel_ct };
+    const float gain { gain_.load(std::memory_order_relaxed) *
+                       duck_.load(std::memory_order_relaxed) };
+    float left { gain };
+    float right { gain };
+    if (channels_ == 2) {
+        const float pan { pan_.load(std::memory_order_relaxed) };
+        left *= std::min(1.0f, 1.0f - pan);
+        right *= std::min(1.0f, 1.0f + pan);
+    }
+
+    // highest gain keeping the buffer's peak at or under the ceiling
+    const float ceiling { ceiling_.load(std::memory_order_relaxed) };
+    const float in_peak { peakLevel(samples, frame_ct * channel_ct, level_) };
+    const float safe_gain { (in_peak * MAX_GAIN > ceiling) ? ceiling / in_peak : MAX_GAIN };
+    const float loudest { std::max(left, right) };
+    if (loudest * limiter_gain_ > safe_gain)
+        limiter_gain_ = safe_gain / loudest;
+    left *= limiter_gain_;
+    right *= limiter_gain_;
+
+    const float from_left { ramp_from_last_ ? last_left_ : left };
+    const float from_right { ramp_from_last_ ? last_right_ : right };
+    const std::size_t step_ct {
+        (from_left == left && from_right == right) ? 1 : RAMP_STEP_CT };
+    float applied_max {};
+    for (std::size_t step {}; step < step_ct; ++step) {
+        const std::size_t begin { frame_ct * step / step_ct };
+        const std::size_t end { frame_ct * (step + 1) / step_ct };
+        const float t { float(step + 1) / float(step_ct) };
+        const float step_left { std::min(from_left + (left - from_left) * t, safe_gain) };
+        const float step_right { std::min(from_right + (right - from_right) * t, safe_gain) };
+        if (channels_ == 2) {
+            applyStereoGain(samples + begin * 2, (end - begin) * 2, step_left, step_right,
+                            level_);
+        } else {
+            applyGain(samples + begin * channel_ct, (end - begin) * channel_ct, step_left,
+                      level_);
+        }
+        applied_max = std::max({ applied_max, step_left, step_right });
+    }
+    raiseTo(peak_, in_peak * applied_max);
+
+    last_left_ = left;
+    last_right_ = right;
+    ramp_from_last_ = true;
+    limiter_gain_ = std::min(1.0f, limiter_gain_ * std::pow(
+        LIMITER_RELEASE_PER_SECOND, float(frame_ct) / float(frequency_)));
+}
+
+void EffectsPipeline::recordTiming(Uint64 start, std::size_t frame_ct) noexcept {
+    if (frame_ct == 0)
+        return;
+    const double seconds {
+        double(SDL_GetPerformanceCounter() - start) / double(SDL_GetPerformanceFrequency()) };
+    const float fraction { float(seconds * frequency_ / double(frame_ct)) };
+    last_fraction_.store(fraction, std::memory_order_relaxed);
+    raiseTo(max_fraction_, fraction);
+    buffer_ct_.fetch_add(1, std::memory_order_relaxed);
+}
+
+}  // namespace sdl2_mixer_util
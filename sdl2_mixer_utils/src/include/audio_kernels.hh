@@ -0,0 +1,60 @@
+#ifndef AUDIO_KERNELS_HH
+#define AUDIO_KERNELS_HH
+
+#include "simd_level.hh"  // SimdLevel
+
+#include "SDL_stdinc.h"  // Sint16
+
+#include <cstddef>       // size_t
+
+
+namespace sdl2_mixer_util {
+
+// kernels are built for Scalar, Sse2 and Avx2, with bit-identical results
+//   at every level
+using sdl2_thread_util::SimdLevel;
+using sdl2_thread_util::SIMD_LEVEL_CT;
+using sdl2_thread_util::simdLevelName;
+
+// highest level supported by both build and CPU, detected once
+SimdLevel bestSimdLevel();
+bool simdLevelSupported(SimdLevel level);
+
+// largest gain magnitude kernels accept, keeping scaled Sint16 samples well
+//   within int32 range before saturation
+constexpr float MAX_GAIN { 16.0f };
+
+/*
+ * Buffer kernels for AUDIO_F32SYS and AUDIO_S16SYS samples, as passed to
+ *   Mix_RegisterEffect and Mix_SetPostMix callbacks. count is in samples,
+ *   not bytes or frames, and float samples are full scale at 1.0. Sint16
+ *   results are rounded to nearest and saturated. Kernels make no allocations
+ *   and take no locks, for use on the audio thread.
+ *
+ * Passing a level the build or CPU doesn't support, or a gain beyond
+ *   MAX_GAIN, throws std::invalid_argument.
+ */
+
+// samples *= gain
+void applyGain(float* samples, std::size_t count, float gain,
+               SimdLevel level = bestSimdLevel());
+void applyGain(Sint16* samples, std::size_t count, float gain,
+               SimdLevel level = bestSimdLevel());
+// interleaved stereo, with left_gain for even samples and right_gain for odd
+void applyStereoGain(float* samples, std::size_t count, float left_gain, float right_gain,
+                     SimdLevel level = bestSimdLevel());
+void applyStereoGain(Sint16* samples, std::size_t count, float left_gain, float right_gain,
+                     SimdLevel level = bestSimdLevel());
+// dst += src * gain; src and dst may be the same buffer
+void mixInto(const float* src, float* dst, std::size_t count, float gain,
+             SimdLevel level = bestSimdLevel());
+void mixInto(const Sint16* src, Sint16* dst, std::size_t count, float gain,
+             SimdLevel level = bestSimdLevel());
+// largest sample magnitude, with full scale 1.0 (so 32768 for Sint16)
+float peakLevel(const float* samples, std::size_t count, SimdLevel level = bestSimdLevel());
+float peakLevel(const Sint16* samples, std::size_t count, SimdLevel level = bestSimdLevel());
+
+}  // namespace sdl2_mixer_util
+
+
+#endif  // AUDIO_KERNELS_HH
@@ -0,0 +1,118 @@
+#ifndef EFFECTS_PIPELINE_HH
+#define EFFECTS_PIPELINE_HH
+
+#include "audio_kernels.hh"  // SimdLevel bestSimdLevel
+
+#include "SDL_audio.h"       // SDL_AudioFormat
+#include "SDL_stdinc.h"      // Uint8 Uint64
+
+#include <atomic>
+#include <cstddef>           // size_t
+#include <cstdint>           // uint64_t
+
+
+namespace sdl2_mixer_util {
+
+// Gain, ducking, stereo balance and peak limiting of AUDIO_S16SYS or
+//   AUDIO_F32SYS audio, as an effect on a channel or MIX_CHANNEL_POST, or as
+//   the Mix_SetPostMix callback. Parameters are atomics settable from any
+//   thread, so process() doesn't allocate, lock or throw; Timing reports its
+//   share of each buffer's playback time. Only one per channel, as
+//   Mix_UnregisterEffect matches by function.
+class EffectsPipeline {
+public:
+    struct Timing {
+        // fractions of each buffer's playback time spent processing it
+        float last {};
+        float max {};
+        std::uint64_t buffer_ct {};
+    };
+
+    // in the format of the open audio device, from Mix_QuerySpec
+    explicit EffectsPipeline(SimdLevel level = bestSimdLevel());
+    // format must be AUDIO_S16SYS or AUDIO_F32SYS, else throws
+    //   std::invalid_argument
+    EffectsPipeline(int frequency, SDL_AudioFormat format, int channels,
+                    SimdLevel level = bestSimdLevel());
+    ~EffectsPipeline();
+
+    // callbacks keep this pointer
+    EffectsPipeline(const EffectsPipeline&) = delete;
+    EffectsPipeline& operator=(const EffectsPipeline&) = delete;
+
+    // Mix_RegisterEffect on channel, detaching first if attached; SDL_mixer
+    //   removes channel effects itself when the channel finishes playing
+    void attach(int channel);
+    // replaces any callback set with Mix_SetPostMix
+    void attachPostMix();
+    // safe to call whether or not still attached
+    void detach();
+    bool attached() const;
+
+    // processes len bytes of samples in place, as all hooks do
+    void process(void* stream, int len) noexcept;
+
+    // linear, clamped to 0 to MAX_GAIN
+    void setGain(float gain);
+    // linear, clamped to 0 to 1, applied on top of gain
+    void setDuck(float gain);
+    // -1 (left) to 1 (right) as stereo balance, attenuating the other side
+    //   linearly, so 0 leaves both at unity; ignored unless 2 channels
+    void setPan(float pan);
+    // peak ceiling, clamped to 1/1000 to 1 of full scale; at the default 1,
+    //   only keeps F32 samples from exceeding full scale
+    void setLimit(float ceiling);
+    float gain() const { return gain_.load(std::memory_order_relaxed); }
+    float duck() const { return duck_.load(std::memory_order_relaxed); }
+    float pan() const { return pan_.load(std::memory_order_relaxed); }
+    float limit() const { return ceiling_.load(std::memory_order_relaxed); }
+
+    // highest output peak since the last call, with full scale 1.0
+    float takePeak();
+    Timing timing() const;
+    void resetTiming();
+
+    int frequency() const { return frequency_; }
+    SDL_AudioFormat format() const { return format_; }
+    int channels() const { return channels_; }
+    SimdLevel simdLevel() const { return level_; }
+
+    // Mix_SetPostMix callback, with EffectsPipeline* as udata
+    static void postMix(void* udata, Uint8* stream, int len);
+
+private:
+    static void effect(int channel, void* stream, int len, void* udata);
+    static void effectDone(int channel, void* udata);
+
+    template<typename Sample>
+    void processSamples(Sample* samples, std::size_t count) noexcept;
+    void recordTiming(Uint64 start, std::size_t frame_ct) noexcept;
+
+    int frequency_;
+    SDL_AudioFormat format_;
+    int channels_;
+    SimdLevel level_;
+
+    std::atomic<float> gain_ { 1.0f };
+    std::atomic<float> duck_ { 1.0f };
+    std::atomic<float> pan_ { 0.0f };
+    std::atomic<float> ceiling_ { 1.0f };
+    std::atomic<float> peak_ {};
+    std::atomic<float> last_fraction_ {};
+    std::atomic<float> max_fraction_ {};
+    std::atomic<std::uint64_t> buffer_ct_ {};
+    // channel for Mix_UnregisterEffect, or DETACHED or POST_MIX
+    std::atomic<int> hook_;
+
+    // audio thread only: gains applied at end of last buffer, and limiter
+    //   gain reduction recovering toward 1
+    float last_left_ {};
+    float last_right_ {};
+    bool ramp_from_last_ {};
+    float limiter_gain_ { 1.0f };
+};
+
+}  // namespace sdl2_mixer_util
+
+
+#endif  // EFFECTS_PIPELINE_HH
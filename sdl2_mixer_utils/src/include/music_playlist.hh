@@ -0,0 +1,170 @@
+#ifndef MUSIC_PLAYLIST_HH
+#define MUSIC_PLAYLIST_HH
+
+#include "sdl2_mixer_smart_ptr.hh"  // unique::MixChunk
+
+#include "SDL_stdinc.h"             // Uint8 Uint16 Uint32
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>                  // size_t
+#include <cstdint>                  // uint64_t SIZE_MAX
+#include <memory>                   // unique_ptr
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace sdl2_mixer_util {
+
+/*
+ * Plays a list of music files back to back without gaps, with the next track
+ *   opened and decoded on a background thread while the current one plays,
+ *   so that file access and decoding never block the caller or the audio
+ *   thread.
+ *
+ * Each file is memory mapped, its pages read in, and decoded whole to the
+ *   device's format by Mix_LoadWAV_RW from the mapping, as SDL_mixer has no
+ *   way to take decoded samples from a Mix_Music. A track so holds its length
+ *   in samples, about 10MiB a minute at 44.1kHz 16-bit stereo, and up to
+ *   three are held at once around a crossfade. Tracks are mixed by a
+ *   Mix_HookMusic callback, which continues from the end of one into the
+ *   start of the prefetched next within the same audio buffer. With a
+ *   crossfade set, the next track starts that long before the current one's
+ *   end, or on skip(), and the two overlap with linear fades. As no Mix_Music
+ *   plays, Mix_VolumeMusic and Mix_HookMusicFinished don't apply; use
+ *   setVolume() instead.
+ *
+ * If the next track is not ready in time, it starts as soon as it is,
+ *   counted in Stats::late. Tracks that fail to load are skipped, with the
+ *   error kept for lastError(). The callback takes no locks and frees
+ *   nothing; finished tracks are freed by the background thread.
+ *
+ * As SDL_mixer takes only one Mix_HookMusic callback, only one MusicPlaylist
+ *   may exist at a time, and Mix_PlayMusic must not be used alongside it.
+ *   Requires an open audio device, and should be destroyed before
+ *   Mix_CloseAudio.
+ */
+class MusicPlaylist {
+public:
+    struct Stats {
+        // tracks started
+        std::uint64_t played {};
+        // tracks started in the same audio buffer as the previous one's end,
+        //   or overlapping it when crossfading
+        std::uint64_t gapless {};
+        // tracks not ready by the previous one's end
+        std::uint64_t late {};
+        // tracks that failed to load
+        std::uint64_t failed {};
+    };
+
+    static constexpr std::size_t NO_TRACK { SIZE_MAX };
+
+    // repeat to play from the first track again after the last
+    explicit MusicPlaylist(std::vector<std::string> paths,
+                           std::chrono::milliseconds crossfade = {}, bool repeat = false);
+    ~MusicPlaylist();
+
+    MusicPlaylist(const MusicPlaylist&) = delete;
+    MusicPlaylist& operator=(const MusicPlaylist&) = delete;
+
+    // play, stop and skip only signal the background thread and audio
+    //   callback, so return without waiting on SDL_mixer or the disk
+
+    // continues from the next track not yet played
+    void play();
+    // halts music, finishing current track
+    void stop();
+    // moves to next track, fading if a crossfade is set
+    void skip();
+
+    // clamped to 0 to MIX_MAX_VOLUME, as with Mix_VolumeMusic
+    void setVolume(int volume);
+    int volume() const { return volume_.load(); }
+
+    // index into paths of track now playing, or NO_TRACK
+    std::size_t currentTrack() const;
+    // false once stopped, or once the last track has ended without repeat
+    bool active() const;
+    std::size_t trackCount() const { return paths_.size(); }
+
+    Stats stats() const;
+    std::string lastError() const;
+
+private:
+    struct Track {
+        std::size_t index {};
+        sdl2_smart_ptr::unique::MixChunk chunk;
+        // bytes of chunk mixed, audio callback only
+        Uint32 position {};
+        Track* next_retired {};
+    };
+
+    static void mixMusic(void* udata, Uint8* stream, int len);
+
+    // audio callback only
+    void mix(Uint8* stream, Uint32 len);
+    // takes ready_ as current_; returns false if none is ready
+    bool startNext(bool continuing);
+    // fades current_ out over length bytes, in place of any fading_
+    void fadeOut(Uint32 length);
+    void retire(Track* track);
+
+    void workLoop();
+    void freeRetired();
+    // nullptr on failure
+    std::unique_ptr<Track> load(std::size_t index);
+    void setError(const std::string& error);
+
+    const std::vector<std::string> paths_;
+    const bool repeat_;
+    Uint16 format_ {};
+    Uint32 frame_size_ {};
+    Uint32 crossfade_size_ {};
+
+    // audio callback only
+    Track* current_ {};
+    // previous track, overlapping current_ while it fades out
+    Track* fading_ {};
+    Uint32 fade_end_ {};
+    Uint32 fade_size_ {};
+    // previous track ended with none ready
+    bool starved_ {};
+
+    // prefetched next track, stored by the background thread and taken by
+    //   the audio callback
+    std::atomic<Track*> ready_ {};
+    // stack of tracks ended by the audio callback, freed by the background
+    //   thread
+    std::atomic<Track*> retired_ {};
+    std::atomic<bool> skip_requested_ {};
+    std::atomic<bool> stop_requested_ {};
+    std::atomic<int> volume_;
+    // set before ready_ is taken, so the background thread never sees both
+    //   empty while a track starts
+    std::atomic<std::size_t> current_index_ { NO_TRACK };
+    std::atomic<bool> active_ {};
+    std::atomic<std::uint64_t> played_ct_ {};
+    std::atomic<std::uint64_t> gapless_ct_ {};
+    std::atomic<std::uint64_t> late_ct_ {};
+    std::atomic<std::uint64_t> failed_ct_ {};
+
+    // never locked by the audio callback
+    mutable std::mutex mtx_;
+    std::condition_variable work_cv_;
+    // next index of paths_ to load
+    std::size_t next_index_ {};
+    // consecutive load failures, to stop once every track has failed
+    std::size_t failed_run_ {};
+    bool quit_ {};
+    std::string error_;
+    std::thread worker_;
+};
+
+}  // namespace sdl2_mixer_util
+
+
+#endif  // MUSIC_PLAYLIST_HH
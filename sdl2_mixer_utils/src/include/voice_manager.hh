@@ -0,0 +1,162 @@
+#ifndef VOICE_MANAGER_HH
+#define VOICE_MANAGER_HH
+
+#include "lock_free_queue.hh"       // SpscQueue
+#include "sdl2_mixer_smart_ptr.hh"  // shared::MixChunk
+
+#include "SDL_mixer.h"              // Mix_Chunk
+#include "SDL_stdinc.h"             // Uint16 Uint32 Uint64
+
+#include <cstddef>                  // size_t
+#include <cstdint>                  // uint64_t
+#include <unordered_map>
+#include <vector>
+
+
+namespace sdl2_mixer_util {
+
+// 32 bit handle to a voice of a VoiceManager, with index in the low bits and
+//   generation in the high bits; 0 is never a valid handle
+struct VoiceHandle {
+    Uint32 value {};
+
+    explicit operator bool() const { return value != 0; }
+    bool operator==(const VoiceHandle& other) const { return value == other.value; }
+    bool operator!=(const VoiceHandle& other) const { return value != other.value; }
+};
+
+struct VoiceParams {
+    // higher priorities take channels first, then louder voices
+    int priority {};
+    // 0 to 1, scaled to MIX_MAX_VOLUME for Mix_Volume
+    float volume { 1.0f };
+    // 0 (at listener) to 1 (out of hearing), scaled to 255 for Mix_SetDistance
+    float distance {};
+    // as for Mix_PlayChannel, -1 to loop until stopped
+    int loops {};
+};
+
+// Plays any number of voices of shared::MixChunks on a fixed number of mixer
+//   channels, ranked by priority, then by volume reduced by distance. The
+//   strongest play, stealing channels from weaker ones, and the rest are
+//   virtual, tracked but not mixed. Virtual voices regain a channel from the
+//   start of their chunk, so one-shots only within PROMOTE_WINDOW_MS of being
+//   played. Sounds may limit their simultaneous voices. Owns all channels and
+//   the only Mix_ChannelFinished callback, so one at a time. Not thread safe.
+class VoiceManager {
+public:
+    struct Stats {
+        std::uint64_t played {};
+        // voices given no channel when played, or losing theirs
+        std::uint64_t virtualized {};
+        // virtual voices given a channel
+        std::uint64_t promoted {};
+        // voices losing their channel to a stronger voice
+        std::uint64_t stolen {};
+        // plays refused by instance limits or voice capacity
+        std::uint64_t dropped {};
+    };
+
+    static constexpr Uint64 PROMOTE_WINDOW_MS { 100 };
+
+    // audible_threshold is the audibility below which voices are virtual,
+    //   by default the smallest step of Mix_Volume
+    explicit VoiceManager(int channel_ct, std::size_t max_voices = 256,
+                          float audible_threshold = 1.0f / MIX_MAX_VOLUME);
+    ~VoiceManager();
+
+    VoiceManager(const VoiceManager&) = delete;
+    VoiceManager& operator=(const VoiceManager&) = delete;
+
+    // null handle if dropped; throws std::invalid_argument on null chunk
+    VoiceHandle play(const sdl2_smart_ptr::shared::MixChunk& chunk,
+                     const VoiceParams& params = {});
+    // no effect on stale handles
+    void stop(VoiceHandle voice);
+    void setVolume(VoiceHandle voice, float volume);
+    void setDistance(VoiceHandle voice, float distance);
+
+    // limit 0 for no limit
+    void setInstanceLimit(const sdl2_smart_ptr::shared::MixChunk& chunk, int limit);
+
+    // reclaims finished channels, ends virtual voices whose time has run out,
+    //   and reassigns channels to the strongest audible voices; call once
+    //   per frame
+    void update();
+
+    // false for finished, stopped and dropped voices
+    bool playing(VoiceHandle voice) const;
+    // playing on a mixer channel
+    bool isReal(VoiceHandle voice) const;
+
+    int channelCount() const { return int(channel_voices_.size()); }
+    int realCount() const;
+    std::size_t voiceCount() const { return live_.size(); }
+    const Stats& stats() const { return stats_; }
+
+private:
+    static constexpr unsigned INDEX_BITS { 16 };
+    static constexpr Uint32 INDEX_MASK { (Uint32(1) << INDEX_BITS) - 1 };
+    static constexpr Uint32 NO_VOICE { ~Uint32(0) };
+    static constexpr int NO_CHANNEL { -1 };
+
+    struct Voice {
+        sdl2_smart_ptr::shared::MixChunk chunk;
+        VoiceParams params;
+        int channel { NO_CHANNEL };
+        Uint64 start_ms {};
+        // 0 when looping until stopped
+        Uint64 end_ms {};
+        // position in live_
+        std::size_t live_i {};
+        Uint16 generation { 1 };
+        bool live {};
+    };
+
+    struct Sound {
+        int limit {};
+        int instance_ct {};
+    };
+
+    static void channelFinished(int channel);
+
+    Voice* voiceOf(VoiceHandle voice);
+    const Voice* voiceOf(VoiceHandle voice) const;
+    float audibility(const Voice& voice) const;
+    bool stronger(const Voice& a, const Voice& b) const;
+    bool promotable(const Voice& voice, Uint64 now_ms) const;
+
+    void drainFinished();
+    // voice on weakest real channel, or NO_VOICE if none are in use
+    Uint32 weakestReal() const;
+    // true if voice got a channel, stealing from a weaker voice if need be
+    bool acquireChannel(Uint32 voice_i);
+    void startOnChannel(Uint32 voice_i, int channel);
+    // halts channel, leaving voice virtual
+    void releaseChannel(Uint32 voice_i);
+    void releaseVoice(Uint32 voice_i);
+
+    std::vector<Voice> voices_;
+    std::vector<Uint32> free_voices_;
+    // indices of live voices, for iteration
+    std::vector<Uint32> live_;
+    // voice on each channel, NO_VOICE if free, or a marker while halting
+    std::vector<Uint32> channel_voices_;
+    std::vector<int> free_channels_;
+    std::unordered_map<Mix_Chunk*, Sound> sounds_;
+    // reused by update()
+    std::vector<Uint32> candidates_;
+
+    // finished channels; producers are serialized by SDL_mixer's audio lock,
+    //   whether on the audio thread or in Mix_HaltChannel on this one
+    sdl2_thread_util::SpscQueue<int> finished_;
+
+    float audible_threshold_;
+    Uint32 bytes_per_ms_ {};
+    Stats stats_ {};
+};
+
+}  // namespace sdl2_mixer_util
+
+
+#endif  // VOICE_MANAGER_HH
@@ -0,0 +1,313 @@
+#include "music_playlist.hh"
+
+#include "mapped_file.hh"  // MappedFile
+#include "safeSdlCall.hh"
+
+#include "SDL_audio.h"  // SDL_MixAudioFormat SDL_AUDIO_BITSIZE
+#include "SDL_mixer.h"  // Mix_LoadWAV_RW Mix_HookMusic Mix_QuerySpec
+
+#include <algorithm>    // min clamp
+#include <exception>
+#include <memory>       // unique_ptr
+#include <stdexcept>    // invalid_argument runtime_error
+#include <utility>      // move
+
+
+namespace sdl2_mixer_util {
+
+// SDL_mixer takes one Mix_HookMusic callback
+static std::atomic<MusicPlaylist*> instance { nullptr };
+
+// background thread wait while playing, bounding how long finished tracks
+//   are kept and the next is left unloaded
+static constexpr std::chrono::milliseconds POLL_INTERVAL { 20 };
+
+// fade volumes change every this many frames, about 1.5ms at 44.1kHz
+static constexpr Uint32 FADE_STEP_FRAMES { 64 };
+
+MusicPlaylist::MusicPlaylist(std::vector<std::string> paths,
+                             std::chrono::milliseconds crossfade, bool repeat) :
+    paths_(std::move(paths)), repeat_(repeat), volume_(MIX_MAX_VOLUME) {
+    if (paths_.empty())
+        throw std::invalid_argument("MusicPlaylist: no tracks");
+    if (crossfade.count() < 0)
+        throw std::invalid_argument("MusicPlaylist: crossfade must not be negative");
+    int frequency {};
+    Uint16 format {};
+    int channels {};
+    safeSdlCall(Mix_QuerySpec, "Mix_QuerySpec",
+                SdlRetTest<int>{ [](const int ret){ return (ret == 0); } },
+                &frequency, &format, &channels);
+    format_ = format;
+    frame_size_ = Uint32(SDL_AUDIO_BITSIZE(format) / 8 * channels);
+    const std::uint64_t crossfade_frames {
+        std::uint64_t(frequency) * std::uint64_t(crossfade.count()) / 1000 };
+    crossfade_size_ = frame_size_ * Uint32(std::min(
+        crossfade_frames, std::uint64_t(UINT32_MAX / frame_size_)));
+    MusicPlaylist* expected { nullptr };
+    if (!instance.compare_exchange_strong(expected, this)) {
+        throw std::runtime_error(
+            "MusicPlaylist: only one may exist, as Mix_HookMusic takes one callback");
+    }
+    Mix_HookMusic(mixMusic, this);
+    worker_ = std::thread(&MusicPlaylist::workLoop, this);
+}
+
+MusicPlaylist::~MusicPlaylist() {
+    // locks out the audio callback, so mix() is not running once it returns
+    Mix_HookMusic(nullptr, nullptr);
+    {
+        std::lock_guard<std::mutex> lock { mtx_ };
+        quit_ = true;
+    }
+    work_cv_.notify_one();
+    worker_.join();
+    retire(current_);
+    retire(fading_);
+    retire(ready_.exchange(nullptr));
+    freeRetired();
+    instance.store(nullptr);
+}
+
+void MusicPlaylist::play() {
+    {
+        std::lock_guard<std::mutex> lock { mtx_ };
+        // from the start again once all have played
+        if (next_index_ >= paths_.size() && ready_.load() == nullptr)
+            next_index_ = 0;
+        failed_run_ = 0;
+        active_.store(true);
+    }
+    work_cv_.notify_one();
+}
+
+void MusicPlaylist::stop() {
+    // before halting, so the next track is not started
+    active_.store(false);
+    stop_requested_.store(true);
+    skip_requested_.store(false);
+}
+
+void MusicPlaylist::skip() {
+    skip_requested_.store(true);
+}
+
+void MusicPlaylist::setVolume(int volume) {
+    volume_.store(std::clamp(volume, 0, MIX_MAX_VOLUME));
+}
+
+std::size_t MusicPlaylist::currentTrack() const {
+    return current_index_.load();
+}
+
+bool MusicPlaylist::active() const {
+    return active_.load();
+}
+
+MusicPlaylist::Stats MusicPlaylist::stats() const {
+    return Stats {
+        played_ct_.load(), gapless_ct_.load(), late_ct_.load(), failed_ct_.load()
+    };
+}
+
+std::string MusicPlaylist::lastError() const {
+    std::lock_guard<std::mutex> lock { mtx_ };
+    return error_;
+}
+
+void MusicPlaylist::setError(const std::string& error) {
+    std::lock_guard<std::mutex> lock { mtx_ };
+    error_ = error;
+}
+
+void MusicPlaylist::mixMusic(void* udata, Uint8* stream, int len) {
+    static_cast<MusicPlaylist*>(udata)->mix(stream, Uint32(len));
+}
+
+void MusicPlaylist::mix(Uint8* stream, Uint32 len) {
+    if (stop_requested_.exchange(false)) {
+        retire(current_);
+        retire(fading_);
+        current_ = nullptr;
+        fading_ = nullptr;
+        starved_ = false;
+    }
+    if (skip_requested_.exchange(false) && current_ != nullptr) {
+        if (crossfade_size_ > 0) {
+            fadeOut(std::min(crossfade_size_, current_->chunk->alen - current_->position));
+        } else {
+            retire(current_);
+            current_ = nullptr;
+        }
+        if (!startNext(true) && active_.load())
+            starved_ = true;
+    }
+
+    // stream is silence on entry, and tracks are mixed into it
+    const int volume { volume_.load() };
+    Uint32 done {};
+    while (done < len) {
+        if (current_ == nullptr && active_.load())
+            startNext(false);
+        if (current_ != nullptr && fading_ == nullptr && crossfade_size_ > 0 &&
+            current_->chunk->alen - current_->position <= crossfade_size_ &&
+            ready_.load() != nullptr) {
+            fadeOut(current_->chunk->alen - current_->position);
+            startNext(true);
+        }
+        if (current_ == nullptr && fading_ == nullptr)
+            break;
+
+        Uint32 size { len - done };
+        if (current_ != nullptr)
+            size = std::min(size, current_->chunk->alen - current_->position);
+        int current_volume { volume };
+        if (fading_ != nullptr) {
+            const Uint32 fade_left { fade_end_ - fading_->position };
+            size = std::min({ size, fade_left, FADE_STEP_FRAMES * frame_size_ });
+            const int fading_volume { int(std::uint64_t(volume) * fade_left / fade_size_) };
+            current_volume = volume - fading_volume;
+            SDL_MixAudioFormat(stream + done, fading_->chunk->abuf + fading_->position,
+                               format_, size, fading_volume);
+            fading_->position += size;
+            if (fading_->position == fade_end_) {
+                retire(fading_);
+                fading_ = nullptr;
+            }
+        }
+        if (current_ != nullptr) {
+            SDL_MixAudioFormat(stream + done, current_->chunk->abuf + current_->position,
+                               format_, size, current_volume);
+            current_->position += size;
+            if (current_->position == current_->chunk->alen) {
+                retire(current_);
+                current_ = nullptr;
+                if (!startNext(true) && active_.load())
+                    starved_ = true;
+            }
+        }
+        done += size;
+    }
+
+    if (!active_.load())
+        starved_ = false;
+    if (current_ != nullptr)
+        current_index_.store(current_->index);
+    else if (fading_ != nullptr)
+        current_index_.store(fading_->index);
+    else
+        current_index_.store(NO_TRACK);
+}
+
+bool MusicPlaylist::startNext(bool continuing) {
+    // only taken here, so still there after the load
+    const Track* next { ready_.load() };
+    if (next == nullptr)
+        return false;
+    current_index_.store(next->index);
+    current_ = ready_.exchange(nullptr);
+    played_ct_.fetch_add(1);
+    if (starved_)
+        late_ct_.fetch_add(1);
+    else if (continuing)
+        gapless_ct_.fetch_add(1);
+    starved_ = false;
+    return true;
+}
+
+void MusicPlaylist::fadeOut(Uint32 length) {
+    retire(fading_);
+    if (length == 0) {
+        fading_ = nullptr;
+        retire(current_);
+        current_ = nullptr;
+        return;
+    }
+    fading_ = current_;
+    current_ = nullptr;
+    fade_end_ = fading_->position + length;
+    fade_size_ = length;
+}
+
+void MusicPlaylist::retire(Track* track) {
+    if (track == nullptr)
+        return;
+    Track* head { retired_.load() };
+    do {
+        track->next_retired = head;
+    } while (!retired_.compare_exchange_weak(head, track));
+}
+
+void MusicPlaylist::freeRetired() {
+    Track* track { retired_.exchange(nullptr) };
+    while (track != nullptr) {
+        Track* next { track->next_retired };
+        delete track;
+        track = next;
+    }
+}
+
+std::unique_ptr<MusicPlaylist::Track> MusicPlaylist::load(std::size_t index) {
+    auto track { std::make_unique<Track>() };
+    track->index = index;
+    try {
+        // decoded samples are copied out, so the mapping is only needed here
+        const sdl2_memory_util::MappedFile file { paths_[index] };
+        // so decoding doesn't wait on disk a page at a time
+        file.prefetch();
+        track->chunk = sdl2_smart_ptr::make_unique(
+            safeSdlCall(Mix_LoadWAV_RW, "Mix_LoadWAV_RW",
+                        SdlRetTest<Mix_Chunk*>{ [](const Mix_Chunk* chunk){
+                            return (chunk == nullptr); } },
+                        file.openRWops(), 1));
+    } catch (const std::exception& e) {
+        setError(paths_[index] + ": " + e.what());
+        return nullptr;
+    }
+    return track;
+}
+
+void MusicPlaylist::workLoop() {
+    std::unique_lock<std::mutex> lock { mtx_ };
+    while (!quit_) {
+        lock.unlock();
+        // Mix_FreeChunk takes the audio lock, so not under mtx_
+        freeRetired();
+        lock.lock();
+        if (!active_.load() || ready_.load() != nullptr) {
+            work_cv_.wait_for(lock, POLL_INTERVAL, [this](){
+                return quit_ || (active_.load() && ready_.load() == nullptr);
+            });
+            continue;
+        }
+
+        if (next_index_ >= paths_.size()) {
+            if (!repeat_) {
+                // nothing left to play once the last track ends; ready_ was
+                //   seen empty, so currentTrack() is set for any now starting
+                if (current_index_.load() == NO_TRACK)
+                    active_.store(false);
+                else
+                    work_cv_.wait_for(lock, POLL_INTERVAL, [this](){ return quit_; });
+                continue;
+            }
+            next_index_ = 0;
+        }
+
+        // prepare next track
+        const std::size_t index { next_index_++ };
+        lock.unlock();
+        std::unique_ptr<Track> track { load(index) };
+        lock.lock();
+        if (track == nullptr) {
+            failed_ct_.fetch_add(1);
+            if (++failed_run_ >= paths_.size())
+                active_.store(false);
+            continue;
+        }
+        failed_run_ = 0;
+        ready_.store(track.release());
+    }
+}
+
+}  // namespace sdl2_mixer_util
@@ -0,0 +1,369 @@
+#include "voice_manager.hh"
+
+#include "safeSdlCall.hh"
+
+#include "SDL_audio.h"  // SDL_AUDIO_BITSIZE
+#include "SDL_timer.h"  // SDL_GetTicks64
+
+#include <algorithm>    // clamp max sort
+#include <atomic>
+#include <cmath>        // lround
+#include <stdexcept>    // invalid_argument runtime_error
+
+
+namespace sdl2_mixer_util {
+
+// Mix_ChannelFinished callbacks take no user data
+static std::atomic<VoiceManager*> instance { nullptr };
+
+// channel_voices_ value between Mix_HaltChannel and its callback
+static constexpr Uint32 HALTING { ~Uint32(0) - 1 };
+
+static const SdlRetTest<int> zero_is_failure {
+    [](const int ret){ return (ret == 0); }
+};
+
+static int mixVolume(const float volume) {
+    return int(std::lround(volume * MIX_MAX_VOLUME));
+}
+
+static Uint8 mixDistance(const float distance) {
+    return Uint8(std::lround(distance * 255.0f));
+}
+
+VoiceManager::VoiceManager(int channel_ct, std::size_t max_voices,
+                           float audible_threshold) :
+    finished_(std::size_t(std::max(channel_ct, 1))), audible_threshold_(audible_threshold) {
+    if (channel_ct < 1)
+        throw std::invalid_argument("VoiceManager: channel_ct must be positive");
+    if (max_voices < 1 || max_voices > INDEX_MASK)
+        throw std::invalid_argument("VoiceManager: max_voices out of range");
+    int frequency {};
+    Uint16 format {};
+    int channels {};
+    safeSdlCall(Mix_QuerySpec, "Mix_QuerySpec", zero_is_failure,
+                &frequency, &format, &channels);
+    bytes_per_ms_ = std::max(Uint32(1), Uint32(frequency * channels *
+                                               (SDL_AUDIO_BITSIZE(format) / 8) / 1000));
+
+    voices_.resize(max_voices);
+    free_voices_.reserve(max_voices);
+    for (std::size_t i { max_voices }; i-- > 0; )
+        free_voices_.push_back(Uint32(i));
+    live_.reserve(max_voices);
+    candidates_.reserve(max_voices);
+    channel_voices_.assign(std::size_t(channel_ct), NO_VOICE);
+    for (int channel { channel_ct }; channel-- > 0; )
+        free_channels_.push_back(channel);
+
+    VoiceManager* expected { nullptr };
+    if (!instance.compare_exchange_strong(expected, this)) {
+        throw std::runtime_error(
+            "VoiceManager: only one may exist, as Mix_ChannelFinished takes one callback");
+    }
+    Mix_AllocateChannels(channel_ct);
+    // so that no channel finishes without a voice
+    Mix_HaltChannel(-1);
+    Mix_ChannelFinished(channelFinished);
+}
+
+VoiceManager::~VoiceManager() {
+    Mix_ChannelFinished(nullptr);
+    instance.store(nullptr);
+    // before chunks are released with voices_
+    Mix_HaltChannel(-1);
+}
+
+void VoiceManager::channelFinished(int channel) {
+    VoiceManager* manager { instance.load(std::memory_order_acquire) };
+    if (manager == nullptr || channel < 0 || channel >= manager->channelCount())
+        return;
+    // never full, as a channel finishes once before it is reclaimed
+    manager->finished_.tryPush(channel);
+}
+
+void VoiceManager::drainFinished() {
+    int finished_channel {};
+    while (finished_.tryPop(finished_channel)) {
+        const std::size_t channel { std::size_t(finished_channel) };
+        const Uint32 voice_i { channel_voices_[channel] };
+        if (voice_i == NO_VOICE)
+            continue;
+        channel_voices_[channel] = NO_VOICE;
+        free_channels_.push_back(int(channel));
+        if (voice_i != HALTING) {
+            // played to the end
+            voices_[voice_i].channel = NO_CHANNEL;
+            releaseVoice(voice_i);
+        }
+    }
+}
+
+VoiceManager::Voice* VoiceManager::voiceOf(VoiceHandle voice) {
+    return const_cast<Voice*>(static_cast<const VoiceManager*>(this)->voiceOf(voice));
+}
+
+const VoiceManager::Voice* VoiceManager::voiceOf(VoiceHandle voice) const {
+    const Uint32 index { voice.value & INDEX_MASK };
+    if (index >= voices_.size())
+        return nullptr;
+    const Voice& v { voices_[index] };
+    return (v.live && v.generation == (voice.value >> INDEX_BITS)) ? &v : nullptr;
+}
+
+float VoiceManager::audibility(const Voice& voice) const {
+    return voice.params.volume * (1.0f - voice.params.distance);
+}
+
+bool VoiceManager::stronger(const Voice& a, const Voice& b) const {
+    if (a.params.priority != b.params.priority)
+        return a.params.priority > b.params.priority;
+    return audibility(a) > audibility(b);
+}
+
+bool VoiceManager::promotable(const Voice& voice, Uint64 now_ms) const {
+    return voice.params.loops == -1 || now_ms < voice.start_ms + PROMOTE_WINDOW_MS;
+}
+
+static void setTimes(Uint64& start_ms, Uint64& end_ms, const Mix_Chunk* chunk,
+                     const int loops, const Uint32 bytes_per_ms, const Uint64 now_ms) {
+    start_ms = now_ms;
+    end_ms = (loops == -1) ? 0 :
+        now_ms + Uint64(chunk->alen / bytes_per_ms) * Uint64(loops + 1);
+}
+
+Uint32 VoiceManager::weakestReal() const {
+    Uint32 weakest { NO_VOICE };
+    for (const Uint32 voice_i : channel_voices_) {
+        if (voice_i >= voices_.size())
+            continue;
+        if (weakest == NO_VOICE || stronger(voices_[weakest], voices_[voice_i]))
+            weakest = voice_i;
+    }
+    return weakest;
+}
+
+void VoiceManager::startOnChannel(Uint32 voice_i, int channel) {
+    Voice& voice { voices_[voice_i] };
+    Mix_Volume(channel, mixVolume(voice.params.volume));
+    // effects set before playing last until the channel finishes
+    if (mixDistance(voice.params.distance) > 0) {
+        safeSdlCall(Mix_SetDistance, "Mix_SetDistance", zero_is_failure,
+                    channel, mixDistance(voice.params.distance));
+    }
+    try {
+        safeSdlCall(Mix_PlayChannel, "Mix_PlayChannel",
+                    SdlRetTest<int>{ [](const int ret){ return (ret == -1); } },
+                    channel, voice.chunk.get(), voice.params.loops);
+    } catch (...) {
+        free_channels_.push_back(channel);
+        throw;
+    }
+    channel_voices_[std::size_t(channel)] = voice_i;
+    voice.channel = channel;
+}
+
+bool VoiceManager::acquireChannel(Uint32 voice_i) {
+    if (free_channels_.empty()) {
+        const Uint32 weakest { weakestReal() };
+        if (weakest == NO_VOICE || !stronger(voices_[voice_i], voices_[weakest]))
+            return false;
+        releaseChannel(weakest);
+        ++stats_.stolen;
+        ++stats_.virtualized;
+        drainFinished();
+        if (free_channels_.empty())
+            return false;
+    }
+    const int channel { free_channels_.back() };
+    free_channels_.pop_back();
+    startOnChannel(voice_i, channel);
+    return true;
+}
+
+void VoiceManager::releaseChannel(Uint32 voice_i) {
+    Voice& voice { voices_[voice_i] };
+    const int channel { voice.channel };
+    // freed when the callback's entry is drained
+    channel_voices_[std::size_t(channel)] = HALTING;
+    voice.channel = NO_CHANNEL;
+    Mix_HaltChannel(channel);
+}
+
+void VoiceManager::releaseVoice(Uint32 voice_i) {
+    Voice& voice { voices_[voice_i] };
+    auto sound { sounds_.find(voice.chunk.get()) };
+    if (sound != sounds_.end())
+        --sound->second.instance_ct;
+    voice.chunk.reset();
+    // swap remove from live_
+    const Uint32 moved { live_.back() };
+    live_[voice.live_i] = moved;
+    voices_[moved].live_i = voice.live_i;
+    live_.pop_back();
+    voice.live = false;
+    if (++voice.generation == 0)
+        voice.generation = 1;
+    free_voices_.push_back(voice_i);
+}
+
+VoiceHandle VoiceManager::play(const sdl2_smart_ptr::shared::MixChunk& chunk,
+                               const VoiceParams& params) {
+    if (chunk == nullptr)
+        throw std::invalid_argument("VoiceManager: cannot play null chunk");
+    if (params.loops < -1)
+        throw std::invalid_argument("VoiceManager: loops must be -1 or more");
+    drainFinished();
+
+    Voice incoming;
+    incoming.params = params;
+    incoming.params.volume = std::clamp(params.volume, 0.0f, 1.0f);
+    incoming.params.distance = std::clamp(params.distance, 0.0f, 1.0f);
+
+    Sound& sound { sounds_[chunk.get()] };
+    if (sound.limit > 0 && sound.instance_ct >= sound.limit) {
+        Uint32 weakest { NO_VOICE };
+        for (const Uint32 voice_i : live_) {
+            if (voices_[voice_i].chunk != chunk)
+                continue;
+            if (weakest == NO_VOICE || stronger(voices_[weakest], voices_[voice_i]))
+                weakest = voice_i;
+        }
+        if (weakest == NO_VOICE || !stronger(incoming, voices_[weakest])) {
+            ++stats_.dropped;
+            return VoiceHandle{};
+        }
+        stop(VoiceHandle{ (Uint32(voices_[weakest].generation) << INDEX_BITS) | weakest });
+    }
+    if (free_voices_.empty()) {
+        Uint32 weakest { NO_VOICE };
+        for (const Uint32 voice_i : live_) {
+            if (weakest == NO_VOICE || stronger(voices_[weakest], voices_[voice_i]))
+                weakest = voice_i;
+        }
+        if (weakest == NO_VOICE || !stronger(incoming, voices_[weakest])) {
+            ++stats_.dropped;
+            return VoiceHandle{};
+        }
+        stop(VoiceHandle{ (Uint32(voices_[weakest].generation) << INDEX_BITS) | weakest });
+    }
+
+    const Uint32 voice_i { free_voices_.back() };
+    free_voices_.pop_back();
+    Voice& voice { voices_[voice_i] };
+    voice.chunk = chunk;
+    voice.params = incoming.params;
+    voice.channel = NO_CHANNEL;
+    voice.live = true;
+    voice.live_i = live_.size();
+    live_.push_back(voice_i);
+    ++sound.instance_ct;
+    ++stats_.played;
+    setTimes(voice.start_ms, voice.end_ms, chunk.get(), voice.params.loops, bytes_per_ms_,
+             SDL_GetTicks64());
+
+    const VoiceHandle handle { (Uint32(voice.generation) << INDEX_BITS) | voice_i };
+    try {
+        if (audibility(voice) < audible_threshold_ || !acquireChannel(voice_i))
+            ++stats_.virtualized;
+    } catch (...) {
+        releaseVoice(voice_i);
+        throw;
+    }
+    return handle;
+}
+
+void VoiceManager::stop(VoiceHandle voice) {
+    const Voice* v { voiceOf(voice) };
+    if (v == nullptr)
+        return;
+    const Uint32 voice_i { voice.value & INDEX_MASK };
+    if (v->channel != NO_CHANNEL) {
+        releaseChannel(voice_i);
+        drainFinished();
+    }
+    releaseVoice(voice_i);
+}
+
+void VoiceManager::setVolume(VoiceHandle voice, float volume) {
+    Voice* v { voiceOf(voice) };
+    if (v == nullptr)
+        return;
+    v->params.volume = std::clamp(volume, 0.0f, 1.0f);
+    if (v->channel != NO_CHANNEL)
+        Mix_Volume(v->channel, mixVolume(v->params.volume));
+}
+
+void VoiceManager::setDistance(VoiceHandle voice, float distance) {
+    Voice* v { voiceOf(voice) };
+    if (v == nullptr)
+        return;
+    const Uint8 old_distance { mixDistance(v->params.distance) };
+    v->params.distance = std::clamp(distance, 0.0f, 1.0f);
+    // Mix_SetDistance 0 unregisters its effect, so fails if there is none
+    if (v->channel != NO_CHANNEL && (old_distance > 0 || mixDistance(v->params.distance) > 0)) {
+        safeSdlCall(Mix_SetDistance, "Mix_SetDistance", zero_is_failure,
+                    v->channel, mixDistance(v->params.distance));
+    }
+}
+
+void VoiceManager::setInstanceLimit(const sdl2_smart_ptr::shared::MixChunk& chunk, int limit) {
+    if (chunk == nullptr)
+        throw std::invalid_argument("VoiceManager: cannot limit null chunk");
+    sounds_[chunk.get()].limit = std::max(limit, 0);
+}
+
+void VoiceManager::update() {
+    drainFinished();
+    const Uint64 now_ms { SDL_GetTicks64() };
+    // backwards, as releasing swaps the last live voice into place
+    for (std::size_t i { live_.size() }; i-- > 0; ) {
+        const Uint32 voice_i { live_[i] };
+        Voice& voice { voices_[voice_i] };
+        if (voice.channel == NO_CHANNEL) {
+            if (voice.end_ms != 0 && now_ms >= voice.end_ms)
+                releaseVoice(voice_i);
+        } else if (audibility(voice) < audible_threshold_) {
+            releaseChannel(voice_i);
+            ++stats_.virtualized;
+        }
+    }
+    drainFinished();
+
+    candidates_.clear();
+    for (const Uint32 voice_i : live_) {
+        const Voice& voice { voices_[voice_i] };
+        if (voice.channel == NO_CHANNEL && audibility(voice) >= audible_threshold_ &&
+            promotable(voice, now_ms)) {
+            candidates_.push_back(voice_i);
+        }
+    }
+    std::sort(candidates_.begin(), candidates_.end(), [this](Uint32 a, Uint32 b){
+        return stronger(voices_[a], voices_[b]);
+    });
+    for (const Uint32 voice_i : candidates_) {
+        Voice& voice { voices_[voice_i] };
+        // strongest first, so no later candidate can take a channel either
+        if (!acquireChannel(voice_i))
+            break;
+        setTimes(voice.start_ms, voice.end_ms, voice.chunk.get(), voice.params.loops,
+                 bytes_per_ms_, now_ms);
+        ++stats_.promoted;
+    }
+}
+
+bool VoiceManager::playing(VoiceHandle voice) const {
+    return voiceOf(voice) != nullptr;
+}
+
+bool VoiceManager::isReal(VoiceHandle voice) const {
+    const Voice* v { voiceOf(voice) };
+    return v != nullptr && v->channel != NO_CHANNEL;
+}
+
+int VoiceManager::realCount() const {
+    return int(std::count_if(channel_voices_.begin(), channel_voices_.end(),
+                             [this](Uint32 voice_i){ return voice_i < voices_.size(); }));
+}
+
+}  // namespace sdl2_mixer_util
@@ -0,0 +1,233 @@
+#include <catch2/catch_version_macros.hpp>               // CATCH_VERSION_MAJOR
+#if (CATCH_VERSION_MAJOR != 3)
+  #error "tests currently only support Catch2 v3.x"
+#endif
+#include <catch2/catch_test_macros.hpp>                  // TEST_CASE, SECTION, REQUIRE
+#include <catch2/benchmark/catch_benchmark.hpp>          // BENCHMARK
+
+#include "audio_kernels.hh"
+
+#include <SDL.h>
+
+#include <cstddef>    // size_t
+#include <cstring>    // memcmp
+#include <stdexcept>  // invalid_argument
+#include <string>
+#include <vector>
+
+
+using namespace sdl2_mixer_util;
+
+static const SimdLevel ALL_SIMD_LEVELS[SIMD_LEVEL_CT] {
+    SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Sse41, SimdLevel::Avx2
+};
+
+// noise across the full range, including both extremes
+static std::vector<Sint16> testS16(std::size_t count, Uint32 seed = 1) {
+    std::vector<Sint16> samples(count);
+    for (Sint16& sample : samples) {
+        seed = seed * 1664525 + 1013904223;
+        sample = Sint16(int(seed >> 16) - 32768);
+    }
+    if (count > 2) {
+        samples[1] = -32768;
+        samples[2] = 32767;
+    }
+    return samples;
+}
+
+// noise in -1.5 to 1.5, so over full scale
+static std::vector<float> testF32(std::size_t count, Uint32 seed = 1) {
+    std::vector<float> samples(count);
+    for (float& sample : samples) {
+        seed = seed * 1664525 + 1013904223;
+        sample = float(int(seed >> 8) - (1 << 23)) / float(1 << 23) * 1.5f;
+    }
+    return samples;
+}
+
+// bitwise, as float == would pass -0.0f for 0.0f
+template<typename Sample>
+static bool sameSamples(const std::vector<Sample>& a, const std::vector<Sample>& b) {
+    return a.size() == b.size() &&
+        (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(Sample)) == 0);
+}
+
+TEST_CASE("SDL audio kernels: SIMD levels match scalar",
+    "[sdl2_mixer_util][SDL2][SDL_mixer][audio_kernels]")
+{
+    REQUIRE(simdLevelSupported(SimdLevel::Scalar));
+    REQUIRE(simdLevelSupported(bestSimdLevel()));
+    for (const SimdLevel level : ALL_SIMD_LEVELS) {
+        if (!simdLevelSupported(level)) {
+            std::vector<float> samples(8);
+            REQUIRE_THROWS_AS(applyGain(samples.data(), 8, 1.0f, level),
+                              std::invalid_argument);
+        }
+    }
+
+    static constexpr float GAINS[] { 0.0f, 0.5f, 1.0f, 1.7f, -3.25f, MAX_GAIN };
+    // all counts up to a few vectors, so every tail length is covered
+    for (std::size_t count {}; count < 72; ++count) {
+        const std::vector<Sint16> s16 { testS16(count, Uint32(count)) };
+        const std::vector<Sint16> s16_dst { testS16(count, Uint32(count) + 1000) };
+        const std::vector<float> f32 { testF32(count, Uint32(count)) };
+        const std::vector<float> f32_dst { testF32(count, Uint32(count) + 1000) };
+
+        for (const float gain : GAINS) {
+            std::vector<Sint16> s16_gain { s16 };
+            std::vector<Sint16> s16_stereo { s16 };
+            std::vector<Sint16> s16_mix { s16_dst };
+            std::vector<float> f32_gain { f32 };
+            std::vector<float> f32_stereo { f32 };
+            std::vector<float> f32_mix { f32_dst };
+            applyGain(s16_gain.data(), count, gain, SimdLevel::Scalar);
+            applyStereoGain(s16_stereo.data(), count, gain, 0.25f, SimdLevel::Scalar);
+            mixInto(s16.data(), s16_mix.data(), count, gain, SimdLevel::Scalar);
+            applyGain(f32_gain.data(), count, gain, SimdLevel::Scalar);
+            applyStereoGain(f32_stereo.data(), count, gain, 0.25f, SimdLevel::Scalar);
+            mixInto(f32.data(), f32_mix.data(), count, gain, SimdLevel::Scalar);
+            const float s16_peak { peakLevel(s16.data(), count, SimdLevel::Scalar) };
+            const float f32_peak { peakLevel(f32.data(), count, SimdLevel::Scalar) };
+
+            for (const SimdLevel level : ALL_SIMD_LEVELS) {
+                if (level == SimdLevel::Scalar || !simdLevelSupported(level))
+                    continue;
+                INFO(simdLevelName(level) << ", " << count << " samples, gain " << gain);
+                std::vector<Sint16> s16_result { s16 };
+                applyGain(s16_result.data(), count, gain, level);
+                REQUIRE(sameSamples(s16_result, s16_gain));
+                s16_result = s16;
+                applyStereoGain(s16_result.data(), count, gain, 0.25f, level);
+                REQUIRE(sameSamples(s16_result, s16_stereo));
+                s16_result = s16_dst;
+                mixInto(s16.data(), s16_result.data(), count, gain, level);
+                REQUIRE(sameSamples(s16_result, s16_mix));
+
+                std::vector<float> f32_result { f32 };
+                applyGain(f32_result.data(), count, gain, level);
+                REQUIRE(sameSamples(f32_result, f32_gain));
+                f32_result = f32;
+                applyStereoGain(f32_result.data(), count, gain, 0.25f, level);
+                REQUIRE(sameSamples(f32_result, f32_stereo));
+                f32_result = f32_dst;
+                mixInto(f32.data(), f32_result.data(), count, gain, level);
+                REQUIRE(sameSamples(f32_result, f32_mix));
+
+                REQUIRE(peakLevel(s16.data(), count, level) == s16_peak);
+                REQUIRE(peakLevel(f32.data(), count, level) == f32_peak);
+            }
+        }
+    }
+}
+
+TEST_CASE("SDL audio kernels: rounding, saturation and peaks",
+    "[sdl2_mixer_util][SDL2][SDL_mixer][audio_kernels]")
+{
+    for (const SimdLevel level : ALL_SIMD_LEVELS) {
+        if (!simdLevelSupported(level))
+            continue;
+        INFO(simdLevelName(level));
+
+        // invalid gains
+        {
+            std::vector<float> samples(32);
+            REQUIRE_THROWS_AS(applyGain(samples.data(), 32, MAX_GAIN * 2, level),
+                              std::invalid_argument);
+            REQUIRE_THROWS_AS(mixInto(samples.data(), samples.data(), 32, -MAX_GAIN * 2, level),
+                              std::invalid_argument);
+        }
+        // Sint16 gain rounds to nearest even and saturates
+        {
+            // repeated past a vector, so both SIMD and scalar tails are checked
+            std::vector<Sint16> samples;
+            for (int i {}; i < 8; ++i)
+                samples.insert(samples.end(), { 3, 5, -3, 20000, -20000, 1, -1, 0 });
+            applyGain(samples.data(), samples.size(), 0.5f, level);
+            for (std::size_t i {}; i < samples.size(); i += 8) {
+                REQUIRE(samples[i] == 2);
+                REQUIRE(samples[i + 1] == 2);
+                REQUIRE(samples[i + 2] == -2);
+                REQUIRE(samples[i + 3] == 10000);
+                REQUIRE(samples[i + 5] == 0);
+            }
+            applyGain(samples.data(), samples.size(), 4.0f, level);
+            for (std::size_t i {}; i < samples.size(); i += 8) {
+                REQUIRE(samples[i + 3] == 32767);
+                REQUIRE(samples[i + 4] == -32768);
+            }
+        }
+        // stereo gain alternates channels
+        {
+            std::vector<float> samples(66, 1.0f);
+            applyStereoGain(samples.data(), samples.size(), 0.5f, 0.0f, level);
+            for (std::size_t i {}; i < samples.size(); ++i)
+                REQUIRE(samples[i] == (i % 2 == 0 ? 0.5f : 0.0f));
+        }
+        // Sint16 mixing saturates
+        {
+            std::vector<Sint16> src(40, 30000);
+            std::vector<Sint16> dst(40, 10000);
+            mixInto(src.data(), dst.data(), dst.size(), 1.0f, level);
+            for (const Sint16 sample : dst)
+                REQUIRE(sample == 32767);
+            mixInto(src.data(), dst.data(), dst.size(), -3.0f, level);
+            for (const Sint16 sample : dst)
+                REQUIRE(sample == -32768);
+        }
+        // peaks
+        {
+            std::vector<Sint16> s16(37);
+            REQUIRE(peakLevel(s16.data(), s16.size(), level) == 0.0f);
+            s16[20] = -32768;
+            REQUIRE(peakLevel(s16.data(), s16.size(), level) == 1.0f);
+            s16[20] = 16384;
+            s16[36] = -16385;
+            REQUIRE(peakLevel(s16.data(), s16.size(), level) == 16385.0f / 32768.0f);
+
+            std::vector<float> f32(37);
+            f32[3] = -1.25f;
+            f32[30] = 1.0f;
+            REQUIRE(peakLevel(f32.data(), f32.size(), level) == 1.25f);
+        }
+    }
+}
+
+TEST_CASE("SDL audio kernel throughput: SIMD levels vs scalar",
+    "[.][benchmark][sdl2_mixer_util][SDL2][SDL_mixer][audio_kernels]")
+{
+    // 1024 stereo frames, a typical Mix_OpenAudio chunksize
+    static constexpr std::size_t SAMPLE_CT { 2048 };
+    std::vector<Sint16> s16 { testS16(SAMPLE_CT) };
+    const std::vector<Sint16> s16_src { testS16(SAMPLE_CT, 7) };
+    std::vector<float> f32 { testF32(SAMPLE_CT) };
+    const std::vector<float> f32_src { testF32(SAMPLE_CT, 7) };
+
+    for (const SimdLevel level : ALL_SIMD_LEVELS) {
+        if (!simdLevelSupported(level))
+            continue;
+        const std::string name { simdLevelName(level) };
+        BENCHMARK("applyStereoGain S16, " + name) {
+            applyStereoGain(s16.data(), SAMPLE_CT, 0.9f, 1.1f, level);
+            return s16[0];
+        };
+        BENCHMARK("applyStereoGain F32, " + name) {
+            applyStereoGain(f32.data(), SAMPLE_CT, 0.9f, 1.1f, level);
+            return f32[0];
+        };
+        BENCHMARK("mixInto S16, " + name) {
+            mixInto(s16_src.data(), s16.data(), SAMPLE_CT, 0.5f, level);
+            return s16[0];
+        };
+        BENCHMARK("mixInto F32, " + name) {
+            mixInto(f32_src.data(), f32.data(), SAMPLE_CT, 0.5f, level);
+            return f32[0];
+        };
+        BENCHMARK("peakLevel S16, " + name) {
+            return peakLevel(s16.data(), SAMPLE_CT, level);
+        };
+        BENCHMARK("peakLevel F32, " + name) {
+            return peakLevel(f32.data(), SAMPLE_CT, level);
+        };
+    }
+}
@@ -0,0 +1,257 @@
+#include <catch2/catch_version_macros.hpp>               // CATCH_VERSION_MAJOR
+#if (CATCH_VERSION_MAJOR != 3)
+  #error "tests currently only support Catch2 v3.x"
+#endif
+#include <catch2/catch_test_macros.hpp>                  // TEST_CASE, SECTION, REQUIRE
+#include <catch2/benchmark/catch_benchmark.hpp>          // BENCHMARK
+
+#include "effects_pipeline.hh"
+
+#include <SDL.h>
+#include <SDL_mixer.h>
+
+#include <cstddef>    // size_t
+#include <stdexcept>  // invalid_argument runtime_error
+#include <string>
+#include <vector>
+
+
+static std::string collectErrorQuitSdlMix(const std::string& func_name) {
+    std::string err { SDL_GetError() };
+    SDL_ClearError();
+    if (err.size() == 0) {
+        err = "failure without setting SDL error";
+    }
+    Mix_Quit();
+    SDL_Quit();
+    return func_name + ": " + err;
+}
+
+using namespace sdl2_mixer_util;
+
+static constexpr int FREQUENCY { 44100 };
+static constexpr std::size_t FRAME_CT { 1024 };
+
+// full scale square wave, in both channels
+static std::vector<float> squareF32() {
+    std::vector<float> samples(FRAME_CT * 2);
+    for (std::size_t i {}; i < samples.size(); ++i)
+        samples[i] = (i / 64 % 2 == 0) ? 1.0f : -1.0f;
+    return samples;
+}
+
+static std::vector<Sint16> squareS16() {
+    std::vector<Sint16> samples(FRAME_CT * 2);
+    for (std::size_t i {}; i < samples.size(); ++i)
+        samples[i] = (i / 64 % 2 == 0) ? 32767 : -32768;
+    return samples;
+}
+
+template<typename Sample>
+static void process(EffectsPipeline& pipeline, std::vector<Sample>& samples) {
+    pipeline.process(samples.data(), int(samples.size() * sizeof(Sample)));
+}
+
+TEST_CASE("SDL_mixer effects pipeline: processing",
+    "[sdl2_mixer_util][SDL2][SDL_mixer][EffectsPipeline]")
+{
+    if (SDL_Init(0) != 0) {
+        FAIL(collectErrorQuitSdlMix("SDL_Init"));
+    }
+
+    {
+        EffectsPipeline f32_pipeline { FREQUENCY, AUDIO_F32SYS, 2 };
+        EffectsPipeline s16_pipeline { FREQUENCY, AUDIO_S16SYS, 2 };
+
+        SECTION("invalid arguments")
+        {
+            REQUIRE_THROWS_AS(EffectsPipeline(FREQUENCY, AUDIO_U8, 2), std::invalid_argument);
+            REQUIRE_THROWS_AS(EffectsPipeline(FREQUENCY, AUDIO_S16SYS, 0),
+                              std::invalid_argument);
+            // without an open audio device
+            REQUIRE_THROWS_AS(EffectsPipeline(), std::runtime_error);
+        }
+        SECTION("defaults leave audio unchanged")
+        {
+            const std::vector<float> f32 { squareF32() };
+            std::vector<float> f32_result { f32 };
+            process(f32_pipeline, f32_result);
+            REQUIRE(f32_result == f32);
+            REQUIRE(f32_pipeline.takePeak() == 1.0f);
+            REQUIRE(f32_pipeline.takePeak() == 0.0f);
+
+            const std::vector<Sint16> s16 { squareS16() };
+            std::vector<Sint16> s16_result { s16 };
+            process(s16_pipeline, s16_result);
+            REQUIRE(s16_result == s16);
+        }
+        SECTION("parameters are clamped")
+        {
+            f32_pipeline.setGain(100.0f);
+            REQUIRE(f32_pipeline.gain() == MAX_GAIN);
+            f32_pipeline.setDuck(-1.0f);
+            REQUIRE(f32_pipeline.duck() == 0.0f);
+            f32_pipeline.setPan(2.0f);
+            REQUIRE(f32_pipeline.pan() == 1.0f);
+            f32_pipeline.setLimit(0.0f);
+            REQUIRE(f32_pipeline.limit() > 0.0f);
+        }
+        SECTION("gain and duck changes ramp, then hold")
+        {
+            f32_pipeline.setGain(0.5f);
+            f32_pipeline.setDuck(0.5f);
+            std::vector<float> samples(FRAME_CT * 2, 0.5f);
+            process(f32_pipeline, samples);
+            // first buffer starts at its gains
+            REQUIRE(samples.front() == 0.125f);
+            REQUIRE(samples.back() == 0.125f);
+
+            f32_pipeline.setDuck(1.0f);
+            samples.assign(FRAME_CT * 2, 0.5f);
+            process(f32_pipeline, samples);
+            REQUIRE(samples.front() > 0.125f);
+            REQUIRE(samples.front() < 0.25f);
+            REQUIRE(samples.back() == 0.25f);
+
+            samples.assign(FRAME_CT * 2, 0.5f);
+            process(f32_pipeline, samples);
+            REQUIRE(samples.front() == 0.25f);
+        }
+        SECTION("pan attenuates the other side")
+        {
+            s16_pipeline.setPan(-1.0f);
+            std::vector<Sint16> samples { squareS16() };
+            process(s16_pipeline, samples);
+            for (std::size_t i {}; i < samples.size(); i += 2) {
+                REQUIRE(samples[i] != 0);
+                REQUIRE(samples[i + 1] == 0);
+            }
+        }
+        SECTION("limiter holds peaks under the ceiling")
+        {
+            f32_pipeline.setLimit(0.5f);
+            s16_pipeline.setLimit(0.5f);
+            f32_pipeline.setGain(4.0f);
+            s16_pipeline.setGain(4.0f);
+            for (int buffer {}; buffer < 4; ++buffer) {
+                std::vector<float> f32 { squareF32() };
+                process(f32_pipeline, f32);
+                REQUIRE(peakLevel(f32.data(), f32.size()) <= 0.5f);
+                std::vector<Sint16> s16 { squareS16() };
+                process(s16_pipeline, s16);
+                REQUIRE(peakLevel(s16.data(), s16.size()) <= 0.5f);
+            }
+            REQUIRE(f32_pipeline.takePeak() <= 0.5f);
+
+            // quiet input is not limited
+            std::vector<float> quiet(FRAME_CT * 2, 0.01f);
+            for (int buffer {}; buffer < 100; ++buffer) {
+                quiet.assign(FRAME_CT * 2, 0.01f);
+                process(f32_pipeline, quiet);
+            }
+            REQUIRE(quiet.back() == 0.04f);
+        }
+        SECTION("callback timing")
+        {
+            std::vector<float> samples { squareF32() };
+            process(f32_pipeline, samples);
+            process(f32_pipeline, samples);
+            EffectsPipeline::Timing timing { f32_pipeline.timing() };
+            REQUIRE(timing.buffer_ct == 2);
+            REQUIRE(timing.last >= 0.0f);
+            REQUIRE(timing.max >= timing.last);
+            f32_pipeline.resetTiming();
+            timing = f32_pipeline.timing();
+            REQUIRE(timing.buffer_ct == 0);
+            REQUIRE(timing.max == 0.0f);
+        }
+    }
+
+    SDL_Quit();
+}
+
+TEST_CASE("SDL_mixer effects pipeline: attaching to SDL_mixer",
+    "[sdl2_mixer_util][SDL2][SDL_mixer][EffectsPipeline]")
+{
+    if (SDL_Init(SDL_INIT_AUDIO) != 0) {
+        SKIP(collectErrorQuitSdlMix("SDL_Init"));
+    }
+
+    if (Mix_OpenAudio(FREQUENCY, MIX_DEFAULT_FORMAT, 2, 2048) != 0) {
+        SKIP(collectErrorQuitSdlMix("Mix_OpenAudio"));
+    }
+
+    {
+        EffectsPipeline pipeline {};
+        REQUIRE(pipeline.format() == MIX_DEFAULT_FORMAT);
+
+        SECTION("Mix_RegisterEffect on final mix")
+        {
+            pipeline.attach(MIX_CHANNEL_POST);
+            REQUIRE(pipeline.attached());
+            pipeline.detach();
+            REQUIRE(!pipeline.attached());
+        }
+        SECTION("Mix_RegisterEffect on invalid channel")
+        {
+            REQUIRE_THROWS_AS(pipeline.attach(Mix_AllocateChannels(-1) + 1),
+                              std::runtime_error);
+            REQUIRE(!pipeline.attached());
+        }
+        SECTION("Mix_SetPostMix")
+        {
+            pipeline.attachPostMix();
+            REQUIRE(pipeline.attached());
+            // replaces Mix_SetPostMix hook
+            pipeline.attach(MIX_CHANNEL_POST);
+            REQUIRE(pipeline.attached());
+        }
+        SECTION("Mix_CloseAudio removes effects")
+        {
+            pipeline.attach(MIX_CHANNEL_POST);
+            Mix_CloseAudio();
+            REQUIRE(!pipeline.attached());
+            // reopened for closing below
+            REQUIRE(Mix_OpenAudio(FREQUENCY, MIX_DEFAULT_FORMAT, 2, 2048) == 0);
+        }
+    }
+
+    Mix_CloseAudio();
+    SDL_Quit();
+}
+
+TEST_CASE("SDL_mixer effects pipeline throughput: callback budget",
+    "[.][benchmark][sdl2_mixer_util][SDL2][SDL_mixer][EffectsPipeline]")
+{
+    if (SDL_Init(0) != 0) {
+        FAIL(collectErrorQuitSdlMix("SDL_Init"));
+    }
+
+    {
+        for (const SimdLevel level : { SimdLevel::Scalar, bestSimdLevel() }) {
+            const std::string name { simdLevelName(level) };
+            EffectsPipeline f32_pipeline { FREQUENCY, AUDIO_F32SYS, 2, level };
+            EffectsPipeline s16_pipeline { FREQUENCY, AUDIO_S16SYS, 2, level };
+            f32_pipeline.setLimit(0.5f);
+            s16_pipeline.setLimit(0.5f);
+            std::vector<float> f32 { squareF32() };
+            std::vector<Sint16> s16 { squareS16() };
+
+            BENCHMARK("process 1024 F32 frames, " + name) {
+                f32_pipeline.setDuck(f32_pipeline.duck() == 1.0f ? 0.5f : 1.0f);
+                process(f32_pipeline, f32);
+                return f32[0];
+            };
+            BENCHMARK("process 1024 S16 frames, " + name) {
+                s16_pipeline.setDuck(s16_pipeline.duck() == 1.0f ? 0.5f : 1.0f);
+                process(s16_pipeline, s16);
+                return s16[0];
+            };
+            SDL_Log("EffectsPipeline %s: max %.4f%% of F32 and %.4f%% of S16 buffer budgets",
+                    name.c_str(), double(f32_pipeline.timing().max) * 100.0,
+                    double(s16_pipeline.timing().max) * 100.0);
+        }
+    }
+
+    SDL_Quit();
+}
@@ -0,0 +1,220 @@
+#include <catch2/catch_version_macros.hpp>               // CATCH_VERSION_MAJOR
+#if (CATCH_VERSION_MAJOR != 3)
+  #error "tests currently only support Catch2 v3.x"
+#endif
+#include <catch2/catch_test_macros.hpp>                  // TEST_CASE, SECTION, REQUIRE
+#include <catch2/benchmark/catch_benchmark.hpp>          // BENCHMARK
+
+#include "music_playlist.hh"
+#include "sdl2_mixer_smart_ptr.hh"
+
+#include <SDL.h>
+#include <SDL_mixer.h>
+
+#include <chrono>
+#include <cstdio>     // remove
+#include <fstream>
+#include <functional> // function
+#include <stdexcept>  // invalid_argument runtime_error
+#include <string>
+#include <vector>
+
+
+static std::string collectErrorQuitSdlMix(const std::string& func_name) {
+    std::string err { SDL_GetError() };
+    SDL_ClearError();
+    if (err.size() == 0) {
+        err = "failure without setting SDL error";
+    }
+    Mix_Quit();
+    SDL_Quit();
+    return func_name + ": " + err;
+}
+
+using namespace sdl2_mixer_util;
+using namespace std::chrono_literals;
+
+static constexpr int FREQUENCY { 44100 };
+
+static void writeLE(std::ofstream& file, Uint32 value, int bytes) {
+    for (int i {}; i < bytes; ++i)
+        file.put(char((value >> (8 * i)) & 0xff));
+}
+
+// silent 16-bit stereo WAV, which SDL_mixer always supports as music
+static std::string writeWav(const std::string& path, Uint32 ms) {
+    const Uint32 data_size { Uint32(FREQUENCY) * 4 * ms / 1000 };
+    std::ofstream file { path, std::ios::binary };
+    file.write("RIFF", 4);
+    writeLE(file, 36 + data_size, 4);
+    file.write("WAVEfmt ", 8);
+    writeLE(file, 16, 4);
+    writeLE(file, 1, 2);                      // PCM
+    writeLE(file, 2, 2);                      // channels
+    writeLE(file, Uint32(FREQUENCY), 4);
+    writeLE(file, Uint32(FREQUENCY) * 4, 4);  // byte rate
+    writeLE(file, 4, 2);                      // block align
+    writeLE(file, 16, 2);                     // bits per sample
+    file.write("data", 4);
+    writeLE(file, data_size, 4);
+    for (Uint32 i {}; i < data_size; ++i)
+        file.put('\0');
+    return path;
+}
+
+// polls until condition or timeout; returns condition
+static bool waitFor(const std::function<bool()>& condition,
+                    std::chrono::milliseconds timeout = 5000ms) {
+    const auto end { std::chrono::steady_clock::now() + timeout };
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > end)
+            return false;
+        SDL_Delay(5);
+    }
+    return true;
+}
+
+static bool openAudio() {
+    return Mix_OpenAudio(FREQUENCY, AUDIO_S16SYS, 2, 1024) == 0;
+}
+
+TEST_CASE("SDL_mixer music playlist: prefetched playback",
+    "[sdl2_mixer_util][SDL2][SDL_mixer][MusicPlaylist]")
+{
+    if (SDL_Init(SDL_INIT_AUDIO) != 0) {
+        SKIP(collectErrorQuitSdlMix("SDL_Init"));
+    }
+    if (!openAudio()) {
+        SKIP(collectErrorQuitSdlMix("Mix_OpenAudio"));
+    }
+
+    const std::vector<std::string> paths {
+        writeWav("music_playlist_test_0.wav", 300),
+        writeWav("music_playlist_test_1.wav", 300),
+        writeWav("music_playlist_test_2.wav", 300)
+    };
+    const std::string long_path { writeWav("music_playlist_test_long.wav", 5000) };
+
+    {
+        SECTION("invalid arguments")
+        {
+            REQUIRE_THROWS_AS(MusicPlaylist({}), std::invalid_argument);
+            REQUIRE_THROWS_AS(MusicPlaylist(paths, -1ms), std::invalid_argument);
+            MusicPlaylist playlist { paths };
+            // Mix_HookMusic is taken
+            REQUIRE_THROWS_AS(MusicPlaylist(paths), std::runtime_error);
+        }
+        SECTION("tracks hand over without waiting")
+        {
+            MusicPlaylist playlist { paths };
+            REQUIRE(playlist.currentTrack() == MusicPlaylist::NO_TRACK);
+            playlist.play();
+            REQUIRE(playlist.active());
+            REQUIRE(waitFor([&](){ return playlist.currentTrack() == 0; }));
+            REQUIRE(waitFor([&](){ return !playlist.active(); }));
+            const MusicPlaylist::Stats stats { playlist.stats() };
+            REQUIRE(stats.played == 3);
+            REQUIRE(stats.gapless == 2);
+            REQUIRE(stats.late == 0);
+            REQUIRE(stats.failed == 0);
+            REQUIRE(playlist.currentTrack() == MusicPlaylist::NO_TRACK);
+            REQUIRE(Mix_PlayingMusic() == 0);
+        }
+        SECTION("tracks failing to load are skipped")
+        {
+            MusicPlaylist playlist { { paths[0], "no_such_track.wav", paths[1] } };
+            playlist.play();
+            REQUIRE(waitFor([&](){ return !playlist.active(); }));
+            REQUIRE(playlist.stats().played == 2);
+            REQUIRE(playlist.stats().failed == 1);
+            REQUIRE(playlist.lastError().find("no_such_track.wav") != std::string::npos);
+        }
+        SECTION("skip and stop")
+        {
+            MusicPlaylist playlist { { long_path, long_path, paths[0] } };
+            playlist.play();
+            REQUIRE(waitFor([&](){ return playlist.currentTrack() == 0; }));
+            playlist.skip();
+            REQUIRE(waitFor([&](){ return playlist.currentTrack() == 1; }, 1000ms));
+            playlist.stop();
+            REQUIRE(!playlist.active());
+            REQUIRE(waitFor([&](){
+                return playlist.currentTrack() == MusicPlaylist::NO_TRACK; }, 1000ms));
+            REQUIRE(Mix_PlayingMusic() == 0);
+
+            // continues after stopped track
+            playlist.play();
+            REQUIRE(waitFor([&](){ return playlist.currentTrack() == 2; }, 1000ms));
+        }
+        SECTION("crossfade")
+        {
+            MusicPlaylist playlist { { paths[0], paths[1] }, 100ms };
+            playlist.play();
+            REQUIRE(waitFor([&](){ return playlist.currentTrack() == 1; }, 1000ms));
+            playlist.skip();
+            REQUIRE(waitFor([&](){ return !playlist.active(); }, 1000ms));
+            REQUIRE(playlist.stats().played == 2);
+            // second track started while the first faded out
+            REQUIRE(playlist.stats().gapless == 1);
+        }
+        SECTION("volume")
+        {
+            MusicPlaylist playlist { paths };
+            REQUIRE(playlist.volume() == MIX_MAX_VOLUME);
+            playlist.setVolume(MIX_MAX_VOLUME / 2);
+            REQUIRE(playlist.volume() == MIX_MAX_VOLUME / 2);
+            playlist.setVolume(MIX_MAX_VOLUME + 1);
+            REQUIRE(playlist.volume() == MIX_MAX_VOLUME);
+            playlist.setVolume(-1);
+            REQUIRE(playlist.volume() == 0);
+        }
+        SECTION("repeat")
+        {
+            MusicPlaylist playlist { { paths[0] }, 0ms, true };
+            playlist.play();
+            REQUIRE(waitFor([&](){ return playlist.stats().played >= 3; }));
+            REQUIRE(playlist.active());
+        }
+    }
+
+    for (const std::string& path : paths)
+        std::remove(path.c_str());
+    std::remove(long_path.c_str());
+    Mix_CloseAudio();
+    SDL_Quit();
+}
+
+TEST_CASE("SDL_mixer music playlist throughput: caller time per track change",
+    "[.][benchmark][sdl2_mixer_util][SDL2][SDL_mixer][MusicPlaylist]")
+{
+    if (SDL_Init(SDL_INIT_AUDIO) != 0) {
+        SKIP(collectErrorQuitSdlMix("SDL_Init"));
+    }
+    if (!openAudio()) {
+        SKIP(collectErrorQuitSdlMix("Mix_OpenAudio"));
+    }
+
+    const std::string path { writeWav("music_playlist_test_bench.wav", 10000) };
+
+    {
+        BENCHMARK("Mix_LoadMUS and Mix_PlayMusic") {
+            auto music { sdl2_smart_ptr::make_unique(Mix_LoadMUS(path.c_str())) };
+            return Mix_PlayMusic(music.get(), 0);
+        };
+
+        MusicPlaylist playlist { { path }, 0ms, true };
+        playlist.play();
+        BENCHMARK("MusicPlaylist::skip") {
+            playlist.skip();
+        };
+        const MusicPlaylist::Stats stats { playlist.stats() };
+        SDL_Log("MusicPlaylist: %llu played, %llu gapless, %llu late",
+                static_cast<unsigned long long>(stats.played),
+                static_cast<unsigned long long>(stats.gapless),
+                static_cast<unsigned long long>(stats.late));
+    }
+
+    std::remove(path.c_str());
+    Mix_CloseAudio();
+    SDL_Quit();
+}
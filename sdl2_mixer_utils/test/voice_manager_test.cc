@@ -0,0 +1,291 @@
+#include <catch2/catch_version_macros.hpp>               // CATCH_VERSION_MAJOR
+#if (CATCH_VERSION_MAJOR != 3)
+  #error "tests currently only support Catch2 v3.x"
+#endif
+#include <catch2/catch_test_macros.hpp>                  // TEST_CASE, SECTION, REQUIRE
+#include <catch2/benchmark/catch_benchmark.hpp>          // BENCHMARK
+
+#include "voice_manager.hh"
+
+#include <SDL.h>
+#include <SDL_mixer.h>
+
+#include <cstddef>    // size_t
+#include <stdexcept>  // invalid_argument runtime_error
+#include <string>
+#include <vector>
+
+
+static std::string collectErrorQuitSdlMix(const std::string& func_name) {
+    std::string err { SDL_GetError() };
+    SDL_ClearError();
+    if (err.size() == 0) {
+        err = "failure without setting SDL error";
+    }
+    Mix_Quit();
+    SDL_Quit();
+    return func_name + ": " + err;
+}
+
+using namespace sdl2_mixer_util;
+
+static constexpr int FREQUENCY { 44100 };
+static constexpr int CHANNEL_CT { 4 };
+static constexpr std::size_t MAX_VOICES { 16 };
+// bytes of S16 stereo per ms
+static constexpr Uint32 BYTES_PER_MS { FREQUENCY * 4 / 1000 };
+
+// silence, of a duration in ms; buffers must outlast their chunks
+static sdl2_smart_ptr::shared::MixChunk silence(std::vector<Uint8>& buffer, Uint32 ms) {
+    buffer.assign(std::size_t(BYTES_PER_MS) * ms, 0);
+    return sdl2_smart_ptr::make_shared(Mix_QuickLoad_RAW(buffer.data(), Uint32(buffer.size())));
+}
+
+static bool openAudio() {
+    return Mix_OpenAudio(FREQUENCY, AUDIO_S16SYS, 2, 2048) == 0;
+}
+
+TEST_CASE("SDL_mixer voice manager: channel allocation",
+    "[sdl2_mixer_util][SDL2][SDL_mixer][VoiceManager]")
+{
+    if (SDL_Init(SDL_INIT_AUDIO) != 0) {
+        SKIP(collectErrorQuitSdlMix("SDL_Init"));
+    }
+    if (!openAudio()) {
+        SKIP(collectErrorQuitSdlMix("Mix_OpenAudio"));
+    }
+
+    {
+        std::vector<Uint8> long_buffer;
+        std::vector<Uint8> short_buffer;
+        const auto long_chunk { silence(long_buffer, 10000) };
+        const auto short_chunk { silence(short_buffer, 20) };
+        VoiceManager voices { CHANNEL_CT, MAX_VOICES };
+        REQUIRE(Mix_AllocateChannels(-1) == CHANNEL_CT);
+
+        SECTION("invalid arguments")
+        {
+            REQUIRE_THROWS_AS(VoiceManager(0), std::invalid_argument);
+            // Mix_ChannelFinished is taken
+            REQUIRE_THROWS_AS(VoiceManager(CHANNEL_CT), std::runtime_error);
+            REQUIRE_THROWS_AS(voices.play(nullptr), std::invalid_argument);
+            REQUIRE_THROWS_AS(voices.play(long_chunk, VoiceParams{ 0, 1.0f, 0.0f, -2 }),
+                              std::invalid_argument);
+        }
+        SECTION("voices past channel count are virtual")
+        {
+            std::vector<VoiceHandle> handles;
+            for (int i {}; i < CHANNEL_CT + 2; ++i)
+                handles.push_back(voices.play(long_chunk));
+            REQUIRE(voices.realCount() == CHANNEL_CT);
+            REQUIRE(voices.voiceCount() == CHANNEL_CT + 2);
+            REQUIRE(Mix_Playing(-1) == CHANNEL_CT);
+            REQUIRE(voices.isReal(handles.front()));
+            REQUIRE(!voices.isReal(handles.back()));
+            REQUIRE(voices.playing(handles.back()));
+            REQUIRE(voices.stats().virtualized == 2);
+        }
+        SECTION("higher priority steals weakest channel")
+        {
+            for (int i {}; i < CHANNEL_CT; ++i)
+                voices.play(long_chunk, VoiceParams{ 0, 1.0f - float(i) * 0.1f });
+            const VoiceHandle quiet { voices.play(long_chunk, VoiceParams{ 0, 0.2f }) };
+            REQUIRE(!voices.isReal(quiet));
+            REQUIRE(voices.stats().stolen == 0);
+
+            const VoiceHandle urgent { voices.play(long_chunk, VoiceParams{ 1, 0.2f }) };
+            REQUIRE(voices.isReal(urgent));
+            REQUIRE(voices.stats().stolen == 1);
+            REQUIRE(voices.realCount() == CHANNEL_CT);
+            REQUIRE(Mix_Playing(-1) == CHANNEL_CT);
+        }
+        SECTION("stopping frees channel immediately")
+        {
+            std::vector<VoiceHandle> handles;
+            for (int i {}; i < CHANNEL_CT; ++i)
+                handles.push_back(voices.play(long_chunk));
+            voices.stop(handles[1]);
+            REQUIRE(!voices.playing(handles[1]));
+            REQUIRE(voices.realCount() == CHANNEL_CT - 1);
+            REQUIRE(voices.isReal(voices.play(long_chunk)));
+        }
+        SECTION("stale handles")
+        {
+            const VoiceHandle handle { voices.play(long_chunk) };
+            REQUIRE(handle);
+            voices.stop(handle);
+            const VoiceHandle reused { voices.play(long_chunk) };
+            REQUIRE(reused != handle);
+            // no effect on voice now in the same storage
+            voices.stop(handle);
+            voices.setVolume(handle, 0.0f);
+            REQUIRE(!voices.playing(handle));
+            REQUIRE(voices.isReal(reused));
+            REQUIRE(!voices.playing(VoiceHandle{}));
+        }
+        SECTION("finished channels are reclaimed")
+        {
+            const VoiceHandle handle { voices.play(short_chunk) };
+            REQUIRE(voices.isReal(handle));
+            SDL_Delay(200);
+            voices.update();
+            REQUIRE(!voices.playing(handle));
+            REQUIRE(voices.voiceCount() == 0);
+            REQUIRE(voices.realCount() == 0);
+        }
+        SECTION("voice capacity")
+        {
+            for (std::size_t i {}; i < MAX_VOICES; ++i)
+                REQUIRE(voices.play(long_chunk));
+            REQUIRE(!voices.play(long_chunk));
+            REQUIRE(voices.stats().dropped == 1);
+            // replaces weakest voice
+            REQUIRE(voices.play(long_chunk, VoiceParams{ 1 }));
+            REQUIRE(voices.voiceCount() == MAX_VOICES);
+        }
+    }
+
+    Mix_CloseAudio();
+    SDL_Quit();
+}
+
+TEST_CASE("SDL_mixer voice manager: virtual voices and instance limits",
+    "[sdl2_mixer_util][SDL2][SDL_mixer][VoiceManager]")
+{
+    if (SDL_Init(SDL_INIT_AUDIO) != 0) {
+        SKIP(collectErrorQuitSdlMix("SDL_Init"));
+    }
+    if (!openAudio()) {
+        SKIP(collectErrorQuitSdlMix("Mix_OpenAudio"));
+    }
+
+    {
+        std::vector<Uint8> long_buffer;
+        std::vector<Uint8> short_buffer;
+        const auto long_chunk { silence(long_buffer, 10000) };
+        const auto short_chunk { silence(short_buffer, 20) };
+        VoiceManager voices { CHANNEL_CT, MAX_VOICES };
+
+        SECTION("distant loops are virtualized, then promoted")
+        {
+            const VoiceHandle loop { voices.play(long_chunk, VoiceParams{ 0, 1.0f, 0.5f, -1 }) };
+            REQUIRE(voices.isReal(loop));
+            voices.setDistance(loop, 1.0f);
+            voices.update();
+            REQUIRE(!voices.isReal(loop));
+            REQUIRE(voices.playing(loop));
+            REQUIRE(Mix_Playing(-1) == 0);
+
+            voices.setDistance(loop, 0.0f);
+            voices.update();
+            REQUIRE(voices.isReal(loop));
+            REQUIRE(voices.stats().promoted == 1);
+        }
+        SECTION("inaudible voices never take channels")
+        {
+            const VoiceHandle silent { voices.play(long_chunk, VoiceParams{ 5, 0.0f }) };
+            voices.update();
+            REQUIRE(voices.playing(silent));
+            REQUIRE(!voices.isReal(silent));
+            REQUIRE(voices.realCount() == 0);
+        }
+        SECTION("one-shots are promoted only just after playing")
+        {
+            std::vector<VoiceHandle> loops;
+            for (int i {}; i < CHANNEL_CT; ++i)
+                loops.push_back(voices.play(long_chunk, VoiceParams{ 1, 1.0f, 0.0f, -1 }));
+            const VoiceHandle late { voices.play(long_chunk) };
+            const VoiceHandle prompt { voices.play(long_chunk, VoiceParams{ 0, 0.5f }) };
+            REQUIRE(!voices.isReal(late));
+            REQUIRE(!voices.isReal(prompt));
+
+            voices.stop(loops[0]);
+            voices.update();
+            // louder one-shot first
+            REQUIRE(voices.isReal(late));
+            REQUIRE(!voices.isReal(prompt));
+
+            voices.stop(loops[1]);
+            SDL_Delay(Uint32(VoiceManager::PROMOTE_WINDOW_MS) + 50);
+            voices.update();
+            REQUIRE(!voices.isReal(prompt));
+            REQUIRE(voices.playing(prompt));
+        }
+        SECTION("virtual one-shots run out")
+        {
+            for (int i {}; i < CHANNEL_CT; ++i)
+                voices.play(long_chunk, VoiceParams{ 1 });
+            const VoiceHandle handle { voices.play(short_chunk) };
+            REQUIRE(!voices.isReal(handle));
+            SDL_Delay(200);
+            voices.update();
+            REQUIRE(!voices.playing(handle));
+        }
+        SECTION("instance limits")
+        {
+            voices.setInstanceLimit(long_chunk, 2);
+            const VoiceHandle first { voices.play(long_chunk, VoiceParams{ 0, 0.5f }) };
+            const VoiceHandle second { voices.play(long_chunk) };
+            REQUIRE(!voices.play(long_chunk, VoiceParams{ 0, 0.5f }));
+            REQUIRE(voices.stats().dropped == 1);
+
+            // louder than first
+            const VoiceHandle third { voices.play(long_chunk) };
+            REQUIRE(third);
+            REQUIRE(!voices.playing(first));
+            REQUIRE(voices.playing(second));
+            REQUIRE(voices.voiceCount() == 2);
+            // other sounds are not limited
+            REQUIRE(voices.play(short_chunk));
+
+            voices.setInstanceLimit(long_chunk, 0);
+            REQUIRE(voices.play(long_chunk, VoiceParams{ 0, 0.5f }));
+        }
+    }
+
+    Mix_CloseAudio();
+    SDL_Quit();
+}
+
+TEST_CASE("SDL_mixer voice manager throughput: hundreds of plays per frame",
+    "[.][benchmark][sdl2_mixer_util][SDL2][SDL_mixer][VoiceManager]")
+{
+    if (SDL_Init(SDL_INIT_AUDIO) != 0) {
+        SKIP(collectErrorQuitSdlMix("SDL_Init"));
+    }
+    if (!openAudio()) {
+        SKIP(collectErrorQuitSdlMix("Mix_OpenAudio"));
+    }
+
+    {
+        static constexpr int PLAYS_PER_FRAME { 256 };
+        std::vector<Uint8> buffers[4];
+        std::vector<sdl2_smart_ptr::shared::MixChunk> chunks;
+        for (std::size_t i {}; i < 4; ++i)
+            chunks.push_back(silence(buffers[i], Uint32(50 + 100 * i)));
+        VoiceManager voices { 32, 1024 };
+        voices.setInstanceLimit(chunks[0], 16);
+        Uint32 seed { 1 };
+
+        BENCHMARK("play 256 voices and update") {
+            for (int i {}; i < PLAYS_PER_FRAME; ++i) {
+                seed = seed * 1664525 + 1013904223;
+                voices.play(chunks[seed >> 30], VoiceParams{
+                        int(seed >> 28 & 3), float(seed >> 8 & 0xff) / 255.0f,
+                        float(seed >> 16 & 0xff) / 255.0f });
+            }
+            voices.update();
+            return voices.voiceCount();
+        };
+        const VoiceManager::Stats& stats { voices.stats() };
+        SDL_Log("VoiceManager: %llu played, %llu virtualized, %llu promoted, %llu stolen, "
+                "%llu dropped", static_cast<unsigned long long>(stats.played),
+                static_cast<unsigned long long>(stats.virtualized),
+                static_cast<unsigned long long>(stats.promoted),
+                static_cast<unsigned long long>(stats.stolen),
+                static_cast<unsigned long long>(stats.dropped));
+    }
+
+    Mix_CloseAudio();
+    SDL_Quit();
+}
@@ -0,0 +1,103 @@
+#include "framed_connection.hh"
+
+#include "safeSdlCall.hh"
+
+#include <cstring>    // memcpy memmove
+#include <limits>     // numeric_limits
+#include <stdexcept>  // invalid_argument length_error
+#include <utility>    // move
+
+
+namespace sdl2_net_util {
+
+FramedConnection::FramedConnection(sdl2_smart_ptr::unique::TcpSocket sock,
+                                   std::size_t max_frame_size,
+                                   std::size_t write_coalesce_size) :
+    sock_(std::move(sock)), max_frame_size_(max_frame_size),
+    write_coalesce_size_(write_coalesce_size) {
+    if (sock_ == nullptr)
+        throw std::invalid_argument("FramedConnection: null socket");
+    // SDLNet_TCP_Recv/Send lengths are int
+    constexpr std::size_t size_limit {
+        std::size_t(std::numeric_limits<int>::max() / 4)
+    };
+    if (max_frame_size_ + HEADER_SIZE > size_limit ||
+        write_coalesce_size_ > size_limit)
+        throw std::invalid_argument("FramedConnection: buffer sizes too large");
+    read_buf_.resize(2 * (max_frame_size_ + HEADER_SIZE));
+    write_buf_.reserve(write_coalesce_size_ + max_frame_size_ + HEADER_SIZE);
+}
+
+bool FramedConnection::receive() {
+    if (!open_)
+        return false;
+    if (read_pos_ == read_end_) {
+        read_pos_ = read_end_ = 0;
+    } else if (read_buf_.size() - read_end_ < max_frame_size_ + HEADER_SIZE) {
+        const std::size_t unread { read_end_ - read_pos_ };
+        std::memmove(read_buf_.data(), read_buf_.data() + read_pos_, unread);
+        stats_.bytes_compacted += unread;
+        read_pos_ = 0;
+        read_end_ = unread;
+    }
+    // unconsumed frames fill buffer
+    if (read_end_ == read_buf_.size())
+        return true;
+
+    const int recv_ct {
+        SDLNet_TCP_Recv(sock_.get(), read_buf_.data() + read_end_,
+                        int(read_buf_.size() - read_end_))
+    };
+    ++stats_.recv_calls;
+    if (recv_ct <= 0) {
+        open_ = false;
+        return false;
+    }
+    read_end_ += std::size_t(recv_ct);
+    stats_.bytes_received += std::size_t(recv_ct);
+    return true;
+}
+
+bool FramedConnection::nextFrame(ByteSpan& frame) {
+    if (read_end_ - read_pos_ < HEADER_SIZE)
+        return false;
+    const Uint8* header { read_buf_.data() + read_pos_ };
+    const std::size_t size { SDLNet_Read32(header) };
+    if (size > max_frame_size_)
+        throw std::length_error("FramedConnection: received frame exceeds max_frame_size");
+    if (read_end_ - read_pos_ < HEADER_SIZE + size)
+        return false;
+    frame.data = header + HEADER_SIZE;
+    frame.size = size;
+    read_pos_ += HEADER_SIZE + size;
+    ++stats_.frames_received;
+    return true;
+}
+
+void FramedConnection::send(const void* data, std::size_t size) {
+    if (size > max_frame_size_)
+        throw std::length_error("FramedConnection: frame exceeds max_frame_size");
+    const std::size_t offset { write_buf_.size() };
+    write_buf_.resize(offset + HEADER_SIZE + size);
+    SDLNet_Write32(Uint32(size), write_buf_.data() + offset);
+    if (size > 0)
+        std::memcpy(write_buf_.data() + offset + HEADER_SIZE, data, size);
+    ++stats_.frames_sent;
+    if (write_buf_.size() >= write_coalesce_size_)
+        flush();
+}
+
+void FramedConnection::flush() {
+    if (write_buf_.empty())
+        return;
+    const int len { int(write_buf_.size()) };
+    // SDLNet_TCP_Send returns less than len on error
+    safeSdlCall(SDLNet_TCP_Send, "SDLNet_TCP_Send",
+                SdlRetTest<int>{ [len](const int ret){ return (ret < len); } },
+                sock_.get(), static_cast<const void*>(write_buf_.data()), len);
+    ++stats_.send_calls;
+    stats_.bytes_sent += write_buf_.size();
+    write_buf_.clear();
+}
+
+}  // namespace sdl2_net_util
@@ -0,0 +1,78 @@
+#ifndef FRAMED_CONNECTION_HH
+#define FRAMED_CONNECTION_HH
+
+#include "sdl2_net_smart_ptr.hh"  // unique::TcpSocket
+
+#include "SDL_net.h"              // TCPsocket
+#include "SDL_stdinc.h"           // Uint8
+
+#include <cstddef>                // size_t
+#include <cstdint>                // uint64_t
+#include <vector>
+
+
+namespace sdl2_net_util {
+
+// read-only view of bytes owned elsewhere (C++17 has no std::span)
+struct ByteSpan {
+    const Uint8* data {};
+    std::size_t size {};
+};
+
+// Frames messages over a TCP socket with a 4 byte big endian length. receive()
+//   makes one SDLNet_TCP_Recv, which blocks, so is best called once the
+//   socket is ready, and nextFrame() returns spans into the receive buffer
+//   without copying. send() queues frames, sent together once
+//   write_coalesce_size is reached or on flush().
+class FramedConnection {
+public:
+    static constexpr std::size_t HEADER_SIZE { 4 };
+
+    struct Stats {
+        std::uint64_t frames_received {};
+        std::uint64_t frames_sent {};
+        std::uint64_t recv_calls {};
+        std::uint64_t send_calls {};
+        std::uint64_t bytes_received {};
+        std::uint64_t bytes_sent {};
+        std::uint64_t bytes_compacted {};
+    };
+
+    explicit FramedConnection(sdl2_smart_ptr::unique::TcpSocket sock,
+                              std::size_t max_frame_size = 64 * 1024,
+                              std::size_t write_coalesce_size = 16 * 1024);
+
+    // returns false once peer has closed connection or a receive error
+    //   occurs; invalidates spans from nextFrame()
+    bool receive();
+    // throws std::length_error if peer announces frame over max_frame_size
+    bool nextFrame(ByteSpan& frame);
+
+    // throws std::length_error if size exceeds max_frame_size
+    void send(const void* data, std::size_t size);
+    void flush();
+
+    bool isOpen() const { return open_; }
+    TCPsocket socket() const { return sock_.get(); }
+    std::size_t maxFrameSize() const { return max_frame_size_; }
+    std::size_t queuedBytes() const { return write_buf_.size(); }
+    const Stats& stats() const { return stats_; }
+
+private:
+    sdl2_smart_ptr::unique::TcpSocket sock_;
+    std::size_t max_frame_size_;
+    std::size_t write_coalesce_size_;
+    // holds two maximum size frames, so that a read always has room for
+    //   at least one more after compaction
+    std::vector<Uint8> read_buf_;
+    std::size_t read_pos_ {};
+    std::size_t read_end_ {};
+    std::vector<Uint8> write_buf_;
+    bool open_ { true };
+    Stats stats_;
+};
+
+}  // namespace sdl2_net_util
+
+
+#endif  // FRAMED_CONNECTION_HH
@@ -0,0 +1,70 @@
+#ifndef SOCKET_REACTOR_HH
+#define SOCKET_REACTOR_HH
+
+#include "sdl2_net_smart_ptr.hh"  // unique::TcpSocket
+
+#include "SDL_net.h"              // TCPsocket
+#include "SDL_stdinc.h"           // Uint32
+
+#include <cstddef>                // size_t
+#include <functional>             // function
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+
+namespace sdl2_net_util {
+
+// Runs a callback for each owned TCP socket ready for reading (or, for
+//   server sockets, with a connection to accept). Rather than a select based
+//   SDLNet_SocketSet, the descriptors behind the sockets are waited on with
+//   epoll on Linux and poll elsewhere, so there is no FD_SETSIZE cap and the
+//   reactor grows as sockets are added. Callbacks may add or remove sockets.
+//   Not thread safe.
+class SocketReactor {
+public:
+    using Callback = std::function<void(TCPsocket)>;
+
+    // throws std::runtime_error if the epoll instance can not be created
+    SocketReactor();
+    ~SocketReactor();
+
+    SocketReactor(const SocketReactor&) = delete;
+    SocketReactor& operator=(const SocketReactor&) = delete;
+
+    // returns raw socket for use as key in remove(); throws
+    //   std::runtime_error if its descriptor can not be watched
+    TCPsocket add(sdl2_smart_ptr::unique::TcpSocket sock, Callback on_ready);
+    // returns ownership of socket, or nullptr if not registered
+    sdl2_smart_ptr::unique::TcpSocket remove(TCPsocket sock);
+    bool contains(TCPsocket sock) const;
+
+    // waits up to timeout_ms for any socket to be ready, then runs callbacks
+    //   of all ready sockets, which see SDLNet_SocketReady as true; returns
+    //   count of callbacks run
+    int poll(Uint32 timeout_ms);
+
+    std::size_t size() const { return members_.size(); }
+
+private:
+    struct Entry {
+        sdl2_smart_ptr::unique::TcpSocket sock;
+        Callback on_ready;
+        std::size_t slot {};
+        bool active { true };
+    };
+    using EntryPtr = std::shared_ptr<Entry>;
+    // epoll instance or pollfd array, see socket_reactor.cc
+    struct Poller;
+
+    std::unique_ptr<Poller> poller_;
+    std::vector<EntryPtr> members_;
+    std::unordered_map<TCPsocket, EntryPtr> entries_;
+    // reused between polls to avoid allocation
+    std::vector<EntryPtr> ready_;
+};
+
+}  // namespace sdl2_net_util
+
+
+#endif  // SOCKET_REACTOR_HH
@@ -0,0 +1,102 @@
+#ifndef UDP_PACKET_POOL_HH
+#define UDP_PACKET_POOL_HH
+
+#include "SDL_net.h"  // UDPpacket UDPsocket IPaddress
+
+#include <array>
+#include <cstddef>    // size_t
+#include <cstdint>    // uint64_t
+#include <memory>
+#include <vector>
+
+
+namespace sdl2_net_util {
+
+// Recycles UDPpackets in power of 2 capacity classes instead of freeing them,
+//   so steady-state send/receive loops don't allocate. Not thread safe; must
+//   outlive every Packet it hands out.
+class UdpPacketPool {
+public:
+    // returns packet to its pool instead of calling SDLNet_FreePacket
+    struct Recycler {
+        UdpPacketPool* pool {};
+        void operator()(UDPpacket*) const;
+    };
+    using Packet = std::unique_ptr<UDPpacket, Recycler>;
+
+    struct Stats {
+        std::uint64_t allocated {};
+        std::uint64_t reused {};
+        std::uint64_t freed {};
+        std::size_t outstanding {};
+        std::size_t pooled {};
+    };
+
+    static constexpr int MIN_CAPACITY { 1 << 6 };
+    // exceeds largest possible UDP payload of 65507 bytes
+    static constexpr int MAX_CAPACITY { 1 << 16 };
+
+    UdpPacketPool() = default;
+    ~UdpPacketPool();
+
+    UdpPacketPool(const UdpPacketPool&) = delete;
+    UdpPacketPool& operator=(const UdpPacketPool&) = delete;
+
+    // packet has maxlen >= min_capacity, len 0 and channel -1
+    Packet acquire(int min_capacity);
+    // preallocates count packets of at least min_capacity
+    void reserve(int min_capacity, std::size_t count);
+    // frees all pooled packets
+    void trim();
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    static constexpr std::size_t CLASS_CT { 11 };  // 2^6 .. 2^16
+
+    void recycle(UDPpacket* packet);
+
+    std::array<std::vector<UDPpacket*>, CLASS_CT> free_lists_;
+    Stats stats_;
+};
+
+// Fixed size batch of pooled packets, sent or received in one
+//   SDLNet_UDP_SendV or SDLNet_UDP_RecvV call
+class UdpBatch {
+public:
+    UdpBatch(UdpPacketPool& pool, std::size_t max_packets, int packet_capacity);
+
+    // copy datagram into next packet, addressed either by IP or by channel
+    //   bound with SDLNet_UDP_Bind; returns false if batch is full or len
+    //   exceeds packet_capacity
+    bool push(const void* data, int len, const IPaddress& address);
+    bool push(const void* data, int len, int channel);
+
+    // sends all pushed packets and clears batch, returns count sent
+    int send(UDPsocket sock);
+    // replaces batch contents with as many datagrams as are waiting, up to
+    //   capacity(), returns count received
+    int recv(UDPsocket sock);
+
+    void clear() { size_ = 0; }
+    std::size_t size() const { return size_; }
+    std::size_t capacity() const { return packets_.size(); }
+    bool empty() const { return size_ == 0; }
+    bool full() const { return size_ == packets_.size(); }
+
+    UDPpacket& operator[](std::size_t i) { return *vector_[i]; }
+    const UDPpacket& operator[](std::size_t i) const { return *vector_[i]; }
+
+private:
+    UDPpacket* next(int len);
+
+    std::vector<UdpPacketPool::Packet> packets_;
+    // NULL-terminated, as expected by SDLNet_UDP_RecvV
+    std::vector<UDPpacket*> vector_;
+    std::size_t size_ {};
+};
+
+}  // namespace sdl2_net_util
+
+
+#endif  // UDP_PACKET_POOL_HH
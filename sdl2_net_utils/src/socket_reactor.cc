@@ -0,0 +1,209 @@
+#include "socket_reactor.hh"
+
+#ifdef _WIN32
+#  include <winsock2.h>    // SOCKET WSAPoll WSAGetLastError
+#else
+#  ifdef __linux__
+#    include <sys/epoll.h> // epoll_create1 epoll_ctl epoll_wait
+#    include <unistd.h>    // close
+#  else
+#    include <poll.h>      // poll
+#  endif
+#  include <cerrno>
+#  include <cstring>       // strerror
+#endif
+
+#include <algorithm>       // min
+#include <climits>         // INT_MAX
+#include <stdexcept>       // invalid_argument runtime_error
+#include <string>
+#include <utility>         // move
+
+
+namespace sdl2_net_util {
+
+#ifdef _WIN32
+using Descriptor = SOCKET;
+
+static std::runtime_error pollError(const std::string& func_name) {
+    return std::runtime_error("SocketReactor: " + func_name + " failed, error " +
+                              std::to_string(WSAGetLastError()));
+}
+#else
+using Descriptor = int;
+
+static std::runtime_error pollError(const std::string& func_name) {
+    return std::runtime_error("SocketReactor: " + func_name + " failed: " +
+                              std::strerror(errno));
+}
+#endif
+
+// SDL_net 2 does not expose the descriptor behind a TCPsocket; this mirrors
+//   the start of struct _TCPsocket in SDLnetTCP.c, unchanged through 2.x
+struct TcpSocketLayout {
+    int ready;
+    Descriptor channel;
+};
+
+static TcpSocketLayout* layout(TCPsocket sock) {
+    return reinterpret_cast<TcpSocketLayout*>(sock);
+}
+
+#ifdef __linux__
+
+struct SocketReactor::Poller {
+    int fd;
+    // reused between waits, grown with member count
+    std::vector<epoll_event> events;
+
+    Poller() : fd(epoll_create1(EPOLL_CLOEXEC)) {
+        if (fd == -1)
+            throw pollError("epoll_create1");
+    }
+    ~Poller() { close(fd); }
+
+    void watch(const Descriptor channel, Entry* entry) {
+        epoll_event event {};
+        event.events = EPOLLIN;
+        event.data.ptr = entry;
+        if (epoll_ctl(fd, EPOLL_CTL_ADD, channel, &event) == -1)
+            throw pollError("epoll_ctl");
+    }
+
+    void unwatch(const Descriptor channel, std::size_t) {
+        // only fails if never watched
+        epoll_ctl(fd, EPOLL_CTL_DEL, channel, nullptr);
+    }
+
+    void wait(const int timeout_ms, const std::vector<EntryPtr>& members,
+              std::vector<EntryPtr>& ready) {
+        events.resize(members.size());
+        const int ready_ct { epoll_wait(fd, events.data(), int(events.size()),
+                                        timeout_ms) };
+        if (ready_ct == -1) {
+            if (errno == EINTR)
+                return;
+            throw pollError("epoll_wait");
+        }
+        // entries can not have been removed since the wait, so slots are current
+        for (int i {}; i < ready_ct; ++i)
+            ready.push_back(members[static_cast<Entry*>(events[std::size_t(i)].data.ptr)->slot]);
+    }
+};
+
+#else
+
+struct SocketReactor::Poller {
+#  ifdef _WIN32
+    using PollFd = WSAPOLLFD;
+#  else
+    using PollFd = pollfd;
+#  endif
+    // parallel to members_
+    std::vector<PollFd> fds;
+
+    void watch(const Descriptor channel, Entry*) {
+        PollFd poll_fd {};
+        poll_fd.fd = channel;
+        poll_fd.events = POLLIN;
+        fds.push_back(poll_fd);
+    }
+
+    // mirrors swap with last member in SocketReactor::remove
+    void unwatch(const Descriptor, const std::size_t slot) {
+        fds[slot] = fds.back();
+        fds.pop_back();
+    }
+
+    void wait(const int timeout_ms, const std::vector<EntryPtr>& members,
+              std::vector<EntryPtr>& ready) {
+#  ifdef _WIN32
+        int ready_ct { WSAPoll(fds.data(), ULONG(fds.size()), timeout_ms) };
+        if (ready_ct == SOCKET_ERROR)
+            throw pollError("WSAPoll");
+#  else
+        int ready_ct { ::poll(fds.data(), nfds_t(fds.size()), timeout_ms) };
+        if (ready_ct == -1) {
+            if (errno == EINTR)
+                return;
+            throw pollError("poll");
+        }
+#  endif
+        // poll reports only a count, so revents are scanned, stopping at the
+        //   last ready descriptor
+        for (std::size_t i {}; ready_ct > 0 && i < fds.size(); ++i) {
+            if (fds[i].revents != 0) {
+                ready.push_back(members[i]);
+                --ready_ct;
+            }
+        }
+    }
+};
+
+#endif  // __linux__
+
+SocketReactor::SocketReactor() :
+    poller_(std::make_unique<Poller>()) {}
+
+SocketReactor::~SocketReactor() = default;
+
+TCPsocket SocketReactor::add(sdl2_smart_ptr::unique::TcpSocket sock,
+                             Callback on_ready) {
+    if (sock == nullptr)
+        throw std::invalid_argument("SocketReactor: cannot add null socket");
+    TCPsocket raw { sock.get() };
+
+    auto entry { std::make_shared<Entry>() };
+    poller_->watch(layout(raw)->channel, entry.get());
+    entry->sock = std::move(sock);
+    entry->on_ready = std::move(on_ready);
+    entry->slot = members_.size();
+    members_.push_back(entry);
+    entries_.emplace(raw, std::move(entry));
+    return raw;
+}
+
+sdl2_smart_ptr::unique::TcpSocket SocketReactor::remove(TCPsocket sock) {
+    auto it { entries_.find(sock) };
+    if (it == entries_.end())
+        return nullptr;
+    EntryPtr entry { std::move(it->second) };
+    entries_.erase(it);
+
+    poller_->unwatch(layout(sock)->channel, entry->slot);
+    members_[entry->slot] = std::move(members_.back());
+    members_[entry->slot]->slot = entry->slot;
+    members_.pop_back();
+
+    // entry may still be referenced by poll() in progress
+    entry->active = false;
+    return std::move(entry->sock);
+}
+
+bool SocketReactor::contains(TCPsocket sock) const {
+    return entries_.find(sock) != entries_.end();
+}
+
+int SocketReactor::poll(Uint32 timeout_ms) {
+    if (members_.empty())
+        return 0;
+
+    ready_.clear();
+    poller_->wait(int(std::min<Uint32>(timeout_ms, INT_MAX)), members_, ready_);
+    // set the flag SDLNet_CheckSockets would have, cleared by SDLNet_TCP_Recv
+    //   and SDLNet_TCP_Accept
+    for (const auto& entry : ready_)
+        layout(entry->sock.get())->ready = 1;
+    int dispatch_ct {};
+    for (const auto& entry : ready_) {
+        // skip sockets removed by earlier callbacks
+        if (!entry->active)
+            continue;
+        entry->on_ready(entry->sock.get());
+        ++dispatch_ct;
+    }
+    ready_.clear();
+    return dispatch_ct;
+}
+
+}  // namespace sdl2_net_util
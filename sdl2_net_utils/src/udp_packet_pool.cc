@@ -0,0 +1,152 @@
+#include "udp_packet_pool.hh"
+
+#include "safeSdlCall.hh"
+
+#include <cstring>    // memcpy
+#include <stdexcept>  // invalid_argument
+
+
+namespace sdl2_net_util {
+
+// index of smallest class holding capacity
+static std::size_t classFor(int capacity) {
+    std::size_t idx {};
+    for (int class_cap { UdpPacketPool::MIN_CAPACITY };
+         class_cap < capacity; class_cap <<= 1)
+        ++idx;
+    return idx;
+}
+
+void UdpPacketPool::Recycler::operator()(UDPpacket* packet) const {
+    pool->recycle(packet);
+}
+
+UdpPacketPool::~UdpPacketPool() {
+    trim();
+}
+
+UdpPacketPool::Packet UdpPacketPool::acquire(int min_capacity) {
+    if (min_capacity > MAX_CAPACITY)
+        throw std::invalid_argument("UdpPacketPool: capacity exceeds MAX_CAPACITY");
+    const std::size_t idx { classFor(min_capacity) };
+    UDPpacket* packet {};
+    if (free_lists_[idx].empty()) {
+        packet = safeSdlCall(
+            SDLNet_AllocPacket, "SDLNet_AllocPacket",
+            SdlRetTest<UDPpacket*>{
+                [](const UDPpacket* ret){ return (ret == nullptr); } },
+            MIN_CAPACITY << idx);
+        ++stats_.allocated;
+    } else {
+        packet = free_lists_[idx].back();
+        free_lists_[idx].pop_back();
+        --stats_.pooled;
+        ++stats_.reused;
+    }
+    packet->channel = -1;
+    packet->len = 0;
+    packet->status = 0;
+    packet->address = {};
+    ++stats_.outstanding;
+    return Packet{ packet, Recycler{ this } };
+}
+
+void UdpPacketPool::reserve(int min_capacity, std::size_t count) {
+    std::vector<Packet> packets;
+    packets.reserve(count);
+    for (std::size_t i {}; i < count; ++i)
+        packets.push_back(acquire(min_capacity));
+    // packets return to pool on scope exit
+}
+
+void UdpPacketPool::recycle(UDPpacket* packet) {
+    --stats_.outstanding;
+    // packet may have been resized by SDLNet_ResizePacket, so file under
+    //   largest class it still satisfies
+    if (packet->maxlen < MIN_CAPACITY) {
+        SDLNet_FreePacket(packet);
+        ++stats_.freed;
+        return;
+    }
+    std::size_t idx { CLASS_CT - 1 };
+    if (packet->maxlen < MAX_CAPACITY) {
+        idx = classFor(packet->maxlen);
+        if ((MIN_CAPACITY << idx) > packet->maxlen)
+            --idx;
+    }
+    free_lists_[idx].push_back(packet);
+    ++stats_.pooled;
+}
+
+void UdpPacketPool::trim() {
+    for (auto& free_list : free_lists_) {
+        for (UDPpacket* packet : free_list)
+            SDLNet_FreePacket(packet);
+        stats_.freed += free_list.size();
+        free_list.clear();
+    }
+    stats_.pooled = 0;
+}
+
+UdpBatch::UdpBatch(UdpPacketPool& pool, std::size_t max_packets,
+                   int packet_capacity) {
+    packets_.reserve(max_packets);
+    vector_.reserve(max_packets + 1);
+    for (std::size_t i {}; i < max_packets; ++i) {
+        packets_.push_back(pool.acquire(packet_capacity));
+        vector_.push_back(packets_.back().get());
+    }
+    vector_.push_back(nullptr);
+}
+
+UDPpacket* UdpBatch::next(int len) {
+    if (full() || len < 0 || len > vector_[size_]->maxlen)
+        return nullptr;
+    return vector_[size_++];
+}
+
+bool UdpBatch::push(const void* data, int len, const IPaddress& address) {
+    UDPpacket* packet { next(len) };
+    if (packet == nullptr)
+        return false;
+    std::memcpy(packet->data, data, std::size_t(len));
+    packet->len = len;
+    packet->channel = -1;
+    packet->address = address;
+    return true;
+}
+
+bool UdpBatch::push(const void* data, int len, int channel) {
+    UDPpacket* packet { next(len) };
+    if (packet == nullptr)
+        return false;
+    std::memcpy(packet->data, data, std::size_t(len));
+    packet->len = len;
+    packet->channel = channel;
+    return true;
+}
+
+int UdpBatch::send(UDPsocket sock) {
+    if (empty())
+        return 0;
+    // SDLNet_UDP_SendV returns count of packets sent, 0 only on failure
+    const int sent_ct {
+        safeSdlCall(SDLNet_UDP_SendV, "SDLNet_UDP_SendV",
+                    SdlRetTest<int>{ [](const int ret){ return (ret == 0); } },
+                    sock, vector_.data(), int(size_))
+    };
+    clear();
+    return sent_ct;
+}
+
+int UdpBatch::recv(UDPsocket sock) {
+    const int recv_ct {
+        safeSdlCall(SDLNet_UDP_RecvV, "SDLNet_UDP_RecvV",
+                    SdlRetTest<int>{ [](const int ret){ return (ret == -1); } },
+                    sock, vector_.data())
+    };
+    size_ = std::size_t(recv_ct);
+    return recv_ct;
+}
+
+}  // namespace sdl2_net_util
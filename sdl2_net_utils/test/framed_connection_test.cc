@@ -0,0 +1,205 @@
+#include <catch2/catch_version_macros.hpp>               // CATCH_VERSION_MAJOR
+#if (CATCH_VERSION_MAJOR != 3)
+  #error "tests currently only support Catch2 v3.x"
+#endif
+#include <catch2/catch_test_macros.hpp>                  // TEST_CASE, SECTION, REQUIRE
+#include <catch2/benchmark/catch_benchmark.hpp>          // BENCHMARK
+
+#include "framed_connection.hh"
+
+#include <SDL.h>
+#include <SDL_net.h>
+
+#include <algorithm>  // sort
+#include <memory>     // make_unique
+#include <stdexcept>  // length_error
+#include <string>
+#include <vector>
+
+
+static std::string collectErrorQuitSdlNet(const std::string& func_name) {
+    std::string err { SDL_GetError() };
+    SDL_ClearError();
+    if (err.size() == 0) {
+        err = "failure without setting SDL error";
+    }
+    SDLNet_Quit();
+    SDL_Quit();
+    return func_name + ": " + err;
+}
+
+using namespace sdl2_net_util;
+using namespace sdl2_smart_ptr;
+
+// connects client and server ends of loopback TCP connection; SDL_net can not
+//   report local port of server socket, so probes for free port
+static bool openLoopbackPair(unique::TcpSocket& client,
+                             unique::TcpSocket& server_end) {
+    unique::TcpSocket server;
+    Uint16 port { 40100 };
+    for ( ; port < 40200 && server == nullptr; ++port) {
+        IPaddress address;
+        if (SDLNet_ResolveHost(&address, nullptr, port) != 0)
+            return false;
+        server = make_unique(SDLNet_TCP_Open(&address));
+    }
+    if (server == nullptr)
+        return false;
+    IPaddress address;
+    if (SDLNet_ResolveHost(&address, "localhost", Uint16(port - 1)) != 0)
+        return false;
+    client = make_unique(SDLNet_TCP_Open(&address));
+    if (client == nullptr)
+        return false;
+    // server sockets are non-blocking
+    const Uint64 deadline { SDL_GetTicks64() + 2000 };
+    while (server_end == nullptr && SDL_GetTicks64() < deadline)
+        server_end = make_unique(SDLNet_TCP_Accept(server.get()));
+    return server_end != nullptr;
+}
+
+// receives until frame_ct frames are collected or connection closes
+static std::vector<std::string> receiveFrames(FramedConnection& conn,
+                                              const std::size_t frame_ct) {
+    std::vector<std::string> frames;
+    ByteSpan frame;
+    while (frames.size() < frame_ct && conn.receive()) {
+        while (conn.nextFrame(frame)) {
+            frames.emplace_back(reinterpret_cast<const char*>(frame.data),
+                                frame.size);
+        }
+    }
+    return frames;
+}
+
+TEST_CASE("SDL_net message framing: FramedConnection",
+    "[sdl2_net_util][SDL2][SDL_net][FramedConnection]")
+{
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        FAIL(collectErrorQuitSdlNet("SDL_Init"));
+    }
+
+    if (SDLNet_Init() != 0) {
+        FAIL(collectErrorQuitSdlNet("SDLNet_Init"));
+    }
+
+    {
+        unique::TcpSocket client_sock, server_sock;
+        if (!openLoopbackPair(client_sock, server_sock)) {
+            SKIP(collectErrorQuitSdlNet("openLoopbackPair"));
+        }
+
+        constexpr std::size_t max_frame_size { 100 };
+        // held by pointer so that client can close its end
+        auto client { std::make_unique<FramedConnection>(
+                std::move(client_sock), max_frame_size, 1024) };
+        FramedConnection server { std::move(server_sock), max_frame_size, 1024 };
+
+        SECTION("small frames are coalesced into one send")
+        {
+            const std::vector<std::string> msgs { "a", "", "bcd", "efghij" };
+            for (const auto& msg : msgs)
+                client->send(msg.data(), msg.size());
+            REQUIRE(client->stats().send_calls == 0);
+            client->flush();
+            REQUIRE(client->stats().send_calls == 1);
+            REQUIRE(client->queuedBytes() == 0);
+
+            REQUIRE(receiveFrames(server, msgs.size()) == msgs);
+        }
+        SECTION("frames split across receives are reassembled")
+        {
+            std::vector<std::string> msgs;
+            for (int i {}; i < 200; ++i)
+                msgs.emplace_back(max_frame_size - std::size_t(i % 7), char('a' + i % 26));
+            for (const auto& msg : msgs)
+                client->send(msg.data(), msg.size());
+            client->flush();
+            REQUIRE(client->stats().send_calls < msgs.size());
+
+            REQUIRE(receiveFrames(server, msgs.size()) == msgs);
+            REQUIRE(server.stats().recv_calls > 1);
+            REQUIRE(server.stats().bytes_compacted > 0);
+        }
+        SECTION("oversized frames")
+        {
+            const std::string msg(max_frame_size + 1, 'x');
+            REQUIRE_THROWS_AS(client->send(msg.data(), msg.size()),
+                              std::length_error);
+        }
+        SECTION("peer close")
+        {
+            client.reset();
+            REQUIRE_FALSE(server.receive());
+            REQUIRE_FALSE(server.isOpen());
+        }
+    }
+
+    SDLNet_Quit();
+    SDL_Quit();
+}
+
+TEST_CASE("SDL_net message framing throughput and latency: FramedConnection",
+    "[.][benchmark][sdl2_net_util][SDL2][SDL_net][FramedConnection]")
+{
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        FAIL(collectErrorQuitSdlNet("SDL_Init"));
+    }
+
+    if (SDLNet_Init() != 0) {
+        FAIL(collectErrorQuitSdlNet("SDLNet_Init"));
+    }
+
+    {
+        unique::TcpSocket client_sock, server_sock;
+        if (!openLoopbackPair(client_sock, server_sock)) {
+            SKIP(collectErrorQuitSdlNet("openLoopbackPair"));
+        }
+
+        FramedConnection client { std::move(client_sock) };
+        FramedConnection server { std::move(server_sock) };
+        const char payload[64] {};
+        constexpr std::size_t frame_ct { 1000 };
+
+        // frames/sec = frame_ct / reported mean time
+        BENCHMARK("1000 64 byte frames, one way") {
+            for (std::size_t i {}; i < frame_ct; ++i)
+                client.send(payload, sizeof(payload));
+            client.flush();
+            std::size_t recv_ct {};
+            ByteSpan frame;
+            while (recv_ct < frame_ct && server.receive()) {
+                while (server.nextFrame(frame))
+                    ++recv_ct;
+            }
+            return recv_ct;
+        };
+
+        // BENCHMARK reports mean and deviation only, so time round trips
+        //   directly for percentiles
+        std::vector<Uint64> round_trips;
+        round_trips.reserve(10000);
+        ByteSpan frame;
+        for (int i {}; i < 10000; ++i) {
+            const Uint64 start { SDL_GetPerformanceCounter() };
+            client.send(payload, sizeof(payload));
+            client.flush();
+            while (!server.nextFrame(frame) && server.receive()) {}
+            server.send(frame.data, frame.size);
+            server.flush();
+            while (!client.nextFrame(frame) && client.receive()) {}
+            REQUIRE(client.isOpen());
+            round_trips.push_back(SDL_GetPerformanceCounter() - start);
+        }
+        std::sort(round_trips.begin(), round_trips.end());
+        const double us_per_tick {
+            1e6 / double(SDL_GetPerformanceFrequency())
+        };
+        SDL_Log("FramedConnection 64 byte round trip: p50 %.1f us, p99 %.1f us",
+                double(round_trips[round_trips.size() / 2]) * us_per_tick,
+                double(round_trips[round_trips.size() * 99 / 100]) * us_per_tick);
+    }
+
+    SDLNet_Quit();
+    SDL_Quit();
+}
@@ -0,0 +1,245 @@
+#include <catch2/catch_version_macros.hpp>               // CATCH_VERSION_MAJOR
+#if (CATCH_VERSION_MAJOR != 3)
+  #error "tests currently only support Catch2 v3.x"
+#endif
+#include <catch2/catch_test_macros.hpp>                  // TEST_CASE, SECTION, REQUIRE
+#include <catch2/benchmark/catch_benchmark.hpp>          // BENCHMARK
+
+#include "socket_reactor.hh"
+
+#include <SDL.h>
+#include <SDL_net.h>
+
+#ifndef _WIN32
+#include <sys/resource.h>  // getrlimit setrlimit
+#endif
+
+#include <algorithm>       // min
+#include <stdexcept>       // invalid_argument
+#include <string>
+#include <utility>         // move
+#include <vector>
+
+
+static std::string collectErrorQuitSdlNet(const std::string& func_name) {
+    std::string err { SDL_GetError() };
+    SDL_ClearError();
+    if (err.size() == 0) {
+        err = "failure without setting SDL error";
+    }
+    SDLNet_Quit();
+    SDL_Quit();
+    return func_name + ": " + err;
+}
+
+using namespace sdl2_net_util;
+using namespace sdl2_smart_ptr;
+
+// SDL_net can not report local port of server socket, so probe for free port
+static TCPsocket openLoopbackServer(Uint16& port) {
+    for (port = 40000; port < 40100; ++port) {
+        IPaddress address;
+        if (SDLNet_ResolveHost(&address, nullptr, port) != 0)
+            return nullptr;
+        TCPsocket server { SDLNet_TCP_Open(&address) };
+        if (server != nullptr)
+            return server;
+    }
+    return nullptr;
+}
+
+static TCPsocket connectLoopback(const Uint16 port) {
+    IPaddress address;
+    if (SDLNet_ResolveHost(&address, "localhost", port) != 0)
+        return nullptr;
+    return SDLNet_TCP_Open(&address);
+}
+
+// adds server socket to reactor, accepting connections as echo sockets
+static TCPsocket addEchoServer(SocketReactor& reactor, TCPsocket server) {
+    return reactor.add(make_unique(server), [&reactor](TCPsocket sock){
+        TCPsocket accepted { SDLNet_TCP_Accept(sock) };
+        if (accepted == nullptr)
+            return;
+        reactor.add(make_unique(accepted), [&reactor](TCPsocket peer){
+            char buf[64];
+            const int len { SDLNet_TCP_Recv(peer, buf, sizeof(buf)) };
+            if (len <= 0) {
+                reactor.remove(peer);
+                return;
+            }
+            SDLNet_TCP_Send(peer, buf, len);
+        });
+    });
+}
+
+// polls until reactor holds expected_ct sockets or timeout
+static void pollUntilSize(SocketReactor& reactor, const std::size_t expected_ct) {
+    const Uint64 deadline { SDL_GetTicks64() + 2000 };
+    while (reactor.size() < expected_ct && SDL_GetTicks64() < deadline)
+        reactor.poll(10);
+}
+
+TEST_CASE("SDL_net socket multiplexing: SocketReactor",
+    "[sdl2_net_util][SDL2][SDL_net][SocketReactor]")
+{
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        FAIL(collectErrorQuitSdlNet("SDL_Init"));
+    }
+
+    if (SDLNet_Init() != 0) {
+        FAIL(collectErrorQuitSdlNet("SDLNet_Init"));
+    }
+
+    Uint16 port {};
+    TCPsocket server { openLoopbackServer(port) };
+    if (server == nullptr) {
+        SKIP(collectErrorQuitSdlNet("SDLNet_TCP_Open"));
+    }
+
+    {
+        SocketReactor reactor;
+        REQUIRE(reactor.poll(0) == 0);
+        REQUIRE_THROWS_AS(reactor.add(nullptr, [](TCPsocket){}), std::invalid_argument);
+        const TCPsocket server_key { addEchoServer(reactor, server) };
+        REQUIRE(reactor.contains(server_key));
+
+        std::vector<unique::TcpSocket> clients;
+        for (int i {}; i < 4; ++i) {
+            clients.push_back(make_unique(connectLoopback(port)));
+            REQUIRE(clients.back() != nullptr);
+        }
+
+        SECTION("accepted sockets are added")
+        {
+            // server + 4 accepted
+            pollUntilSize(reactor, 5);
+            REQUIRE(reactor.size() == 5);
+        }
+        SECTION("dispatched sockets are flagged ready")
+        {
+            pollUntilSize(reactor, 5);
+            const TCPsocket client { clients.front().get() };
+            const TCPsocket client_key {
+                reactor.add(std::move(clients.front()), [](TCPsocket sock){
+                    REQUIRE(SDLNet_SocketReady(sock));
+                    char byte {};
+                    REQUIRE(SDLNet_TCP_Recv(sock, &byte, 1) == 1);
+                    REQUIRE_FALSE(SDLNet_SocketReady(sock));
+                }) };
+            REQUIRE(client_key == client);
+            char byte { 'x' };
+            REQUIRE(SDLNet_TCP_Send(client, &byte, 1) == 1);
+            // echo of byte by accepted peer
+            int dispatch_ct {};
+            const Uint64 deadline { SDL_GetTicks64() + 2000 };
+            while (dispatch_ct < 2 && SDL_GetTicks64() < deadline)
+                dispatch_ct += reactor.poll(10);
+            REQUIRE(dispatch_ct == 2);
+        }
+        SECTION("ready sockets are dispatched")
+        {
+            pollUntilSize(reactor, 5);
+            const char msg[] { "ping" };
+            for (auto& client : clients)
+                REQUIRE(SDLNet_TCP_Send(client.get(), msg, sizeof(msg)) == int(sizeof(msg)));
+            int dispatch_ct {};
+            const Uint64 deadline { SDL_GetTicks64() + 2000 };
+            while (dispatch_ct < 4 && SDL_GetTicks64() < deadline)
+                dispatch_ct += reactor.poll(10);
+            REQUIRE(dispatch_ct == 4);
+            for (auto& client : clients) {
+                char reply[sizeof(msg)] {};
+                REQUIRE(SDLNet_TCP_Recv(client.get(), reply, sizeof(reply)) == int(sizeof(msg)));
+                REQUIRE(std::string(reply) == msg);
+            }
+        }
+        SECTION("closed peers are removed by their callback")
+        {
+            pollUntilSize(reactor, 5);
+            clients.clear();
+            const Uint64 deadline { SDL_GetTicks64() + 2000 };
+            while (reactor.size() > 1 && SDL_GetTicks64() < deadline)
+                reactor.poll(10);
+            REQUIRE(reactor.size() == 1);
+        }
+        SECTION("remove returns ownership")
+        {
+            auto removed { reactor.remove(server_key) };
+            REQUIRE(removed.get() == server_key);
+            REQUIRE_FALSE(reactor.contains(server_key));
+            REQUIRE(reactor.remove(server_key) == nullptr);
+        }
+    }
+
+    SDLNet_Quit();
+    SDL_Quit();
+}
+
+TEST_CASE("SDL_net socket multiplexing latency: SocketReactor",
+    "[.][benchmark][sdl2_net_util][SDL2][SDL_net][SocketReactor]")
+{
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        FAIL(collectErrorQuitSdlNet("SDL_Init"));
+    }
+
+    if (SDLNet_Init() != 0) {
+        FAIL(collectErrorQuitSdlNet("SDLNet_Init"));
+    }
+
+    Uint16 port {};
+    TCPsocket server { openLoopbackServer(port) };
+    if (server == nullptr) {
+        SKIP(collectErrorQuitSdlNet("SDLNet_TCP_Open"));
+    }
+
+    {
+        SocketReactor reactor;
+        addEchoServer(reactor, server);
+        std::vector<unique::TcpSocket> clients;
+
+        // each connection uses 2 descriptors in this process, leaving some
+        //   for those already open; 4096 connections takes 8192 descriptors,
+        //   well past FD_SETSIZE
+        std::size_t max_connection_ct { 4096 };
+#ifndef _WIN32
+        rlimit limit {};
+        if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+            limit.rlim_cur = limit.rlim_max;
+            setrlimit(RLIMIT_NOFILE, &limit);
+            getrlimit(RLIMIT_NOFILE, &limit);
+            if (limit.rlim_cur != RLIM_INFINITY)
+                max_connection_ct = std::min(max_connection_ct,
+                                             (std::size_t(limit.rlim_cur) - 64) / 2);
+        }
+#endif
+        for (const std::size_t connection_ct :
+                 { std::size_t(1), std::size_t(16), std::size_t(64), std::size_t(256),
+                   std::size_t(1024), std::size_t(4096) }) {
+            if (connection_ct > max_connection_ct) {
+                WARN("descriptor limit too low for " << connection_ct << " connections");
+                continue;
+            }
+            // accepting as clients connect, as listen backlog is short
+            while (clients.size() < connection_ct) {
+                clients.push_back(make_unique(connectLoopback(port)));
+                REQUIRE(clients.back() != nullptr);
+                pollUntilSize(reactor, clients.size() + 1);
+            }
+            REQUIRE(reactor.size() == connection_ct + 1);
+
+            // round trip on one connection while all others are idle
+            TCPsocket client { clients.back().get() };
+            BENCHMARK("echo round trip, " + std::to_string(connection_ct) +
+                      " connections") {
+                char byte { 'x' };
+                SDLNet_TCP_Send(client, &byte, 1);
+                while (reactor.poll(100) == 0) {}
+                return SDLNet_TCP_Recv(client, &byte, 1);
+            };
+        }
+    }
+
+    SDLNet_Quit();
+    SDL_Quit();
+}
@@ -0,0 +1,233 @@
+#include <catch2/catch_version_macros.hpp>               // CATCH_VERSION_MAJOR
+#if (CATCH_VERSION_MAJOR != 3)
+  #error "tests currently only support Catch2 v3.x"
+#endif
+#include <catch2/catch_test_macros.hpp>                  // TEST_CASE, SECTION, REQUIRE
+#include <catch2/benchmark/catch_benchmark.hpp>          // BENCHMARK
+
+#include "udp_packet_pool.hh"
+
+#include <SDL.h>
+#include <SDL_net.h>
+
+#include <cstring>    // memcmp
+#include <stdexcept>  // invalid_argument
+#include <string>
+
+
+static std::string collectErrorQuitSdlNet(const std::string& func_name) {
+    std::string err { SDL_GetError() };
+    SDL_ClearError();
+    if (err.size() == 0) {
+        err = "failure without setting SDL error";
+    }
+    SDLNet_Quit();
+    SDL_Quit();
+    return func_name + ": " + err;
+}
+
+using namespace sdl2_net_util;
+
+// opens UDP socket on OS-selected port, and resolves loopback address for it
+static UDPsocket openLoopbackUdp(IPaddress& address) {
+    UDPsocket sock { SDLNet_UDP_Open(0) };
+    if (sock == nullptr)
+        return nullptr;
+    const IPaddress* local { SDLNet_UDP_GetPeerAddress(sock, -1) };
+    if (local == nullptr ||
+        SDLNet_ResolveHost(&address, "localhost",
+                           SDLNet_Read16(&local->port)) != 0) {
+        SDLNet_UDP_Close(sock);
+        return nullptr;
+    }
+    return sock;
+}
+
+// receives into batch until total of expected_ct received or timeout
+static int recvUntil(UdpBatch& batch, UDPsocket sock, const int expected_ct) {
+    const Uint64 deadline { SDL_GetTicks64() + 2000 };
+    int recv_ct {};
+    while (recv_ct < expected_ct && SDL_GetTicks64() < deadline)
+        recv_ct += batch.recv(sock);
+    return recv_ct;
+}
+
+TEST_CASE("SDL_net packet pooling: UdpPacketPool",
+    "[sdl2_net_util][SDL2][SDL_net][UdpPacketPool]")
+{
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        FAIL(collectErrorQuitSdlNet("SDL_Init"));
+    }
+
+    if (SDLNet_Init() != 0) {
+        FAIL(collectErrorQuitSdlNet("SDLNet_Init"));
+    }
+
+    {
+        UdpPacketPool pool;
+
+        SECTION("released packets are reused by capacity class")
+        {
+            UDPpacket* first {};
+            {
+                auto packet { pool.acquire(100) };
+                REQUIRE(packet->maxlen >= 100);
+                REQUIRE(packet->channel == -1);
+                first = packet.get();
+                REQUIRE(pool.stats().outstanding == 1);
+            }
+            REQUIRE(pool.stats().pooled == 1);
+
+            auto same_class { pool.acquire(120) };
+            REQUIRE(same_class.get() == first);
+            auto larger_class { pool.acquire(1000) };
+            REQUIRE(larger_class.get() != first);
+            REQUIRE(pool.stats().allocated == 2);
+            REQUIRE(pool.stats().reused == 1);
+        }
+        SECTION("reserve preallocates")
+        {
+            pool.reserve(512, 4);
+            REQUIRE(pool.stats().allocated == 4);
+            REQUIRE(pool.stats().pooled == 4);
+            {
+                UdpBatch batch { pool, 4, 512 };
+                REQUIRE(batch.capacity() == 4);
+                REQUIRE(pool.stats().allocated == 4);
+            }
+            REQUIRE(pool.stats().pooled == 4);
+            pool.trim();
+            REQUIRE(pool.stats().pooled == 0);
+            REQUIRE(pool.stats().freed == 4);
+        }
+        SECTION("capacity beyond MAX_CAPACITY")
+        {
+            REQUIRE_THROWS_AS(pool.acquire(UdpPacketPool::MAX_CAPACITY + 1),
+                              std::invalid_argument);
+        }
+    }
+
+    SDLNet_Quit();
+    SDL_Quit();
+}
+
+TEST_CASE("SDL_net batched datagrams: UdpBatch",
+    "[sdl2_net_util][SDL2][SDL_net][UdpBatch]")
+{
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        FAIL(collectErrorQuitSdlNet("SDL_Init"));
+    }
+
+    if (SDLNet_Init() != 0) {
+        FAIL(collectErrorQuitSdlNet("SDLNet_Init"));
+    }
+
+    IPaddress address;
+    UDPsocket sock { openLoopbackUdp(address) };
+    if (sock == nullptr) {
+        SKIP(collectErrorQuitSdlNet("SDLNet_UDP_Open"));
+    }
+
+    {
+        UdpPacketPool pool;
+        UdpBatch out_batch { pool, 8, 64 };
+        UdpBatch in_batch { pool, 8, 64 };
+        const char payload[] { "0123456789" };
+
+        SECTION("push fails when full or oversized")
+        {
+            REQUIRE_FALSE(out_batch.push(payload, 65, address));
+            for (int i {}; i < 8; ++i)
+                REQUIRE(out_batch.push(payload, i + 1, address));
+            REQUIRE(out_batch.full());
+            REQUIRE_FALSE(out_batch.push(payload, 1, address));
+        }
+        SECTION("loopback send and receive")
+        {
+            for (int i {}; i < 8; ++i)
+                REQUIRE(out_batch.push(payload, i + 1, address));
+            REQUIRE(out_batch.send(sock) == 8);
+            REQUIRE(out_batch.empty());
+
+            REQUIRE(recvUntil(in_batch, sock, 8) == 8);
+            // loopback delivery may be split across several recv calls
+            for (std::size_t i {}; i < in_batch.size(); ++i) {
+                REQUIRE(in_batch[i].len > 0);
+                REQUIRE(std::memcmp(in_batch[i].data, payload,
+                                    std::size_t(in_batch[i].len)) == 0);
+            }
+        }
+        SECTION("steady state makes no allocations")
+        {
+            const auto allocated { pool.stats().allocated };
+            for (int tick {}; tick < 10; ++tick) {
+                for (int i {}; i < 8; ++i)
+                    out_batch.push(payload, sizeof(payload), address);
+                out_batch.send(sock);
+                recvUntil(in_batch, sock, 8);
+            }
+            REQUIRE(pool.stats().allocated == allocated);
+        }
+    }
+
+    SDLNet_UDP_Close(sock);
+    SDLNet_Quit();
+    SDL_Quit();
+}
+
+TEST_CASE("SDL_net batched datagram throughput: UdpBatch",
+    "[.][benchmark][sdl2_net_util][SDL2][SDL_net][UdpBatch]")
+{
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        FAIL(collectErrorQuitSdlNet("SDL_Init"));
+    }
+
+    if (SDLNet_Init() != 0) {
+        FAIL(collectErrorQuitSdlNet("SDLNet_Init"));
+    }
+
+    IPaddress address;
+    UDPsocket sock { openLoopbackUdp(address) };
+    if (sock == nullptr) {
+        SKIP(collectErrorQuitSdlNet("SDLNet_UDP_Open"));
+    }
+
+    {
+        constexpr int batch_ct { 64 };
+        UdpPacketPool pool;
+        UdpBatch out_batch { pool, batch_ct, 256 };
+        UdpBatch in_batch { pool, batch_ct, 256 };
+        const char payload[128] {};
+
+        // datagrams/sec = batch_ct / reported mean time
+        BENCHMARK("send and receive 64 datagrams, pooled batch") {
+            for (int i {}; i < batch_ct; ++i)
+                out_batch.push(payload, sizeof(payload), address);
+            out_batch.send(sock);
+            return recvUntil(in_batch, sock, batch_ct);
+        };
+
+        BENCHMARK("send and receive 64 datagrams, packet per datagram") {
+            int recv_ct {};
+            for (int i {}; i < batch_ct; ++i) {
+                UDPpacket* packet { SDLNet_AllocPacket(256) };
+                std::memcpy(packet->data, payload, sizeof(payload));
+                packet->len = sizeof(payload);
+                packet->address = address;
+                SDLNet_UDP_Send(sock, -1, packet);
+                SDLNet_FreePacket(packet);
+            }
+            const Uint64 deadline { SDL_GetTicks64() + 2000 };
+            while (recv_ct < batch_ct && SDL_GetTicks64() < deadline) {
+                UDPpacket* packet { SDLNet_AllocPacket(256) };
+                recv_ct += SDLNet_UDP_Recv(sock, packet);
+                SDLNet_FreePacket(packet);
+            }
+            return recv_ct;
+        };
+    }
+
+    SDLNet_UDP_Close(sock);
+    SDLNet_Quit();
+    SDL_Quit();
+}
@@ -0,0 +1,289 @@
+#include "dirty_region.hh"
+
+#include "safeSdlCall.hh"
+
+#include "SDL_pixels.h"   // SDL_PIXELFORMAT_ARGB8888
+
+#include <limits>         // numeric_limits
+#include <stdexcept>      // invalid_argument
+
+
+namespace sdl2_render_util {
+
+static const SdlRetTest<int> int_ret_test {
+    [](const int ret){ return (ret != 0); }
+};
+
+static std::int64_t rectArea(const SDL_Rect& rect) {
+    return std::int64_t(rect.w) * rect.h;
+}
+
+static SDL_Rect unionRect(const SDL_Rect& a, const SDL_Rect& b) {
+    SDL_Rect result;
+    SDL_UnionRect(&a, &b, &result);
+    return result;
+}
+
+// overlapping rects must merge to keep rects disjoint, and edge-aligned
+//   neighbors merge for free
+static bool shouldMerge(const SDL_Rect& a, const SDL_Rect& b) {
+    return SDL_HasIntersection(&a, &b) == SDL_TRUE ||
+        rectArea(unionRect(a, b)) == rectArea(a) + rectArea(b);
+}
+
+static void recordFrame(RedrawStats& stats, bool presented, std::int64_t redrawn,
+                        int w, int h) {
+    const std::int64_t total { std::int64_t(w) * h };
+    ++stats.frames;
+    if (!presented)
+        ++stats.skipped_frames;
+    stats.last_pixels_redrawn = redrawn;
+    stats.last_percent_redrawn = total == 0 ? 0.0 : 100.0 * double(redrawn) / double(total);
+    stats.total_pixels_redrawn += redrawn;
+    stats.total_pixels += total;
+}
+
+DirtyRegion::DirtyRegion(int w, int h, std::size_t max_rects) :
+    w_(w), h_(h), max_rects_(max_rects) {
+    if (w_ < 0 || h_ < 0)
+        throw std::invalid_argument("DirtyRegion: size must not be negative");
+    if (max_rects_ == 0)
+        throw std::invalid_argument("DirtyRegion: max_rects must be at least 1");
+}
+
+void DirtyRegion::add(const SDL_Rect& rect) {
+    const SDL_Rect bounds { 0, 0, w_, h_ };
+    SDL_Rect clipped;
+    if (SDL_IntersectRect(&rect, &bounds, &clipped) != SDL_TRUE)
+        return;
+    for (const SDL_Rect& existing : rects_) {
+        SDL_Rect overlap;
+        if (SDL_IntersectRect(&clipped, &existing, &overlap) == SDL_TRUE &&
+            rectArea(overlap) == rectArea(clipped))
+            return;
+    }
+    rects_.push_back(clipped);
+    absorb(rects_.size() - 1);
+    while (rects_.size() > max_rects_)
+        mergeCheapestPair();
+}
+
+void DirtyRegion::addAll() {
+    rects_.clear();
+    if (w_ > 0 && h_ > 0)
+        rects_.push_back(SDL_Rect{ 0, 0, w_, h_ });
+}
+
+void DirtyRegion::resize(int w, int h) {
+    if (w < 0 || h < 0)
+        throw std::invalid_argument("DirtyRegion: size must not be negative");
+    const int old_w { w_ };
+    const int old_h { h_ };
+    w_ = w;
+    h_ = h;
+    // drop or clip rects outside new area
+    std::vector<SDL_Rect> old_rects;
+    old_rects.swap(rects_);
+    for (const SDL_Rect& rect : old_rects)
+        add(rect);
+    if (w_ > old_w)
+        add(SDL_Rect{ old_w, 0, w_ - old_w, h_ });
+    if (h_ > old_h)
+        add(SDL_Rect{ 0, old_h, w_, h_ - old_h });
+}
+
+std::int64_t DirtyRegion::area() const {
+    std::int64_t total {};
+    for (const SDL_Rect& rect : rects_)
+        total += rectArea(rect);
+    return total;
+}
+
+void DirtyRegion::absorb(std::size_t index) {
+    bool merged { true };
+    while (merged) {
+        merged = false;
+        for (std::size_t i {}; i < rects_.size(); ++i) {
+            if (i == index || !shouldMerge(rects_[index], rects_[i]))
+                continue;
+            rects_[index] = unionRect(rects_[index], rects_[i]);
+            // swap-remove, following rect at index if it moves
+            rects_[i] = rects_.back();
+            if (index == rects_.size() - 1)
+                index = i;
+            rects_.pop_back();
+            merged = true;
+            break;
+        }
+    }
+}
+
+void DirtyRegion::mergeCheapestPair() {
+    std::size_t best_a {};
+    std::size_t best_b { 1 };
+    std::int64_t best_waste { std::numeric_limits<std::int64_t>::max() };
+    for (std::size_t a {}; a < rects_.size(); ++a) {
+        for (std::size_t b { a + 1 }; b < rects_.size(); ++b) {
+            const std::int64_t waste {
+                rectArea(unionRect(rects_[a], rects_[b])) -
+                rectArea(rects_[a]) - rectArea(rects_[b]) };
+            if (waste < best_waste) {
+                best_waste = waste;
+                best_a = a;
+                best_b = b;
+            }
+        }
+    }
+    rects_[best_a] = unionRect(rects_[best_a], rects_[best_b]);
+    rects_[best_b] = rects_.back();
+    if (best_a == rects_.size() - 1)
+        best_a = best_b;
+    rects_.pop_back();
+    absorb(best_a);
+}
+
+DirtyRectRenderer::DirtyRectRenderer(SDL_Renderer* renderer, std::size_t max_rects) :
+    renderer_(renderer), dirty_(0, 0, max_rects) {
+    if (renderer_ == nullptr)
+        throw std::invalid_argument("DirtyRectRenderer: renderer must not be null");
+    if (SDL_RenderTargetSupported(renderer_) != SDL_TRUE)
+        throw std::invalid_argument("DirtyRectRenderer: renderer must support render targets");
+}
+
+void DirtyRectRenderer::handleEvent(const SDL_Event& event) {
+    switch (event.type) {
+    case SDL_RENDER_DEVICE_RESET:
+        // textures are lost with device, see SDL_EventType
+        target_.reset();
+        break;
+    case SDL_RENDER_TARGETS_RESET:
+        dirty_.addAll();
+        break;
+    case SDL_WINDOWEVENT:
+        if (event.window.event == SDL_WINDOWEVENT_EXPOSED)
+            force_present_ = true;
+        break;
+    default:
+        break;
+    }
+}
+
+void DirtyRectRenderer::syncTarget() {
+    int w {};
+    int h {};
+    safeSdlCall(SDL_GetRendererOutputSize, "SDL_GetRendererOutputSize", int_ret_test,
+                renderer_, &w, &h);
+    if (target_ != nullptr && w == dirty_.width() && h == dirty_.height())
+        return;
+    target_.reset();
+    target_ = sdl2_smart_ptr::make_unique(
+        safeSdlCall(SDL_CreateTexture, "SDL_CreateTexture",
+                    SdlRetTest<SDL_Texture*>{
+                        [](const SDL_Texture* ret){ return (ret == nullptr); } },
+                    renderer_, Uint32(SDL_PIXELFORMAT_ARGB8888),
+                    int(SDL_TEXTUREACCESS_TARGET), w, h));
+    // copied over whole output, so must replace rather than blend
+    safeSdlCall(SDL_SetTextureBlendMode, "SDL_SetTextureBlendMode", int_ret_test,
+                target_.get(), SDL_BLENDMODE_NONE);
+    dirty_.resize(w, h);
+    dirty_.addAll();
+}
+
+bool DirtyRectRenderer::present(const Redraw& redraw) {
+    syncTarget();
+    if (dirty_.empty() && !force_present_) {
+        recordFrame(stats_, false, 0, dirty_.width(), dirty_.height());
+        return false;
+    }
+
+    if (!dirty_.empty()) {
+        SDL_Texture* previous_target { SDL_GetRenderTarget(renderer_) };
+        safeSdlCall(SDL_SetRenderTarget, "SDL_SetRenderTarget", int_ret_test,
+                    renderer_, target_.get());
+        try {
+            for (const SDL_Rect& rect : dirty_.rects()) {
+                safeSdlCall(SDL_RenderSetClipRect, "SDL_RenderSetClipRect", int_ret_test,
+                            renderer_, &rect);
+                redraw(renderer_, rect);
+            }
+        } catch (...) {
+            SDL_RenderSetClipRect(renderer_, nullptr);
+            SDL_SetRenderTarget(renderer_, previous_target);
+            throw;
+        }
+        safeSdlCall(SDL_RenderSetClipRect, "SDL_RenderSetClipRect", int_ret_test,
+                    renderer_, nullptr);
+        safeSdlCall(SDL_SetRenderTarget, "SDL_SetRenderTarget", int_ret_test,
+                    renderer_, previous_target);
+    }
+
+    // back buffer contents are undefined after a present, so whole target
+    //   is copied each time
+    safeSdlCall(SDL_RenderCopy, "SDL_RenderCopy", int_ret_test,
+                renderer_, target_.get(), nullptr, nullptr);
+    SDL_RenderPresent(renderer_);
+    recordFrame(stats_, true, dirty_.area(), dirty_.width(), dirty_.height());
+    dirty_.clear();
+    force_present_ = false;
+    return true;
+}
+
+DirtyRectSurface::DirtyRectSurface(SDL_Window* window, std::size_t max_rects) :
+    window_(window), dirty_(0, 0, max_rects) {
+    if (window_ == nullptr)
+        throw std::invalid_argument("DirtyRectSurface: window must not be null");
+}
+
+void DirtyRectSurface::handleEvent(const SDL_Event& event) {
+    if (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_EXPOSED)
+        force_present_ = true;
+}
+
+SDL_Surface* DirtyRectSurface::syncSurface() {
+    SDL_Surface* surface {
+        safeSdlCall(SDL_GetWindowSurface, "SDL_GetWindowSurface",
+                    SdlRetTest<SDL_Surface*>{
+                        [](const SDL_Surface* ret){ return (ret == nullptr); } },
+                    window_) };
+    // new surface may reuse address of old
+    if (surface != surface_ || surface->w != dirty_.width() || surface->h != dirty_.height()) {
+        surface_ = surface;
+        dirty_.resize(surface->w, surface->h);
+        dirty_.addAll();
+    }
+    return surface;
+}
+
+bool DirtyRectSurface::present(const Redraw& redraw) {
+    SDL_Surface* surface { syncSurface() };
+    if (dirty_.empty() && !force_present_) {
+        recordFrame(stats_, false, 0, dirty_.width(), dirty_.height());
+        return false;
+    }
+
+    try {
+        for (const SDL_Rect& rect : dirty_.rects()) {
+            SDL_SetClipRect(surface, &rect);
+            redraw(surface, rect);
+        }
+    } catch (...) {
+        SDL_SetClipRect(surface, nullptr);
+        throw;
+    }
+    SDL_SetClipRect(surface, nullptr);
+
+    if (force_present_) {
+        safeSdlCall(SDL_UpdateWindowSurface, "SDL_UpdateWindowSurface", int_ret_test,
+                    window_);
+    } else {
+        const std::vector<SDL_Rect>& rects { dirty_.rects() };
+        safeSdlCall(SDL_UpdateWindowSurfaceRects, "SDL_UpdateWindowSurfaceRects",
+                    int_ret_test, window_, rects.data(), int(rects.size()));
+    }
+    recordFrame(stats_, true, dirty_.area(), dirty_.width(), dirty_.height());
+    dirty_.clear();
+    force_present_ = false;
+    return true;
+}
+
+}  // namespace sdl2_render_util
@@ -0,0 +1,138 @@
+#ifndef DIRTY_REGION_HH
+#define DIRTY_REGION_HH
+
+#include "sdl2_smart_ptr.hh"  // unique::Texture
+
+#include "SDL_events.h"       // SDL_Event
+#include "SDL_rect.h"         // SDL_Rect
+#include "SDL_render.h"       // SDL_Renderer
+#include "SDL_surface.h"      // SDL_Surface
+#include "SDL_video.h"        // SDL_Window
+
+#include <cstddef>            // size_t
+#include <cstdint>            // int64_t uint64_t
+#include <functional>
+#include <vector>
+
+
+namespace sdl2_render_util {
+
+// Non-overlapping rects of a w x h area needing redraw. Added rects are
+//   clipped and merged with any they touch, and past max_rects the pair
+//   wasting the fewest pixels is merged.
+class DirtyRegion {
+public:
+    static constexpr std::size_t DEFAULT_MAX_RECTS { 16 };
+
+    // max_rects must be at least 1
+    DirtyRegion(int w, int h, std::size_t max_rects = DEFAULT_MAX_RECTS);
+
+    void add(const SDL_Rect& rect);
+    void addAll();
+    // marks new area dirty
+    void resize(int w, int h);
+    void clear() { rects_.clear(); }
+
+    const std::vector<SDL_Rect>& rects() const { return rects_; }
+    bool empty() const { return rects_.empty(); }
+    // pixels covered by rects
+    std::int64_t area() const;
+    int width() const { return w_; }
+    int height() const { return h_; }
+
+private:
+    // merges rect at index with any others it touches until none do
+    void absorb(std::size_t index);
+    void mergeCheapestPair();
+
+    int w_;
+    int h_;
+    std::size_t max_rects_;
+    std::vector<SDL_Rect> rects_;
+};
+
+struct RedrawStats {
+    std::uint64_t frames {};
+    // frames with nothing dirty or exposed, so nothing was drawn or presented
+    std::uint64_t skipped_frames {};
+    std::int64_t last_pixels_redrawn {};
+    double last_percent_redrawn {};
+    std::int64_t total_pixels_redrawn {};
+    std::int64_t total_pixels {};
+
+    // across all frames
+    double percentRedrawn() const {
+        return total_pixels == 0 ? 0.0 :
+            100.0 * double(total_pixels_redrawn) / double(total_pixels);
+    }
+};
+
+// Partial redraw through a renderer into a persistent target texture, only
+//   dirty rects redrawn each frame, and frames with nothing dirty not
+//   presented. Pass events to handleEvent() for full redraws on lost targets
+//   and resizes. Renderer's thread only.
+class DirtyRectRenderer {
+public:
+    // draws the part of the scene within clip; drawing outside it is clipped
+    using Redraw = std::function<void(SDL_Renderer* renderer, const SDL_Rect& clip)>;
+
+    explicit DirtyRectRenderer(SDL_Renderer* renderer,
+                               std::size_t max_rects = DirtyRegion::DEFAULT_MAX_RECTS);
+
+    DirtyRegion& dirty() { return dirty_; }
+    void handleEvent(const SDL_Event& event);
+
+    // returns false if nothing was dirty and the frame was skipped
+    bool present(const Redraw& redraw);
+
+    SDL_Texture* target() const { return target_.get(); }
+    const RedrawStats& stats() const { return stats_; }
+    void resetStats() { stats_ = {}; }
+
+private:
+    // (re)creates target if output size changed, marking everything dirty
+    void syncTarget();
+
+    SDL_Renderer* renderer_;
+    sdl2_smart_ptr::unique::Texture target_;
+    DirtyRegion dirty_;
+    // window exposed, so must present even if nothing is dirty
+    bool force_present_ {};
+    RedrawStats stats_;
+};
+
+// Partial redraw into a window surface without a renderer, updating only
+//   dirty rects with SDL_UpdateWindowSurfaceRects. Pass events to
+//   handleEvent() for full redraws on exposure and resizes.
+class DirtyRectSurface {
+public:
+    using Redraw = std::function<void(SDL_Surface* surface, const SDL_Rect& clip)>;
+
+    explicit DirtyRectSurface(SDL_Window* window,
+                              std::size_t max_rects = DirtyRegion::DEFAULT_MAX_RECTS);
+
+    DirtyRegion& dirty() { return dirty_; }
+    void handleEvent(const SDL_Event& event);
+
+    bool present(const Redraw& redraw);
+
+    const RedrawStats& stats() const { return stats_; }
+    void resetStats() { stats_ = {}; }
+
+private:
+    // SDL_GetWindowSurface, marking everything dirty if surface was replaced
+    SDL_Surface* syncSurface();
+
+    SDL_Window* window_;
+    // only compared, as SDL frees window surfaces
+    SDL_Surface* surface_ {};
+    DirtyRegion dirty_;
+    // window exposed, so whole surface must be copied to screen
+    bool force_present_ {};
+    RedrawStats stats_;
+};
+
+}  // namespace sdl2_render_util
+
+
+#endif  // DIRTY_REGION_HH
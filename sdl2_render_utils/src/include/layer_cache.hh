@@ -0,0 +1,90 @@
+#ifndef LAYER_CACHE_HH
+#define LAYER_CACHE_HH
+
+#include "sdl2_smart_ptr.hh"  // unique::Texture
+
+#include "SDL_blendmode.h"    // SDL_BlendMode
+#include "SDL_events.h"       // SDL_Event
+#include "SDL_rect.h"         // SDL_Rect
+#include "SDL_render.h"       // SDL_Renderer SDL_Texture
+
+#include <cstddef>            // size_t
+#include <cstdint>            // uint64_t
+#include <functional>
+#include <unordered_map>
+
+
+namespace sdl2_render_util {
+
+// Draws mostly static layers, eg backgrounds or HUD panels, once into target
+//   textures, which composite() copies until the caller passes a new version
+//   for the layer. Textures are composited with premultiplied alpha where
+//   supported, as drawing onto transparent pixels premultiplies. Pass events
+//   to handleEvent() to redraw after target or device resets. Renderer's
+//   thread only.
+class LayerCache {
+public:
+    using LayerId = std::uint64_t;
+    // draws layer content with renderer targeting layer texture
+    using Draw = std::function<void(SDL_Renderer* renderer)>;
+
+    struct Stats {
+        std::uint64_t composites {};
+        // composites that needed layer drawn first
+        std::uint64_t redraws {};
+        // redraws because contents were lost rather than changed
+        std::uint64_t lost_redraws {};
+    };
+
+    explicit LayerCache(SDL_Renderer* renderer);
+
+    LayerCache(const LayerCache&) = delete;
+    LayerCache& operator=(const LayerCache&) = delete;
+
+    // draws layer if new, resized, lost or of a different version, then
+    //   copies it to area of current render target
+    void composite(LayerId id, std::uint64_t version, const SDL_Rect& area,
+                   const Draw& draw);
+
+    // next composite will redraw layer
+    void invalidate(LayerId id);
+    void invalidateAll();
+    // frees layer texture
+    void erase(LayerId id);
+    void clear() { layers_.clear(); }
+
+    void handleEvent(const SDL_Event& event);
+
+    std::size_t size() const { return layers_.size(); }
+    bool contains(LayerId id) const { return layers_.count(id) != 0; }
+    SDL_Renderer* renderer() const { return renderer_; }
+    const Stats& stats() const { return stats_; }
+    void resetStats() { stats_ = {}; }
+
+private:
+    struct Layer {
+        sdl2_smart_ptr::unique::Texture texture;
+        std::uint64_t version {};
+        int w {};
+        int h {};
+        bool valid {};
+        bool lost {};
+    };
+
+    void redraw(Layer& layer, const Draw& draw);
+
+    SDL_Renderer* renderer_;
+    // premultiplied alpha, until renderer rejects it for SDL_BLENDMODE_BLEND
+    SDL_BlendMode composite_blend_mode_;
+    std::unordered_map<LayerId, Layer> layers_;
+    Stats stats_;
+};
+
+// FNV-1a, for versions made from a hash of layer inputs
+std::uint64_t hashLayerInputs(const void* data, std::size_t size,
+                              std::uint64_t seed = 0xcbf29ce484222325);
+
+}  // namespace sdl2_render_util
+
+
+#endif  // LAYER_CACHE_HH
@@ -0,0 +1,112 @@
+#ifndef SPRITE_BATCH_HH
+#define SPRITE_BATCH_HH
+
+#include "SDL_blendmode.h"    // SDL_BlendMode
+#include "SDL_pixels.h"       // SDL_Color
+#include "SDL_rect.h"         // SDL_Rect SDL_FRect SDL_FPoint
+#include "SDL_render.h"       // SDL_Renderer SDL_Texture SDL_RendererFlip
+#include "SDL_stdinc.h"       // Uint32
+
+#include <cstddef>            // size_t
+#include <cstdint>            // uint64_t
+#include <unordered_map>
+#include <vector>
+
+
+namespace sdl2_render_util {
+
+// Collects sprite draws and on flush() submits one SDL_RenderGeometryRaw per
+//   run of sprites sharing a layer, blend mode and texture, lower layers
+//   first. Within a layer only sprites of the same texture keep their order.
+//   Texture color and alpha modulation are not applied, pass a color instead.
+//   Renderer's thread only; textures must outlive the next flush().
+class SpriteBatch {
+public:
+    static constexpr SDL_Color WHITE { 255, 255, 255, 255 };
+
+    struct Stats {
+        std::uint64_t sprites {};
+        std::uint64_t geometry_calls {};
+        std::uint64_t flushes {};
+    };
+
+    explicit SpriteBatch(SDL_Renderer* renderer);
+
+    SpriteBatch(const SpriteBatch&) = delete;
+    SpriteBatch& operator=(const SpriteBatch&) = delete;
+
+    // src of nullptr uses whole texture, as with SDL_RenderCopyF
+    void draw(SDL_Texture* texture, const SDL_Rect* src, const SDL_FRect& dst,
+              int layer = 0, SDL_Color color = WHITE);
+    // angle in degrees clockwise about center, relative to dst, or about
+    //   dst center if nullptr, as with SDL_RenderCopyExF
+    void drawEx(SDL_Texture* texture, const SDL_Rect* src, const SDL_FRect& dst,
+                double angle, const SDL_FPoint* center, SDL_RendererFlip flip,
+                int layer = 0, SDL_Color color = WHITE);
+
+    // submits and clears all pending sprites
+    void flush();
+    // discards pending sprites without drawing them
+    void clear();
+
+    std::size_t pending() const { return layer_.size(); }
+    SDL_Renderer* renderer() const { return renderer_; }
+    const Stats& stats() const { return stats_; }
+    void resetStats() { stats_ = {}; }
+
+private:
+    struct TextureInfo {
+        SDL_Texture* texture;
+        float w;
+        float h;
+        SDL_BlendMode blend_mode;
+    };
+
+    std::size_t textureIndex(SDL_Texture* texture);
+    void push(SDL_Texture* texture, const SDL_Rect* src, const SDL_FRect& dst,
+              float cos_a, float sin_a, float center_x, float center_y,
+              SDL_RendererFlip flip, int layer, SDL_Color color);
+    // fills xy_ and uv_ for all pending sprites
+    void generateVertices();
+
+    SDL_Renderer* renderer_;
+
+    // textures drawn since last flush, with lookup cache
+    std::vector<TextureInfo> textures_;
+    std::unordered_map<SDL_Texture*, Uint32> texture_indices_;
+    SDL_Texture* last_texture_ {};
+    Uint32 last_texture_index_ {};
+
+    // pending sprites, one element each
+    std::vector<float> dst_x_;
+    std::vector<float> dst_y_;
+    std::vector<float> dst_w_;
+    std::vector<float> dst_h_;
+    std::vector<float> center_x_;
+    std::vector<float> center_y_;
+    std::vector<float> cos_;
+    std::vector<float> sin_;
+    std::vector<float> u0_;
+    std::vector<float> v0_;
+    std::vector<float> u1_;
+    std::vector<float> v1_;
+    std::vector<SDL_Color> color_;
+    std::vector<Uint32> texture_index_;
+    std::vector<int> layer_;
+
+    // scratch reused between flushes
+    std::vector<float> xy_;
+    std::vector<float> uv_;
+    std::vector<SDL_Color> vertex_color_;
+    std::vector<Uint32> by_blend_mode_;
+    std::vector<std::uint64_t> rank_;
+    std::vector<std::uint64_t> order_;
+    std::vector<int> indices_;
+
+    Stats stats_;
+};
+
+}  // namespace sdl2_render_util
+
+
+#endif  // SPRITE_BATCH_HH
@@ -0,0 +1,97 @@
+#ifndef STREAMING_TEXTURE_HH
+#define STREAMING_TEXTURE_HH
+
+#include "sdl2_smart_ptr.hh"  // unique::Texture
+
+#include "SDL_render.h"       // SDL_Renderer SDL_Texture
+#include "SDL_stdinc.h"       // Uint8 Uint32
+
+#include <chrono>
+#include <cstddef>            // size_t
+#include <cstdint>            // uint64_t
+#include <vector>
+
+
+namespace sdl2_render_util {
+
+// Ring of streaming textures for content updated every frame, eg video:
+//   each write goes to the slot after the current one, so the frame drawn is
+//   never the one written. SDL calls must be made on the renderer's thread,
+//   WriteSpan pixels may be filled from any. SDL calls slower than
+//   stall_threshold count as producer waits.
+class StreamingTexture {
+public:
+    struct WriteSpan {
+        void* pixels {};
+        int pitch {};
+        int w {};
+        int h {};
+        std::size_t slot {};
+
+        Uint8* row(const int y) const {
+            return static_cast<Uint8*>(pixels) + std::ptrdiff_t(y) * pitch;
+        }
+    };
+
+    struct Stats {
+        std::uint64_t published {};
+        // published frames replaced before being retrieved by current()
+        std::uint64_t dropped {};
+        std::uint64_t producer_waits {};
+        std::chrono::microseconds total_wait {};
+        std::chrono::microseconds max_wait {};
+    };
+
+    // slot_ct must be at least 2
+    StreamingTexture(SDL_Renderer* renderer, Uint32 format, int w, int h,
+                     std::size_t slot_ct = 3,
+                     std::chrono::microseconds stall_threshold =
+                     std::chrono::microseconds { 500 });
+
+    // locks next slot; only one write may be in progress at a time
+    WriteSpan beginWrite();
+    // unlocks slot and publishes it as current
+    void endWrite(const WriteSpan& span);
+
+    // replace contents of next slot and publish it, see SDL_UpdateTexture
+    void update(const void* pixels, int pitch);
+    // planar YV12/IYUV, see SDL_UpdateYUVTexture
+    void updateYUV(const Uint8* y_plane, int y_pitch,
+                   const Uint8* u_plane, int u_pitch,
+                   const Uint8* v_plane, int v_pitch);
+    // NV12/NV21, see SDL_UpdateNVTexture
+    void updateNV(const Uint8* y_plane, int y_pitch,
+                  const Uint8* uv_plane, int uv_pitch);
+
+    // most recently published slot, or nullptr before first publish
+    SDL_Texture* current();
+
+    std::size_t slotCount() const { return slots_.size(); }
+    Uint32 format() const { return format_; }
+    int width() const { return w_; }
+    int height() const { return h_; }
+    const Stats& stats() const { return stats_; }
+    void resetStats() { stats_ = {}; }
+
+private:
+    static constexpr std::size_t NO_SLOT { std::size_t(-1) };
+
+    std::size_t nextSlot() const;
+    void publish(std::size_t slot);
+    void recordCallTime(std::chrono::steady_clock::time_point start);
+
+    std::vector<sdl2_smart_ptr::unique::Texture> slots_;
+    Uint32 format_;
+    int w_;
+    int h_;
+    std::chrono::microseconds stall_threshold_;
+    std::size_t current_slot_ { NO_SLOT };
+    bool current_retrieved_ { true };
+    bool writing_ {};
+    Stats stats_;
+};
+
+}  // namespace sdl2_render_util
+
+
+#endif  // STREAMING_TEXTURE_HH
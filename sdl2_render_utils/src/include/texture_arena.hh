@@ -0,0 +1,58 @@
+#ifndef TEXTURE_ARENA_HH
+#define TEXTURE_ARENA_HH
+
+#include "sdl2_slot_map.hh"   // slot_map::Texture
+#include "sdl2_smart_ptr.hh"  // unique::Renderer unique::Texture
+
+#include "SDL_render.h"       // SDL_Renderer SDL_Texture
+#include "SDL_stdinc.h"       // Uint32
+#include "SDL_surface.h"      // SDL_Surface
+
+#include <cstddef>            // size_t
+
+
+namespace sdl2_render_util {
+
+// slot index plus generation; default constructed handles are null
+using TextureHandle = sdl2_smart_ptr::slot_map::Texture::Handle;
+
+// Owns a renderer and the textures created through it, referred to by
+//   generation-checked TextureHandles, so stale handles are detected after a
+//   slot is reused. On destruction the renderer frees all textures itself.
+//   Renderer's thread only.
+class TextureArena {
+public:
+    explicit TextureArena(sdl2_smart_ptr::unique::Renderer renderer);
+    ~TextureArena();
+
+    TextureArena(const TextureArena&) = delete;
+    TextureArena& operator=(const TextureArena&) = delete;
+
+    SDL_Renderer* renderer() const { return renderer_.get(); }
+
+    TextureHandle create(Uint32 format, int access, int w, int h);
+    TextureHandle createFromSurface(SDL_Surface* surface);
+    // texture must have been created with renderer()
+    TextureHandle adopt(sdl2_smart_ptr::unique::Texture texture);
+
+    // returns false for stale or null handles
+    bool destroy(TextureHandle handle) { return textures_.release(handle); }
+    void clear();
+
+    bool valid(TextureHandle handle) const { return textures_.contains(handle); }
+    // nullptr for stale or null handles
+    SDL_Texture* get(TextureHandle handle) const { return textures_.get(handle); }
+    // throws std::out_of_range for stale or null handles
+    SDL_Texture* at(TextureHandle handle) const;
+
+    std::size_t size() const { return textures_.size(); }
+
+private:
+    sdl2_smart_ptr::slot_map::Texture textures_;
+    sdl2_smart_ptr::unique::Renderer renderer_;
+};
+
+}  // namespace sdl2_render_util
+
+
+#endif  // TEXTURE_ARENA_HH
@@ -0,0 +1,132 @@
+#include "layer_cache.hh"
+
+#include "safeSdlCall.hh"
+
+#include "SDL_error.h"    // SDL_ClearError
+#include "SDL_pixels.h"   // SDL_PIXELFORMAT_ARGB8888
+
+#include <stdexcept>      // invalid_argument
+
+
+namespace sdl2_render_util {
+
+static const SdlRetTest<int> int_ret_test {
+    [](const int ret){ return (ret != 0); }
+};
+
+LayerCache::LayerCache(SDL_Renderer* renderer) :
+    renderer_(renderer),
+    composite_blend_mode_(SDL_ComposeCustomBlendMode(
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD)) {
+    if (renderer_ == nullptr)
+        throw std::invalid_argument("LayerCache: renderer must not be null");
+    if (SDL_RenderTargetSupported(renderer_) != SDL_TRUE)
+        throw std::invalid_argument("LayerCache: renderer must support render targets");
+}
+
+void LayerCache::redraw(Layer& layer, const Draw& draw) {
+    if (layer.texture == nullptr) {
+        layer.texture = sdl2_smart_ptr::make_unique(
+            safeSdlCall(SDL_CreateTexture, "SDL_CreateTexture",
+                        SdlRetTest<SDL_Texture*>{
+                            [](const SDL_Texture* ret){ return (ret == nullptr); } },
+                        renderer_, Uint32(SDL_PIXELFORMAT_ARGB8888),
+                        int(SDL_TEXTUREACCESS_TARGET), layer.w, layer.h));
+        if (SDL_SetTextureBlendMode(layer.texture.get(), composite_blend_mode_) != 0) {
+            SDL_ClearError();
+            composite_blend_mode_ = SDL_BLENDMODE_BLEND;
+            safeSdlCall(SDL_SetTextureBlendMode, "SDL_SetTextureBlendMode", int_ret_test,
+                        layer.texture.get(), composite_blend_mode_);
+        }
+    }
+
+    SDL_Texture* previous_target { SDL_GetRenderTarget(renderer_) };
+    safeSdlCall(SDL_SetRenderTarget, "SDL_SetRenderTarget", int_ret_test,
+                renderer_, layer.texture.get());
+    try {
+        // clear to transparent, leaving draw color as caller set it
+        Uint8 r {};
+        Uint8 g {};
+        Uint8 b {};
+        Uint8 a {};
+        safeSdlCall(SDL_GetRenderDrawColor, "SDL_GetRenderDrawColor", int_ret_test,
+                    renderer_, &r, &g, &b, &a);
+        safeSdlCall(SDL_SetRenderDrawColor, "SDL_SetRenderDrawColor", int_ret_test,
+                    renderer_, Uint8(0), Uint8(0), Uint8(0), Uint8(0));
+        safeSdlCall(SDL_RenderClear, "SDL_RenderClear", int_ret_test, renderer_);
+        safeSdlCall(SDL_SetRenderDrawColor, "SDL_SetRenderDrawColor", int_ret_test,
+                    renderer_, r, g, b, a);
+        draw(renderer_);
+    } catch (...) {
+        SDL_SetRenderTarget(renderer_, previous_target);
+        layer.valid = false;
+        throw;
+    }
+    safeSdlCall(SDL_SetRenderTarget, "SDL_SetRenderTarget", int_ret_test,
+                renderer_, previous_target);
+}
+
+void LayerCache::composite(LayerId id, std::uint64_t version, const SDL_Rect& area,
+                           const Draw& draw) {
+    if (area.w <= 0 || area.h <= 0)
+        throw std::invalid_argument("LayerCache: layer area must not be empty");
+    Layer& layer { layers_[id] };
+    if (layer.texture != nullptr && (layer.w != area.w || layer.h != area.h))
+        layer.texture.reset();
+    if (layer.texture == nullptr || !layer.valid || layer.version != version) {
+        layer.w = area.w;
+        layer.h = area.h;
+        layer.valid = false;
+        redraw(layer, draw);
+        layer.version = version;
+        layer.valid = true;
+        ++stats_.redraws;
+        if (layer.lost)
+            ++stats_.lost_redraws;
+        layer.lost = false;
+    }
+    safeSdlCall(SDL_RenderCopy, "SDL_RenderCopy", int_ret_test,
+                renderer_, layer.texture.get(), nullptr, &area);
+    ++stats_.composites;
+}
+
+void LayerCache::invalidate(LayerId id) {
+    const auto it { layers_.find(id) };
+    if (it != layers_.end())
+        it->second.valid = false;
+}
+
+void LayerCache::invalidateAll() {
+    for (auto& [id, layer] : layers_)
+        layer.valid = false;
+}
+
+void LayerCache::erase(LayerId id) {
+    layers_.erase(id);
+}
+
+void LayerCache::handleEvent(const SDL_Event& event) {
+    if (event.type != SDL_RENDER_TARGETS_RESET && event.type != SDL_RENDER_DEVICE_RESET)
+        return;
+    for (auto& [id, layer] : layers_) {
+        // textures are lost with device, see SDL_EventType
+        if (event.type == SDL_RENDER_DEVICE_RESET)
+            layer.texture.reset();
+        layer.valid = false;
+        layer.lost = true;
+    }
+}
+
+std::uint64_t hashLayerInputs(const void* data, std::size_t size, std::uint64_t seed) {
+    static constexpr std::uint64_t FNV_PRIME { 0x100000001b3 };
+    const auto* bytes { static_cast<const unsigned char*>(data) };
+    std::uint64_t hash { seed };
+    for (std::size_t i {}; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+}  // namespace sdl2_render_util
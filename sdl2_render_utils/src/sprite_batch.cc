@@ -0,0 +1,267 @@
+#include "sprite_batch.hh"
+
+#include "safeSdlCall.hh"
+
+#include <algorithm>   // sort
+#include <cmath>       // cos sin
+#include <cstdint>     // INT16_MIN INT16_MAX
+#include <iterator>    // begin end
+#include <stdexcept>   // invalid_argument out_of_range
+#include <utility>     // swap
+
+
+namespace sdl2_render_util {
+
+static const SdlRetTest<int> int_ret_test {
+    [](const int ret){ return (ret != 0); }
+};
+
+// sort keys are layer, then texture rank, then sprite index, each in its
+//   own bit field
+static constexpr int LAYER_SHIFT { 48 };
+static constexpr int RANK_SHIFT { 32 };
+static constexpr std::size_t MAX_TEXTURES { 1 << 16 };
+// keeps vertex indices within int
+static constexpr std::size_t MAX_PENDING { 1 << 24 };
+static constexpr double RADIANS_PER_DEGREE { 3.14159265358979323846 / 180.0 };
+
+SpriteBatch::SpriteBatch(SDL_Renderer* renderer) : renderer_(renderer) {
+    if (renderer_ == nullptr)
+        throw std::invalid_argument("SpriteBatch: renderer must not be null");
+}
+
+std::size_t SpriteBatch::textureIndex(SDL_Texture* texture) {
+    // consecutive draws usually share a texture
+    if (texture == last_texture_ && texture != nullptr)
+        return last_texture_index_;
+    const auto it { texture_indices_.find(texture) };
+    if (it != texture_indices_.end()) {
+        last_texture_ = texture;
+        last_texture_index_ = it->second;
+        return it->second;
+    }
+    if (textures_.size() == MAX_TEXTURES)
+        flush();
+    int w {};
+    int h {};
+    SDL_BlendMode blend_mode {};
+    safeSdlCall(SDL_QueryTexture, "SDL_QueryTexture", int_ret_test,
+                texture, nullptr, nullptr, &w, &h);
+    safeSdlCall(SDL_GetTextureBlendMode, "SDL_GetTextureBlendMode", int_ret_test,
+                texture, &blend_mode);
+    const Uint32 index { Uint32(textures_.size()) };
+    textures_.push_back(TextureInfo{ texture, float(w), float(h), blend_mode });
+    texture_indices_.emplace(texture, index);
+    last_texture_ = texture;
+    last_texture_index_ = index;
+    return index;
+}
+
+void SpriteBatch::push(SDL_Texture* texture, const SDL_Rect* src, const SDL_FRect& dst,
+                       float cos_a, float sin_a, float center_x, float center_y,
+                       SDL_RendererFlip flip, int layer, SDL_Color color) {
+    if (texture == nullptr)
+        throw std::invalid_argument("SpriteBatch: texture must not be null");
+    if (layer < INT16_MIN || layer > INT16_MAX)
+        throw std::out_of_range("SpriteBatch: layer must fit in 16 bits");
+    if (pending() == MAX_PENDING)
+        flush();
+    const std::size_t index { textureIndex(texture) };
+    const TextureInfo& info { textures_[index] };
+
+    float u0 { 0.0f };
+    float v0 { 0.0f };
+    float u1 { 1.0f };
+    float v1 { 1.0f };
+    if (src != nullptr) {
+        u0 = float(src->x) / info.w;
+        v0 = float(src->y) / info.h;
+        u1 = float(src->x + src->w) / info.w;
+        v1 = float(src->y + src->h) / info.h;
+    }
+    if (flip & SDL_FLIP_HORIZONTAL)
+        std::swap(u0, u1);
+    if (flip & SDL_FLIP_VERTICAL)
+        std::swap(v0, v1);
+
+    dst_x_.push_back(dst.x);
+    dst_y_.push_back(dst.y);
+    dst_w_.push_back(dst.w);
+    dst_h_.push_back(dst.h);
+    center_x_.push_back(center_x);
+    center_y_.push_back(center_y);
+    cos_.push_back(cos_a);
+    sin_.push_back(sin_a);
+    u0_.push_back(u0);
+    v0_.push_back(v0);
+    u1_.push_back(u1);
+    v1_.push_back(v1);
+    color_.push_back(color);
+    texture_index_.push_back(Uint32(index));
+    layer_.push_back(layer);
+}
+
+void SpriteBatch::draw(SDL_Texture* texture, const SDL_Rect* src, const SDL_FRect& dst,
+                       int layer, SDL_Color color) {
+    push(texture, src, dst, 1.0f, 0.0f, 0.0f, 0.0f, SDL_FLIP_NONE, layer, color);
+}
+
+void SpriteBatch::drawEx(SDL_Texture* texture, const SDL_Rect* src, const SDL_FRect& dst,
+                         double angle, const SDL_FPoint* center, SDL_RendererFlip flip,
+                         int layer, SDL_Color color) {
+    if (angle == 0.0) {
+        // unrotated corners are then exactly dst edges
+        push(texture, src, dst, 1.0f, 0.0f, 0.0f, 0.0f, flip, layer, color);
+        return;
+    }
+    const double radians { angle * RADIANS_PER_DEGREE };
+    const SDL_FPoint pivot { center != nullptr ? *center :
+                             SDL_FPoint{ dst.w / 2.0f, dst.h / 2.0f } };
+    push(texture, src, dst, float(std::cos(radians)), float(std::sin(radians)),
+         pivot.x, pivot.y, flip, layer, color);
+}
+
+void SpriteBatch::generateVertices() {
+    const std::size_t count { pending() };
+    xy_.resize(count * 8);
+    uv_.resize(count * 8);
+    vertex_color_.resize(count * 4);
+
+    const float* dst_x { dst_x_.data() };
+    const float* dst_y { dst_y_.data() };
+    const float* dst_w { dst_w_.data() };
+    const float* dst_h { dst_h_.data() };
+    const float* center_x { center_x_.data() };
+    const float* center_y { center_y_.data() };
+    const float* cos_a { cos_.data() };
+    const float* sin_a { sin_.data() };
+    float* xy { xy_.data() };
+    // corners clockwise from top left, relative to pivot, rotated and then
+    //   moved back to pivot's screen position
+    for (std::size_t i {}; i < count; ++i) {
+        const float left { -center_x[i] };
+        const float top { -center_y[i] };
+        const float right { dst_w[i] - center_x[i] };
+        const float bottom { dst_h[i] - center_y[i] };
+        const float origin_x { dst_x[i] + center_x[i] };
+        const float origin_y { dst_y[i] + center_y[i] };
+        const float c { cos_a[i] };
+        const float s { sin_a[i] };
+        xy[i * 8 + 0] = origin_x + left * c - top * s;
+        xy[i * 8 + 1] = origin_y + left * s + top * c;
+        xy[i * 8 + 2] = origin_x + right * c - top * s;
+        xy[i * 8 + 3] = origin_y + right * s + top * c;
+        xy[i * 8 + 4] = origin_x + right * c - bottom * s;
+        xy[i * 8 + 5] = origin_y + right * s + bottom * c;
+        xy[i * 8 + 6] = origin_x + left * c - bottom * s;
+        xy[i * 8 + 7] = origin_y + left * s + bottom * c;
+    }
+
+    const float* u0 { u0_.data() };
+    const float* v0 { v0_.data() };
+    const float* u1 { u1_.data() };
+    const float* v1 { v1_.data() };
+    float* uv { uv_.data() };
+    for (std::size_t i {}; i < count; ++i) {
+        uv[i * 8 + 0] = u0[i];
+        uv[i * 8 + 1] = v0[i];
+        uv[i * 8 + 2] = u1[i];
+        uv[i * 8 + 3] = v0[i];
+        uv[i * 8 + 4] = u1[i];
+        uv[i * 8 + 5] = v1[i];
+        uv[i * 8 + 6] = u0[i];
+        uv[i * 8 + 7] = v1[i];
+    }
+
+    for (std::size_t i {}; i < count; ++i) {
+        for (std::size_t corner {}; corner < 4; ++corner)
+            vertex_color_[i * 4 + corner] = color_[i];
+    }
+}
+
+void SpriteBatch::flush() {
+    const std::size_t count { pending() };
+    if (count == 0)
+        return;
+    generateVertices();
+
+    // rank textures by blend mode, so runs of a layer with the same blend
+    //   mode are adjacent
+    by_blend_mode_.resize(textures_.size());
+    for (std::size_t i {}; i < by_blend_mode_.size(); ++i)
+        by_blend_mode_[i] = Uint32(i);
+    std::sort(by_blend_mode_.begin(), by_blend_mode_.end(),
+              [this](const Uint32 a, const Uint32 b){
+                  return textures_[a].blend_mode < textures_[b].blend_mode ||
+                      (textures_[a].blend_mode == textures_[b].blend_mode && a < b);
+              });
+    rank_.resize(textures_.size());
+    for (std::size_t i {}; i < by_blend_mode_.size(); ++i)
+        rank_[by_blend_mode_[i]] = i;
+
+    order_.resize(count);
+    for (std::size_t i {}; i < count; ++i) {
+        const std::uint64_t layer { std::uint64_t(layer_[i] - INT16_MIN) };
+        order_[i] = (layer << LAYER_SHIFT) | (rank_[texture_index_[i]] << RANK_SHIFT) | i;
+    }
+    std::sort(order_.begin(), order_.end());
+
+    // a layer change without a texture change needs no new call, as no
+    //   other texture can be drawn in between
+    indices_.clear();
+    indices_.reserve(count * 6);
+    std::size_t run_start {};
+    Uint32 run_texture { texture_index_[order_.front() & 0xffffffff] };
+    const auto submitRun { [this, &run_start, &run_texture, count](){
+        const int* run_indices { indices_.data() + run_start };
+        safeSdlCall(SDL_RenderGeometryRaw, "SDL_RenderGeometryRaw", int_ret_test,
+                    renderer_, textures_[run_texture].texture,
+                    xy_.data(), int(sizeof(float) * 2),
+                    vertex_color_.data(), int(sizeof(SDL_Color)),
+                    uv_.data(), int(sizeof(float) * 2),
+                    int(count * 4),
+                    static_cast<const void*>(run_indices),
+                    int(indices_.size() - run_start), int(sizeof(int)));
+        ++stats_.geometry_calls;
+        run_start = indices_.size();
+    } };
+    for (const std::uint64_t key : order_) {
+        const std::size_t sprite { std::size_t(key & 0xffffffff) };
+        if (texture_index_[sprite] != run_texture) {
+            submitRun();
+            run_texture = texture_index_[sprite];
+        }
+        const int base { int(sprite * 4) };
+        const int quad[] { base, base + 1, base + 2, base, base + 2, base + 3 };
+        indices_.insert(indices_.end(), std::begin(quad), std::end(quad));
+    }
+    submitRun();
+
+    stats_.sprites += count;
+    ++stats_.flushes;
+    clear();
+}
+
+void SpriteBatch::clear() {
+    textures_.clear();
+    texture_indices_.clear();
+    last_texture_ = nullptr;
+    last_texture_index_ = 0;
+    dst_x_.clear();
+    dst_y_.clear();
+    dst_w_.clear();
+    dst_h_.clear();
+    center_x_.clear();
+    center_y_.clear();
+    cos_.clear();
+    sin_.clear();
+    u0_.clear();
+    v0_.clear();
+    u1_.clear();
+    v1_.clear();
+    color_.clear();
+    texture_index_.clear();
+    layer_.clear();
+}
+
+}  // namespace sdl2_render_util
@@ -0,0 +1,129 @@
+#include "streaming_texture.hh"
+
+#include "safeSdlCall.hh"
+
+#include <algorithm>   // max
+#include <stdexcept>   // invalid_argument logic_error
+
+
+namespace sdl2_render_util {
+
+static const SdlRetTest<SDL_Texture*> create_texture_test {
+    [](const SDL_Texture* ret){ return (ret == nullptr); }
+};
+
+static const SdlRetTest<int> int_ret_test {
+    [](const int ret){ return (ret != 0); }
+};
+
+StreamingTexture::StreamingTexture(SDL_Renderer* renderer, Uint32 format,
+                                   int w, int h, std::size_t slot_ct,
+                                   std::chrono::microseconds stall_threshold) :
+    format_(format), w_(w), h_(h), stall_threshold_(stall_threshold) {
+    if (slot_ct < 2)
+        throw std::invalid_argument("StreamingTexture: slot_ct must be at least 2");
+    slots_.reserve(slot_ct);
+    for (std::size_t i {}; i < slot_ct; ++i) {
+        slots_.push_back(sdl2_smart_ptr::make_unique(
+            safeSdlCall(SDL_CreateTexture, "SDL_CreateTexture",
+                        create_texture_test,
+                        renderer, format, int(SDL_TEXTUREACCESS_STREAMING),
+                        w, h)));
+    }
+}
+
+std::size_t StreamingTexture::nextSlot() const {
+    // oldest slot is least likely to still be in use by the driver
+    return (current_slot_ == NO_SLOT) ? 0 : (current_slot_ + 1) % slots_.size();
+}
+
+void StreamingTexture::publish(std::size_t slot) {
+    if (!current_retrieved_)
+        ++stats_.dropped;
+    current_slot_ = slot;
+    current_retrieved_ = false;
+    ++stats_.published;
+}
+
+void StreamingTexture::recordCallTime(
+    std::chrono::steady_clock::time_point start) {
+    const auto elapsed {
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start)
+    };
+    if (elapsed < stall_threshold_)
+        return;
+    ++stats_.producer_waits;
+    stats_.total_wait += elapsed;
+    stats_.max_wait = std::max(stats_.max_wait, elapsed);
+}
+
+StreamingTexture::WriteSpan StreamingTexture::beginWrite() {
+    if (writing_)
+        throw std::logic_error("StreamingTexture: beginWrite called during write");
+    WriteSpan span;
+    span.w = w_;
+    span.h = h_;
+    span.slot = nextSlot();
+    const auto start { std::chrono::steady_clock::now() };
+    safeSdlCall(SDL_LockTexture, "SDL_LockTexture", int_ret_test,
+                slots_[span.slot].get(), nullptr, &span.pixels, &span.pitch);
+    recordCallTime(start);
+    writing_ = true;
+    return span;
+}
+
+void StreamingTexture::endWrite(const WriteSpan& span) {
+    if (!writing_ || span.slot != nextSlot())
+        throw std::logic_error("StreamingTexture: endWrite without matching beginWrite");
+    SDL_UnlockTexture(slots_[span.slot].get());
+    writing_ = false;
+    publish(span.slot);
+}
+
+void StreamingTexture::update(const void* pixels, int pitch) {
+    if (writing_)
+        throw std::logic_error("StreamingTexture: update called during write");
+    const std::size_t slot { nextSlot() };
+    const auto start { std::chrono::steady_clock::now() };
+    safeSdlCall(SDL_UpdateTexture, "SDL_UpdateTexture", int_ret_test,
+                slots_[slot].get(), nullptr, pixels, pitch);
+    recordCallTime(start);
+    publish(slot);
+}
+
+void StreamingTexture::updateYUV(const Uint8* y_plane, int y_pitch,
+                                 const Uint8* u_plane, int u_pitch,
+                                 const Uint8* v_plane, int v_pitch) {
+    if (writing_)
+        throw std::logic_error("StreamingTexture: updateYUV called during write");
+    const std::size_t slot { nextSlot() };
+    const auto start { std::chrono::steady_clock::now() };
+    safeSdlCall(SDL_UpdateYUVTexture, "SDL_UpdateYUVTexture", int_ret_test,
+                slots_[slot].get(), nullptr,
+                y_plane, y_pitch, u_plane, u_pitch, v_plane, v_pitch);
+    recordCallTime(start);
+    publish(slot);
+}
+
+void StreamingTexture::updateNV(const Uint8* y_plane, int y_pitch,
+                                const Uint8* uv_plane, int uv_pitch) {
+    if (writing_)
+        throw std::logic_error("StreamingTexture: updateNV called during write");
+    const std::size_t slot { nextSlot() };
+    const auto start { std::chrono::steady_clock::now() };
+    safeSdlCall(SDL_UpdateNVTexture, "SDL_UpdateNVTexture", int_ret_test,
+                slots_[slot].get(), nullptr,
+                y_plane, y_pitch, uv_plane, uv_pitch);
+    recordCallTime(start);
+    publish(slot);
+}
+
+SDL_Texture* StreamingTexture::current() {
+    if (current_slot_ == NO_SLOT)
+        return nullptr;
+    current_retrieved_ = true;
+    return slots_[current_slot_].get();
+}
+
+}  // namespace sdl2_render_util
@@ -0,0 +1,60 @@
+#include "texture_arena.hh"
+
+#include "safeSdlCall.hh"
+
+#include <stdexcept>  // invalid_argument out_of_range
+#include <utility>    // move
+
+
+namespace sdl2_render_util {
+
+static const SdlRetTest<SDL_Texture*> sdl_texture_test {
+    [](const SDL_Texture* ret){ return (ret == nullptr); }
+};
+
+TextureArena::TextureArena(sdl2_smart_ptr::unique::Renderer renderer) :
+    renderer_(std::move(renderer)) {
+    if (renderer_ == nullptr)
+        throw std::invalid_argument("TextureArena: null renderer");
+}
+
+TextureArena::~TextureArena() {
+    // SDL_DestroyRenderer frees the renderer's textures in one pass, so they
+    //   are only dropped here
+    textures_.abandon();
+}
+
+TextureHandle TextureArena::create(Uint32 format, int access, int w, int h) {
+    return textures_.insert(safeSdlCall(SDL_CreateTexture, "SDL_CreateTexture",
+                                        sdl_texture_test,
+                                        renderer_.get(), format, access, w, h));
+}
+
+TextureHandle TextureArena::createFromSurface(SDL_Surface* surface) {
+    return textures_.insert(safeSdlCall(SDL_CreateTextureFromSurface,
+                                        "SDL_CreateTextureFromSurface", sdl_texture_test,
+                                        renderer_.get(), surface));
+}
+
+TextureHandle TextureArena::adopt(sdl2_smart_ptr::unique::Texture texture) {
+    if (texture == nullptr)
+        throw std::invalid_argument("TextureArena: cannot adopt null texture");
+    return textures_.insert(std::move(texture));
+}
+
+void TextureArena::clear() {
+    // destroyed here rather than by the slot map's deleter, so that
+    //   accounting is settled in one update
+    for (SDL_Texture* texture : textures_)
+        SDL_DestroyTexture(texture);
+    textures_.abandon();
+}
+
+SDL_Texture* TextureArena::at(TextureHandle handle) const {
+    SDL_Texture* texture { textures_.get(handle) };
+    if (texture == nullptr)
+        throw std::out_of_range("TextureArena: stale texture handle");
+    return texture;
+}
+
+}  // namespace sdl2_render_util
@@ -0,0 +1,235 @@
+#include <catch2/catch_version_macros.hpp>               // CATCH_VERSION_MAJOR
+#if (CATCH_VERSION_MAJOR != 3)
+  #error "tests currently only support Catch2 v3.x"
+#endif
+#include <catch2/catch_test_macros.hpp>                  // TEST_CASE, SECTION, REQUIRE
+
+#include "dirty_region.hh"
+
+#include "sdl2_smart_ptr.hh"  // unique::Surface unique::Renderer make_unique
+
+#include <SDL.h>
+
+#include <array>
+#include <stdexcept>  // invalid_argument
+#include <string>
+#include <vector>
+
+
+static std::string collectErrorQuitSdl(const std::string& func_name) {
+    std::string err { SDL_GetError() };
+    SDL_ClearError();
+    if (err.size() == 0) {
+        err = "failure without setting SDL error";
+    }
+    SDL_Quit();
+    return func_name + ": " + err;
+}
+
+using namespace sdl2_render_util;
+using namespace sdl2_smart_ptr;
+
+static bool rectsOverlap(const std::vector<SDL_Rect>& rects) {
+    for (std::size_t a {}; a < rects.size(); ++a) {
+        for (std::size_t b { a + 1 }; b < rects.size(); ++b) {
+            if (SDL_HasIntersection(&rects[a], &rects[b]) == SDL_TRUE)
+                return true;
+        }
+    }
+    return false;
+}
+
+static bool operator==(const SDL_Rect& a, const SDL_Rect& b) {
+    return a.x == b.x && a.y == b.y && a.w == b.w && a.h == b.h;
+}
+
+TEST_CASE("SDL render dirty rect merging: DirtyRegion",
+    "[sdl2_render_util][SDL2][render][DirtyRegion]")
+{
+    if (SDL_Init(0) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    SECTION("invalid arguments")
+    {
+        REQUIRE_THROWS_AS(DirtyRegion(-1, 10), std::invalid_argument);
+        REQUIRE_THROWS_AS(DirtyRegion(10, 10, 0), std::invalid_argument);
+    }
+    SECTION("clipping and containment")
+    {
+        DirtyRegion region { 100, 100 };
+        REQUIRE(region.empty());
+        region.add(SDL_Rect{ -10, -10, 20, 20 });
+        REQUIRE(region.rects().size() == 1);
+        REQUIRE(region.rects()[0] == SDL_Rect{ 0, 0, 10, 10 });
+        region.add(SDL_Rect{ 200, 200, 10, 10 });
+        region.add(SDL_Rect{ 2, 2, 4, 4 });
+        REQUIRE(region.rects().size() == 1);
+        REQUIRE(region.area() == 100);
+    }
+    SECTION("overlapping and adjacent rects merge")
+    {
+        DirtyRegion region { 100, 100 };
+        region.add(SDL_Rect{ 0, 0, 10, 10 });
+        region.add(SDL_Rect{ 10, 0, 10, 10 });
+        REQUIRE(region.rects().size() == 1);
+        REQUIRE(region.rects()[0] == SDL_Rect{ 0, 0, 20, 10 });
+
+        // disjoint rects stay separate until a third joins them
+        region.add(SDL_Rect{ 50, 50, 10, 10 });
+        REQUIRE(region.rects().size() == 2);
+        region.add(SDL_Rect{ 15, 5, 40, 50 });
+        REQUIRE(region.rects().size() == 1);
+        REQUIRE(region.rects()[0] == SDL_Rect{ 0, 0, 60, 60 });
+    }
+    SECTION("rect count is bounded")
+    {
+        DirtyRegion region { 1000, 1000, 4 };
+        for (int i {}; i < 20; ++i)
+            region.add(SDL_Rect{ (i * 97) % 990, (i * 61) % 990, 5, 5 });
+        REQUIRE(region.rects().size() <= 4);
+        REQUIRE_FALSE(rectsOverlap(region.rects()));
+        REQUIRE(region.area() >= 20 * 25);
+
+        region.addAll();
+        REQUIRE(region.rects().size() == 1);
+        REQUIRE(region.area() == 1000 * 1000);
+        region.clear();
+        REQUIRE(region.empty());
+    }
+    SECTION("resize")
+    {
+        DirtyRegion region { 100, 100 };
+        region.add(SDL_Rect{ 80, 80, 20, 20 });
+        region.resize(90, 120);
+        REQUIRE_FALSE(rectsOverlap(region.rects()));
+        // clipped old rect plus new 90x20 strip
+        REQUIRE(region.area() == 10 * 20 + 90 * 20);
+    }
+
+    SDL_Quit();
+}
+
+TEST_CASE("SDL render partial redraw: DirtyRectRenderer",
+    "[sdl2_render_util][SDL2][render][DirtyRectRenderer]")
+{
+    if (SDL_Init(0) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    {
+        unique::Surface output { make_unique(
+            SDL_CreateRGBSurfaceWithFormat(0, 32, 32, 32, SDL_PIXELFORMAT_RGBA32)) };
+        REQUIRE(output != nullptr);
+        unique::Renderer renderer { make_unique(SDL_CreateSoftwareRenderer(output.get())) };
+        REQUIRE(renderer != nullptr);
+
+        DirtyRectRenderer partial { renderer.get() };
+        std::array<Uint8, 3> color { 255, 0, 0 };
+        std::vector<SDL_Rect> redrawn;
+        const DirtyRectRenderer::Redraw redraw {
+            [&color, &redrawn](SDL_Renderer* target_renderer, const SDL_Rect& clip){
+                redrawn.push_back(clip);
+                SDL_SetRenderDrawColor(target_renderer, color[0], color[1], color[2], 255);
+                SDL_RenderFillRect(target_renderer, nullptr);
+            }
+        };
+        const auto readPixel { [&renderer](int x, int y){
+            std::vector<Uint8> pixels(32 * 32 * 4);
+            REQUIRE(SDL_RenderReadPixels(renderer.get(), nullptr, SDL_PIXELFORMAT_RGBA32,
+                                         pixels.data(), 32 * 4) == 0);
+            const std::size_t offset { (std::size_t(y) * 32 + std::size_t(x)) * 4 };
+            return std::array<Uint8, 3>{ pixels[offset], pixels[offset + 1],
+                                         pixels[offset + 2] };
+        } };
+
+        // first frame draws everything
+        REQUIRE(partial.present(redraw));
+        REQUIRE(redrawn.size() == 1);
+        REQUIRE(partial.stats().last_percent_redrawn == 100.0);
+        REQUIRE(partial.target() != nullptr);
+        REQUIRE(readPixel(20, 20) == color);
+
+        // then nothing until marked dirty
+        redrawn.clear();
+        REQUIRE_FALSE(partial.present(redraw));
+        REQUIRE(redrawn.empty());
+        REQUIRE(partial.stats().skipped_frames == 1);
+
+        color = { 0, 0, 255 };
+        partial.dirty().add(SDL_Rect{ 0, 0, 8, 8 });
+        REQUIRE(partial.present(redraw));
+        REQUIRE(redrawn.size() == 1);
+        REQUIRE(partial.stats().last_pixels_redrawn == 64);
+        REQUIRE(partial.stats().last_percent_redrawn == 6.25);
+        REQUIRE(readPixel(4, 4) == color);
+        REQUIRE(readPixel(20, 20) == std::array<Uint8, 3>{ 255, 0, 0 });
+        REQUIRE(partial.stats().frames == 3);
+        REQUIRE(partial.stats().percentRedrawn() > 6.25);
+        REQUIRE(partial.stats().percentRedrawn() < 50.0);
+
+        // lost target contents are redrawn in full
+        SDL_Event event {};
+        event.type = SDL_RENDER_TARGETS_RESET;
+        partial.handleEvent(event);
+        redrawn.clear();
+        REQUIRE(partial.present(redraw));
+        REQUIRE(partial.stats().last_percent_redrawn == 100.0);
+        REQUIRE(readPixel(20, 20) == color);
+        REQUIRE(SDL_GetRenderTarget(renderer.get()) == nullptr);
+    }
+
+    SDL_Quit();
+}
+
+TEST_CASE("SDL render partial redraw: DirtyRectSurface",
+    "[sdl2_render_util][SDL2][render][DirtyRectSurface]")
+{
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    SDL_Window* window {
+        SDL_CreateWindow("test_window", 0, 0, 32, 32, SDL_WINDOW_HIDDEN)
+    };
+    if (window == nullptr) {
+        FAIL(collectErrorQuitSdl("SDL_CreateWindow"));
+    }
+
+    {
+        DirtyRectSurface partial { window };
+        std::vector<SDL_Rect> redrawn;
+        const DirtyRectSurface::Redraw redraw {
+            [&redrawn](SDL_Surface* surface, const SDL_Rect& clip){
+                REQUIRE(surface->clip_rect == clip);
+                redrawn.push_back(clip);
+                SDL_FillRect(surface, nullptr, SDL_MapRGB(surface->format, 255, 0, 0));
+            }
+        };
+
+        REQUIRE(partial.present(redraw));
+        REQUIRE(partial.stats().last_percent_redrawn == 100.0);
+
+        REQUIRE_FALSE(partial.present(redraw));
+
+        redrawn.clear();
+        partial.dirty().add(SDL_Rect{ 0, 0, 4, 4 });
+        partial.dirty().add(SDL_Rect{ 20, 20, 4, 4 });
+        REQUIRE(partial.present(redraw));
+        REQUIRE(redrawn.size() == 2);
+        REQUIRE(partial.stats().last_pixels_redrawn == 32);
+
+        // exposed window is updated without redrawing
+        SDL_Event event {};
+        event.type = SDL_WINDOWEVENT;
+        event.window.event = SDL_WINDOWEVENT_EXPOSED;
+        partial.handleEvent(event);
+        redrawn.clear();
+        REQUIRE(partial.present(redraw));
+        REQUIRE(redrawn.empty());
+        REQUIRE(partial.stats().skipped_frames == 1);
+    }
+
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+}
@@ -0,0 +1,197 @@
+#include <catch2/catch_version_macros.hpp>               // CATCH_VERSION_MAJOR
+#if (CATCH_VERSION_MAJOR != 3)
+  #error "tests currently only support Catch2 v3.x"
+#endif
+#include <catch2/catch_test_macros.hpp>                  // TEST_CASE, SECTION, REQUIRE
+#include <catch2/benchmark/catch_benchmark.hpp>          // BENCHMARK
+
+#include "layer_cache.hh"
+
+#include "sdl2_smart_ptr.hh"  // unique::Surface unique::Renderer make_unique
+
+#include <SDL.h>
+
+#include <array>
+#include <stdexcept>  // invalid_argument
+#include <string>
+#include <vector>
+
+
+static std::string collectErrorQuitSdl(const std::string& func_name) {
+    std::string err { SDL_GetError() };
+    SDL_ClearError();
+    if (err.size() == 0) {
+        err = "failure without setting SDL error";
+    }
+    SDL_Quit();
+    return func_name + ": " + err;
+}
+
+using namespace sdl2_render_util;
+using namespace sdl2_smart_ptr;
+
+using Rgb = std::array<Uint8, 3>;
+
+static Rgb readPixel(SDL_Renderer* renderer, int x, int y) {
+    std::vector<Uint8> pixels(32 * 32 * 4);
+    REQUIRE(SDL_RenderReadPixels(renderer, nullptr, SDL_PIXELFORMAT_RGBA32,
+                                 pixels.data(), 32 * 4) == 0);
+    const std::size_t offset { (std::size_t(y) * 32 + std::size_t(x)) * 4 };
+    return Rgb{ pixels[offset], pixels[offset + 1], pixels[offset + 2] };
+}
+
+TEST_CASE("SDL render retained layers: LayerCache",
+    "[sdl2_render_util][SDL2][render][LayerCache]")
+{
+    if (SDL_Init(0) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    {
+        unique::Surface output { make_unique(
+            SDL_CreateRGBSurfaceWithFormat(0, 32, 32, 32, SDL_PIXELFORMAT_RGBA32)) };
+        REQUIRE(output != nullptr);
+        unique::Renderer renderer { make_unique(SDL_CreateSoftwareRenderer(output.get())) };
+        REQUIRE(renderer != nullptr);
+        REQUIRE(SDL_SetRenderDrawColor(renderer.get(), 0, 0, 0, 255) == 0);
+        REQUIRE(SDL_RenderClear(renderer.get()) == 0);
+
+        LayerCache cache { renderer.get() };
+        int draw_ct {};
+        Rgb color { 255, 0, 0 };
+        const LayerCache::Draw fill {
+            [&draw_ct, &color](SDL_Renderer* layer_renderer){
+                ++draw_ct;
+                SDL_SetRenderDrawColor(layer_renderer, color[0], color[1], color[2], 255);
+                // layer coordinates, offset by composite area
+                const SDL_Rect rect { 0, 0, 4, 4 };
+                SDL_RenderFillRect(layer_renderer, &rect);
+            }
+        };
+        const SDL_Rect area { 8, 8, 8, 8 };
+
+        SECTION("invalid arguments")
+        {
+            REQUIRE_THROWS_AS(LayerCache(nullptr), std::invalid_argument);
+            REQUIRE_THROWS_AS(cache.composite(1, 0, SDL_Rect{ 0, 0, 0, 8 }, fill),
+                              std::invalid_argument);
+        }
+        SECTION("layers are drawn once per version")
+        {
+            cache.composite(1, 0, area, fill);
+            REQUIRE(draw_ct == 1);
+            REQUIRE(cache.contains(1));
+            REQUIRE(SDL_GetRenderTarget(renderer.get()) == nullptr);
+            REQUIRE(readPixel(renderer.get(), 10, 10) == color);
+            // transparent rest of layer leaves target untouched
+            REQUIRE(readPixel(renderer.get(), 14, 14) == Rgb{ 0, 0, 0 });
+            REQUIRE(readPixel(renderer.get(), 2, 2) == Rgb{ 0, 0, 0 });
+
+            for (int i {}; i < 10; ++i)
+                cache.composite(1, 0, area, fill);
+            REQUIRE(draw_ct == 1);
+            REQUIRE(cache.stats().composites == 11);
+            REQUIRE(cache.stats().redraws == 1);
+
+            color = { 0, 0, 255 };
+            cache.composite(1, 1, area, fill);
+            REQUIRE(draw_ct == 2);
+            REQUIRE(readPixel(renderer.get(), 10, 10) == color);
+
+            // resized layer is redrawn
+            cache.composite(1, 1, SDL_Rect{ 0, 0, 16, 16 }, fill);
+            REQUIRE(draw_ct == 3);
+
+            cache.invalidate(1);
+            cache.composite(1, 1, area, fill);
+            REQUIRE(draw_ct == 4);
+
+            cache.composite(2, 0, SDL_Rect{ 20, 20, 4, 4 }, fill);
+            REQUIRE(cache.size() == 2);
+            cache.invalidateAll();
+            cache.composite(1, 1, area, fill);
+            cache.composite(2, 0, SDL_Rect{ 20, 20, 4, 4 }, fill);
+            REQUIRE(draw_ct == 7);
+
+            cache.erase(2);
+            REQUIRE_FALSE(cache.contains(2));
+            cache.clear();
+            REQUIRE(cache.size() == 0);
+        }
+        SECTION("lost targets are redrawn")
+        {
+            cache.composite(1, 0, area, fill);
+            SDL_Event event {};
+            event.type = SDL_RENDER_TARGETS_RESET;
+            cache.handleEvent(event);
+            cache.composite(1, 0, area, fill);
+            REQUIRE(draw_ct == 2);
+            REQUIRE(cache.stats().lost_redraws == 1);
+
+            event.type = SDL_RENDER_DEVICE_RESET;
+            cache.handleEvent(event);
+            cache.composite(1, 0, area, fill);
+            REQUIRE(draw_ct == 3);
+            REQUIRE(cache.stats().lost_redraws == 2);
+            REQUIRE(readPixel(renderer.get(), 10, 10) == color);
+        }
+        SECTION("hashed versions")
+        {
+            const int score_a[] { 100, 3 };
+            const int score_b[] { 100, 4 };
+            REQUIRE(hashLayerInputs(score_a, sizeof(score_a)) ==
+                    hashLayerInputs(score_a, sizeof(score_a)));
+            REQUIRE(hashLayerInputs(score_a, sizeof(score_a)) !=
+                    hashLayerInputs(score_b, sizeof(score_b)));
+        }
+    }
+
+    SDL_Quit();
+}
+
+// Approximates a static HUD panel: grid of 1024 small filled rects
+static void drawPanel(SDL_Renderer* renderer, int x, int y) {
+    SDL_SetRenderDrawColor(renderer, 40, 40, 60, 255);
+    for (int row {}; row < 32; ++row) {
+        for (int col {}; col < 32; ++col) {
+            const SDL_Rect cell { x + col * 8, y + row * 8, 7, 7 };
+            SDL_RenderFillRect(renderer, &cell);
+        }
+    }
+}
+
+TEST_CASE("SDL render retained layers throughput: LayerCache",
+    "[.][benchmark][sdl2_render_util][SDL2][render][LayerCache]")
+{
+    if (SDL_Init(0) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    {
+        unique::Surface output { make_unique(
+            SDL_CreateRGBSurfaceWithFormat(0, 640, 480, 32, SDL_PIXELFORMAT_RGBA32)) };
+        REQUIRE(output != nullptr);
+        unique::Renderer renderer { make_unique(SDL_CreateSoftwareRenderer(output.get())) };
+        REQUIRE(renderer != nullptr);
+
+        LayerCache cache { renderer.get() };
+        const LayerCache::Draw panel {
+            [](SDL_Renderer* layer_renderer){ drawPanel(layer_renderer, 0, 0); }
+        };
+
+        BENCHMARK("4 panels of 1024 rects, drawn directly") {
+            for (int i {}; i < 4; ++i)
+                drawPanel(renderer.get(), (i % 2) * 320, (i / 2) * 240);
+            return SDL_RenderFlush(renderer.get());
+        };
+        BENCHMARK("4 panels of 1024 rects, LayerCache") {
+            for (int i {}; i < 4; ++i) {
+                cache.composite(LayerCache::LayerId(i), 0,
+                                SDL_Rect{ (i % 2) * 320, (i / 2) * 240, 256, 256 }, panel);
+            }
+            return SDL_RenderFlush(renderer.get());
+        };
+    }
+
+    SDL_Quit();
+}
@@ -0,0 +1,245 @@
+#include <catch2/catch_version_macros.hpp>               // CATCH_VERSION_MAJOR
+#if (CATCH_VERSION_MAJOR != 3)
+  #error "tests currently only support Catch2 v3.x"
+#endif
+#include <catch2/catch_test_macros.hpp>                  // TEST_CASE, SECTION, REQUIRE
+#include <catch2/benchmark/catch_benchmark.hpp>          // BENCHMARK
+
+#include "sprite_batch.hh"
+
+#include "sdl2_smart_ptr.hh"  // unique::Surface unique::Renderer unique::Texture make_unique
+
+#include <SDL.h>
+
+#include <array>
+#include <chrono>
+#include <stdexcept>  // invalid_argument out_of_range
+#include <string>
+#include <vector>
+
+
+static std::string collectErrorQuitSdl(const std::string& func_name) {
+    std::string err { SDL_GetError() };
+    SDL_ClearError();
+    if (err.size() == 0) {
+        err = "failure without setting SDL error";
+    }
+    SDL_Quit();
+    return func_name + ": " + err;
+}
+
+using namespace sdl2_render_util;
+using namespace sdl2_smart_ptr;
+
+using Rgba = std::array<Uint8, 4>;
+
+static constexpr Rgba BLACK { 0, 0, 0, 255 };
+static constexpr Rgba RED { 255, 0, 0, 255 };
+static constexpr Rgba BLUE { 0, 0, 255, 255 };
+
+// one texel per color, left to right
+static unique::Texture createStripTexture(SDL_Renderer* renderer,
+                                          const std::vector<Rgba>& texels) {
+    unique::Texture texture { make_unique(
+        SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC,
+                          int(texels.size()), 1)) };
+    REQUIRE(texture != nullptr);
+    REQUIRE(SDL_UpdateTexture(texture.get(), nullptr, texels.data(),
+                              int(texels.size() * sizeof(Rgba))) == 0);
+    REQUIRE(SDL_SetTextureBlendMode(texture.get(), SDL_BLENDMODE_NONE) == 0);
+    return texture;
+}
+
+static Rgba readPixel(SDL_Renderer* renderer, SDL_Surface* target, int x, int y) {
+    std::vector<Uint8> pixels(std::size_t(target->w) * std::size_t(target->h) * 4);
+    REQUIRE(SDL_RenderReadPixels(renderer, nullptr, SDL_PIXELFORMAT_RGBA32,
+                                 pixels.data(), target->w * 4) == 0);
+    const std::size_t offset { (std::size_t(y) * std::size_t(target->w) + std::size_t(x)) * 4 };
+    return Rgba{ pixels[offset], pixels[offset + 1], pixels[offset + 2], pixels[offset + 3] };
+}
+
+TEST_CASE("SDL render sprite batching: SpriteBatch",
+    "[sdl2_render_util][SDL2][render][SpriteBatch]")
+{
+    if (SDL_Init(0) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    {
+        unique::Surface target { make_unique(
+            SDL_CreateRGBSurfaceWithFormat(0, 32, 32, 32, SDL_PIXELFORMAT_RGBA32)) };
+        REQUIRE(target != nullptr);
+        unique::Renderer renderer { make_unique(SDL_CreateSoftwareRenderer(target.get())) };
+        REQUIRE(renderer != nullptr);
+        REQUIRE(SDL_SetRenderDrawColor(renderer.get(), 0, 0, 0, 255) == 0);
+        REQUIRE(SDL_RenderClear(renderer.get()) == 0);
+
+        unique::Texture red_blue { createStripTexture(renderer.get(), { RED, BLUE }) };
+        unique::Texture red { createStripTexture(renderer.get(), { RED }) };
+        unique::Texture blue { createStripTexture(renderer.get(), { BLUE }) };
+
+        SpriteBatch batch { renderer.get() };
+
+        SECTION("invalid arguments")
+        {
+            REQUIRE_THROWS_AS(SpriteBatch(nullptr), std::invalid_argument);
+            const SDL_FRect dst { 0.0f, 0.0f, 1.0f, 1.0f };
+            REQUIRE_THROWS_AS(batch.draw(nullptr, nullptr, dst), std::invalid_argument);
+            REQUIRE_THROWS_AS(batch.draw(red.get(), nullptr, dst, 40000), std::out_of_range);
+            REQUIRE(batch.pending() == 0);
+        }
+        SECTION("one geometry call per texture run")
+        {
+            for (int i {}; i < 300; ++i) {
+                SDL_Texture* textures[] { red.get(), blue.get(), red_blue.get() };
+                batch.draw(textures[i % 3], nullptr,
+                           SDL_FRect{ float(i % 32), 0.0f, 1.0f, 1.0f });
+            }
+            REQUIRE(batch.pending() == 300);
+            batch.flush();
+            REQUIRE(batch.pending() == 0);
+            REQUIRE(batch.stats().sprites == 300);
+            REQUIRE(batch.stats().geometry_calls == 3);
+
+            // texture continuing into next layer needs no new call
+            batch.resetStats();
+            const SDL_FRect dst { 0.0f, 0.0f, 4.0f, 4.0f };
+            batch.draw(red.get(), nullptr, dst, 0);
+            batch.draw(blue.get(), nullptr, dst, 1);
+            batch.draw(blue.get(), nullptr, dst, 0);
+            batch.flush();
+            REQUIRE(batch.stats().geometry_calls == 2);
+
+            batch.flush();
+            REQUIRE(batch.stats().flushes == 1);
+        }
+        SECTION("source rects and flips")
+        {
+            batch.draw(red_blue.get(), nullptr, SDL_FRect{ 8.0f, 0.0f, 16.0f, 8.0f });
+            batch.drawEx(red_blue.get(), nullptr, SDL_FRect{ 8.0f, 8.0f, 16.0f, 8.0f },
+                         0.0, nullptr, SDL_FLIP_HORIZONTAL);
+            const SDL_Rect blue_half { 1, 0, 1, 1 };
+            batch.draw(red_blue.get(), &blue_half, SDL_FRect{ 8.0f, 16.0f, 16.0f, 8.0f });
+            batch.flush();
+            REQUIRE(readPixel(renderer.get(), target.get(), 10, 4) == RED);
+            REQUIRE(readPixel(renderer.get(), target.get(), 21, 4) == BLUE);
+            REQUIRE(readPixel(renderer.get(), target.get(), 10, 12) == BLUE);
+            REQUIRE(readPixel(renderer.get(), target.get(), 21, 12) == RED);
+            REQUIRE(readPixel(renderer.get(), target.get(), 10, 20) == BLUE);
+            REQUIRE(readPixel(renderer.get(), target.get(), 4, 4) == BLACK);
+        }
+        SECTION("rotation")
+        {
+            // 24x8 about its center (16, 16), so clockwise quarter turn moves
+            //   left (red) end to top
+            batch.drawEx(red_blue.get(), nullptr, SDL_FRect{ 4.0f, 12.0f, 24.0f, 8.0f },
+                         90.0, nullptr, SDL_FLIP_NONE);
+            batch.flush();
+            REQUIRE(readPixel(renderer.get(), target.get(), 16, 6) == RED);
+            REQUIRE(readPixel(renderer.get(), target.get(), 16, 26) == BLUE);
+            REQUIRE(readPixel(renderer.get(), target.get(), 6, 16) == BLACK);
+            REQUIRE(readPixel(renderer.get(), target.get(), 26, 16) == BLACK);
+
+            // about top left corner
+            REQUIRE(SDL_RenderClear(renderer.get()) == 0);
+            const SDL_FPoint corner { 0.0f, 0.0f };
+            batch.drawEx(red.get(), nullptr, SDL_FRect{ 16.0f, 16.0f, 8.0f, 8.0f },
+                         180.0, &corner, SDL_FLIP_NONE);
+            batch.flush();
+            REQUIRE(readPixel(renderer.get(), target.get(), 12, 12) == RED);
+            REQUIRE(readPixel(renderer.get(), target.get(), 20, 20) == BLACK);
+        }
+        SECTION("layers")
+        {
+            const SDL_FRect dst { 0.0f, 0.0f, 8.0f, 8.0f };
+            batch.draw(red.get(), nullptr, dst, 1);
+            batch.draw(blue.get(), nullptr, dst, 0);
+            batch.flush();
+            REQUIRE(readPixel(renderer.get(), target.get(), 4, 4) == RED);
+        }
+        SECTION("clear discards sprites")
+        {
+            batch.draw(red.get(), nullptr, SDL_FRect{ 0.0f, 0.0f, 8.0f, 8.0f });
+            batch.clear();
+            batch.flush();
+            REQUIRE(batch.stats().geometry_calls == 0);
+            REQUIRE(readPixel(renderer.get(), target.get(), 4, 4) == BLACK);
+        }
+    }
+
+    SDL_Quit();
+}
+
+TEST_CASE("SDL render sprite batching throughput: SpriteBatch",
+    "[.][benchmark][sdl2_render_util][SDL2][render][SpriteBatch]")
+{
+    if (SDL_Init(0) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    {
+        static constexpr int SPRITE_CT { 10000 };
+
+        unique::Surface target { make_unique(
+            SDL_CreateRGBSurfaceWithFormat(0, 640, 480, 32, SDL_PIXELFORMAT_RGBA32)) };
+        REQUIRE(target != nullptr);
+        unique::Renderer renderer { make_unique(SDL_CreateSoftwareRenderer(target.get())) };
+        REQUIRE(renderer != nullptr);
+
+        std::vector<unique::Texture> textures;
+        for (const Rgba& color : { RED, BLUE, BLACK, Rgba{ 0, 255, 0, 255 } })
+            textures.push_back(createStripTexture(renderer.get(), { color, color }));
+        const auto spriteDst { [](const int i){
+            return SDL_FRect{ float(i * 7 % 624), float(i * 13 % 464), 16.0f, 16.0f };
+        } };
+
+        SpriteBatch batch { renderer.get() };
+
+        BENCHMARK("10000 sprites, SDL_RenderCopyF") {
+            for (int i {}; i < SPRITE_CT; ++i) {
+                const SDL_FRect dst { spriteDst(i) };
+                SDL_RenderCopyF(renderer.get(), textures[std::size_t(i % 4)].get(),
+                                nullptr, &dst);
+            }
+            return SDL_RenderFlush(renderer.get());
+        };
+        BENCHMARK("10000 sprites, SpriteBatch") {
+            for (int i {}; i < SPRITE_CT; ++i)
+                batch.draw(textures[std::size_t(i % 4)].get(), nullptr, spriteDst(i));
+            batch.flush();
+            return SDL_RenderFlush(renderer.get());
+        };
+        BENCHMARK("10000 rotated sprites, SDL_RenderCopyExF") {
+            for (int i {}; i < SPRITE_CT; ++i) {
+                const SDL_FRect dst { spriteDst(i) };
+                SDL_RenderCopyExF(renderer.get(), textures[std::size_t(i % 4)].get(),
+                                  nullptr, &dst, double(i % 360), nullptr, SDL_FLIP_NONE);
+            }
+            return SDL_RenderFlush(renderer.get());
+        };
+        BENCHMARK("10000 rotated sprites, SpriteBatch") {
+            for (int i {}; i < SPRITE_CT; ++i) {
+                batch.drawEx(textures[std::size_t(i % 4)].get(), nullptr, spriteDst(i),
+                             double(i % 360), nullptr, SDL_FLIP_NONE);
+            }
+            batch.flush();
+            return SDL_RenderFlush(renderer.get());
+        };
+
+        // Catch2 reports time per frame; log draws/sec for comparison with
+        //   renderer backend profiles
+        static constexpr int FRAME_CT { 20 };
+        const auto start { std::chrono::steady_clock::now() };
+        for (int frame {}; frame < FRAME_CT; ++frame) {
+            for (int i {}; i < SPRITE_CT; ++i)
+                batch.draw(textures[std::size_t(i % 4)].get(), nullptr, spriteDst(i));
+            batch.flush();
+            SDL_RenderFlush(renderer.get());
+        }
+        const std::chrono::duration<double> elapsed { std::chrono::steady_clock::now() - start };
+        SDL_Log("SpriteBatch: %.0f draws/sec on software renderer",
+                double(SPRITE_CT * FRAME_CT) / elapsed.count());
+    }
+
+    SDL_Quit();
+}
@@ -0,0 +1,118 @@
+#include <catch2/catch_version_macros.hpp>               // CATCH_VERSION_MAJOR
+#if (CATCH_VERSION_MAJOR != 3)
+  #error "tests currently only support Catch2 v3.x"
+#endif
+#include <catch2/catch_test_macros.hpp>                  // TEST_CASE, SECTION, REQUIRE
+
+#include "streaming_texture.hh"
+
+#include <SDL.h>
+
+#include <cstring>    // memset
+#include <stdexcept>  // logic_error
+#include <string>
+#include <vector>
+
+
+static std::string collectErrorQuitSdl(const std::string& func_name) {
+    std::string err { SDL_GetError() };
+    SDL_ClearError();
+    if (err.size() == 0) {
+        err = "failure without setting SDL error";
+    }
+    SDL_Quit();
+    return func_name + ": " + err;
+}
+
+using namespace sdl2_render_util;
+
+TEST_CASE("SDL render streaming: StreamingTexture",
+    "[sdl2_render_util][SDL2][render][StreamingTexture]")
+{
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    SDL_Window* window {
+        SDL_CreateWindow("test_window", 0, 0, 1, 1, SDL_WINDOW_HIDDEN)
+    };
+    if (window == nullptr) {
+        FAIL(collectErrorQuitSdl("SDL_CreateWindow"));
+    }
+
+    SDL_Renderer* renderer {
+        SDL_CreateRenderer(window, -1, 0)
+    };
+    if (renderer == nullptr) {
+        SDL_DestroyWindow(window);
+        FAIL(collectErrorQuitSdl("SDL_CreateRenderer"));
+    }
+
+    constexpr int w { 16 };
+    constexpr int h { 8 };
+
+    SECTION("fewer than 2 slots")
+    {
+        REQUIRE_THROWS_AS(
+            StreamingTexture(renderer, SDL_PIXELFORMAT_RGBA32, w, h, 1),
+            std::invalid_argument);
+    }
+    SECTION("locked writes rotate through slots")
+    {
+        StreamingTexture stream { renderer, SDL_PIXELFORMAT_RGBA32, w, h, 3 };
+        REQUIRE(stream.current() == nullptr);
+
+        std::vector<SDL_Texture*> frames;
+        for (int i {}; i < 4; ++i) {
+            auto span { stream.beginWrite() };
+            REQUIRE(span.pixels != nullptr);
+            REQUIRE(span.pitch >= w * 4);
+            REQUIRE_THROWS_AS(stream.beginWrite(), std::logic_error);
+            for (int y {}; y < span.h; ++y)
+                std::memset(span.row(y), i, std::size_t(span.w) * 4);
+            stream.endWrite(span);
+            frames.push_back(stream.current());
+        }
+        REQUIRE(frames[0] != frames[1]);
+        REQUIRE(frames[1] != frames[2]);
+        REQUIRE(frames[0] == frames[3]);
+        REQUIRE(stream.stats().published == 4);
+        REQUIRE(stream.stats().dropped == 0);
+    }
+    SECTION("frames not retrieved are counted as dropped")
+    {
+        StreamingTexture stream { renderer, SDL_PIXELFORMAT_RGBA32, w, h, 2 };
+        std::vector<Uint8> pixels(std::size_t(w) * h * 4, 0xff);
+        stream.update(pixels.data(), w * 4);
+        stream.update(pixels.data(), w * 4);
+        stream.update(pixels.data(), w * 4);
+        REQUIRE(stream.current() != nullptr);
+        REQUIRE(stream.stats().published == 3);
+        REQUIRE(stream.stats().dropped == 2);
+    }
+    SECTION("planar YUV updates")
+    {
+        std::vector<Uint8> y_plane(std::size_t(w) * h, 0x80);
+        std::vector<Uint8> u_plane(std::size_t(w / 2) * (h / 2), 0x80);
+        std::vector<Uint8> v_plane(std::size_t(w / 2) * (h / 2), 0x80);
+        std::vector<Uint8> uv_plane(std::size_t(w) * (h / 2), 0x80);
+
+        SECTION("IYUV")
+        {
+            StreamingTexture stream { renderer, SDL_PIXELFORMAT_IYUV, w, h };
+            stream.updateYUV(y_plane.data(), w, u_plane.data(), w / 2,
+                             v_plane.data(), w / 2);
+            REQUIRE(stream.current() != nullptr);
+        }
+        SECTION("NV12")
+        {
+            StreamingTexture stream { renderer, SDL_PIXELFORMAT_NV12, w, h };
+            stream.updateNV(y_plane.data(), w, uv_plane.data(), w);
+            REQUIRE(stream.current() != nullptr);
+        }
+    }
+
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+}
@@ -0,0 +1,110 @@
+#include <catch2/catch_version_macros.hpp>               // CATCH_VERSION_MAJOR
+#if (CATCH_VERSION_MAJOR != 3)
+  #error "tests currently only support Catch2 v3.x"
+#endif
+#include <catch2/catch_test_macros.hpp>                  // TEST_CASE, SECTION, REQUIRE
+
+#include "texture_arena.hh"
+
+#include "sdl2_resource_accounting.hh"
+
+#include <SDL.h>
+
+#include <stdexcept>  // out_of_range
+#include <string>
+#include <utility>    // move
+#include <vector>
+
+
+static std::string collectErrorQuitSdl(const std::string& func_name) {
+    std::string err { SDL_GetError() };
+    SDL_ClearError();
+    if (err.size() == 0) {
+        err = "failure without setting SDL error";
+    }
+    SDL_Quit();
+    return func_name + ": " + err;
+}
+
+using namespace sdl2_render_util;
+using namespace sdl2_smart_ptr;
+
+TEST_CASE("SDL render texture ownership: TextureArena",
+    "[sdl2_render_util][SDL2][render][TextureArena]")
+{
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    SDL_Window* window {
+        SDL_CreateWindow("test_window", 0, 0, 1, 1, SDL_WINDOW_HIDDEN)
+    };
+    if (window == nullptr) {
+        FAIL(collectErrorQuitSdl("SDL_CreateWindow"));
+    }
+
+    auto renderer { make_unique(SDL_CreateRenderer(window, -1, 0)) };
+    if (renderer == nullptr) {
+        SDL_DestroyWindow(window);
+        FAIL(collectErrorQuitSdl("SDL_CreateRenderer"));
+    }
+
+    const ResourceStats before { resourceStats(ResourceType::Texture) };
+    {
+        TextureArena arena { std::move(renderer) };
+        REQUIRE(arena.renderer() != nullptr);
+
+        SECTION("handles resolve to live textures")
+        {
+            const TextureHandle a {
+                arena.create(SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, 4, 4) };
+            const TextureHandle b {
+                arena.create(SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, 4, 4) };
+            REQUIRE(a != b);
+            REQUIRE(arena.size() == 2);
+            REQUIRE(arena.get(a) != nullptr);
+            REQUIRE(arena.at(b) != arena.at(a));
+            REQUIRE_FALSE(arena.valid(TextureHandle{}));
+        }
+        SECTION("stale handles after slot reuse")
+        {
+            const TextureHandle a {
+                arena.create(SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, 4, 4) };
+            REQUIRE(arena.destroy(a));
+            REQUIRE_FALSE(arena.destroy(a));
+            const TextureHandle b {
+                arena.create(SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, 4, 4) };
+            // same slot, next generation
+            REQUIRE((b.value & slot_map::Texture::INDEX_MASK) ==
+                    (a.value & slot_map::Texture::INDEX_MASK));
+            REQUIRE_FALSE(arena.valid(a));
+            REQUIRE(arena.get(a) == nullptr);
+            REQUIRE_THROWS_AS(arena.at(a), std::out_of_range);
+            REQUIRE(arena.valid(b));
+        }
+        SECTION("adopted and surface textures, bulk clear")
+        {
+            auto surface { make_unique(
+                SDL_CreateRGBSurfaceWithFormat(0, 4, 4, 32, SDL_PIXELFORMAT_RGBA32)) };
+            REQUIRE(surface != nullptr);
+            std::vector<TextureHandle> handles;
+            for (int i {}; i < 100; ++i)
+                handles.push_back(arena.createFromSurface(surface.get()));
+            handles.push_back(arena.adopt(make_unique(
+                SDL_CreateTextureFromSurface(arena.renderer(), surface.get()))));
+            REQUIRE(arena.size() == 101);
+            arena.clear();
+            REQUIRE(arena.size() == 0);
+            bool any_valid {};
+            for (const auto& handle : handles)
+                any_valid = any_valid || arena.valid(handle);
+            REQUIRE_FALSE(any_valid);
+        }
+        // renderer destroys remaining textures with itself
+    }
+    // textures left to the renderer are accounted for with it
+    REQUIRE(resourceStats(ResourceType::Texture).live == before.live);
+
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+}
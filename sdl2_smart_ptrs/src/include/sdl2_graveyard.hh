@@ -0,0 +1,174 @@
+#ifndef SDL2_GRAVEYARD_HH
+#define SDL2_GRAVEYARD_HH
+
+#include "sdl2_resource_accounting.hh"  // detail::isAccounted detail::markAccounted
+#include "sdl2_smart_ptr.hh"  // deleter::Renderer deleter::Surface deleter::Texture
+
+#include <atomic>
+#include <chrono>             // microseconds
+#include <cstddef>            // size_t
+#include <cstdint>            // uint64_t
+#include <memory>             // unique_ptr shared_ptr
+
+namespace sdl2_smart_ptr {
+
+/*
+ * Queue of SDL allocations awaiting destruction, for resources that must be
+ *   destroyed on a particular thread (textures and renderers on the render
+ *   thread), or that are too slow to destroy in bulk mid-frame.
+ *
+ * bury() may be called from any thread, and is lock-free. It takes nodes from
+ *   a pool allocated by the constructor, so neither allocates nor throws while
+ *   fewer than capacity allocations are pending; past that it falls back to
+ *   nothrow new, and if even that fails the allocation is leaked, counted in
+ *   Stats::leaked, as deleters can not throw. drain() and
+ *   drainAll() must only be called from the owning thread, typically at the
+ *   end of each frame; drain() destroys in burial order until its time budget
+ *   is spent, always destroying at least one allocation so a backlog can not
+ *   stall. The destructor drains everything, so must also run on the owning
+ *   thread.
+ */
+class Graveyard {
+public:
+    using DestroyFunc = void (*)(void*);
+
+    struct Stats {
+        std::uint64_t buried {};
+        std::uint64_t destroyed {};
+        std::uint64_t drains {};
+        // drains that ended with allocations left over
+        std::uint64_t budget_exhausted {};
+        std::chrono::microseconds max_drain_time {};
+        // burials past capacity, given nodes from the heap
+        std::uint64_t overflowed {};
+        // burials past capacity that found no memory either
+        std::uint64_t leaked {};
+    };
+
+    static constexpr std::size_t DEFAULT_CAPACITY { 1024 };
+
+    explicit Graveyard(std::size_t capacity = DEFAULT_CAPACITY);
+    ~Graveyard();
+
+    Graveyard(const Graveyard&) = delete;
+    Graveyard& operator=(const Graveyard&) = delete;
+
+    // destroy must not be null
+    void bury(void* ptr, DestroyFunc destroy) noexcept;
+
+    // return count of allocations destroyed
+    std::size_t drain(std::chrono::microseconds budget);
+    std::size_t drainAll();
+
+    std::size_t pending() const { return pending_ct_.load(std::memory_order_relaxed); }
+    std::size_t capacity() const { return capacity_; }
+    // owning thread only
+    Stats stats() const;
+
+private:
+    struct Node {
+        void* ptr;
+        DestroyFunc destroy;
+        Node* next;
+        // pool index + 1 of next free node, 0 at end of free list
+        std::atomic<std::uint32_t> next_free;
+        bool pooled;
+    };
+
+    // nullptr if pool is empty
+    Node* takeFree() noexcept;
+    void giveFree(Node* node);
+    // moves newly buried nodes to end of owner's list, in burial order
+    void collectIncoming();
+    void destroyOldest();
+
+    const std::size_t capacity_;
+    std::unique_ptr<Node[]> pool_;
+    // pool index + 1 of first free node in low 32 bits, and a count of
+    //   changes in high 32 bits, so a node taken and returned meanwhile
+    //   fails the compare and exchange
+    std::atomic<std::uint64_t> free_head_ {};
+    // stack of nodes pushed by bury(), newest first
+    std::atomic<Node*> incoming_ {};
+    std::atomic<std::size_t> pending_ct_ {};
+    std::atomic<std::uint64_t> buried_ct_ {};
+    std::atomic<std::uint64_t> overflowed_ct_ {};
+    std::atomic<std::uint64_t> leaked_ct_ {};
+    // owning thread only, oldest first
+    Node* oldest_ {};
+    Node* newest_ {};
+    Stats stats_;
+};
+
+namespace deleter {
+
+/*
+ * Deleter policy that buries allocations in a Graveyard, to be destroyed
+ *   later by Deleter on the graveyard's owning thread. With no graveyard,
+ *   destroys immediately.
+ */
+template<typename Deleter>
+struct Deferred {
+    template<typename T>
+    void operator()(T* ptr) const noexcept {
+        if (ptr == nullptr)
+            return;
+        if (graveyard == nullptr)
+            detail::markAccounted(Deleter{}, detail::isAccounted(*this))(ptr);
+        else if (detail::isAccounted(*this))
+            graveyard->bury(ptr, &destroyAccounted<T>);
+        else
+            graveyard->bury(ptr, &destroy<T>);
+    }
+
+    template<typename T>
+    static void destroy(void* ptr) { Deleter{}(static_cast<T*>(ptr)); }
+
+    template<typename T>
+    static void destroyAccounted(void* ptr) {
+        detail::markAccounted(Deleter{})(static_cast<T*>(ptr));
+    }
+
+    Graveyard* graveyard {};
+#ifdef SDL2_SMART_PTRS_ACCOUNT_RESOURCES
+    // carried over from Deleter by make_deferred/make_deferred_shared
+    bool accounted {};
+#endif
+};
+
+}  // namespace deleter
+
+namespace deferred {
+
+template<typename T, typename Deleter>
+using Ptr = std::unique_ptr<T, deleter::Deferred<Deleter>>;
+
+using Renderer = Ptr<SDL_Renderer, deleter::Renderer>;
+using Surface  = Ptr<SDL_Surface,  deleter::Surface>;
+using Texture  = Ptr<SDL_Texture,  deleter::Texture>;
+
+}  // namespace deferred
+
+// takes ownership from a unique:: handle, eg make_deferred(make_unique(tp), g)
+template<typename T, typename Deleter>
+deferred::Ptr<T, Deleter> make_deferred(std::unique_ptr<T, Deleter> up,
+                                        Graveyard& graveyard) {
+    const bool accounted { detail::isAccounted(up.get_deleter()) };
+    return deferred::Ptr<T, Deleter>{
+        up.release(),
+        detail::markAccounted(deleter::Deferred<Deleter>{ &graveyard }, accounted) };
+}
+
+template<typename T, typename Deleter>
+std::shared_ptr<T> make_deferred_shared(std::unique_ptr<T, Deleter> up,
+                                        Graveyard& graveyard) {
+    const bool accounted { detail::isAccounted(up.get_deleter()) };
+    return std::shared_ptr<T>{
+        up.release(),
+        detail::markAccounted(deleter::Deferred<Deleter>{ &graveyard }, accounted) };
+}
+
+}  // namespace sdl2_smart_ptr
+
+
+#endif  // SDL2_GRAVEYARD_HH
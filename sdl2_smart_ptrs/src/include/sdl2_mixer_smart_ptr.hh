@@ -1,6 +1,9 @@
 #ifndef SDL2_MIXER_SMART_PTR_HH
 #define SDL2_MIXER_SMART_PTR_HH
 
+#include "sdl2_graveyard.hh"  // deferred::Ptr
+#include "sdl2_resource_accounting.hh"  // deleter::Accounted detail::ResourceTraits
+
 #include "SDL_mixer.h"     // Mix_Chunk, Mix_Music
 
 #include <memory>
@@ -9,16 +12,27 @@ namespace sdl2_smart_ptr {
 
 namespace deleter {
 
-struct MixChunk {
+struct MixChunk : Accounted {
     void operator()(Mix_Chunk*) const;
 };
 
-struct MixMusic {
+struct MixMusic : Accounted {
     void operator()(Mix_Music*) const;
 };
 
 }  // namespace deleter
 
+namespace detail {
+
+template<> struct ResourceTraits<Mix_Music> : Unsized<ResourceType::MixMusic> {};
+
+template<> struct ResourceTraits<Mix_Chunk> {
+    static constexpr ResourceType TYPE { ResourceType::MixChunk };
+    static std::size_t bytes(const Mix_Chunk*);
+};
+
+}  // namespace detail
+
 namespace unique {
 
 using MixChunk = std::unique_ptr<Mix_Chunk, deleter::MixChunk>;
@@ -40,6 +54,24 @@ using MixMusic = std::weak_ptr<Mix_Music>;
 
 }  // namespace weak
 
+// defined in sdl2_slot_map.hh
+template<typename T, typename Deleter>
+class SlotMap;
+
+namespace slot_map {
+
+using MixChunk = SlotMap<Mix_Chunk, deleter::MixChunk>;
+using MixMusic = SlotMap<Mix_Music, deleter::MixMusic>;
+
+}  // namespace slot_map
+
+namespace deferred {
+
+using MixChunk = Ptr<Mix_Chunk, deleter::MixChunk>;
+using MixMusic = Ptr<Mix_Music, deleter::MixMusic>;
+
+}  // namespace deferred
+
 unique::MixChunk make_unique(Mix_Chunk*);
 unique::MixMusic make_unique(Mix_Music*);
 
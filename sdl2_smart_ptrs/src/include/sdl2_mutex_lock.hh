@@ -0,0 +1,69 @@
+#ifndef SDL2_MUTEX_LOCK_HH
+#define SDL2_MUTEX_LOCK_HH
+
+#include "sdl2_mutex_profile.hh"  // unique::ProfiledMutex MutexProfile
+#include "sdl2_smart_ptr.hh"      // unique::Mutex shared::Mutex
+
+#include "SDL_mutex.h"            // SDL_mutex SDL_cond
+#include "SDL_stdinc.h"           // Uint32 Uint64
+
+namespace sdl2_smart_ptr {
+
+/*
+ * Scoped lock of an SDL_mutex, unlocked on destruction, in the manner of
+ *   std::unique_lock. Locking from a shared::Mutex also holds a reference to
+ *   it, so the mutex outlives the lock.
+ *
+ * When built with SDL2_SMART_PTRS_PROFILE_MUTEXES, locks of profiled mutexes
+ *   try SDL_TryLockMutex first, timing the blocking SDL_LockMutex only when
+ *   that fails, and record wait and hold times in the mutex's MutexProfile.
+ *
+ * SDL_LockMutex, SDL_UnlockMutex and SDL_CondWait failures are thrown as
+ *   std::runtime_error.
+ */
+class MutexLock {
+public:
+    struct TryToLock {};
+    static constexpr TryToLock TRY_TO_LOCK {};
+
+    explicit MutexLock(SDL_mutex* mutex);
+    explicit MutexLock(const unique::Mutex& mutex);
+    explicit MutexLock(const shared::Mutex& mutex);
+#ifdef SDL2_SMART_PTRS_PROFILE_MUTEXES
+    // otherwise same type as unique::Mutex
+    explicit MutexLock(const unique::ProfiledMutex& mutex);
+#endif
+    // uses SDL_TryLockMutex, check ownsLock() for result
+    MutexLock(SDL_mutex* mutex, TryToLock);
+
+    MutexLock(const MutexLock&) = delete;
+    MutexLock& operator=(const MutexLock&) = delete;
+
+    ~MutexLock();
+
+    void lock();
+    void unlock();
+    bool ownsLock() const { return owns_lock_; }
+    SDL_mutex* mutex() const { return mutex_; }
+
+    // lock must be owned; spurious wakeups are possible, as with SDL_CondWait
+    void wait(SDL_cond* cond);
+    // returns false on timeout
+    bool waitTimeout(SDL_cond* cond, Uint32 timeout_ms);
+
+private:
+    SDL_mutex* mutex_;
+    shared::Mutex keep_alive_;
+    bool owns_lock_ {};
+#ifdef SDL2_SMART_PTRS_PROFILE_MUTEXES
+    void recordHold();
+
+    MutexProfile* profile_ {};
+    Uint64 hold_start_ {};
+#endif
+};
+
+}  // namespace sdl2_smart_ptr
+
+
+#endif  // SDL2_MUTEX_LOCK_HH
@@ -0,0 +1,105 @@
+#ifndef SDL2_MUTEX_PROFILE_HH
+#define SDL2_MUTEX_PROFILE_HH
+
+#include "sdl2_smart_ptr.hh"  // unique::Mutex shared::Mutex make_unique make_shared
+
+#include "SDL_mutex.h"        // SDL_mutex
+#include "SDL_stdinc.h"       // Uint64
+
+#include <atomic>
+#include <cstdint>            // uint64_t
+#include <string>
+#include <vector>
+
+namespace sdl2_smart_ptr {
+
+/*
+ * Contention counters shared by all profiled mutexes created with the same
+ *   name, updated by MutexLock. Times are in SDL_GetPerformanceCounter ticks.
+ */
+struct MutexProfile {
+    explicit MutexProfile(const std::string& profile_name) : name(profile_name) {}
+
+    void recordAcquisition(Uint64 wait_ticks, bool contended);
+    void recordHold(Uint64 hold_ticks);
+
+    const std::string name;
+    std::atomic<std::uint64_t> acquisitions {};
+    std::atomic<std::uint64_t> contended_acquisitions {};
+    std::atomic<std::uint64_t> total_wait_ticks {};
+    std::atomic<std::uint64_t> max_wait_ticks {};
+    std::atomic<std::uint64_t> total_hold_ticks {};
+};
+
+struct MutexProfileSnapshot {
+    std::string name;
+    std::uint64_t acquisitions {};
+    std::uint64_t contended_acquisitions {};
+    double total_wait_ms {};
+    double max_wait_ms {};
+    double total_hold_ms {};
+};
+
+/*
+ * Profiled mutexes are opt-in: building with SDL2_SMART_PTRS_PROFILE_MUTEXES
+ *   defined (CMake option of the same name) gives unique::ProfiledMutex a
+ *   deleter that points to the MutexProfile for its name, which MutexLock
+ *   uses to time each lock. Otherwise unique::ProfiledMutex is unique::Mutex,
+ *   the make_profiled_* functions forward to make_unique/make_shared, and no
+ *   profiles are registered.
+ */
+#ifdef SDL2_SMART_PTRS_PROFILE_MUTEXES
+
+namespace deleter {
+
+struct ProfiledMutex {
+    void operator()(SDL_mutex*) const;
+
+    MutexProfile* profile {};
+};
+
+}  // namespace deleter
+
+namespace unique {
+
+using ProfiledMutex = std::unique_ptr<SDL_mutex, deleter::ProfiledMutex>;
+
+}  // namespace unique
+
+unique::ProfiledMutex make_profiled_unique(SDL_mutex*, const std::string& name);
+shared::Mutex         make_profiled_shared(SDL_mutex*, const std::string& name);
+
+// nullptr if mutex was not made by make_profiled_shared
+MutexProfile* mutexProfile(const shared::Mutex& mutex);
+
+#else
+
+namespace unique {
+
+using ProfiledMutex = Mutex;
+
+}  // namespace unique
+
+inline unique::ProfiledMutex make_profiled_unique(SDL_mutex* mp, const std::string&) {
+    return make_unique(mp);
+}
+
+inline shared::Mutex make_profiled_shared(SDL_mutex* mp, const std::string&) {
+    return make_shared(mp);
+}
+
+#endif  // SDL2_SMART_PTRS_PROFILE_MUTEXES
+
+// global registry, profiles live until program exit
+MutexProfile& registerMutexProfile(const std::string& name);
+// sorted by total wait time, longest first
+std::vector<MutexProfileSnapshot> mutexProfiles();
+// one line per profile, as sorted by mutexProfiles()
+std::string mutexContentionReport();
+// zeroes counters of all profiles
+void resetMutexProfiles();
+
+}  // namespace sdl2_smart_ptr
+
+
+#endif  // SDL2_MUTEX_PROFILE_HH
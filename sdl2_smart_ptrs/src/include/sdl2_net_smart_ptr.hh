@@ -1,6 +1,8 @@
 #ifndef SDL2_NET_SMART_PTR_HH
 #define SDL2_NET_SMART_PTR_HH
 
+#include "sdl2_resource_accounting.hh"  // deleter::Accounted detail::ResourceTraits
+
 #include "SDL_net.h"     // _SDLNet_SocketSet _TCPsocket UDPpacket
 
 #include <memory>
@@ -16,51 +18,91 @@ namespace deleter {
  *   so using hidden types for consistent syntax with STL smart pointer templates.
  */
 
-struct SocketSet {
+struct SocketSet : Accounted {
     void operator()(_SDLNet_SocketSet*) const;
 };
 
-struct TcpSocket {
+struct TcpSocket : Accounted {
     void operator()(_TCPsocket*) const;
 };
 
-struct UdpPacket {
+struct UdpPacket : Accounted {
     void operator()(UDPpacket*) const;
 };
 
+// packet vectors are NULL-terminated arrays from SDLNet_AllocPacketV
+struct UdpPacketVector : Accounted {
+    void operator()(UDPpacket**) const;
+};
+
 }  // namespace deleter
 
+namespace detail {
+
+template<> struct ResourceTraits<_SDLNet_SocketSet> : Unsized<ResourceType::SocketSet> {};
+template<> struct ResourceTraits<_TCPsocket>        : Unsized<ResourceType::TcpSocket> {};
+
+template<> struct ResourceTraits<UDPpacket> {
+    static constexpr ResourceType TYPE { ResourceType::UdpPacket };
+    static std::size_t bytes(const UDPpacket*);
+};
+
+// packet vectors
+template<> struct ResourceTraits<UDPpacket*> {
+    static constexpr ResourceType TYPE { ResourceType::UdpPacketVector };
+    static std::size_t bytes(UDPpacket* const*);
+};
+
+}  // namespace detail
+
 namespace unique {
 
-using SocketSet = std::unique_ptr<_SDLNet_SocketSet, deleter::SocketSet>;
-using TcpSocket = std::unique_ptr<_TCPsocket,        deleter::TcpSocket>;
-using UdpPacket = std::unique_ptr<UDPpacket,         deleter::UdpPacket>;
+using SocketSet       = std::unique_ptr<_SDLNet_SocketSet, deleter::SocketSet>;
+using TcpSocket       = std::unique_ptr<_TCPsocket,        deleter::TcpSocket>;
+using UdpPacket       = std::unique_ptr<UDPpacket,         deleter::UdpPacket>;
+using UdpPacketVector = std::unique_ptr<UDPpacket*[],      deleter::UdpPacketVector>;
 
 }  // namespace unique
 
 namespace shared {
 
-using SocketSet = std::shared_ptr<_SDLNet_SocketSet>;
-using TcpSocket = std::shared_ptr<_TCPsocket>;
-using UdpPacket = std::shared_ptr<UDPpacket>;
+using SocketSet       = std::shared_ptr<_SDLNet_SocketSet>;
+using TcpSocket       = std::shared_ptr<_TCPsocket>;
+using UdpPacket       = std::shared_ptr<UDPpacket>;
+using UdpPacketVector = std::shared_ptr<UDPpacket*[]>;
 
 }  // namespace shared
 
 namespace weak {
 
-using SocketSet = std::weak_ptr<_SDLNet_SocketSet>;
-using TcpSocket = std::weak_ptr<_TCPsocket>;
-using UdpPacket = std::weak_ptr<UDPpacket>;
+using SocketSet       = std::weak_ptr<_SDLNet_SocketSet>;
+using TcpSocket       = std::weak_ptr<_TCPsocket>;
+using UdpPacket       = std::weak_ptr<UDPpacket>;
+using UdpPacketVector = std::weak_ptr<UDPpacket*[]>;
 
 }  // namespace weak
 
-unique::SocketSet make_unique(_SDLNet_SocketSet*);
-unique::TcpSocket make_unique(_TCPsocket*);
-unique::UdpPacket make_unique(UDPpacket*);
+// defined in sdl2_slot_map.hh
+template<typename T, typename Deleter>
+class SlotMap;
+
+namespace slot_map {
+
+using SocketSet = SlotMap<_SDLNet_SocketSet, deleter::SocketSet>;
+using TcpSocket = SlotMap<_TCPsocket,        deleter::TcpSocket>;
+using UdpPacket = SlotMap<UDPpacket,         deleter::UdpPacket>;
+
+}  // namespace slot_map
+
+unique::SocketSet       make_unique(_SDLNet_SocketSet*);
+unique::TcpSocket       make_unique(_TCPsocket*);
+unique::UdpPacket       make_unique(UDPpacket*);
+unique::UdpPacketVector make_unique(UDPpacket**);
 
-shared::SocketSet make_shared(_SDLNet_SocketSet*);
-shared::TcpSocket make_shared(_TCPsocket*);
-shared::UdpPacket make_shared(UDPpacket*);
+shared::SocketSet       make_shared(_SDLNet_SocketSet*);
+shared::TcpSocket       make_shared(_TCPsocket*);
+shared::UdpPacket       make_shared(UDPpacket*);
+shared::UdpPacketVector make_shared(UDPpacket**);
 
 }  // namespace sdl2_smart_ptr
 
@@ -0,0 +1,157 @@
+#ifndef SDL2_RESOURCE_ACCOUNTING_HH
+#define SDL2_RESOURCE_ACCOUNTING_HH
+
+#include <cstddef>      // size_t
+#include <cstdint>      // int64_t
+#include <string>
+#include <type_traits>  // false_type true_type void_t
+#include <utility>      // declval
+#include <vector>
+
+namespace sdl2_smart_ptr {
+
+enum class ResourceType {
+    Cursor,
+    CondVar,
+    Mutex,
+    Renderer,
+    Semaphore,
+    Surface,
+    Texture,
+    Thread,
+    Window,
+    MixChunk,
+    MixMusic,
+    SocketSet,
+    TcpSocket,
+    UdpPacket,
+    UdpPacketVector,
+    TtfFont,
+    RtfContext
+};
+
+constexpr std::size_t RESOURCE_TYPE_CT { std::size_t(ResourceType::RtfContext) + 1 };
+
+const char* resourceTypeName(ResourceType type);
+
+/*
+ * Live resource accounting is opt-in: building with
+ *   SDL2_SMART_PTRS_ACCOUNT_RESOURCES defined (CMake option of the same name)
+ *   gives every deleter:: struct a flag, set only by make_unique/make_shared
+ *   (and adopting containers like SlotMap), so that exactly the allocations
+ *   counted at creation are counted again at destruction. Otherwise deleters
+ *   stay empty, nothing is recorded and all queries return zeros.
+ *
+ * Counters are written only by their own thread, so recording costs a few
+ *   uncontended stores; queries sum all threads' counters. For the same
+ *   reason peaks are sampled rather than exact: every 64 creations per
+ *   thread, on every query, and by sampleResourcePeaks(), eg once per frame.
+ *
+ * Bytes are estimates of pixel/sample data: surface pitch * h, texture
+ *   w * h * bytes per pixel, chunk alen, packet maxlen; other types count 0.
+ */
+#ifdef SDL2_SMART_PTRS_ACCOUNT_RESOURCES
+constexpr bool RESOURCE_ACCOUNTING { true };
+#else
+constexpr bool RESOURCE_ACCOUNTING { false };
+#endif
+
+struct ResourceStats {
+    ResourceType type {};
+    std::int64_t live {};
+    std::int64_t peak_live {};
+    std::int64_t bytes {};
+    std::int64_t peak_bytes {};
+    std::int64_t created {};
+    std::int64_t destroyed {};
+};
+
+ResourceStats resourceStats(ResourceType type);
+// all types, in ResourceType order
+std::vector<ResourceStats> resourceStats();
+// one line per type created at least once
+std::string resourceReport();
+// one line per type with live allocations; logged at exit when not empty
+std::string resourceLeakReport();
+void sampleResourcePeaks();
+// lowers peaks to current values
+void resetResourcePeaks();
+
+// used by accounted deleters; no-ops unless accounting
+void recordCreation(ResourceType type, std::size_t bytes);
+// count > 1 for allocations freed together, eg by their owner
+void recordDestruction(ResourceType type, std::size_t bytes, std::size_t count = 1);
+
+namespace deleter {
+
+// base of all deleters of SDL allocations
+struct Accounted {
+#ifdef SDL2_SMART_PTRS_ACCOUNT_RESOURCES
+    bool accounted {};
+#endif
+};
+
+}  // namespace deleter
+
+namespace detail {
+
+// specialized next to each deleter, with TYPE and bytes(T*)
+template<typename T>
+struct ResourceTraits;
+
+template<ResourceType R>
+struct Unsized {
+    static constexpr ResourceType TYPE { R };
+    static std::size_t bytes(const void*) { return 0; }
+};
+
+template<typename Deleter, typename = void>
+struct HasAccountedFlag : std::false_type {};
+
+template<typename Deleter>
+struct HasAccountedFlag<Deleter, std::void_t<decltype(std::declval<Deleter&>().accounted)>> :
+    std::true_type {};
+
+template<typename Deleter>
+bool isAccounted([[maybe_unused]] const Deleter& dltr) {
+    if constexpr (HasAccountedFlag<Deleter>::value)
+        return dltr.accounted;
+    else
+        return false;
+}
+
+template<typename Deleter>
+Deleter markAccounted(Deleter dltr, [[maybe_unused]] bool accounted = true) {
+    if constexpr (HasAccountedFlag<Deleter>::value)
+        dltr.accounted = accounted;
+    return dltr;
+}
+
+// counts ptr as created, returning a Deleter that counts its destruction
+template<typename Deleter, typename T>
+Deleter accountCreation([[maybe_unused]] T* ptr) {
+    Deleter dltr {};
+    if constexpr (HasAccountedFlag<Deleter>::value) {
+        if (ptr != nullptr) {
+            recordCreation(ResourceTraits<T>::TYPE, ResourceTraits<T>::bytes(ptr));
+            dltr.accounted = true;
+        }
+    }
+    return dltr;
+}
+
+// call before destroying ptr
+template<typename Deleter, typename T>
+void accountDestruction([[maybe_unused]] const Deleter& dltr, [[maybe_unused]] T* ptr) {
+    if constexpr (HasAccountedFlag<Deleter>::value) {
+        if (dltr.accounted)
+            recordDestruction(ResourceTraits<T>::TYPE, ResourceTraits<T>::bytes(ptr));
+    }
+}
+
+}  // namespace detail
+
+}  // namespace sdl2_smart_ptr
+
+
+#endif  // SDL2_RESOURCE_ACCOUNTING_HH
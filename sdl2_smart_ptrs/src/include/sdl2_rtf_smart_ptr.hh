@@ -1,6 +1,8 @@
 #ifndef SDL2_RTF_SMART_PTR_HH
 #define SDL2_RTF_SMART_PTR_HH
 
+#include "sdl2_resource_accounting.hh"  // deleter::Accounted detail::ResourceTraits
+
 #include "SDL_rtf.h"     // RTF_Context
 
 #include <memory>
@@ -10,12 +12,18 @@ namespace sdl2_smart_ptr {
 
 namespace deleter {
 
-struct RtfContext {
+struct RtfContext : Accounted {
     void operator()(RTF_Context*) const;
 };
 
 }  // namespace deleter
 
+namespace detail {
+
+template<> struct ResourceTraits<RTF_Context> : Unsized<ResourceType::RtfContext> {};
+
+}  // namespace detail
+
 namespace unique {
 
 using RtfContext = std::unique_ptr<RTF_Context, deleter::RtfContext>;
@@ -34,6 +42,16 @@ using RtfContext = std::weak_ptr<RTF_Context>;
 
 }  // namespace weak
 
+// defined in sdl2_slot_map.hh
+template<typename T, typename Deleter>
+class SlotMap;
+
+namespace slot_map {
+
+using RtfContext = SlotMap<RTF_Context, deleter::RtfContext>;
+
+}  // namespace slot_map
+
 unique::RtfContext make_unique(RTF_Context*);
 
 shared::RtfContext make_shared(RTF_Context*);
@@ -0,0 +1,241 @@
+#ifndef SDL2_SLOT_MAP_HH
+#define SDL2_SLOT_MAP_HH
+
+#include "sdl2_resource_accounting.hh"  // detail::accountCreation detail::markAccounted recordDestruction
+#include "sdl2_smart_ptr.hh"  // deleter::
+
+#include "SDL_stdinc.h"       // Uint16 Uint32
+
+#include <cstddef>            // size_t
+#include <memory>             // unique_ptr
+#include <stdexcept>          // invalid_argument length_error
+#include <utility>            // move
+#include <vector>
+
+namespace sdl2_smart_ptr {
+
+// 32 bit handle to an element of a SlotMap<T, ...>, with index in the low
+//   bits and generation in the high bits; 0 is never a valid handle
+template<typename T>
+struct SlotHandle {
+    Uint32 value {};
+
+    explicit operator bool() const { return value != 0; }
+    bool operator==(const SlotHandle& other) const { return value == other.value; }
+    bool operator!=(const SlotHandle& other) const { return value != other.value; }
+};
+
+/*
+ * Owning registry of SDL allocations addressed by SlotHandles. Raw pointers
+ *   are stored contiguously in insertion order (until removals swap the last
+ *   element into the gap), so iterating over all elements reads one array
+ *   rather than following each shared_ptr to its control block.
+ *
+ * Releasing an element runs Deleter on it and bumps its slot's generation,
+ *   so remaining handles to it no longer resolve, in O(1). A slot whose
+ *   generation would wrap is retired instead of reused.
+ *
+ * Not thread-safe.
+ */
+template<typename T, typename Deleter>
+class SlotMap {
+public:
+    using Handle = SlotHandle<T>;
+
+    static constexpr unsigned INDEX_BITS { 20 };
+    static constexpr Uint32 MAX_SLOTS { Uint32(1) << INDEX_BITS };
+    static constexpr Uint32 INDEX_MASK { MAX_SLOTS - 1 };
+    static constexpr Uint32 MAX_GENERATION { (Uint32(1) << (32 - INDEX_BITS)) - 1 };
+
+    // elements are counted by resource accounting while owned, see
+    //   sdl2_resource_accounting.hh
+    explicit SlotMap(Deleter deleter = Deleter{}) :
+        deleter_(detail::markAccounted(std::move(deleter))) {}
+    ~SlotMap() { clear(); }
+
+    SlotMap(const SlotMap&) = delete;
+    SlotMap& operator=(const SlotMap&) = delete;
+
+    // takes ownership; throws std::invalid_argument on nullptr
+    Handle insert(T* ptr) {
+        if (ptr == nullptr)
+            throw std::invalid_argument("SlotMap: cannot insert nullptr");
+        detail::accountCreation<Deleter>(ptr);
+        return adopt(ptr);
+    }
+
+    Handle insert(std::unique_ptr<T, Deleter> up) {
+        if (up == nullptr)
+            throw std::invalid_argument("SlotMap: cannot insert nullptr");
+        if (!detail::isAccounted(up.get_deleter()))
+            detail::accountCreation<Deleter>(up.get());
+        return adopt(up.release());
+    }
+
+    bool contains(Handle handle) const { return slotOf(handle) != nullptr; }
+
+    // nullptr for stale handles
+    T* get(Handle handle) const {
+        const Slot* slot { slotOf(handle) };
+        return slot == nullptr ? nullptr : dense_[slot->dense_or_next];
+    }
+
+    // runs deleter; returns false for stale handles
+    bool release(Handle handle) {
+        T* ptr { remove(handle) };
+        if (ptr == nullptr)
+            return false;
+        deleter_(ptr);
+        return true;
+    }
+
+    // removes without running deleter; nullptr for stale handles
+    std::unique_ptr<T, Deleter> extract(Handle handle) {
+        return std::unique_ptr<T, Deleter>{ remove(handle), deleter_ };
+    }
+
+    void clear() {
+        for (T* ptr : dense_)
+            deleter_(ptr);
+        forgetAll();
+    }
+
+    // removes all elements without running deleter, for when something else
+    //   frees them at once, like SDL_DestroyRenderer does its textures;
+    //   accounting is settled in one update
+    void abandon() {
+        if constexpr (ACCOUNTED) {
+            if (!dense_.empty())
+                recordDestruction(detail::ResourceTraits<T>::TYPE, bytes_, dense_.size());
+        }
+        forgetAll();
+    }
+
+    void reserve(std::size_t capacity) {
+        slots_.reserve(capacity);
+        dense_.reserve(capacity);
+        dense_slots_.reserve(capacity);
+    }
+
+    std::size_t size() const { return dense_.size(); }
+    bool empty() const { return dense_.empty(); }
+
+    // dense iteration over raw pointers, in no particular order
+    auto begin() const { return dense_.cbegin(); }
+    auto end() const { return dense_.cend(); }
+    // handle of element at position i of dense iteration
+    Handle handleAt(std::size_t i) const {
+        const Uint32 index { dense_slots_[i] };
+        return Handle{ (Uint32(slots_[index].generation) << INDEX_BITS) | index };
+    }
+
+private:
+    static constexpr Uint32 NO_SLOT { ~Uint32(0) };
+    static constexpr bool ACCOUNTED { detail::HasAccountedFlag<Deleter>::value };
+
+    void forgetAll() {
+        for (const Uint32 index : dense_slots_)
+            freeSlot(index);
+        dense_.clear();
+        dense_slots_.clear();
+        bytes_ = 0;
+    }
+
+    Handle adopt(T* ptr) {
+        Uint32 index { free_head_ };
+        if (index != NO_SLOT) {
+            free_head_ = slots_[index].dense_or_next;
+        } else {
+            if (slots_.size() == MAX_SLOTS) {
+                deleter_(ptr);
+                throw std::length_error("SlotMap: slots exhausted");
+            }
+            index = Uint32(slots_.size());
+            slots_.push_back(Slot{});
+        }
+        Slot& slot { slots_[index] };
+        slot.dense_or_next = Uint32(dense_.size());
+        slot.live = true;
+        if constexpr (ACCOUNTED)
+            bytes_ += detail::ResourceTraits<T>::bytes(ptr);
+        dense_.push_back(ptr);
+        dense_slots_.push_back(index);
+        return Handle{ (Uint32(slot.generation) << INDEX_BITS) | index };
+    }
+
+    struct Slot {
+        // position in dense_ while live, next free slot otherwise
+        Uint32 dense_or_next {};
+        Uint16 generation { 1 };
+        bool live {};
+    };
+
+    const Slot* slotOf(Handle handle) const {
+        const Uint32 index { handle.value & INDEX_MASK };
+        if (index >= slots_.size())
+            return nullptr;
+        const Slot& slot { slots_[index] };
+        if (!slot.live || Uint32(slot.generation) != (handle.value >> INDEX_BITS))
+            return nullptr;
+        return &slot;
+    }
+
+    T* remove(Handle handle) {
+        const Slot* slot { slotOf(handle) };
+        if (slot == nullptr)
+            return nullptr;
+        const Uint32 dense_index { slot->dense_or_next };
+        T* ptr { dense_[dense_index] };
+        if constexpr (ACCOUNTED)
+            bytes_ -= detail::ResourceTraits<T>::bytes(ptr);
+        // swap last element into gap
+        const std::size_t last { dense_.size() - 1 };
+        if (dense_index != last) {
+            dense_[dense_index] = dense_[last];
+            dense_slots_[dense_index] = dense_slots_[last];
+            slots_[dense_slots_[dense_index]].dense_or_next = dense_index;
+        }
+        dense_.pop_back();
+        dense_slots_.pop_back();
+        freeSlot(handle.value & INDEX_MASK);
+        return ptr;
+    }
+
+    void freeSlot(Uint32 index) {
+        Slot& slot { slots_[index] };
+        slot.live = false;
+        if (slot.generation == MAX_GENERATION)
+            return;  // retired
+        ++slot.generation;
+        slot.dense_or_next = free_head_;
+        free_head_ = index;
+    }
+
+    std::vector<Slot> slots_;
+    std::vector<T*> dense_;
+    // slot index of each element of dense_
+    std::vector<Uint32> dense_slots_;
+    Uint32 free_head_ { NO_SLOT };
+    // of all elements while accounting, see abandon()
+    std::size_t bytes_ {};
+    Deleter deleter_;
+};
+
+namespace slot_map {
+
+using Cursor    = SlotMap<SDL_Cursor,   deleter::Cursor>;
+using CondVar   = SlotMap<SDL_cond,     deleter::CondVar>;
+using Mutex     = SlotMap<SDL_mutex,    deleter::Mutex>;
+using Renderer  = SlotMap<SDL_Renderer, deleter::Renderer>;
+using Semaphore = SlotMap<SDL_sem,      deleter::Semaphore>;
+using Surface   = SlotMap<SDL_Surface,  deleter::Surface>;
+using Texture   = SlotMap<SDL_Texture,  deleter::Texture>;
+using Thread    = SlotMap<SDL_Thread,   deleter::Thread>;
+using Window    = SlotMap<SDL_Window,   deleter::Window>;
+
+}  // namespace slot_map
+
+}  // namespace sdl2_smart_ptr
+
+
+#endif  // SDL2_SLOT_MAP_HH
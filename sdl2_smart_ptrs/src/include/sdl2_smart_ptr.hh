@@ -1,10 +1,13 @@
 #ifndef SDL2_SMART_PTR_HH
 #define SDL2_SMART_PTR_HH
 
+#include "sdl2_resource_accounting.hh"  // deleter::Accounted detail::ResourceTraits
+
 #include "SDL_mouse.h"     // SDL_Cursor
 #include "SDL_mutex.h"     // SDL_cond SDL_mutex SDL_sem
 #include "SDL_render.h"    // SDL_Renderer SDL_Texture
 #include "SDL_surface.h"
+#include "SDL_thread.h"    // SDL_Thread
 #include "SDL_video.h"     // SDL_Window
 
 #include <memory>
@@ -13,40 +16,68 @@ namespace sdl2_smart_ptr {
 
 namespace deleter {
 
-struct Cursor {
+struct Cursor : Accounted {
     void operator()(SDL_Cursor*) const;
 };
 
-struct CondVar {
+struct CondVar : Accounted {
     void operator()(SDL_cond*) const;
 };
 
-struct Mutex {
+struct Mutex : Accounted {
     void operator()(SDL_mutex*) const;
 };
 
-struct Renderer {
+struct Renderer : Accounted {
     void operator()(SDL_Renderer*) const;
 };
 
-struct Semaphore {
+struct Semaphore : Accounted {
     void operator()(SDL_sem*) const;
 };
 
-struct Surface {
+struct Surface : Accounted {
     void operator()(SDL_Surface*) const;
 };
 
-struct Texture {
+struct Texture : Accounted {
     void operator()(SDL_Texture*) const;
 };
 
-struct Window {
+// joins thread with SDL_WaitThread, discarding its return value; threads
+//   meant to outlive their handle should be released and SDL_DetachThread-ed
+struct Thread : Accounted {
+    void operator()(SDL_Thread*) const;
+};
+
+struct Window : Accounted {
     void operator()(SDL_Window*) const;
 };
 
 }  // namespace deleter
 
+namespace detail {
+
+template<> struct ResourceTraits<SDL_Cursor>   : Unsized<ResourceType::Cursor> {};
+template<> struct ResourceTraits<SDL_cond>     : Unsized<ResourceType::CondVar> {};
+template<> struct ResourceTraits<SDL_mutex>    : Unsized<ResourceType::Mutex> {};
+template<> struct ResourceTraits<SDL_Renderer> : Unsized<ResourceType::Renderer> {};
+template<> struct ResourceTraits<SDL_sem>      : Unsized<ResourceType::Semaphore> {};
+template<> struct ResourceTraits<SDL_Thread>   : Unsized<ResourceType::Thread> {};
+template<> struct ResourceTraits<SDL_Window>   : Unsized<ResourceType::Window> {};
+
+template<> struct ResourceTraits<SDL_Surface> {
+    static constexpr ResourceType TYPE { ResourceType::Surface };
+    static std::size_t bytes(const SDL_Surface*);
+};
+
+template<> struct ResourceTraits<SDL_Texture> {
+    static constexpr ResourceType TYPE { ResourceType::Texture };
+    static std::size_t bytes(SDL_Texture*);
+};
+
+}  // namespace detail
+
 namespace unique {
 
 using Cursor       = std::unique_ptr<SDL_Cursor,   deleter::Cursor>;
@@ -56,6 +87,7 @@ using Renderer     = std::unique_ptr<SDL_Renderer, deleter::Renderer>;
 using Semaphore    = std::unique_ptr<SDL_sem,      deleter::Semaphore>;
 using Surface      = std::unique_ptr<SDL_Surface,  deleter::Surface>;
 using Texture      = std::unique_ptr<SDL_Texture,  deleter::Texture>;
+using Thread       = std::unique_ptr<SDL_Thread,   deleter::Thread>;
 using Window       = std::unique_ptr<SDL_Window,   deleter::Window>;
 
 }   // namespace unique
@@ -69,6 +101,7 @@ using Renderer     = std::shared_ptr<SDL_Renderer>;
 using Semaphore    = std::shared_ptr<SDL_sem>;
 using Surface      = std::shared_ptr<SDL_Surface>;
 using Texture      = std::shared_ptr<SDL_Texture>;
+using Thread       = std::shared_ptr<SDL_Thread>;
 using Window       = std::shared_ptr<SDL_Window>;
 
 }   // namespace shared
@@ -82,6 +115,7 @@ using Renderer     = std::weak_ptr<SDL_Renderer>;
 using Semaphore    = std::weak_ptr<SDL_sem>;
 using Surface      = std::weak_ptr<SDL_Surface>;
 using Texture      = std::weak_ptr<SDL_Texture>;
+using Thread       = std::weak_ptr<SDL_Thread>;
 using Window       = std::weak_ptr<SDL_Window>;
 
 }   // namespace weak
@@ -93,6 +127,7 @@ unique::Renderer  make_unique(SDL_Renderer*);
 unique::Semaphore make_unique(SDL_sem*);
 unique::Surface   make_unique(SDL_Surface*);
 unique::Texture   make_unique(SDL_Texture*);
+unique::Thread    make_unique(SDL_Thread*);
 unique::Window    make_unique(SDL_Window*);
 
 shared::Cursor    make_shared(SDL_Cursor*);
@@ -102,6 +137,7 @@ shared::Renderer  make_shared(SDL_Renderer*);
 shared::Semaphore make_shared(SDL_sem*);
 shared::Surface   make_shared(SDL_Surface*);
 shared::Texture   make_shared(SDL_Texture*);
+shared::Thread    make_shared(SDL_Thread*);
 shared::Window    make_shared(SDL_Window*);
 
 }  // namespace sdl2_smart_ptr
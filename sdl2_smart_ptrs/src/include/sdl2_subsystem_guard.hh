@@ -0,0 +1,171 @@
+#ifndef SDL2_SUBSYSTEM_GUARD_HH
+#define SDL2_SUBSYSTEM_GUARD_HH
+
+#include "SDL_mixer.h"    // MIX_DEFAULT_*
+#include "SDL_stdinc.h"   // Uint16 Uint32
+
+#include <array>
+#include <chrono>
+#include <cstddef>        // size_t
+#include <exception>      // exception_ptr
+#include <initializer_list>
+#include <optional>
+#include <string>
+#include <thread>
+
+namespace sdl2_smart_ptr {
+
+/*
+ * Scoped initialization of SDL2 and its auxiliary libraries, complementing
+ *   the smart pointers for what they allocate. Each constructor initializes
+ *   its library, throwing std::runtime_error with the SDL error on failure,
+ *   and each destructor quits it. Guards of auxiliary libraries must be
+ *   destroyed before the Sdl guard, as Subsystems below ensures.
+ */
+namespace guard {
+
+// SDL_Init, SDL_Quit
+class Sdl {
+public:
+    explicit Sdl(Uint32 flags);
+    ~Sdl();
+
+    Sdl(const Sdl&) = delete;
+    Sdl& operator=(const Sdl&) = delete;
+};
+
+// IMG_Init, failing if any of flags are not initialized; IMG_Quit
+class Img {
+public:
+    explicit Img(int flags);
+    ~Img();
+
+    Img(const Img&) = delete;
+    Img& operator=(const Img&) = delete;
+};
+
+// TTF_Init, TTF_Quit
+class Ttf {
+public:
+    Ttf();
+    ~Ttf();
+
+    Ttf(const Ttf&) = delete;
+    Ttf& operator=(const Ttf&) = delete;
+};
+
+// SDLNet_Init, SDLNet_Quit
+class Net {
+public:
+    Net();
+    ~Net();
+
+    Net(const Net&) = delete;
+    Net& operator=(const Net&) = delete;
+};
+
+// as passed to Mix_OpenAudio
+struct MixAudioSpec {
+    int frequency { MIX_DEFAULT_FREQUENCY };
+    Uint16 format { MIX_DEFAULT_FORMAT };
+    int channels { MIX_DEFAULT_CHANNELS };
+    int chunk_size { 2048 };
+};
+
+// Mix_Init, failing if any of flags are not initialized, and Mix_OpenAudio;
+//   Mix_CloseAudio and Mix_Quit
+class Mix {
+public:
+    explicit Mix(int flags = 0, const MixAudioSpec& spec = {});
+    ~Mix();
+
+    Mix(const Mix&) = delete;
+    Mix& operator=(const Mix&) = delete;
+};
+
+}  // namespace guard
+
+enum class Subsystem { Sdl, Img, Ttf, Net, Mix };
+
+struct SubsystemConfig {
+    // SDL_INIT_AUDIO need not be given, it is initialized along with Mix
+    Uint32 sdl_flags {};
+    int img_flags {};
+    int mix_flags {};
+    guard::MixAudioSpec mix_spec {};
+};
+
+/*
+ * Owns a guard for SDL, initialized by the constructor, and one for each
+ *   auxiliary library, initialized lazily: by require() on first use, or
+ *   ahead of it by initAsync(), which initializes each library on a thread
+ *   of its own, so that slow ones like opening the audio device overlap each
+ *   other and the rest of startup. require() then waits for that library
+ *   alone, and rethrows any exception from its initialization, every time.
+ *
+ * The destructor waits for any initialization still running, then quits the
+ *   libraries in a fixed order: SDL_mixer, SDL_net, SDL_ttf, SDL_image, and
+ *   SDL last.
+ *
+ * Initialization times are kept per subsystem, to track startup regressions.
+ *   The audio subsystem is initialized on the calling thread before Mix is,
+ *   as SDL_InitSubSystem must not be called concurrently, and counts towards
+ *   Mix's time. sdl_flags should include SDL_INIT_VIDEO if video is used, as
+ *   it must be initialized on the main thread.
+ *
+ * Other than the initialization itself, not thread safe: all calls should be
+ *   made from the thread that constructed it.
+ */
+class Subsystems {
+public:
+    explicit Subsystems(const SubsystemConfig& config = {});
+    ~Subsystems();
+
+    Subsystems(const Subsystems&) = delete;
+    Subsystems& operator=(const Subsystems&) = delete;
+
+    // starts those not yet started, each on a new thread, without waiting
+    void initAsync(std::initializer_list<Subsystem> subsystems);
+    // initializes subsystem on this thread if not yet started, or waits for
+    //   it if started by initAsync()
+    void require(Subsystem subsystem);
+
+    // whether initialized and waited for by require()
+    bool isInitialized(Subsystem subsystem) const;
+    // zero if not yet initialized and waited for by require()
+    std::chrono::nanoseconds initTime(Subsystem subsystem) const;
+    // one line per subsystem initialized, or failed, in Subsystem order
+    std::string initReport() const;
+
+private:
+    enum class State { NotStarted, Running, Done };
+
+    struct Slot {
+        State state { State::NotStarted };
+        std::thread worker;
+        std::exception_ptr error;
+        std::chrono::nanoseconds init_time {};
+    };
+
+    static constexpr std::size_t SUBSYSTEM_CT { 5 };
+
+    Slot& slot(Subsystem subsystem);
+    const Slot& slot(Subsystem subsystem) const;
+    void prepare(Subsystem subsystem);
+    void initialize(Subsystem subsystem);
+
+    const SubsystemConfig config_;
+    std::array<Slot, SUBSYSTEM_CT> slots_;
+    // declared in initialization order, so that the default would also
+    //   destroy them in the right one; optional to time SDL_Init
+    std::optional<guard::Sdl> sdl_;
+    std::optional<guard::Img> img_;
+    std::optional<guard::Ttf> ttf_;
+    std::optional<guard::Net> net_;
+    std::optional<guard::Mix> mix_;
+};
+
+}  // namespace sdl2_smart_ptr
+
+
+#endif  // SDL2_SUBSYSTEM_GUARD_HH
@@ -1,6 +1,8 @@
 #ifndef SDL2_TTF_SMART_PTR_HH
 #define SDL2_TTF_SMART_PTR_HH
 
+#include "sdl2_resource_accounting.hh"  // deleter::Accounted detail::ResourceTraits
+
 #include "SDL_ttf.h"     // TTF_Font
 
 #include <memory>
@@ -9,12 +11,18 @@ namespace sdl2_smart_ptr {
 
 namespace deleter {
 
-struct TtfFont {
+struct TtfFont : Accounted {
     void operator()(TTF_Font*) const;
 };
 
 }  // namespace deleter
 
+namespace detail {
+
+template<> struct ResourceTraits<TTF_Font> : Unsized<ResourceType::TtfFont> {};
+
+}  // namespace detail
+
 namespace unique {
 
 using TtfFont = std::unique_ptr<TTF_Font, deleter::TtfFont>;
@@ -33,6 +41,16 @@ using TtfFont = std::weak_ptr<TTF_Font>;
 
 }  // namespace weak
 
+// defined in sdl2_slot_map.hh
+template<typename T, typename Deleter>
+class SlotMap;
+
+namespace slot_map {
+
+using TtfFont = SlotMap<TTF_Font, deleter::TtfFont>;
+
+}  // namespace slot_map
+
 unique::TtfFont make_unique(TTF_Font*);
 
 shared::TtfFont make_shared(TTF_Font*);
@@ -0,0 +1,154 @@
+#include "sdl2_graveyard.hh"
+
+#include <cassert>
+#include <cstdint>    // uint32_t uint64_t UINT32_MAX
+#include <memory>     // make_unique
+#include <new>        // nothrow
+#include <stdexcept>  // invalid_argument
+
+namespace sdl2_smart_ptr {
+
+Graveyard::Graveyard(std::size_t capacity) : capacity_(capacity) {
+    if (capacity >= UINT32_MAX)
+        throw std::invalid_argument("Graveyard: capacity must be less than UINT32_MAX");
+    pool_ = std::make_unique<Node[]>(capacity_);
+    for (std::size_t i {}; i < capacity_; ++i) {
+        pool_[i].pooled = true;
+        pool_[i].next_free.store(std::uint32_t(i + 2 <= capacity_ ? i + 2 : 0),
+                                 std::memory_order_relaxed);
+    }
+    free_head_.store(capacity_ > 0 ? 1 : 0, std::memory_order_release);
+}
+
+Graveyard::~Graveyard() {
+    drainAll();
+}
+
+Graveyard::Node* Graveyard::takeFree() noexcept {
+    std::uint64_t head { free_head_.load(std::memory_order_acquire) };
+    while (true) {
+        const std::uint32_t first { std::uint32_t(head) };
+        if (first == 0)
+            return nullptr;
+        Node* node { &pool_[first - 1] };
+        // may be stale if node was taken meanwhile, when the exchange fails
+        const std::uint64_t next {
+            ((head >> 32) + 1) << 32 | node->next_free.load(std::memory_order_relaxed) };
+        if (free_head_.compare_exchange_weak(head, next, std::memory_order_acquire,
+                                             std::memory_order_acquire))
+            return node;
+    }
+}
+
+void Graveyard::giveFree(Node* node) {
+    const std::uint32_t index { std::uint32_t(node - pool_.get() + 1) };
+    std::uint64_t head { free_head_.load(std::memory_order_relaxed) };
+    do {
+        node->next_free.store(std::uint32_t(head), std::memory_order_relaxed);
+    } while (!free_head_.compare_exchange_weak(head, ((head >> 32) + 1) << 32 | index,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed));
+}
+
+void Graveyard::bury(void* ptr, DestroyFunc destroy) noexcept {
+    assert(destroy != nullptr);
+    Node* node { takeFree() };
+    if (node == nullptr) {
+        node = new (std::nothrow) Node{};
+        if (node == nullptr) {
+            leaked_ct_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        node->pooled = false;
+        overflowed_ct_.fetch_add(1, std::memory_order_relaxed);
+    }
+    node->ptr = ptr;
+    node->destroy = destroy;
+    node->next = incoming_.load(std::memory_order_relaxed);
+    // only the owner removes nodes, and always all at once, so no ABA hazard
+    while (!incoming_.compare_exchange_weak(node->next, node,
+                                            std::memory_order_release,
+                                            std::memory_order_relaxed)) {}
+    pending_ct_.fetch_add(1, std::memory_order_relaxed);
+    buried_ct_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Graveyard::collectIncoming() {
+    Node* stack { incoming_.exchange(nullptr, std::memory_order_acquire) };
+    if (stack == nullptr)
+        return;
+    // reverse newest-first stack into oldest-first list
+    Node* batch_newest { stack };
+    Node* batch_oldest {};
+    while (stack != nullptr) {
+        Node* next { stack->next };
+        stack->next = batch_oldest;
+        batch_oldest = stack;
+        stack = next;
+    }
+    if (newest_ == nullptr)
+        oldest_ = batch_oldest;
+    else
+        newest_->next = batch_oldest;
+    newest_ = batch_newest;
+}
+
+void Graveyard::destroyOldest() {
+    Node* node { oldest_ };
+    oldest_ = node->next;
+    if (oldest_ == nullptr)
+        newest_ = nullptr;
+    node->destroy(node->ptr);
+    if (node->pooled)
+        giveFree(node);
+    else
+        delete node;
+    pending_ct_.fetch_sub(1, std::memory_order_relaxed);
+    ++stats_.destroyed;
+}
+
+std::size_t Graveyard::drain(std::chrono::microseconds budget) {
+    using clock = std::chrono::steady_clock;
+    const auto start { clock::now() };
+    collectIncoming();
+    std::size_t destroyed_ct {};
+    while (oldest_ != nullptr) {
+        destroyOldest();
+        ++destroyed_ct;
+        if (std::chrono::duration_cast<std::chrono::microseconds>(
+                clock::now() - start) >= budget)
+            break;
+    }
+    const auto drain_time {
+        std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start)
+    };
+    ++stats_.drains;
+    if (oldest_ != nullptr)
+        ++stats_.budget_exhausted;
+    if (drain_time > stats_.max_drain_time)
+        stats_.max_drain_time = drain_time;
+    return destroyed_ct;
+}
+
+std::size_t Graveyard::drainAll() {
+    std::size_t destroyed_ct {};
+    // destroying an allocation may bury others, eg a texture atlas owning
+    //   deferred textures
+    for (collectIncoming(); oldest_ != nullptr; collectIncoming()) {
+        while (oldest_ != nullptr) {
+            destroyOldest();
+            ++destroyed_ct;
+        }
+    }
+    return destroyed_ct;
+}
+
+Graveyard::Stats Graveyard::stats() const {
+    Stats stats { stats_ };
+    stats.buried = buried_ct_.load(std::memory_order_relaxed);
+    stats.overflowed = overflowed_ct_.load(std::memory_order_relaxed);
+    stats.leaked = leaked_ct_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+}  // namespace sdl2_smart_ptr
@@ -2,32 +2,40 @@
 
 namespace sdl2_smart_ptr {
 
+namespace detail {
+
+std::size_t ResourceTraits<Mix_Chunk>::bytes(const Mix_Chunk* mcp) { return mcp->alen; }
+
+}  // namespace detail
+
 namespace deleter {
 
-void MixChunk::operator()(Mix_Chunk* mcp) const { Mix_FreeChunk(mcp); }
+void MixChunk::operator()(Mix_Chunk* mcp) const {
+    detail::accountDestruction(*this, mcp);
+    Mix_FreeChunk(mcp);
+}
 
-void MixMusic::operator()(Mix_Music* mmp) const { Mix_FreeMusic(mmp); }
+void MixMusic::operator()(Mix_Music* mmp) const {
+    detail::accountDestruction(*this, mmp);
+    Mix_FreeMusic(mmp);
+}
 
 }  // namespace deleter
 
 unique::MixChunk make_unique(Mix_Chunk* mcp) {
-    static const deleter::MixChunk dltr;
-    return unique::MixChunk{ mcp, dltr };
+    return unique::MixChunk{ mcp, detail::accountCreation<deleter::MixChunk>(mcp) };
 }
 
 unique::MixMusic make_unique(Mix_Music* mmp) {
-    static const deleter::MixMusic dltr;
-    return unique::MixMusic{ mmp, dltr };
+    return unique::MixMusic{ mmp, detail::accountCreation<deleter::MixMusic>(mmp) };
 }
 
 shared::MixChunk make_shared(Mix_Chunk* mcp) {
-    static const deleter::MixChunk dltr;
-    return shared::MixChunk{ mcp, dltr };
+    return shared::MixChunk{ mcp, detail::accountCreation<deleter::MixChunk>(mcp) };
 }
 
 shared::MixMusic make_shared(Mix_Music* mmp) {
-    static const deleter::MixMusic dltr;
-    return shared::MixMusic{ mmp, dltr };
+    return shared::MixMusic{ mmp, detail::accountCreation<deleter::MixMusic>(mmp) };
 }
 
 }  // namespace sdl2_smart_ptr
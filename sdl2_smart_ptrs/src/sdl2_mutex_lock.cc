@@ -0,0 +1,141 @@
+#include "sdl2_mutex_lock.hh"
+
+#include "safeSdlCall.hh"
+
+#include "SDL_timer.h"  // SDL_GetPerformanceCounter
+
+#include <stdexcept>    // invalid_argument logic_error
+
+namespace sdl2_smart_ptr {
+
+static const SdlRetTest<int> negative_is_failure {
+    [](const int ret){ return (ret < 0); }
+};
+
+static const SdlRetTest<int> nonzero_is_failure {
+    [](const int ret){ return (ret != 0); }
+};
+
+MutexLock::MutexLock(SDL_mutex* mutex) : mutex_(mutex) {
+    if (mutex_ == nullptr)
+        throw std::invalid_argument("MutexLock: null mutex");
+    lock();
+}
+
+MutexLock::MutexLock(const unique::Mutex& mutex) : MutexLock(mutex.get()) {}
+
+MutexLock::MutexLock(const shared::Mutex& mutex) :
+    mutex_(mutex.get()), keep_alive_(mutex) {
+    if (mutex_ == nullptr)
+        throw std::invalid_argument("MutexLock: null mutex");
+#ifdef SDL2_SMART_PTRS_PROFILE_MUTEXES
+    profile_ = mutexProfile(mutex);
+#endif
+    lock();
+}
+
+#ifdef SDL2_SMART_PTRS_PROFILE_MUTEXES
+MutexLock::MutexLock(const unique::ProfiledMutex& mutex) :
+    mutex_(mutex.get()), profile_(mutex.get_deleter().profile) {
+    if (mutex_ == nullptr)
+        throw std::invalid_argument("MutexLock: null mutex");
+    lock();
+}
+#endif
+
+MutexLock::MutexLock(SDL_mutex* mutex, TryToLock) : mutex_(mutex) {
+    if (mutex_ == nullptr)
+        throw std::invalid_argument("MutexLock: null mutex");
+    const int ret { safeSdlCall(SDL_TryLockMutex, "SDL_TryLockMutex", negative_is_failure,
+                                mutex_) };
+    owns_lock_ = (ret == 0);
+}
+
+MutexLock::~MutexLock() {
+    // destructor can not throw, and SDL_UnlockMutex only fails on null mutex
+    if (owns_lock_) {
+#ifdef SDL2_SMART_PTRS_PROFILE_MUTEXES
+        recordHold();
+#endif
+        SDL_UnlockMutex(mutex_);
+    }
+}
+
+void MutexLock::lock() {
+    if (owns_lock_)
+        throw std::logic_error("MutexLock: lock already owned");
+#ifdef SDL2_SMART_PTRS_PROFILE_MUTEXES
+    if (profile_ != nullptr) {
+        const int ret { safeSdlCall(SDL_TryLockMutex, "SDL_TryLockMutex",
+                                    negative_is_failure, mutex_) };
+        const bool contended { ret == SDL_MUTEX_TIMEDOUT };
+        Uint64 wait_ticks {};
+        if (contended) {
+            const Uint64 wait_start { SDL_GetPerformanceCounter() };
+            safeSdlCall(SDL_LockMutex, "SDL_LockMutex", nonzero_is_failure, mutex_);
+            hold_start_ = SDL_GetPerformanceCounter();
+            wait_ticks = hold_start_ - wait_start;
+        } else {
+            hold_start_ = SDL_GetPerformanceCounter();
+        }
+        profile_->recordAcquisition(wait_ticks, contended);
+        owns_lock_ = true;
+        return;
+    }
+#endif
+    safeSdlCall(SDL_LockMutex, "SDL_LockMutex", nonzero_is_failure, mutex_);
+    owns_lock_ = true;
+}
+
+void MutexLock::unlock() {
+    if (!owns_lock_)
+        throw std::logic_error("MutexLock: lock not owned");
+#ifdef SDL2_SMART_PTRS_PROFILE_MUTEXES
+    recordHold();
+#endif
+    safeSdlCall(SDL_UnlockMutex, "SDL_UnlockMutex", nonzero_is_failure, mutex_);
+    owns_lock_ = false;
+}
+
+// time spent waiting on a condition variable counts as neither hold nor
+//   contention
+void MutexLock::wait(SDL_cond* cond) {
+    if (!owns_lock_)
+        throw std::logic_error("MutexLock: lock not owned");
+#ifdef SDL2_SMART_PTRS_PROFILE_MUTEXES
+    recordHold();
+#endif
+    // hold restarts even if the wait fails, as the lock is still owned
+    safeSdlCall([this](SDL_cond* wait_cond){
+            const int ret { SDL_CondWait(wait_cond, mutex_) };
+#ifdef SDL2_SMART_PTRS_PROFILE_MUTEXES
+            hold_start_ = SDL_GetPerformanceCounter();
+#endif
+            return ret;
+        }, "SDL_CondWait", nonzero_is_failure, cond);
+}
+
+bool MutexLock::waitTimeout(SDL_cond* cond, Uint32 timeout_ms) {
+    if (!owns_lock_)
+        throw std::logic_error("MutexLock: lock not owned");
+#ifdef SDL2_SMART_PTRS_PROFILE_MUTEXES
+    recordHold();
+#endif
+    const int ret { safeSdlCall([this](SDL_cond* wait_cond, Uint32 wait_ms){
+            const int wait_ret { SDL_CondWaitTimeout(wait_cond, mutex_, wait_ms) };
+#ifdef SDL2_SMART_PTRS_PROFILE_MUTEXES
+            hold_start_ = SDL_GetPerformanceCounter();
+#endif
+            return wait_ret;
+        }, "SDL_CondWaitTimeout", negative_is_failure, cond, timeout_ms) };
+    return ret != SDL_MUTEX_TIMEDOUT;
+}
+
+#ifdef SDL2_SMART_PTRS_PROFILE_MUTEXES
+void MutexLock::recordHold() {
+    if (profile_ != nullptr)
+        profile_->recordHold(SDL_GetPerformanceCounter() - hold_start_);
+}
+#endif
+
+}  // namespace sdl2_smart_ptr
@@ -0,0 +1,128 @@
+#include "sdl2_mutex_profile.hh"
+
+#include "SDL_timer.h"  // SDL_GetPerformanceFrequency
+
+#include <algorithm>    // sort
+#include <iomanip>      // setprecision
+#include <map>
+#include <memory>       // unique_ptr
+#include <mutex>        // mutex lock_guard
+#include <sstream>
+#include <utility>      // move
+
+namespace sdl2_smart_ptr {
+
+void MutexProfile::recordAcquisition(Uint64 wait_ticks, bool contended) {
+    acquisitions.fetch_add(1, std::memory_order_relaxed);
+    if (!contended)
+        return;
+    contended_acquisitions.fetch_add(1, std::memory_order_relaxed);
+    total_wait_ticks.fetch_add(wait_ticks, std::memory_order_relaxed);
+    std::uint64_t max_wait { max_wait_ticks.load(std::memory_order_relaxed) };
+    while (wait_ticks > max_wait &&
+           !max_wait_ticks.compare_exchange_weak(max_wait, wait_ticks,
+                                                 std::memory_order_relaxed)) {}
+}
+
+void MutexProfile::recordHold(Uint64 hold_ticks) {
+    total_hold_ticks.fetch_add(hold_ticks, std::memory_order_relaxed);
+}
+
+// std::mutex rather than SDL_mutex, so registry can be used before SDL_Init
+//   and never shows up in its own report
+static std::mutex registry_mutex;
+
+static std::map<std::string, std::unique_ptr<MutexProfile>>& registry() {
+    static std::map<std::string, std::unique_ptr<MutexProfile>> profiles;
+    return profiles;
+}
+
+MutexProfile& registerMutexProfile(const std::string& name) {
+    std::lock_guard<std::mutex> lock { registry_mutex };
+    auto& profile { registry()[name] };
+    if (profile == nullptr)
+        profile = std::make_unique<MutexProfile>(name);
+    return *profile;
+}
+
+std::vector<MutexProfileSnapshot> mutexProfiles() {
+    const double ms_per_tick {
+        1000.0 / double(SDL_GetPerformanceFrequency())
+    };
+    std::vector<MutexProfileSnapshot> snapshots;
+    {
+        std::lock_guard<std::mutex> lock { registry_mutex };
+        snapshots.reserve(registry().size());
+        for (const auto& [name, profile] : registry()) {
+            MutexProfileSnapshot snapshot;
+            snapshot.name = name;
+            snapshot.acquisitions = profile->acquisitions.load(std::memory_order_relaxed);
+            snapshot.contended_acquisitions =
+                profile->contended_acquisitions.load(std::memory_order_relaxed);
+            snapshot.total_wait_ms =
+                double(profile->total_wait_ticks.load(std::memory_order_relaxed)) * ms_per_tick;
+            snapshot.max_wait_ms =
+                double(profile->max_wait_ticks.load(std::memory_order_relaxed)) * ms_per_tick;
+            snapshot.total_hold_ms =
+                double(profile->total_hold_ticks.load(std::memory_order_relaxed)) * ms_per_tick;
+            snapshots.push_back(std::move(snapshot));
+        }
+    }
+    std::sort(snapshots.begin(), snapshots.end(),
+              [](const MutexProfileSnapshot& a, const MutexProfileSnapshot& b){
+                  return a.total_wait_ms > b.total_wait_ms;
+              });
+    return snapshots;
+}
+
+std::string mutexContentionReport() {
+    std::ostringstream report;
+    report << std::fixed << std::setprecision(3);
+    for (const auto& snapshot : mutexProfiles()) {
+        report << snapshot.name << ": " <<
+            snapshot.acquisitions << " acquisitions, " <<
+            snapshot.contended_acquisitions << " contended, wait " <<
+            snapshot.total_wait_ms << " ms total " <<
+            snapshot.max_wait_ms << " ms max, hold " <<
+            snapshot.total_hold_ms << " ms total\n";
+    }
+    return report.str();
+}
+
+void resetMutexProfiles() {
+    std::lock_guard<std::mutex> lock { registry_mutex };
+    for (auto& [name, profile] : registry()) {
+        profile->acquisitions = 0;
+        profile->contended_acquisitions = 0;
+        profile->total_wait_ticks = 0;
+        profile->max_wait_ticks = 0;
+        profile->total_hold_ticks = 0;
+    }
+}
+
+#ifdef SDL2_SMART_PTRS_PROFILE_MUTEXES
+
+namespace deleter {
+
+void ProfiledMutex::operator()(SDL_mutex* mp) const { SDL_DestroyMutex(mp); }
+
+}  // namespace deleter
+
+unique::ProfiledMutex make_profiled_unique(SDL_mutex* mp, const std::string& name) {
+    return unique::ProfiledMutex{
+        mp, deleter::ProfiledMutex{ &registerMutexProfile(name) } };
+}
+
+shared::Mutex make_profiled_shared(SDL_mutex* mp, const std::string& name) {
+    return shared::Mutex{
+        mp, deleter::ProfiledMutex{ &registerMutexProfile(name) } };
+}
+
+MutexProfile* mutexProfile(const shared::Mutex& mutex) {
+    const auto* dltr { std::get_deleter<deleter::ProfiledMutex>(mutex) };
+    return dltr == nullptr ? nullptr : dltr->profile;
+}
+
+#endif  // SDL2_SMART_PTRS_PROFILE_MUTEXES
+
+}  // namespace sdl2_smart_ptr
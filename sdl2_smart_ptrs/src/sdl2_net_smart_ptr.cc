@@ -2,44 +2,77 @@
 
 namespace sdl2_smart_ptr {
 
+namespace detail {
+
+std::size_t ResourceTraits<UDPpacket>::bytes(const UDPpacket* upp) {
+    return std::size_t(upp->maxlen);
+}
+
+std::size_t ResourceTraits<UDPpacket*>::bytes(UDPpacket* const* upvp) {
+    std::size_t total {};
+    for (; *upvp != nullptr; ++upvp)
+        total += std::size_t((*upvp)->maxlen);
+    return total;
+}
+
+}  // namespace detail
+
 namespace deleter {
 
-void SocketSet::operator()(_SDLNet_SocketSet* ssp) const { SDLNet_FreeSocketSet(ssp); }
+void SocketSet::operator()(_SDLNet_SocketSet* ssp) const {
+    detail::accountDestruction(*this, ssp);
+    SDLNet_FreeSocketSet(ssp);
+}
 
-void TcpSocket::operator()(_TCPsocket* tsp) const { SDLNet_TCP_Close(tsp); }
+void TcpSocket::operator()(_TCPsocket* tsp) const {
+    detail::accountDestruction(*this, tsp);
+    SDLNet_TCP_Close(tsp);
+}
 
-void UdpPacket::operator()(UDPpacket* upp) const { SDLNet_FreePacket(upp); }
+void UdpPacket::operator()(UDPpacket* upp) const {
+    detail::accountDestruction(*this, upp);
+    SDLNet_FreePacket(upp);
+}
+
+void UdpPacketVector::operator()(UDPpacket** upvp) const {
+    detail::accountDestruction(*this, upvp);
+    SDLNet_FreePacketV(upvp);
+}
 
 }  // namespace deleter
 
-unique::SocketSet make_unique(_SDLNet_SocketSet* ssp) {
-    static const deleter::SocketSet dltr;
-    return unique::SocketSet{ ssp, dltr };
+unique::SocketSet       make_unique(_SDLNet_SocketSet* ssp) {
+    return unique::SocketSet{ ssp, detail::accountCreation<deleter::SocketSet>(ssp) };
+}
+
+unique::TcpSocket       make_unique(_TCPsocket* tsp) {
+    return unique::TcpSocket{ tsp, detail::accountCreation<deleter::TcpSocket>(tsp) };
+}
+
+unique::UdpPacket       make_unique(UDPpacket* upp) {
+    return unique::UdpPacket{ upp, detail::accountCreation<deleter::UdpPacket>(upp) };
 }
 
-unique::TcpSocket make_unique(_TCPsocket* tsp) {
-    static const deleter::TcpSocket dltr;
-    return unique::TcpSocket{ tsp, dltr };
+unique::UdpPacketVector make_unique(UDPpacket** upvp) {
+    return unique::UdpPacketVector{
+        upvp, detail::accountCreation<deleter::UdpPacketVector>(upvp) };
 }
 
-unique::UdpPacket make_unique(UDPpacket* upp) {
-    static const deleter::UdpPacket dltr;
-    return unique::UdpPacket{ upp, dltr };
+shared::SocketSet       make_shared(_SDLNet_SocketSet* ssp) {
+    return shared::SocketSet{ ssp, detail::accountCreation<deleter::SocketSet>(ssp) };
 }
 
-shared::SocketSet make_shared(_SDLNet_SocketSet* ssp) {
-    static const deleter::SocketSet dltr;
-    return shared::SocketSet{ ssp, dltr };
+shared::TcpSocket       make_shared(_TCPsocket* tsp) {
+    return shared::TcpSocket{ tsp, detail::accountCreation<deleter::TcpSocket>(tsp) };
 }
 
-shared::TcpSocket make_shared(_TCPsocket* tsp) {
-    static const deleter::TcpSocket dltr;
-    return shared::TcpSocket{ tsp, dltr };
+shared::UdpPacket       make_shared(UDPpacket* upp) {
+    return shared::UdpPacket{ upp, detail::accountCreation<deleter::UdpPacket>(upp) };
 }
 
-shared::UdpPacket make_shared(UDPpacket* upp) {
-    static const deleter::UdpPacket dltr;
-    return shared::UdpPacket{ upp, dltr };
+shared::UdpPacketVector make_shared(UDPpacket** upvp) {
+    return shared::UdpPacketVector{
+        upvp, detail::accountCreation<deleter::UdpPacketVector>(upvp) };
 }
 
 }  // namespace sdl2_smart_ptr
@@ -0,0 +1,235 @@
+#include "sdl2_resource_accounting.hh"
+
+#include "SDL_log.h"  // SDL_LogWarn
+
+#include <algorithm>  // find max
+#include <array>
+#include <atomic>
+#include <cstdlib>    // atexit
+#include <mutex>      // mutex lock_guard
+#include <sstream>
+
+namespace sdl2_smart_ptr {
+
+static constexpr std::array<const char*, RESOURCE_TYPE_CT> RESOURCE_TYPE_NAMES {
+    "Cursor",
+    "CondVar",
+    "Mutex",
+    "Renderer",
+    "Semaphore",
+    "Surface",
+    "Texture",
+    "Thread",
+    "Window",
+    "MixChunk",
+    "MixMusic",
+    "SocketSet",
+    "TcpSocket",
+    "UdpPacket",
+    "UdpPacketVector",
+    "TtfFont",
+    "RtfContext"
+};
+
+const char* resourceTypeName(ResourceType type) {
+    return RESOURCE_TYPE_NAMES[std::size_t(type)];
+}
+
+// creations per thread between automatic peak samples
+static constexpr unsigned PEAK_SAMPLE_INTERVAL { 64 };
+
+namespace {
+
+// atomic only so other threads can read while owning thread writes
+struct ThreadCounter {
+    std::atomic<std::int64_t> created {};
+    std::atomic<std::int64_t> destroyed {};
+    std::atomic<std::int64_t> bytes_created {};
+    std::atomic<std::int64_t> bytes_destroyed {};
+};
+
+using ThreadCounters = std::array<ThreadCounter, RESOURCE_TYPE_CT>;
+
+struct Totals {
+    std::int64_t created {};
+    std::int64_t destroyed {};
+    std::int64_t bytes_created {};
+    std::int64_t bytes_destroyed {};
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<const ThreadCounters*> threads;
+    // counters of exited threads
+    std::array<Totals, RESOURCE_TYPE_CT> retired;
+    std::array<std::int64_t, RESOURCE_TYPE_CT> peak_live {};
+    std::array<std::int64_t, RESOURCE_TYPE_CT> peak_bytes {};
+};
+
+}  // namespace
+
+static void logLeakReport() {
+    const std::string report { resourceLeakReport() };
+    if (!report.empty()) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION,
+                    "sdl2_smart_ptr: resources alive at exit:\n%s", report.c_str());
+    }
+}
+
+static Registry& registry() {
+    static Registry reg;
+    // registered after reg is constructed, so called before it is destroyed
+    static const bool leak_report_registered { std::atexit(logLeakReport) == 0 };
+    static_cast<void>(leak_report_registered);
+    return reg;
+}
+
+static void add(std::atomic<std::int64_t>& counter, std::int64_t n) {
+    // single writer, so no read-modify-write needed
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+namespace {
+
+// registers its counters for the lifetime of the thread
+struct ThreadCountersRegistration {
+    ThreadCountersRegistration() {
+        Registry& reg { registry() };
+        std::lock_guard<std::mutex> lock { reg.mutex };
+        reg.threads.push_back(&counters);
+    }
+
+    ~ThreadCountersRegistration() {
+        Registry& reg { registry() };
+        std::lock_guard<std::mutex> lock { reg.mutex };
+        for (std::size_t i {}; i < RESOURCE_TYPE_CT; ++i) {
+            reg.retired[i].created += counters[i].created.load(std::memory_order_relaxed);
+            reg.retired[i].destroyed += counters[i].destroyed.load(std::memory_order_relaxed);
+            reg.retired[i].bytes_created +=
+                counters[i].bytes_created.load(std::memory_order_relaxed);
+            reg.retired[i].bytes_destroyed +=
+                counters[i].bytes_destroyed.load(std::memory_order_relaxed);
+        }
+        reg.threads.erase(std::find(reg.threads.begin(), reg.threads.end(), &counters));
+    }
+
+    ThreadCounters counters;
+};
+
+}  // namespace
+
+static ThreadCounters& threadCounters() {
+    thread_local ThreadCountersRegistration registration;
+    return registration.counters;
+}
+
+static thread_local unsigned creations_until_sample { PEAK_SAMPLE_INTERVAL };
+
+void recordCreation(ResourceType type, std::size_t bytes) {
+    ThreadCounter& counter { threadCounters()[std::size_t(type)] };
+    add(counter.created, 1);
+    add(counter.bytes_created, std::int64_t(bytes));
+    if (--creations_until_sample == 0) {
+        creations_until_sample = PEAK_SAMPLE_INTERVAL;
+        sampleResourcePeaks();
+    }
+}
+
+void recordDestruction(ResourceType type, std::size_t bytes, std::size_t count) {
+    ThreadCounter& counter { threadCounters()[std::size_t(type)] };
+    add(counter.destroyed, std::int64_t(count));
+    add(counter.bytes_destroyed, std::int64_t(bytes));
+}
+
+// registry mutex must be held; also raises peaks to current values
+static ResourceStats lockedStats(Registry& reg, std::size_t i) {
+    Totals totals { reg.retired[i] };
+    for (const ThreadCounters* counters : reg.threads) {
+        const ThreadCounter& counter { (*counters)[i] };
+        totals.created += counter.created.load(std::memory_order_relaxed);
+        totals.destroyed += counter.destroyed.load(std::memory_order_relaxed);
+        totals.bytes_created += counter.bytes_created.load(std::memory_order_relaxed);
+        totals.bytes_destroyed += counter.bytes_destroyed.load(std::memory_order_relaxed);
+    }
+    ResourceStats stats;
+    stats.type = ResourceType(i);
+    stats.created = totals.created;
+    stats.destroyed = totals.destroyed;
+    stats.live = totals.created - totals.destroyed;
+    stats.bytes = totals.bytes_created - totals.bytes_destroyed;
+    reg.peak_live[i] = std::max(reg.peak_live[i], stats.live);
+    reg.peak_bytes[i] = std::max(reg.peak_bytes[i], stats.bytes);
+    stats.peak_live = reg.peak_live[i];
+    stats.peak_bytes = reg.peak_bytes[i];
+    return stats;
+}
+
+ResourceStats resourceStats(ResourceType type) {
+    if (!RESOURCE_ACCOUNTING)
+        return ResourceStats{ type };
+    Registry& reg { registry() };
+    std::lock_guard<std::mutex> lock { reg.mutex };
+    return lockedStats(reg, std::size_t(type));
+}
+
+std::vector<ResourceStats> resourceStats() {
+    std::vector<ResourceStats> all_stats;
+    all_stats.reserve(RESOURCE_TYPE_CT);
+    if (!RESOURCE_ACCOUNTING) {
+        for (std::size_t i {}; i < RESOURCE_TYPE_CT; ++i)
+            all_stats.push_back(ResourceStats{ ResourceType(i) });
+        return all_stats;
+    }
+    Registry& reg { registry() };
+    std::lock_guard<std::mutex> lock { reg.mutex };
+    for (std::size_t i {}; i < RESOURCE_TYPE_CT; ++i)
+        all_stats.push_back(lockedStats(reg, i));
+    return all_stats;
+}
+
+static void reportLine(std::ostringstream& report, const ResourceStats& stats) {
+    report << resourceTypeName(stats.type) << ": " <<
+        stats.live << " live (peak " << stats.peak_live << "), " <<
+        stats.bytes << " bytes (peak " << stats.peak_bytes << "), " <<
+        stats.created << " created, " << stats.destroyed << " destroyed\n";
+}
+
+std::string resourceReport() {
+    std::ostringstream report;
+    for (const auto& stats : resourceStats()) {
+        if (stats.created != 0)
+            reportLine(report, stats);
+    }
+    return report.str();
+}
+
+std::string resourceLeakReport() {
+    std::ostringstream report;
+    for (const auto& stats : resourceStats()) {
+        if (stats.live != 0)
+            reportLine(report, stats);
+    }
+    return report.str();
+}
+
+void sampleResourcePeaks() {
+    if (!RESOURCE_ACCOUNTING)
+        return;
+    Registry& reg { registry() };
+    std::lock_guard<std::mutex> lock { reg.mutex };
+    for (std::size_t i {}; i < RESOURCE_TYPE_CT; ++i)
+        lockedStats(reg, i);
+}
+
+void resetResourcePeaks() {
+    if (!RESOURCE_ACCOUNTING)
+        return;
+    Registry& reg { registry() };
+    std::lock_guard<std::mutex> lock { reg.mutex };
+    reg.peak_live.fill(0);
+    reg.peak_bytes.fill(0);
+    for (std::size_t i {}; i < RESOURCE_TYPE_CT; ++i)
+        lockedStats(reg, i);
+}
+
+}  // namespace sdl2_smart_ptr
@@ -4,18 +4,19 @@ namespace sdl2_smart_ptr {
 
 namespace deleter {
 
-void RtfContext::operator()(RTF_Context* rcp) const { RTF_FreeContext(rcp); }
+void RtfContext::operator()(RTF_Context* rcp) const {
+    detail::accountDestruction(*this, rcp);
+    RTF_FreeContext(rcp);
+}
 
 }  // namespace deleter
 
 unique::RtfContext make_unique(RTF_Context* tfp) {
-    static const deleter::RtfContext dltr;
-    return unique::RtfContext{ tfp, dltr };
+    return unique::RtfContext{ tfp, detail::accountCreation<deleter::RtfContext>(tfp) };
 }
 
 shared::RtfContext make_shared(RTF_Context* tfp) {
-    static const deleter::RtfContext dltr;
-    return shared::RtfContext{ tfp, dltr };
+    return shared::RtfContext{ tfp, detail::accountCreation<deleter::RtfContext>(tfp) };
 }
 
 }  // namespace sdl2_smart_ptr
@@ -2,104 +2,145 @@
 
 namespace sdl2_smart_ptr {
 
+namespace detail {
+
+std::size_t ResourceTraits<SDL_Surface>::bytes(const SDL_Surface* sp) {
+    return std::size_t(sp->pitch) * std::size_t(sp->h);
+}
+
+std::size_t ResourceTraits<SDL_Texture>::bytes(SDL_Texture* tp) {
+    Uint32 format {};
+    int w {}, h {};
+    if (SDL_QueryTexture(tp, &format, nullptr, &w, &h) != 0)
+        return 0;
+    const std::size_t pixels { std::size_t(w) * std::size_t(h) };
+    // planar YUV formats average 12 bits per pixel
+    if (SDL_ISPIXELFORMAT_FOURCC(format))
+        return pixels * 3 / 2;
+    return pixels * SDL_BYTESPERPIXEL(format);
+}
+
+}  // namespace detail
+
 namespace deleter {
 
-void Cursor::operator()(SDL_Cursor* cp) const { SDL_FreeCursor(cp); }
+void Cursor::operator()(SDL_Cursor* cp) const {
+    detail::accountDestruction(*this, cp);
+    SDL_FreeCursor(cp);
+}
 
-void CondVar::operator()(SDL_cond* cp) const { SDL_DestroyCond(cp); }
+void CondVar::operator()(SDL_cond* cp) const {
+    detail::accountDestruction(*this, cp);
+    SDL_DestroyCond(cp);
+}
+
+void Mutex::operator()(SDL_mutex* mp) const {
+    detail::accountDestruction(*this, mp);
+    SDL_DestroyMutex(mp);
+}
 
-void Mutex::operator()(SDL_mutex* mp) const { SDL_DestroyMutex(mp); }
+void Renderer::operator()(SDL_Renderer* rp) const {
+    detail::accountDestruction(*this, rp);
+    SDL_DestroyRenderer(rp);
+}
 
-void Renderer::operator()(SDL_Renderer* rp) const { SDL_DestroyRenderer(rp); }
+void Semaphore::operator()(SDL_sem* sp) const {
+    detail::accountDestruction(*this, sp);
+    SDL_DestroySemaphore(sp);
+}
 
-void Semaphore::operator()(SDL_sem* sp) const { SDL_DestroySemaphore(sp); }
+void Surface::operator()(SDL_Surface* sp) const {
+    detail::accountDestruction(*this, sp);
+    SDL_FreeSurface(sp);
+}
 
-void Surface::operator()(SDL_Surface* sp) const { SDL_FreeSurface(sp); }
+void Texture::operator()(SDL_Texture* tp) const {
+    detail::accountDestruction(*this, tp);
+    SDL_DestroyTexture(tp);
+}
 
-void Texture::operator()(SDL_Texture* tp) const { SDL_DestroyTexture(tp); }
+void Thread::operator()(SDL_Thread* tp) const {
+    detail::accountDestruction(*this, tp);
+    SDL_WaitThread(tp, nullptr);
+}
 
-void Window::operator()(SDL_Window* wp) const { SDL_DestroyWindow(wp); }
+void Window::operator()(SDL_Window* wp) const {
+    detail::accountDestruction(*this, wp);
+    SDL_DestroyWindow(wp);
+}
 
 }  // namespace deleter
 
 unique::Cursor    make_unique(SDL_Cursor* cp) {
-    static const deleter::Cursor dltr;
-    return unique::Cursor{ cp, dltr };
+    return unique::Cursor{ cp, detail::accountCreation<deleter::Cursor>(cp) };
 }
 
 unique::CondVar   make_unique(SDL_cond* cvp) {
-    static const deleter::CondVar dltr;
-    return unique::CondVar{ cvp, dltr };
+    return unique::CondVar{ cvp, detail::accountCreation<deleter::CondVar>(cvp) };
 }
 
 unique::Mutex     make_unique(SDL_mutex* mp) {
-    static const deleter::Mutex dltr;
-    return unique::Mutex{ mp, dltr };
+    return unique::Mutex{ mp, detail::accountCreation<deleter::Mutex>(mp) };
 }
 
 unique::Renderer  make_unique(SDL_Renderer* rp) {
-    static const deleter::Renderer dltr;
-    return unique::Renderer{ rp, dltr };
+    return unique::Renderer{ rp, detail::accountCreation<deleter::Renderer>(rp) };
 }
 
 unique::Semaphore make_unique(SDL_sem* sp) {
-    static const deleter::Semaphore dltr;
-    return unique::Semaphore{ sp, dltr };
+    return unique::Semaphore{ sp, detail::accountCreation<deleter::Semaphore>(sp) };
 }
 
 unique::Surface   make_unique(SDL_Surface* sp) {
-    static const deleter::Surface dltr;
-    return unique::Surface{ sp, dltr };
+    return unique::Surface{ sp, detail::accountCreation<deleter::Surface>(sp) };
 }
 
 unique::Texture   make_unique(SDL_Texture* tp) {
-    static const deleter::Texture dltr;
-    return unique::Texture{ tp, dltr };
+    return unique::Texture{ tp, detail::accountCreation<deleter::Texture>(tp) };
+}
+
+unique::Thread    make_unique(SDL_Thread* tp) {
+    return unique::Thread{ tp, detail::accountCreation<deleter::Thread>(tp) };
 }
 
 unique::Window    make_unique(SDL_Window* wp) {
-    static const deleter::Window dltr;
-    return unique::Window{ wp, dltr };
+    return unique::Window{ wp, detail::accountCreation<deleter::Window>(wp) };
 }
 
 shared::Cursor    make_shared(SDL_Cursor* cp) {
-    static const deleter::Cursor dltr;
-    return shared::Cursor{ cp, dltr };
+    return shared::Cursor{ cp, detail::accountCreation<deleter::Cursor>(cp) };
 }
 
 shared::CondVar   make_shared(SDL_cond* cvp) {
-    static const deleter::CondVar dltr;
-    return shared::CondVar{ cvp, dltr };
+    return shared::CondVar{ cvp, detail::accountCreation<deleter::CondVar>(cvp) };
 }
 
 shared::Mutex     make_shared(SDL_mutex* mp) {
-    static const deleter::Mutex dltr;
-    return shared::Mutex{ mp, dltr };
+    return shared::Mutex{ mp, detail::accountCreation<deleter::Mutex>(mp) };
 }
 
 shared::Renderer  make_shared(SDL_Renderer* rp) {
-    static const deleter::Renderer dltr;
-    return shared::Renderer{ rp, dltr };
+    return shared::Renderer{ rp, detail::accountCreation<deleter::Renderer>(rp) };
 }
 
 shared::Semaphore make_shared(SDL_sem* sp) {
-    static const deleter::Semaphore dltr;
-    return shared::Semaphore{ sp, dltr };
+    return shared::Semaphore{ sp, detail::accountCreation<deleter::Semaphore>(sp) };
 }
 
 shared::Surface   make_shared(SDL_Surface* sp) {
-    static const deleter::Surface dltr;
-    return shared::Surface{ sp, dltr };
+    return shared::Surface{ sp, detail::accountCreation<deleter::Surface>(sp) };
 }
 
 shared::Texture   make_shared(SDL_Texture* tp) {
-    static const deleter::Texture dltr;
-    return shared::Texture{ tp, dltr };
+    return shared::Texture{ tp, detail::accountCreation<deleter::Texture>(tp) };
+}
+
+shared::Thread    make_shared(SDL_Thread* tp) {
+    return shared::Thread{ tp, detail::accountCreation<deleter::Thread>(tp) };
 }
 
 shared::Window    make_shared(SDL_Window* wp) {
-    static const deleter::Window dltr;
-    return shared::Window{ wp, dltr };
+    return shared::Window{ wp, detail::accountCreation<deleter::Window>(wp) };
 }
 
 }  // namespace sdl2_smart_ptr
@@ -0,0 +1,213 @@
+#include "sdl2_subsystem_guard.hh"
+
+#include "safeSdlCall.hh"
+
+#include "SDL.h"         // SDL_Init SDL_InitSubSystem SDL_WasInit SDL_Quit
+#include "SDL_image.h"   // IMG_Init IMG_Quit
+#include "SDL_net.h"     // SDLNet_Init SDLNet_Quit
+#include "SDL_ttf.h"     // TTF_Init TTF_Quit
+
+#include <iomanip>       // setprecision
+#include <sstream>
+
+namespace sdl2_smart_ptr {
+
+namespace guard {
+
+Sdl::Sdl(Uint32 flags) {
+    safeSdlCall(SDL_Init, "SDL_Init",
+                SdlRetTest<int>{ [](const int ret){ return (ret != 0); } },
+                flags);
+}
+
+Sdl::~Sdl() { SDL_Quit(); }
+
+Img::Img(int flags) {
+    try {
+        safeSdlCall(IMG_Init, "IMG_Init",
+                    SdlRetTest<int>{ [flags](const int ret){ return ((ret & flags) != flags); } },
+                    flags);
+    } catch (...) {
+        // unloads any libraries loaded for the flags that did succeed
+        IMG_Quit();
+        throw;
+    }
+}
+
+Img::~Img() { IMG_Quit(); }
+
+Ttf::Ttf() {
+    safeSdlCall(TTF_Init, "TTF_Init",
+                SdlRetTest<int>{ [](const int ret){ return (ret != 0); } });
+}
+
+Ttf::~Ttf() { TTF_Quit(); }
+
+Net::Net() {
+    safeSdlCall(SDLNet_Init, "SDLNet_Init",
+                SdlRetTest<int>{ [](const int ret){ return (ret != 0); } });
+}
+
+Net::~Net() { SDLNet_Quit(); }
+
+Mix::Mix(int flags, const MixAudioSpec& spec) {
+    try {
+        safeSdlCall(Mix_Init, "Mix_Init",
+                    SdlRetTest<int>{ [flags](const int ret){ return ((ret & flags) != flags); } },
+                    flags);
+        safeSdlCall(Mix_OpenAudio, "Mix_OpenAudio",
+                    SdlRetTest<int>{ [](const int ret){ return (ret != 0); } },
+                    spec.frequency, spec.format, spec.channels, spec.chunk_size);
+    } catch (...) {
+        Mix_Quit();
+        throw;
+    }
+}
+
+Mix::~Mix() {
+    Mix_CloseAudio();
+    Mix_Quit();
+}
+
+}  // namespace guard
+
+static const char* subsystemName(Subsystem subsystem) {
+    switch (subsystem) {
+    case Subsystem::Sdl: return "SDL";
+    case Subsystem::Img: return "SDL_image";
+    case Subsystem::Ttf: return "SDL_ttf";
+    case Subsystem::Net: return "SDL_net";
+    case Subsystem::Mix: return "SDL_mixer";
+    }
+    return "";
+}
+
+Subsystems::Subsystems(const SubsystemConfig& config) : config_(config) {
+    const auto start { std::chrono::steady_clock::now() };
+    sdl_.emplace(config_.sdl_flags);
+    Slot& sdl_slot { slot(Subsystem::Sdl) };
+    sdl_slot.init_time = std::chrono::steady_clock::now() - start;
+    sdl_slot.state = State::Done;
+}
+
+Subsystems::~Subsystems() {
+    for (Slot& slot : slots_) {
+        if (slot.worker.joinable())
+            slot.worker.join();
+    }
+    mix_.reset();
+    net_.reset();
+    ttf_.reset();
+    img_.reset();
+    sdl_.reset();
+}
+
+Subsystems::Slot& Subsystems::slot(Subsystem subsystem) {
+    return slots_[static_cast<std::size_t>(subsystem)];
+}
+
+const Subsystems::Slot& Subsystems::slot(Subsystem subsystem) const {
+    return slots_[static_cast<std::size_t>(subsystem)];
+}
+
+void Subsystems::initAsync(std::initializer_list<Subsystem> subsystems) {
+    for (const Subsystem subsystem : subsystems) {
+        Slot& subsystem_slot { slot(subsystem) };
+        if (subsystem_slot.state != State::NotStarted)
+            continue;
+        prepare(subsystem);
+        subsystem_slot.worker = std::thread(&Subsystems::initialize, this, subsystem);
+        subsystem_slot.state = State::Running;
+    }
+}
+
+void Subsystems::require(Subsystem subsystem) {
+    Slot& subsystem_slot { slot(subsystem) };
+    switch (subsystem_slot.state) {
+    case State::NotStarted:
+        prepare(subsystem);
+        initialize(subsystem);
+        break;
+    case State::Running:
+        subsystem_slot.worker.join();
+        break;
+    case State::Done:
+        break;
+    }
+    subsystem_slot.state = State::Done;
+    if (subsystem_slot.error != nullptr)
+        std::rethrow_exception(subsystem_slot.error);
+}
+
+bool Subsystems::isInitialized(Subsystem subsystem) const {
+    const Slot& subsystem_slot { slot(subsystem) };
+    return subsystem_slot.state == State::Done && subsystem_slot.error == nullptr;
+}
+
+std::chrono::nanoseconds Subsystems::initTime(Subsystem subsystem) const {
+    const Slot& subsystem_slot { slot(subsystem) };
+    return subsystem_slot.state == State::Done ?
+        subsystem_slot.init_time : std::chrono::nanoseconds {};
+}
+
+std::string Subsystems::initReport() const {
+    std::ostringstream report;
+    report << std::fixed << std::setprecision(3);
+    for (std::size_t i {}; i < SUBSYSTEM_CT; ++i) {
+        const Slot& subsystem_slot { slots_[i] };
+        if (subsystem_slot.state != State::Done)
+            continue;
+        report << subsystemName(static_cast<Subsystem>(i)) << ": " <<
+            std::chrono::duration<double, std::milli>(subsystem_slot.init_time).count() <<
+            " ms" << (subsystem_slot.error != nullptr ? " (failed)" : "") << '\n';
+    }
+    return report.str();
+}
+
+// on the calling thread, before any initialization is started on a worker
+void Subsystems::prepare(Subsystem subsystem) {
+    if (subsystem != Subsystem::Mix || SDL_WasInit(SDL_INIT_AUDIO) != 0)
+        return;
+    Slot& mix_slot { slot(Subsystem::Mix) };
+    const auto start { std::chrono::steady_clock::now() };
+    try {
+        // else Mix_OpenAudio would call it, possibly concurrently with others
+        safeSdlCall(SDL_InitSubSystem, "SDL_InitSubSystem",
+                    SdlRetTest<int>{ [](const int ret){ return (ret != 0); } },
+                    Uint32(SDL_INIT_AUDIO));
+    } catch (...) {
+        mix_slot.error = std::current_exception();
+    }
+    mix_slot.init_time += std::chrono::steady_clock::now() - start;
+}
+
+// on any thread; writes only to the guard and slot of subsystem
+void Subsystems::initialize(Subsystem subsystem) {
+    Slot& subsystem_slot { slot(subsystem) };
+    if (subsystem_slot.error != nullptr)
+        return;
+    const auto start { std::chrono::steady_clock::now() };
+    try {
+        switch (subsystem) {
+        case Subsystem::Sdl:
+            break;
+        case Subsystem::Img:
+            img_.emplace(config_.img_flags);
+            break;
+        case Subsystem::Ttf:
+            ttf_.emplace();
+            break;
+        case Subsystem::Net:
+            net_.emplace();
+            break;
+        case Subsystem::Mix:
+            mix_.emplace(config_.mix_flags, config_.mix_spec);
+            break;
+        }
+    } catch (...) {
+        subsystem_slot.error = std::current_exception();
+    }
+    subsystem_slot.init_time += std::chrono::steady_clock::now() - start;
+}
+
+}  // namespace sdl2_smart_ptr
@@ -4,18 +4,19 @@ namespace sdl2_smart_ptr {
 
 namespace deleter {
 
-void TtfFont::operator()(TTF_Font* fp) const { TTF_CloseFont(fp); }
+void TtfFont::operator()(TTF_Font* fp) const {
+    detail::accountDestruction(*this, fp);
+    TTF_CloseFont(fp);
+}
 
 }  // namespace deleter
 
 unique::TtfFont make_unique(TTF_Font* tfp) {
-    static const deleter::TtfFont dltr;
-    return unique::TtfFont{ tfp, dltr };
+    return unique::TtfFont{ tfp, detail::accountCreation<deleter::TtfFont>(tfp) };
 }
 
 shared::TtfFont make_shared(TTF_Font* tfp) {
-    static const deleter::TtfFont dltr;
-    return shared::TtfFont{ tfp, dltr };
+    return shared::TtfFont{ tfp, detail::accountCreation<deleter::TtfFont>(tfp) };
 }
 
 }  // namespace sdl2_smart_ptr
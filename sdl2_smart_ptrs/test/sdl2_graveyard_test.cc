@@ -0,0 +1,148 @@
+#include <catch2/catch_version_macros.hpp>               // CATCH_VERSION_MAJOR
+#if (CATCH_VERSION_MAJOR != 3)
+  #error "tests currently only support Catch2 v3.x"
+#endif
+#include <catch2/catch_test_macros.hpp>                  // TEST_CASE, SECTION, REQUIRE
+
+#include "sdl2_graveyard.hh"
+
+#include <SDL.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+static std::string collectErrorQuitSdl(const std::string& func_name) {
+    std::string err { SDL_GetError() };
+    SDL_ClearError();
+    if (err.size() == 0) {
+        err = "failure without setting SDL error";
+    }
+    SDL_Quit();
+    return func_name + ": " + err;
+}
+
+using namespace sdl2_smart_ptr;
+
+// frees surface, recording destruction order by surface width
+static std::vector<int> destroyed_widths;
+
+struct RecordingSurfaceDeleter {
+    void operator()(SDL_Surface* sp) const {
+        destroyed_widths.push_back(sp->w);
+        SDL_FreeSurface(sp);
+    }
+};
+
+static SDL_Surface* createSurface(int w) {
+    return SDL_CreateRGBSurfaceWithFormat(0, w, 1, 32, SDL_PIXELFORMAT_RGBA32);
+}
+
+static int burySurfacesThread(void* graveyard) {
+    for (int i {}; i < 100; ++i) {
+        deferred::Surface up_surface {
+            make_deferred(make_unique(createSurface(1)),
+                          *static_cast<Graveyard*>(graveyard)) };
+    }
+    return 0;
+}
+
+TEST_CASE("SDL core deferred destruction: Graveyard",
+    "[sdl2_smart_ptr][SDL2][core][Graveyard]")
+{
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    SDL_Surface* surface { createSurface(1) };
+    if (surface == nullptr) {
+        SKIP(collectErrorQuitSdl("SDL_CreateRGBSurfaceWithFormat"));
+    }
+    SDL_FreeSurface(surface);
+    destroyed_widths.clear();
+
+    {
+        Graveyard graveyard;
+
+        SECTION("destruction waits for drain, in burial order")
+        {
+            for (int w { 1 }; w <= 3; ++w) {
+                deferred::Ptr<SDL_Surface, RecordingSurfaceDeleter> up_surface {
+                    createSurface(w),
+                    deleter::Deferred<RecordingSurfaceDeleter>{ &graveyard } };
+            }
+            REQUIRE(destroyed_widths.empty());
+            REQUIRE(graveyard.pending() == 3);
+            REQUIRE(graveyard.drainAll() == 3);
+            REQUIRE(destroyed_widths == std::vector<int>{ 1, 2, 3 });
+            REQUIRE(graveyard.pending() == 0);
+        }
+        SECTION("drain budget")
+        {
+            for (int w { 1 }; w <= 3; ++w) {
+                auto up_surface { make_deferred(
+                    std::unique_ptr<SDL_Surface, RecordingSurfaceDeleter>{ createSurface(w) },
+                    graveyard) };
+            }
+            // always makes progress
+            REQUIRE(graveyard.drain(std::chrono::microseconds{ 0 }) == 1);
+            REQUIRE(graveyard.pending() == 2);
+            REQUIRE(graveyard.drain(std::chrono::seconds{ 1 }) == 2);
+            const auto stats { graveyard.stats() };
+            REQUIRE(stats.buried == 3);
+            REQUIRE(stats.destroyed == 3);
+            REQUIRE(stats.drains == 2);
+            REQUIRE(stats.budget_exhausted == 1);
+        }
+        SECTION("burial from other threads")
+        {
+            {
+                std::vector<unique::Thread> threads;
+                for (int i {}; i < 4; ++i) {
+                    threads.push_back(make_unique(
+                        SDL_CreateThread(burySurfacesThread, "burySurfacesThread",
+                                         &graveyard)));
+                    REQUIRE(threads.back() != nullptr);
+                }
+            }
+            REQUIRE(graveyard.pending() == 400);
+            REQUIRE(graveyard.drainAll() == 400);
+        }
+        SECTION("burial past pool capacity")
+        {
+            Graveyard small_graveyard { 2 };
+            REQUIRE(small_graveyard.capacity() == 2);
+            for (int round {}; round < 2; ++round) {
+                for (int w { 1 }; w <= 3; ++w) {
+                    deferred::Ptr<SDL_Surface, RecordingSurfaceDeleter> up_surface {
+                        createSurface(w),
+                        deleter::Deferred<RecordingSurfaceDeleter>{ &small_graveyard } };
+                }
+                REQUIRE(small_graveyard.drainAll() == 3);
+            }
+            REQUIRE(destroyed_widths == std::vector<int>{ 1, 2, 3, 1, 2, 3 });
+            const auto stats { small_graveyard.stats() };
+            REQUIRE(stats.buried == 6);
+            REQUIRE(stats.overflowed == 2);
+            REQUIRE(stats.leaked == 0);
+        }
+        SECTION("shared handles and no graveyard")
+        {
+            {
+                auto sp_surface { make_deferred_shared(
+                    std::unique_ptr<SDL_Surface, RecordingSurfaceDeleter>{ createSurface(1) },
+                    graveyard) };
+                auto sp_copy { sp_surface };
+            }
+            REQUIRE(graveyard.pending() == 1);
+            {
+                deferred::Ptr<SDL_Surface, RecordingSurfaceDeleter> up_surface {
+                    createSurface(2) };
+            }
+            REQUIRE(destroyed_widths == std::vector<int>{ 2 });
+        }
+        // remaining burials are destroyed with graveyard
+    }
+
+    SDL_Quit();
+}
@@ -0,0 +1,97 @@
+#include <catch2/catch_version_macros.hpp>               // CATCH_VERSION_MAJOR
+#if (CATCH_VERSION_MAJOR != 3)
+  #error "tests currently only support Catch2 v3.x"
+#endif
+#include <catch2/catch_test_macros.hpp>                  // TEST_CASE, SECTION, REQUIRE
+
+#include "sdl2_mutex_lock.hh"
+
+#include <SDL.h>
+
+#include <stdexcept>  // logic_error
+#include <string>
+
+static std::string collectErrorQuitSdl(const std::string& func_name) {
+    std::string err { SDL_GetError() };
+    SDL_ClearError();
+    if (err.size() == 0) {
+        err = "failure without setting SDL error";
+    }
+    SDL_Quit();
+    return func_name + ": " + err;
+}
+
+using namespace sdl2_smart_ptr;
+
+// SDL mutexes are recursive, so exclusion can only be seen from another thread
+static int tryLockThread(void* mutex) {
+    MutexLock lock { static_cast<SDL_mutex*>(mutex), MutexLock::TRY_TO_LOCK };
+    return lock.ownsLock() ? 1 : 0;
+}
+
+static bool lockedByOtherThread(SDL_mutex* mutex) {
+    SDL_Thread* thread {
+        SDL_CreateThread(tryLockThread, "tryLockThread", mutex)
+    };
+    REQUIRE(thread != nullptr);
+    int acquired {};
+    SDL_WaitThread(thread, &acquired);
+    return acquired == 0;
+}
+
+TEST_CASE("SDL core mutex locking: MutexLock",
+    "[sdl2_smart_ptr][SDL2][core][SDL_mutex][MutexLock]")
+{
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    {
+        auto mutex { make_unique(SDL_CreateMutex()) };
+        if (mutex == nullptr) {
+            SKIP(collectErrorQuitSdl("SDL_CreateMutex"));
+        }
+
+        SECTION("scoped lock of unique::Mutex")
+        {
+            {
+                MutexLock lock { mutex };
+                REQUIRE(lock.ownsLock());
+                REQUIRE(lock.mutex() == mutex.get());
+                REQUIRE(lockedByOtherThread(mutex.get()));
+            }
+            REQUIRE_FALSE(lockedByOtherThread(mutex.get()));
+        }
+        SECTION("manual unlock and relock")
+        {
+            MutexLock lock { mutex };
+            lock.unlock();
+            REQUIRE_FALSE(lock.ownsLock());
+            REQUIRE_FALSE(lockedByOtherThread(mutex.get()));
+            REQUIRE_THROWS_AS(lock.unlock(), std::logic_error);
+            lock.lock();
+            REQUIRE(lockedByOtherThread(mutex.get()));
+            REQUIRE_THROWS_AS(lock.lock(), std::logic_error);
+        }
+        SECTION("shared::Mutex is kept alive by lock")
+        {
+            shared::Mutex sp_mutex { mutex.release(), deleter::Mutex{} };
+            MutexLock lock { sp_mutex };
+            REQUIRE(sp_mutex.use_count() == 2);
+            sp_mutex.reset();
+            REQUIRE(lockedByOtherThread(lock.mutex()));
+        }
+        SECTION("condition variable timeout")
+        {
+            auto cond { make_unique(SDL_CreateCond()) };
+            REQUIRE(cond != nullptr);
+            MutexLock lock { mutex };
+            REQUIRE_FALSE(lock.waitTimeout(cond.get(), 1));
+            REQUIRE(lock.ownsLock());
+            lock.unlock();
+            REQUIRE_THROWS_AS(lock.wait(cond.get()), std::logic_error);
+        }
+    }
+
+    SDL_Quit();
+}
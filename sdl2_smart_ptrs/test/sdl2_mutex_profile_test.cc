@@ -0,0 +1,116 @@
+#include <catch2/catch_version_macros.hpp>               // CATCH_VERSION_MAJOR
+#if (CATCH_VERSION_MAJOR != 3)
+  #error "tests currently only support Catch2 v3.x"
+#endif
+#include <catch2/catch_test_macros.hpp>                  // TEST_CASE, SECTION, REQUIRE
+
+#include "sdl2_mutex_lock.hh"
+#include "sdl2_mutex_profile.hh"
+
+#include <SDL.h>
+
+#include <string>
+#include <type_traits>  // is_same_v
+#include <vector>
+
+static std::string collectErrorQuitSdl(const std::string& func_name) {
+    std::string err { SDL_GetError() };
+    SDL_ClearError();
+    if (err.size() == 0) {
+        err = "failure without setting SDL error";
+    }
+    SDL_Quit();
+    return func_name + ": " + err;
+}
+
+using namespace sdl2_smart_ptr;
+
+// holds mutex for 20ms, signaling semaphore once locked
+struct HolderArgs {
+    SDL_mutex* mutex;
+    SDL_sem* locked;
+};
+
+static int holdMutexThread(void* data) {
+    auto* args { static_cast<HolderArgs*>(data) };
+    SDL_LockMutex(args->mutex);
+    SDL_SemPost(args->locked);
+    SDL_Delay(20);
+    SDL_UnlockMutex(args->mutex);
+    return 0;
+}
+
+static const MutexProfileSnapshot* findProfile(
+    const std::vector<MutexProfileSnapshot>& profiles, const std::string& name) {
+    for (const auto& profile : profiles) {
+        if (profile.name == name)
+            return &profile;
+    }
+    return nullptr;
+}
+
+TEST_CASE("SDL core mutex contention profiling: ProfiledMutex",
+    "[sdl2_smart_ptr][SDL2][core][SDL_mutex][ProfiledMutex]")
+{
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    {
+        auto mutex { make_profiled_unique(SDL_CreateMutex(), "test mutex") };
+        if (mutex == nullptr) {
+            SKIP(collectErrorQuitSdl("SDL_CreateMutex"));
+        }
+        auto sp_mutex { make_profiled_shared(SDL_CreateMutex(), "test mutex") };
+        REQUIRE(sp_mutex != nullptr);
+        resetMutexProfiles();
+
+        {
+            MutexLock lock { mutex };
+        }
+        {
+            MutexLock lock { sp_mutex };
+        }
+        auto sem { make_unique(SDL_CreateSemaphore(0)) };
+        REQUIRE(sem != nullptr);
+        HolderArgs args { mutex.get(), sem.get() };
+        SDL_Thread* holder {
+            SDL_CreateThread(holdMutexThread, "holdMutexThread", &args)
+        };
+        REQUIRE(holder != nullptr);
+        SDL_SemWait(sem.get());
+        {
+            MutexLock lock { mutex };
+        }
+        SDL_WaitThread(holder, nullptr);
+
+#ifdef SDL2_SMART_PTRS_PROFILE_MUTEXES
+        SECTION("acquisitions are recorded by name")
+        {
+            const auto profiles { mutexProfiles() };
+            const auto* profile { findProfile(profiles, "test mutex") };
+            REQUIRE(profile != nullptr);
+            REQUIRE(profile->acquisitions == 3);
+            REQUIRE(profile->contended_acquisitions == 1);
+            REQUIRE(profile->max_wait_ms > 0.0);
+            REQUIRE(profile->total_wait_ms >= profile->max_wait_ms);
+            REQUIRE(mutexContentionReport().find("test mutex: 3 acquisitions, 1 contended") !=
+                    std::string::npos);
+        }
+        SECTION("reset")
+        {
+            resetMutexProfiles();
+            const auto profiles { mutexProfiles() };
+            REQUIRE(findProfile(profiles, "test mutex")->acquisitions == 0);
+        }
+#else
+        SECTION("instrumentation off compiles down to plain handles")
+        {
+            STATIC_REQUIRE(std::is_same_v<unique::ProfiledMutex, unique::Mutex>);
+            REQUIRE(findProfile(mutexProfiles(), "test mutex") == nullptr);
+        }
+#endif
+    }
+
+    SDL_Quit();
+}
@@ -181,3 +181,54 @@ TEST_CASE("SDL_net allocations: UDPpacket",
     SDLNet_Quit();
     SDL_Quit();
 }
+
+TEST_CASE("SDL_net allocations: UDPpacket vector",
+    "[sdl2_smart_ptr][SDL2][SDL_net][UDPpacketV]")
+{
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        FAIL(collectErrorQuitSdlNet("SDL_Init"));
+    }
+
+    if (SDLNet_Init() != 0) {
+        FAIL(collectErrorQuitSdlNet("SDLNet_Init"));
+    }
+
+    UDPpacket** udppacketv {
+        SDLNet_AllocPacketV(4, 100)
+    };
+    if (udppacketv == nullptr) {
+        SKIP(collectErrorQuitSdlNet("SDLNet_AllocPacketV"));
+    }
+
+    deleter::UdpPacketVector dltr;
+
+    SECTION("direct use of deleter after manual allocation")
+    {
+        dltr(udppacketv);
+    }
+    SECTION("unique:: ctor")
+    {
+        unique::UdpPacketVector up_udppacketv{udppacketv, dltr};
+        REQUIRE(up_udppacketv.get() == udppacketv);
+        REQUIRE(up_udppacketv[4] == nullptr);
+    }
+    SECTION("make_unique")
+    {
+        auto up_udppacketv{ make_unique(udppacketv) };
+        REQUIRE(up_udppacketv.get() == udppacketv);
+    }
+    SECTION("shared:: ctor")
+    {
+        shared::UdpPacketVector sp_udppacketv{udppacketv, dltr};
+        REQUIRE(sp_udppacketv.get() == udppacketv);
+        REQUIRE(sp_udppacketv[4] == nullptr);
+    }
+    SECTION("make_shared")
+    {
+        auto sp_udppacketv{ make_shared(udppacketv) };
+        REQUIRE(sp_udppacketv.get() == udppacketv);
+    }
+
+    SDLNet_Quit();
+    SDL_Quit();
+}
@@ -0,0 +1,152 @@
+#include <catch2/catch_version_macros.hpp>               // CATCH_VERSION_MAJOR
+#if (CATCH_VERSION_MAJOR != 3)
+  #error "tests currently only support Catch2 v3.x"
+#endif
+#include <catch2/catch_test_macros.hpp>                  // TEST_CASE, SECTION, REQUIRE
+
+#include "sdl2_graveyard.hh"
+#include "sdl2_resource_accounting.hh"
+#include "sdl2_slot_map.hh"
+#include "sdl2_smart_ptr.hh"
+
+#include <SDL.h>
+
+#include <string>
+#include <utility>  // move
+#include <vector>
+
+static std::string collectErrorQuitSdl(const std::string& func_name) {
+    std::string err { SDL_GetError() };
+    SDL_ClearError();
+    if (err.size() == 0) {
+        err = "failure without setting SDL error";
+    }
+    SDL_Quit();
+    return func_name + ": " + err;
+}
+
+using namespace sdl2_smart_ptr;
+
+static SDL_Surface* createSurface(int w) {
+    return SDL_CreateRGBSurfaceWithFormat(0, w, 4, 32, SDL_PIXELFORMAT_RGBA32);
+}
+
+// creates surface on another thread, returned by handing over a shared::Surface
+static int createSurfaceThread(void* sp_surface) {
+    *static_cast<shared::Surface*>(sp_surface) = make_shared(createSurface(8));
+    return 0;
+}
+
+TEST_CASE("SDL core live resource accounting: ResourceStats",
+    "[sdl2_smart_ptr][SDL2][core][ResourceStats]")
+{
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    SDL_Surface* surface { createSurface(1) };
+    if (surface == nullptr) {
+        SKIP(collectErrorQuitSdl("SDL_CreateRGBSurfaceWithFormat"));
+    }
+    SDL_FreeSurface(surface);
+
+    // other tests may leave counts behind, so compare against baseline
+    const ResourceStats before { resourceStats(ResourceType::Surface) };
+    resetResourcePeaks();
+
+#ifdef SDL2_SMART_PTRS_ACCOUNT_RESOURCES
+    SECTION("factories count live handles and bytes")
+    {
+        {
+            auto up_surface { make_unique(createSurface(2)) };
+            auto sp_surface { make_shared(createSurface(4)) };
+            REQUIRE(up_surface != nullptr);
+            REQUIRE(sp_surface != nullptr);
+            const auto stats { resourceStats(ResourceType::Surface) };
+            REQUIRE(stats.live - before.live == 2);
+            REQUIRE(stats.bytes - before.bytes ==
+                    up_surface->pitch * up_surface->h + sp_surface->pitch * sp_surface->h);
+            REQUIRE(stats.created - before.created == 2);
+            REQUIRE(resourceReport().find("Surface: ") != std::string::npos);
+        }
+        const auto stats { resourceStats(ResourceType::Surface) };
+        REQUIRE(stats.live == before.live);
+        REQUIRE(stats.bytes == before.bytes);
+        REQUIRE(stats.peak_live - before.live == 2);
+        REQUIRE(stats.destroyed - before.destroyed == 2);
+    }
+    SECTION("pointers not made by factories are not counted")
+    {
+        {
+            unique::Surface up_surface { createSurface(2) };
+            REQUIRE(resourceStats(ResourceType::Surface).live == before.live);
+        }
+        REQUIRE(resourceStats(ResourceType::Surface).destroyed == before.destroyed);
+    }
+    SECTION("creation and destruction on different threads")
+    {
+        shared::Surface sp_surface;
+        unique::Thread creator { make_unique(
+            SDL_CreateThread(createSurfaceThread, "createSurfaceThread", &sp_surface)) };
+        REQUIRE(creator != nullptr);
+        creator.reset();  // joins, retiring creator's counters
+        REQUIRE(sp_surface != nullptr);
+        REQUIRE(resourceStats(ResourceType::Surface).live - before.live == 1);
+        sp_surface.reset();
+        REQUIRE(resourceStats(ResourceType::Surface).live == before.live);
+    }
+    SECTION("ownership passed to graveyard or slot map stays counted")
+    {
+        {
+            Graveyard graveyard;
+            auto up_surface { make_deferred(make_unique(createSurface(2)), graveyard) };
+            up_surface.reset();
+            REQUIRE(resourceStats(ResourceType::Surface).live - before.live == 1);
+            graveyard.drainAll();
+            REQUIRE(resourceStats(ResourceType::Surface).live == before.live);
+
+            slot_map::Surface surfaces;
+            const auto a { surfaces.insert(createSurface(2)) };
+            surfaces.insert(make_unique(createSurface(2)));
+            REQUIRE(resourceStats(ResourceType::Surface).live - before.live == 2);
+            auto extracted { surfaces.extract(a) };
+            surfaces.clear();
+            REQUIRE(resourceStats(ResourceType::Surface).live - before.live == 1);
+            REQUIRE(resourceLeakReport().find("Surface: ") != std::string::npos);
+        }
+        REQUIRE(resourceStats(ResourceType::Surface).live == before.live);
+    }
+    SECTION("slot map abandon settles counts and bytes at once")
+    {
+        slot_map::Surface surfaces;
+        SDL_Surface* a_ptr { createSurface(2) };
+        SDL_Surface* b_ptr { createSurface(4) };
+        surfaces.insert(a_ptr);
+        const auto b { surfaces.insert(b_ptr) };
+        surfaces.release(surfaces.insert(createSurface(8)));
+        auto extracted { surfaces.extract(b) };
+        surfaces.insert(std::move(extracted));
+        REQUIRE(resourceStats(ResourceType::Surface).live - before.live == 2);
+        surfaces.abandon();
+        const auto stats { resourceStats(ResourceType::Surface) };
+        REQUIRE(stats.live == before.live);
+        REQUIRE(stats.bytes == before.bytes);
+        REQUIRE(stats.destroyed - before.destroyed == 3);
+        SDL_FreeSurface(a_ptr);
+        SDL_FreeSurface(b_ptr);
+    }
+#else
+    SECTION("accounting off keeps deleters empty and records nothing")
+    {
+        STATIC_REQUIRE(sizeof(unique::Surface) == sizeof(SDL_Surface*));
+        auto up_surface { make_unique(createSurface(2)) };
+        REQUIRE(up_surface != nullptr);
+        const auto stats { resourceStats(ResourceType::Surface) };
+        REQUIRE(stats.live == 0);
+        REQUIRE(stats.created == before.created);
+        REQUIRE(resourceReport().empty());
+    }
+#endif
+
+    SDL_Quit();
+}
@@ -0,0 +1,184 @@
+#include <catch2/catch_version_macros.hpp>               // CATCH_VERSION_MAJOR
+#if (CATCH_VERSION_MAJOR != 3)
+  #error "tests currently only support Catch2 v3.x"
+#endif
+#include <catch2/catch_test_macros.hpp>                  // TEST_CASE, SECTION, REQUIRE
+#include <catch2/benchmark/catch_benchmark.hpp>          // BENCHMARK
+
+#include "sdl2_slot_map.hh"
+
+#include <SDL.h>
+
+#include <memory>     // unique_ptr
+#include <stdexcept>  // invalid_argument
+#include <string>
+#include <vector>
+
+static std::string collectErrorQuitSdl(const std::string& func_name) {
+    std::string err { SDL_GetError() };
+    SDL_ClearError();
+    if (err.size() == 0) {
+        err = "failure without setting SDL error";
+    }
+    SDL_Quit();
+    return func_name + ": " + err;
+}
+
+using namespace sdl2_smart_ptr;
+
+// frees surface, counting calls
+static int destroyed_ct {};
+
+struct CountingSurfaceDeleter {
+    void operator()(SDL_Surface* sp) const {
+        ++destroyed_ct;
+        SDL_FreeSurface(sp);
+    }
+};
+
+static SDL_Surface* createSurface(int w) {
+    return SDL_CreateRGBSurfaceWithFormat(0, w, 1, 32, SDL_PIXELFORMAT_RGBA32);
+}
+
+TEST_CASE("SDL core generational handles: SlotMap",
+    "[sdl2_smart_ptr][SDL2][core][SlotMap]")
+{
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    SDL_Surface* surface { createSurface(1) };
+    if (surface == nullptr) {
+        SKIP(collectErrorQuitSdl("SDL_CreateRGBSurfaceWithFormat"));
+    }
+    SDL_FreeSurface(surface);
+    destroyed_ct = 0;
+
+    SECTION("handles resolve to inserted pointers")
+    {
+        slot_map::Surface surfaces;
+        SDL_Surface* a_ptr { createSurface(1) };
+        const auto a { surfaces.insert(a_ptr) };
+        const auto b { surfaces.insert(make_unique(createSurface(2))) };
+        REQUIRE(a);
+        REQUIRE(a != b);
+        REQUIRE(surfaces.size() == 2);
+        REQUIRE(surfaces.get(a) == a_ptr);
+        REQUIRE(surfaces.get(b)->w == 2);
+        REQUIRE_FALSE(surfaces.contains(slot_map::Surface::Handle{}));
+        REQUIRE_THROWS_AS(surfaces.insert(static_cast<SDL_Surface*>(nullptr)),
+                          std::invalid_argument);
+    }
+    SECTION("stale handles after slot reuse")
+    {
+        SlotMap<SDL_Surface, CountingSurfaceDeleter> surfaces;
+        const auto a { surfaces.insert(createSurface(1)) };
+        REQUIRE(surfaces.release(a));
+        REQUIRE(destroyed_ct == 1);
+        REQUIRE_FALSE(surfaces.release(a));
+        const auto b { surfaces.insert(createSurface(2)) };
+        // same slot, next generation
+        REQUIRE((b.value & surfaces.INDEX_MASK) == (a.value & surfaces.INDEX_MASK));
+        REQUIRE_FALSE(surfaces.contains(a));
+        REQUIRE(surfaces.get(a) == nullptr);
+        REQUIRE(surfaces.get(b)->w == 2);
+    }
+    SECTION("extract transfers ownership")
+    {
+        SlotMap<SDL_Surface, CountingSurfaceDeleter> surfaces;
+        const auto a { surfaces.insert(createSurface(1)) };
+        {
+            auto up_surface { surfaces.extract(a) };
+            REQUIRE(up_surface != nullptr);
+            REQUIRE(surfaces.empty());
+            REQUIRE(destroyed_ct == 0);
+            REQUIRE(surfaces.extract(a) == nullptr);
+        }
+        REQUIRE(destroyed_ct == 1);
+    }
+    SECTION("dense iteration stays packed after removals")
+    {
+        SlotMap<SDL_Surface, CountingSurfaceDeleter> surfaces;
+        std::vector<SlotHandle<SDL_Surface>> handles;
+        for (int w { 1 }; w <= 10; ++w)
+            handles.push_back(surfaces.insert(createSurface(w)));
+        for (std::size_t i {}; i < handles.size(); i += 2)
+            REQUIRE(surfaces.release(handles[i]));
+        REQUIRE(surfaces.size() == 5);
+        int w_sum {};
+        for (const SDL_Surface* sp : surfaces)
+            w_sum += sp->w;
+        REQUIRE(w_sum == 2 + 4 + 6 + 8 + 10);
+        for (std::size_t i {}; i < surfaces.size(); ++i)
+            REQUIRE(surfaces.get(surfaces.handleAt(i)) == *(surfaces.begin() + long(i)));
+    }
+    SECTION("clear and destruction run deleter")
+    {
+        {
+            SlotMap<SDL_Surface, CountingSurfaceDeleter> surfaces;
+            const auto a { surfaces.insert(createSurface(1)) };
+            surfaces.insert(createSurface(2));
+            surfaces.clear();
+            REQUIRE(destroyed_ct == 2);
+            REQUIRE_FALSE(surfaces.contains(a));
+            surfaces.insert(createSurface(3));
+        }
+        REQUIRE(destroyed_ct == 3);
+    }
+    SECTION("abandon forgets elements without running deleter")
+    {
+        SlotMap<SDL_Surface, CountingSurfaceDeleter> surfaces;
+        SDL_Surface* a_ptr { createSurface(1) };
+        SDL_Surface* b_ptr { createSurface(2) };
+        const auto a { surfaces.insert(a_ptr) };
+        surfaces.insert(b_ptr);
+        surfaces.abandon();
+        REQUIRE(destroyed_ct == 0);
+        REQUIRE(surfaces.empty());
+        REQUIRE_FALSE(surfaces.contains(a));
+        // as if freed at once by their owner
+        SDL_FreeSurface(a_ptr);
+        SDL_FreeSurface(b_ptr);
+    }
+
+    SDL_Quit();
+}
+
+TEST_CASE("SDL core generational handles iteration: SlotMap",
+    "[.][benchmark][sdl2_smart_ptr][SDL2][core][SlotMap]")
+{
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    {
+        slot_map::Surface slot_surfaces;
+        std::vector<shared::Surface> shared_surfaces;
+        std::vector<slot_map::Surface::Handle> handles;
+        for (int i {}; i < 10000; ++i) {
+            handles.push_back(slot_surfaces.insert(createSurface(1 + i % 16)));
+            shared_surfaces.push_back(make_shared(createSurface(1 + i % 16)));
+        }
+
+        BENCHMARK("10000 surfaces, SlotMap dense iteration") {
+            long w_sum {};
+            for (const SDL_Surface* sp : slot_surfaces)
+                w_sum += sp->w;
+            return w_sum;
+        };
+        BENCHMARK("10000 surfaces, SlotMap handle lookup") {
+            long w_sum {};
+            for (const auto handle : handles)
+                w_sum += slot_surfaces.get(handle)->w;
+            return w_sum;
+        };
+        BENCHMARK("10000 surfaces, vector<shared::Surface> iteration") {
+            long w_sum {};
+            for (const shared::Surface& sp_surface : shared_surfaces)
+                w_sum += sp_surface->w;
+            return w_sum;
+        };
+    }
+
+    SDL_Quit();
+}
@@ -362,6 +362,59 @@ TEST_CASE("SDL core allocations: SDL_Texture",
     SDL_Quit();
 }
 
+static int setFlagThread(void* flag) {
+    SDL_Delay(10);
+    *static_cast<int*>(flag) = 1;
+    return 0;
+}
+
+TEST_CASE("SDL core allocations: SDL_Thread",
+    "[sdl2_smart_ptr][SDL2][core][SDL_Thread]")
+{
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    int flag {};
+    SDL_Thread* thread {
+        SDL_CreateThread(setFlagThread, "setFlagThread", &flag)
+    };
+    if (thread == nullptr) {
+        SKIP(collectErrorQuitSdl("SDL_CreateThread"));
+    }
+
+    deleter::Thread dltr;
+
+    // deleter joins, so thread has always finished after handle is gone
+    SECTION("direct use of deleter after manual allocation")
+    {
+        dltr(thread);
+    }
+    SECTION("unique:: ctor")
+    {
+        unique::Thread up_thread{thread, dltr};
+        REQUIRE(up_thread.get() == thread);
+    }
+    SECTION("make_unique")
+    {
+        auto up_thread{ make_unique(thread) };
+        REQUIRE(up_thread.get() == thread);
+    }
+    SECTION("shared:: ctor")
+    {
+        shared::Thread sp_thread{thread, dltr};
+        REQUIRE(sp_thread.get() == thread);
+    }
+    SECTION("make_shared")
+    {
+        auto sp_thread{ make_shared(thread) };
+        REQUIRE(sp_thread.get() == thread);
+    }
+    REQUIRE(flag == 1);
+
+    SDL_Quit();
+}
+
 TEST_CASE("SDL core allocations: SDL_Window",
     "[sdl2_smart_ptr][SDL2][core][SDL_Window]")
 {
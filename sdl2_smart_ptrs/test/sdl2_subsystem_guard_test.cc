@@ -0,0 +1,168 @@
+#include <catch2/catch_version_macros.hpp>               // CATCH_VERSION_MAJOR
+#if (CATCH_VERSION_MAJOR != 3)
+  #error "tests currently only support Catch2 v3.x"
+#endif
+#include <catch2/catch_test_macros.hpp>                  // TEST_CASE, SECTION, REQUIRE
+#include <catch2/benchmark/catch_benchmark.hpp>          // BENCHMARK
+
+#include "sdl2_subsystem_guard.hh"
+
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_ttf.h>
+
+#include <optional>
+#include <stdexcept>  // runtime_error
+#include <string>
+
+
+using namespace sdl2_smart_ptr;
+
+TEST_CASE("SDL subsystem guards: guard::",
+    "[sdl2_smart_ptr][SDL2][SDL_ttf][SDL_net][SDL_image][guard]")
+{
+    {
+        guard::Sdl sdl { SDL_INIT_EVENTS };
+        REQUIRE(SDL_WasInit(SDL_INIT_EVENTS) == SDL_INIT_EVENTS);
+
+        SECTION("SDL_ttf")
+        {
+            {
+                guard::Ttf ttf;
+                REQUIRE(TTF_WasInit() == 1);
+            }
+            REQUIRE(TTF_WasInit() == 0);
+        }
+        SECTION("SDL_net, SDL_image")
+        {
+            guard::Net net;
+            guard::Img img { 0 };
+        }
+        SECTION("IMG_Init of unknown flags throws")
+        {
+            std::optional<guard::Img> img;
+            REQUIRE_THROWS_AS(img.emplace(0x1000), std::runtime_error);
+            REQUIRE(!img.has_value());
+        }
+    }
+    REQUIRE(SDL_WasInit(0) == 0);
+}
+
+TEST_CASE("SDL subsystem guards: Subsystems",
+    "[sdl2_smart_ptr][SDL2][SDL_ttf][SDL_net][SDL_image][SDL_mixer][Subsystems]")
+{
+    SECTION("SDL initialized by constructor, rest lazily")
+    {
+        {
+            Subsystems subsystems { SubsystemConfig { SDL_INIT_EVENTS } };
+            REQUIRE(SDL_WasInit(SDL_INIT_EVENTS) == SDL_INIT_EVENTS);
+            REQUIRE(subsystems.isInitialized(Subsystem::Sdl));
+            REQUIRE(subsystems.initTime(Subsystem::Sdl).count() > 0);
+            REQUIRE(!subsystems.isInitialized(Subsystem::Ttf));
+            REQUIRE(TTF_WasInit() == 0);
+            REQUIRE(subsystems.initTime(Subsystem::Ttf).count() == 0);
+
+            subsystems.require(Subsystem::Ttf);
+            REQUIRE(subsystems.isInitialized(Subsystem::Ttf));
+            REQUIRE(TTF_WasInit() == 1);
+            // only once
+            subsystems.require(Subsystem::Ttf);
+            REQUIRE(TTF_WasInit() == 1);
+            REQUIRE(subsystems.initReport().find("SDL_ttf: ") != std::string::npos);
+            REQUIRE(subsystems.initReport().find("SDL_net") == std::string::npos);
+        }
+        REQUIRE(TTF_WasInit() == 0);
+        REQUIRE(SDL_WasInit(0) == 0);
+    }
+    SECTION("initAsync on worker threads")
+    {
+        {
+            Subsystems subsystems;
+            subsystems.initAsync({ Subsystem::Img, Subsystem::Ttf, Subsystem::Net });
+            // started again by neither
+            subsystems.initAsync({ Subsystem::Ttf });
+            subsystems.require(Subsystem::Ttf);
+            REQUIRE(TTF_WasInit() == 1);
+            subsystems.require(Subsystem::Img);
+            subsystems.require(Subsystem::Net);
+            for (const Subsystem subsystem :
+                     { Subsystem::Img, Subsystem::Ttf, Subsystem::Net }) {
+                REQUIRE(subsystems.isInitialized(subsystem));
+            }
+            const std::string report { subsystems.initReport() };
+            REQUIRE(report.find("SDL: ") == 0);
+            REQUIRE(report.find("SDL_image: ") != std::string::npos);
+            REQUIRE(report.find("SDL_net: ") != std::string::npos);
+        }
+        REQUIRE(TTF_WasInit() == 0);
+        REQUIRE(SDL_WasInit(0) == 0);
+    }
+    SECTION("destroyed while initializing")
+    {
+        {
+            Subsystems subsystems;
+            subsystems.initAsync({ Subsystem::Img, Subsystem::Ttf, Subsystem::Net });
+        }
+        REQUIRE(TTF_WasInit() == 0);
+        REQUIRE(SDL_WasInit(0) == 0);
+    }
+    SECTION("failures are rethrown by every require")
+    {
+        SubsystemConfig config;
+        config.img_flags = 0x1000;
+        Subsystems subsystems { config };
+        subsystems.initAsync({ Subsystem::Img });
+        REQUIRE_THROWS_AS(subsystems.require(Subsystem::Img), std::runtime_error);
+        REQUIRE_THROWS_AS(subsystems.require(Subsystem::Img), std::runtime_error);
+        REQUIRE(!subsystems.isInitialized(Subsystem::Img));
+        REQUIRE(subsystems.initReport().find("SDL_image: ") != std::string::npos);
+        REQUIRE(subsystems.initReport().find("(failed)") != std::string::npos);
+    }
+    SECTION("SDL_mixer, with audio subsystem")
+    {
+        {
+            Subsystems subsystems;
+            subsystems.initAsync({ Subsystem::Mix });
+            try {
+                subsystems.require(Subsystem::Mix);
+            } catch (const std::runtime_error& e) {
+                // no audio device
+                SKIP(e.what());
+            }
+            REQUIRE(SDL_WasInit(SDL_INIT_AUDIO) == SDL_INIT_AUDIO);
+            REQUIRE(subsystems.isInitialized(Subsystem::Mix));
+            REQUIRE(subsystems.initTime(Subsystem::Mix).count() > 0);
+        }
+        REQUIRE(SDL_WasInit(0) == 0);
+    }
+}
+
+TEST_CASE("SDL subsystem initialization: serial and initAsync",
+    "[.][benchmark][sdl2_smart_ptr][SDL2][SDL_ttf][SDL_net][SDL_image][SDL_mixer]"
+    "[Subsystems]")
+{
+    const SubsystemConfig config { SDL_INIT_EVENTS, IMG_INIT_PNG | IMG_INIT_JPG };
+    const auto requireAll { [](Subsystems& subsystems){
+        for (const Subsystem subsystem :
+                 { Subsystem::Img, Subsystem::Ttf, Subsystem::Net, Subsystem::Mix }) {
+            subsystems.require(subsystem);
+        }
+    } };
+    try {
+        Subsystems subsystems { config };
+        requireAll(subsystems);
+        SDL_Log("Subsystems serial initialization:\n%s", subsystems.initReport().c_str());
+    } catch (const std::runtime_error& e) {
+        SKIP(e.what());
+    }
+
+    BENCHMARK("serial") {
+        Subsystems subsystems { config };
+        requireAll(subsystems);
+    };
+    BENCHMARK("initAsync") {
+        Subsystems subsystems { config };
+        subsystems.initAsync({ Subsystem::Img, Subsystem::Ttf, Subsystem::Net, Subsystem::Mix });
+        requireAll(subsystems);
+    };
+}
@@ -0,0 +1,78 @@
+#include "consumer_parker.hh"
+
+#include "safeSdlCall.hh"
+
+#include "SDL_mutex.h"  // SDL_CreateSemaphore SDL_SemWait SDL_SemPost
+
+
+namespace sdl2_thread_util {
+
+static const SdlRetTest<int> sdl_int_test {
+    [](const int ret){ return (ret < 0); }
+};
+
+ConsumerParker::ConsumerParker() :
+    sem_(sdl2_smart_ptr::make_unique(
+             safeSdlCall(SDL_CreateSemaphore, "SDL_CreateSemaphore",
+                         SdlRetTest<SDL_sem*>{
+                             [](const SDL_sem* ret){ return (ret == nullptr); } },
+                         Uint32(0)))) {}
+
+void ConsumerParker::prepareWait() {
+    // orders this increment before consumer's recheck of queue, pairing
+    //   with notifyOne
+    waiter_ct_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+void ConsumerParker::cancelWait() {
+    // if a producer already claimed this waiter, its post is left as a
+    //   spurious wakeup
+    claimWaiter();
+}
+
+void ConsumerParker::wait() {
+    safeSdlCall(SDL_SemWait, "SDL_SemWait", sdl_int_test, sem_.get());
+}
+
+bool ConsumerParker::waitTimeout(Uint32 timeout_ms) {
+    const int ret {
+        safeSdlCall(SDL_SemWaitTimeout, "SDL_SemWaitTimeout", sdl_int_test,
+                    sem_.get(), timeout_ms)
+    };
+    if (ret == SDL_MUTEX_TIMEDOUT) {
+        // waiter no longer parked; same caveat as cancelWait
+        claimWaiter();
+        return false;
+    }
+    return true;
+}
+
+bool ConsumerParker::claimWaiter() {
+    int waiter_ct { waiter_ct_.load(std::memory_order_relaxed) };
+    while (waiter_ct > 0) {
+        if (waiter_ct_.compare_exchange_weak(waiter_ct, waiter_ct - 1,
+                                             std::memory_order_seq_cst,
+                                             std::memory_order_relaxed))
+            return true;
+    }
+    return false;
+}
+
+void ConsumerParker::notifyOne() {
+    // orders producer's push before load of waiter count, pairing with
+    //   prepareWait
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiter_ct_.load(std::memory_order_relaxed) == 0)
+        return;
+    if (claimWaiter())
+        safeSdlCall(SDL_SemPost, "SDL_SemPost", sdl_int_test, sem_.get());
+}
+
+void ConsumerParker::notifyAll() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (claimWaiter())
+        safeSdlCall(SDL_SemPost, "SDL_SemPost", sdl_int_test, sem_.get());
+}
+
+}  // namespace sdl2_thread_util
@@ -0,0 +1,55 @@
+#ifndef CONSUMER_PARKER_HH
+#define CONSUMER_PARKER_HH
+
+#include "sdl2_smart_ptr.hh"  // unique::Semaphore
+
+#include "SDL_stdinc.h"       // Uint32
+
+#include <atomic>
+
+
+namespace sdl2_thread_util {
+
+/*
+ * Parks idle consumers of a lock-free queue on an SDL_sem, so producers only
+ *   make an SDL call when a consumer is waiting. Consumers must loop, as a
+ *   canceled wait can leave a spurious wakeup:
+ * ```
+ * while (!queue.tryPop(item)) {
+ *     parker.prepareWait();
+ *     if (queue.tryPop(item)) {
+ *         parker.cancelWait();
+ *         break;
+ *     }
+ *     parker.wait();
+ * }
+ * ```
+ * Producers call notifyOne() after each push.
+ */
+class ConsumerParker {
+public:
+    ConsumerParker();
+
+    void prepareWait();
+    void cancelWait();
+    void wait();
+    // returns false on timeout
+    bool waitTimeout(Uint32 timeout_ms);
+
+    void notifyOne();
+    void notifyAll();
+
+    int waiterCount() const { return waiter_ct_.load(std::memory_order_relaxed); }
+
+private:
+    // decrements waiter_ct_ if positive, returns true if decremented
+    bool claimWaiter();
+
+    std::atomic<int> waiter_ct_ {};
+    sdl2_smart_ptr::unique::Semaphore sem_;
+};
+
+}  // namespace sdl2_thread_util
+
+
+#endif  // CONSUMER_PARKER_HH
@@ -0,0 +1,118 @@
+#ifndef JOB_SYSTEM_HH
+#define JOB_SYSTEM_HH
+
+#include "consumer_parker.hh"
+
+#include "sdl2_smart_ptr.hh"  // unique::Thread
+
+#include <atomic>
+#include <cstddef>            // size_t
+#include <deque>
+#include <exception>          // exception_ptr
+#include <functional>         // function
+#include <memory>             // shared_ptr unique_ptr
+#include <mutex>
+#include <vector>
+
+
+namespace sdl2_thread_util {
+
+class JobSystem;
+
+namespace detail {
+
+struct Job {
+    std::function<void()> func;
+    // unfinished dependencies, plus one held by submit() until scheduling
+    std::atomic<int> blocking_ct {};
+    std::atomic<bool> done {};
+    std::exception_ptr exception;
+    // guards dependents and order of done being set vs dependents added
+    std::mutex mutex;
+    std::vector<std::shared_ptr<Job>> dependents;
+};
+
+}  // namespace detail
+
+using JobHandle = std::shared_ptr<detail::Job>;
+
+/*
+ * Work-stealing job scheduler. Each worker thread owns a deque of ready jobs:
+ *   jobs submitted from a worker go to the back of its own deque and are run
+ *   newest first, for cache locality, while idle workers steal the oldest
+ *   job from the front of others' deques. Jobs submitted from other threads
+ *   are dealt out round robin. Workers with nothing to run or steal park on
+ *   an SDL_sem (see ConsumerParker).
+ *
+ * A job may list other jobs as dependencies, and only becomes ready once all
+ *   of them have finished. wait() runs other ready jobs while the awaited job
+ *   is unfinished, so waiting from inside a job does not deadlock, and
+ *   rethrows any exception thrown by the job.
+ *
+ * Workers are unique::Threads, joined on destruction after all submitted jobs
+ *   have run.
+ */
+class JobSystem {
+public:
+    // worker_ct 0 uses one worker per CPU reported by SDL_GetCPUCount, less
+    //   one for the thread calling wait()
+    explicit JobSystem(int worker_ct = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    JobHandle submit(std::function<void()> func,
+                     const std::vector<JobHandle>& dependencies = {});
+    void wait(const JobHandle& job);
+    // waits for all jobs before rethrowing first exception
+    void waitAll(const std::vector<JobHandle>& jobs);
+
+    // calls func(range_begin, range_end) for chunks of [begin, end) of
+    //   grain_size indices in parallel, and waits for all of them; grain_size
+    //   0 makes 4 chunks per worker
+    void parallelFor(std::size_t begin, std::size_t end, std::size_t grain_size,
+                     const std::function<void(std::size_t, std::size_t)>& func);
+
+    int workerCount() const { return int(workers_.size()); }
+    std::size_t stealCount() const { return steal_ct_.load(std::memory_order_relaxed); }
+
+private:
+    struct WorkerDeque {
+        std::mutex mutex;
+        std::deque<JobHandle> jobs;
+    };
+
+    struct WorkerArgs {
+        JobSystem* system;
+        std::size_t index;
+    };
+
+    static int workerMain(void* data);
+    void workerLoop();
+    void stopWorkers();
+
+    void schedule(JobHandle job);
+    // runs one ready job, preferring own deque when called from a worker;
+    //   returns false if none was found
+    bool runOne();
+    JobHandle popOwn(std::size_t index);
+    JobHandle steal(std::size_t thief_index);
+    void run(const JobHandle& job);
+    void finish(const JobHandle& job);
+
+    std::vector<std::unique_ptr<WorkerDeque>> deques_;
+    std::vector<std::unique_ptr<WorkerArgs>> worker_args_;
+    std::atomic<std::size_t> ready_ct_ {};
+    std::atomic<std::size_t> next_deque_ {};
+    std::atomic<std::size_t> steal_ct_ {};
+    std::atomic<bool> stopping_ {};
+    ConsumerParker parker_;
+    // last member, so workers are joined before anything they use is destroyed
+    std::vector<sdl2_smart_ptr::unique::Thread> workers_;
+};
+
+}  // namespace sdl2_thread_util
+
+
+#endif  // JOB_SYSTEM_HH
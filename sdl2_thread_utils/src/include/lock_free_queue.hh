@@ -0,0 +1,257 @@
+#ifndef LOCK_FREE_QUEUE_HH
+#define LOCK_FREE_QUEUE_HH
+
+#include "consumer_parker.hh"
+
+#include "SDL_stdinc.h"  // Uint32
+
+#include <atomic>
+#include <cstddef>       // size_t ptrdiff_t
+#include <memory>        // unique_ptr
+#include <stdexcept>     // invalid_argument
+#include <thread>        // this_thread::yield
+#include <utility>       // forward move
+
+
+namespace sdl2_thread_util {
+
+namespace detail {
+
+// keeps producer and consumer indices from sharing a cache line
+constexpr std::size_t CACHE_LINE_SIZE { 64 };
+
+inline std::size_t roundUpPow2(std::size_t capacity) {
+    if (capacity > (std::size_t(1) << (sizeof(std::size_t) * 8 - 2)))
+        throw std::invalid_argument("lock free queue: capacity too large");
+    std::size_t pow2 { 2 };
+    while (pow2 < capacity)
+        pow2 <<= 1;
+    return pow2;
+}
+
+}  // namespace detail
+
+/*
+ * Bounded single producer, single consumer queue. Push and pop are wait-free;
+ *   pop() and popTimeout() park the consumer on an SDL_sem while the queue is
+ *   empty (see ConsumerParker). A full queue makes push() yield until there
+ *   is room, and tryPush() fail.
+ *
+ * Capacity is rounded up to a power of 2. T must be default constructible
+ *   and move assignable, and popped slots are left moved-from.
+ */
+template<typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(std::size_t capacity) :
+        capacity_(detail::roundUpPow2(capacity)), mask_(capacity_ - 1),
+        buffer_(std::make_unique<T[]>(capacity_)) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // producer thread only
+    template<typename U>
+    bool tryPush(U&& item) {
+        const std::size_t tail { tail_.load(std::memory_order_relaxed) };
+        if (tail - head_cache_ == capacity_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ == capacity_)
+                return false;
+        }
+        buffer_[tail & mask_] = std::forward<U>(item);
+        tail_.store(tail + 1, std::memory_order_release);
+        parker_.notifyOne();
+        return true;
+    }
+
+    template<typename U>
+    void push(U&& item) {
+        while (!tryPush(std::forward<U>(item)))
+            std::this_thread::yield();
+    }
+
+    // consumer thread only
+    bool tryPop(T& item) {
+        const std::size_t head { head_.load(std::memory_order_relaxed) };
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_)
+                return false;
+        }
+        item = std::move(buffer_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    void pop(T& item) {
+        while (!tryPop(item)) {
+            parker_.prepareWait();
+            if (tryPop(item)) {
+                parker_.cancelWait();
+                return;
+            }
+            parker_.wait();
+        }
+    }
+
+    // returns false if no item arrived within timeout_ms of last wakeup
+    bool popTimeout(T& item, Uint32 timeout_ms) {
+        while (!tryPop(item)) {
+            parker_.prepareWait();
+            if (tryPop(item)) {
+                parker_.cancelWait();
+                return true;
+            }
+            if (!parker_.waitTimeout(timeout_ms))
+                return tryPop(item);
+        }
+        return true;
+    }
+
+    std::size_t capacity() const { return capacity_; }
+    // exact only when called from producer or consumer with the other idle
+    std::size_t sizeApprox() const {
+        return tail_.load(std::memory_order_acquire) -
+            head_.load(std::memory_order_acquire);
+    }
+
+private:
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::unique_ptr<T[]> buffer_;
+    ConsumerParker parker_;
+
+    // consumer side
+    alignas(detail::CACHE_LINE_SIZE) std::atomic<std::size_t> head_ {};
+    std::size_t tail_cache_ {};
+    // producer side
+    alignas(detail::CACHE_LINE_SIZE) std::atomic<std::size_t> tail_ {};
+    std::size_t head_cache_ {};
+};
+
+/*
+ * Bounded multiple producer, multiple consumer queue, after Dmitry Vyukov's
+ *   design: each slot carries a sequence number, so producers and consumers
+ *   each claim a slot with one compare-and-swap and never contend on a lock.
+ *   Consumers park on an SDL_sem while the queue is empty, as in SpscQueue.
+ *
+ * Capacity is rounded up to a power of 2. T must be default constructible
+ *   and move assignable, and popped slots are left moved-from.
+ */
+template<typename T>
+class MpmcQueue {
+public:
+    explicit MpmcQueue(std::size_t capacity) :
+        capacity_(detail::roundUpPow2(capacity)), mask_(capacity_ - 1),
+        cells_(std::make_unique<Cell[]>(capacity_)) {
+        for (std::size_t i {}; i < capacity_; ++i)
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    template<typename U>
+    bool tryPush(U&& item) {
+        Cell* cell;
+        std::size_t pos { enqueue_pos_.load(std::memory_order_relaxed) };
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            const std::size_t seq { cell->sequence.load(std::memory_order_acquire) };
+            const std::ptrdiff_t diff { std::ptrdiff_t(seq) - std::ptrdiff_t(pos) };
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+                                                       std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;  // full
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = std::forward<U>(item);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        parker_.notifyOne();
+        return true;
+    }
+
+    template<typename U>
+    void push(U&& item) {
+        while (!tryPush(std::forward<U>(item)))
+            std::this_thread::yield();
+    }
+
+    bool tryPop(T& item) {
+        Cell* cell;
+        std::size_t pos { dequeue_pos_.load(std::memory_order_relaxed) };
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            const std::size_t seq { cell->sequence.load(std::memory_order_acquire) };
+            const std::ptrdiff_t diff { std::ptrdiff_t(seq) - std::ptrdiff_t(pos + 1) };
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1,
+                                                       std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;  // empty
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        item = std::move(cell->value);
+        cell->sequence.store(pos + capacity_, std::memory_order_release);
+        return true;
+    }
+
+    void pop(T& item) {
+        while (!tryPop(item)) {
+            parker_.prepareWait();
+            if (tryPop(item)) {
+                parker_.cancelWait();
+                return;
+            }
+            parker_.wait();
+        }
+    }
+
+    // returns false if no item arrived within timeout_ms of last wakeup
+    bool popTimeout(T& item, Uint32 timeout_ms) {
+        while (!tryPop(item)) {
+            parker_.prepareWait();
+            if (tryPop(item)) {
+                parker_.cancelWait();
+                return true;
+            }
+            if (!parker_.waitTimeout(timeout_ms))
+                return tryPop(item);
+        }
+        return true;
+    }
+
+    std::size_t capacity() const { return capacity_; }
+    std::size_t sizeApprox() const {
+        const std::size_t enqueued { enqueue_pos_.load(std::memory_order_acquire) };
+        const std::size_t dequeued { dequeue_pos_.load(std::memory_order_acquire) };
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T value {};
+    };
+
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    ConsumerParker parker_;
+
+    alignas(detail::CACHE_LINE_SIZE) std::atomic<std::size_t> enqueue_pos_ {};
+    alignas(detail::CACHE_LINE_SIZE) std::atomic<std::size_t> dequeue_pos_ {};
+};
+
+}  // namespace sdl2_thread_util
+
+
+#endif  // LOCK_FREE_QUEUE_HH
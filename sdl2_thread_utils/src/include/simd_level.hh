@@ -0,0 +1,34 @@
+#ifndef SIMD_LEVEL_HH
+#define SIMD_LEVEL_HH
+
+#include <cstddef>  // size_t
+
+
+namespace sdl2_thread_util {
+
+// x86 instruction sets that SIMD kernels are compiled for, each library
+//   building its kernels for some of them and choosing one at runtime
+enum class SimdLevel {
+    Scalar,
+    Sse2,
+    Sse41,
+    Avx2
+};
+constexpr std::size_t SIMD_LEVEL_CT { 4 };
+
+// for masks of levels a library has kernels for
+constexpr unsigned simdLevelBit(SimdLevel level) { return 1u << unsigned(level); }
+
+// as reported by SDL_HasSSE2/SDL_HasSSE41/SDL_HasAVX2, detected once;
+//   Scalar is always supported
+bool cpuSupports(SimdLevel level);
+// in built, a mask of simdLevelBit()s, and supported by the CPU
+bool simdLevelSupported(SimdLevel level, unsigned built);
+// highest level supported by both built and CPU
+SimdLevel bestSimdLevel(unsigned built);
+const char* simdLevelName(SimdLevel level);
+
+}  // namespace sdl2_thread_util
+
+
+#endif  // SIMD_LEVEL_HH
@@ -0,0 +1,245 @@
+#include "job_system.hh"
+
+#include "safeSdlCall.hh"
+
+#include "SDL_cpuinfo.h"  // SDL_GetCPUCount
+#include "SDL_thread.h"   // SDL_CreateThread
+
+#include <algorithm>      // max min
+#include <stdexcept>      // invalid_argument
+#include <string>
+#include <thread>         // this_thread::yield
+#include <utility>        // move
+
+
+namespace sdl2_thread_util {
+
+// identifies worker threads, so that their submissions go to their own deque
+static thread_local const JobSystem* tls_system {};
+static thread_local std::size_t tls_index {};
+
+JobSystem::JobSystem(int worker_ct) {
+    if (worker_ct < 0)
+        throw std::invalid_argument("JobSystem: worker_ct must not be negative");
+    if (worker_ct == 0)
+        worker_ct = std::max(1, SDL_GetCPUCount() - 1);
+
+    const std::size_t deque_ct { std::size_t(worker_ct) };
+    deques_.reserve(deque_ct);
+    worker_args_.reserve(deque_ct);
+    for (std::size_t i {}; i < deque_ct; ++i) {
+        deques_.push_back(std::make_unique<WorkerDeque>());
+        worker_args_.push_back(std::make_unique<WorkerArgs>(WorkerArgs{ this, i }));
+    }
+    workers_.reserve(deque_ct);
+    try {
+        for (std::size_t i {}; i < deque_ct; ++i) {
+            const std::string name { "JobSystem worker " + std::to_string(i) };
+            // SDL_CreateThread is a macro on some platforms, so can not be
+            //   passed to safeSdlCall directly
+            workers_.push_back(sdl2_smart_ptr::make_unique(
+                safeSdlCall([](SDL_ThreadFunction fn, const char* thread_name, void* data){
+                                return SDL_CreateThread(fn, thread_name, data); },
+                            "SDL_CreateThread",
+                            SdlRetTest<SDL_Thread*>{
+                                [](const SDL_Thread* ret){ return (ret == nullptr); } },
+                            &JobSystem::workerMain, name.c_str(),
+                            static_cast<void*>(worker_args_[i].get()))));
+        }
+    } catch (...) {
+        stopWorkers();
+        throw;
+    }
+}
+
+JobSystem::~JobSystem() {
+    stopWorkers();
+}
+
+// workers run remaining jobs before exiting
+void JobSystem::stopWorkers() {
+    stopping_ = true;
+    parker_.notifyAll();
+    workers_.clear();
+}
+
+int JobSystem::workerMain(void* data) {
+    const auto* args { static_cast<const WorkerArgs*>(data) };
+    tls_system = args->system;
+    tls_index = args->index;
+    args->system->workerLoop();
+    return 0;
+}
+
+void JobSystem::workerLoop() {
+    for (;;) {
+        if (runOne())
+            continue;
+        if (stopping_.load(std::memory_order_acquire))
+            return;
+        parker_.prepareWait();
+        if (ready_ct_.load(std::memory_order_relaxed) > 0 ||
+            stopping_.load(std::memory_order_relaxed)) {
+            parker_.cancelWait();
+            continue;
+        }
+        parker_.wait();
+    }
+}
+
+JobHandle JobSystem::submit(std::function<void()> func,
+                            const std::vector<JobHandle>& dependencies) {
+    auto job { std::make_shared<detail::Job>() };
+    job->func = std::move(func);
+    job->blocking_ct = int(dependencies.size()) + 1;
+    int satisfied_ct { 1 };
+    for (const auto& dependency : dependencies) {
+        if (dependency == nullptr) {
+            ++satisfied_ct;
+            continue;
+        }
+        std::lock_guard<std::mutex> lock { dependency->mutex };
+        if (dependency->done.load(std::memory_order_relaxed))
+            ++satisfied_ct;
+        else
+            dependency->dependents.push_back(job);
+    }
+    if (job->blocking_ct.fetch_sub(satisfied_ct, std::memory_order_acq_rel) == satisfied_ct)
+        schedule(job);
+    return job;
+}
+
+void JobSystem::schedule(JobHandle job) {
+    const std::size_t target {
+        tls_system == this ? tls_index :
+        next_deque_.fetch_add(1, std::memory_order_relaxed) % deques_.size()
+    };
+    {
+        WorkerDeque& deque { *deques_[target] };
+        std::lock_guard<std::mutex> lock { deque.mutex };
+        deque.jobs.push_back(std::move(job));
+    }
+    ready_ct_.fetch_add(1, std::memory_order_relaxed);
+    parker_.notifyOne();
+}
+
+bool JobSystem::runOne() {
+    JobHandle job;
+    if (tls_system == this) {
+        job = popOwn(tls_index);
+        if (job == nullptr)
+            job = steal(tls_index);
+    } else {
+        job = steal(next_deque_.load(std::memory_order_relaxed) % deques_.size());
+    }
+    if (job == nullptr)
+        return false;
+    run(job);
+    return true;
+}
+
+JobHandle JobSystem::popOwn(std::size_t index) {
+    WorkerDeque& deque { *deques_[index] };
+    std::lock_guard<std::mutex> lock { deque.mutex };
+    if (deque.jobs.empty())
+        return nullptr;
+    JobHandle job { std::move(deque.jobs.back()) };
+    deque.jobs.pop_back();
+    ready_ct_.fetch_sub(1, std::memory_order_relaxed);
+    return job;
+}
+
+// visits every deque, starting after thief_index
+JobHandle JobSystem::steal(std::size_t thief_index) {
+    const std::size_t deque_ct { deques_.size() };
+    for (std::size_t i { 1 }; i <= deque_ct; ++i) {
+        const std::size_t victim { (thief_index + i) % deque_ct };
+        if (tls_system == this && victim == tls_index)
+            continue;
+        WorkerDeque& deque { *deques_[victim] };
+        std::lock_guard<std::mutex> lock { deque.mutex };
+        if (deque.jobs.empty())
+            continue;
+        JobHandle job { std::move(deque.jobs.front()) };
+        deque.jobs.pop_front();
+        ready_ct_.fetch_sub(1, std::memory_order_relaxed);
+        steal_ct_.fetch_add(1, std::memory_order_relaxed);
+        return job;
+    }
+    return nullptr;
+}
+
+void JobSystem::run(const JobHandle& job) {
+    try {
+        job->func();
+    } catch (...) {
+        job->exception = std::current_exception();
+    }
+    // release captures as soon as possible
+    job->func = nullptr;
+    finish(job);
+}
+
+// dependents are scheduled even if job threw, the exception is only seen by
+//   wait()
+void JobSystem::finish(const JobHandle& job) {
+    std::vector<JobHandle> dependents;
+    {
+        std::lock_guard<std::mutex> lock { job->mutex };
+        job->done.store(true, std::memory_order_release);
+        dependents.swap(job->dependents);
+    }
+    for (auto& dependent : dependents) {
+        if (dependent->blocking_ct.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            schedule(std::move(dependent));
+    }
+}
+
+void JobSystem::wait(const JobHandle& job) {
+    if (job == nullptr)
+        throw std::invalid_argument("JobSystem: cannot wait on null job");
+    while (!job->done.load(std::memory_order_acquire)) {
+        if (!runOne())
+            std::this_thread::yield();
+    }
+    if (job->exception)
+        std::rethrow_exception(job->exception);
+}
+
+void JobSystem::waitAll(const std::vector<JobHandle>& jobs) {
+    std::exception_ptr first_exception;
+    for (const auto& job : jobs) {
+        try {
+            wait(job);
+        } catch (...) {
+            if (!first_exception)
+                first_exception = std::current_exception();
+        }
+    }
+    if (first_exception)
+        std::rethrow_exception(first_exception);
+}
+
+void JobSystem::parallelFor(std::size_t begin, std::size_t end, std::size_t grain_size,
+                            const std::function<void(std::size_t, std::size_t)>& func) {
+    if (end <= begin)
+        return;
+    const std::size_t index_ct { end - begin };
+    if (grain_size == 0)
+        grain_size = std::max(std::size_t(1), index_ct / (deques_.size() * 4));
+    if (grain_size >= index_ct) {
+        func(begin, end);
+        return;
+    }
+    std::vector<JobHandle> jobs;
+    jobs.reserve(index_ct / grain_size + 1);
+    for (std::size_t chunk_begin { begin }; chunk_begin < end; chunk_begin += grain_size) {
+        const std::size_t chunk_end { std::min(end, chunk_begin + grain_size) };
+        jobs.push_back(submit([&func, chunk_begin, chunk_end](){
+            func(chunk_begin, chunk_end);
+        }));
+    }
+    waitAll(jobs);
+}
+
+}  // namespace sdl2_thread_util
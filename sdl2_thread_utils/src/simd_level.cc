@@ -0,0 +1,62 @@
+#include "simd_level.hh"
+
+#include "SDL_cpuinfo.h"  // SDL_HasSSE2 SDL_HasSSE41 SDL_HasAVX2
+
+#include <array>
+
+
+namespace sdl2_thread_util {
+
+static bool detect(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::Scalar:
+        return true;
+    case SimdLevel::Sse2:
+        return SDL_HasSSE2() == SDL_TRUE;
+    case SimdLevel::Sse41:
+        return SDL_HasSSE41() == SDL_TRUE;
+    case SimdLevel::Avx2:
+        // also checks that OS saves ymm registers
+        return SDL_HasAVX2() == SDL_TRUE;
+    }
+    return false;
+}
+
+bool cpuSupports(SimdLevel level) {
+    static const std::array<bool, SIMD_LEVEL_CT> supported {
+        detect(SimdLevel::Scalar),
+        detect(SimdLevel::Sse2),
+        detect(SimdLevel::Sse41),
+        detect(SimdLevel::Avx2)
+    };
+    const std::size_t i { std::size_t(level) };
+    return i < SIMD_LEVEL_CT && supported[i];
+}
+
+bool simdLevelSupported(SimdLevel level, unsigned built) {
+    return (built & simdLevelBit(level)) != 0 && cpuSupports(level);
+}
+
+SimdLevel bestSimdLevel(unsigned built) {
+    for (std::size_t i { SIMD_LEVEL_CT - 1 }; i > 0; --i) {
+        if (simdLevelSupported(SimdLevel(i), built))
+            return SimdLevel(i);
+    }
+    return SimdLevel::Scalar;
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::Scalar:
+        return "scalar";
+    case SimdLevel::Sse2:
+        return "SSE2";
+    case SimdLevel::Sse41:
+        return "SSE4.1";
+    case SimdLevel::Avx2:
+        return "AVX2";
+    }
+    return "unknown";
+}
+
+}  // namespace sdl2_thread_util
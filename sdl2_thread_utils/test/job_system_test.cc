@@ -0,0 +1,162 @@
+#include <catch2/catch_version_macros.hpp>               // CATCH_VERSION_MAJOR
+#if (CATCH_VERSION_MAJOR != 3)
+  #error "tests currently only support Catch2 v3.x"
+#endif
+#include <catch2/catch_test_macros.hpp>                  // TEST_CASE, SECTION, REQUIRE
+#include <catch2/benchmark/catch_benchmark.hpp>          // BENCHMARK
+
+#include "job_system.hh"
+
+#include <SDL.h>
+
+#include <atomic>
+#include <cmath>      // sqrt
+#include <cstdint>    // uint64_t
+#include <mutex>
+#include <stdexcept>  // runtime_error
+#include <string>
+#include <vector>
+
+
+static std::string collectErrorQuitSdl(const std::string& func_name) {
+    std::string err { SDL_GetError() };
+    SDL_ClearError();
+    if (err.size() == 0) {
+        err = "failure without setting SDL error";
+    }
+    SDL_Quit();
+    return func_name + ": " + err;
+}
+
+using namespace sdl2_thread_util;
+
+TEST_CASE("SDL core work-stealing jobs: JobSystem",
+    "[sdl2_thread_util][SDL2][core][JobSystem]")
+{
+    if (SDL_Init(0) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    {
+        JobSystem jobs { 4 };
+        REQUIRE(jobs.workerCount() == 4);
+
+        SECTION("dependencies run first")
+        {
+            std::mutex order_mutex;
+            std::vector<int> order;
+            auto record { [&order_mutex, &order](const int i){
+                return [&order_mutex, &order, i](){
+                    SDL_Delay(1);
+                    std::lock_guard<std::mutex> lock { order_mutex };
+                    order.push_back(i);
+                };
+            } };
+            const JobHandle a { jobs.submit(record(0)) };
+            const JobHandle b { jobs.submit(record(1)) };
+            const JobHandle c { jobs.submit(record(2), { a, b }) };
+            const JobHandle d { jobs.submit(record(3), { c }) };
+            jobs.wait(d);
+            REQUIRE(order.size() == 4);
+            REQUIRE(order[2] == 2);
+            REQUIRE(order[3] == 3);
+            // dependency already finished when submitted
+            const JobHandle e { jobs.submit(record(4), { d }) };
+            jobs.wait(e);
+            REQUIRE(order.back() == 4);
+        }
+        SECTION("parallelFor covers range once")
+        {
+            std::vector<std::atomic<int>> visits(10007);
+            jobs.parallelFor(0, visits.size(), 0,
+                             [&visits](std::size_t begin, std::size_t end){
+                                 for (std::size_t i { begin }; i < end; ++i)
+                                     ++visits[i];
+                             });
+            bool each_once { true };
+            for (const auto& visit : visits)
+                each_once = each_once && (visit == 1);
+            REQUIRE(each_once);
+        }
+        SECTION("jobs can submit and wait on jobs")
+        {
+            std::atomic<int> leaf_ct {};
+            const JobHandle root { jobs.submit([&jobs, &leaf_ct](){
+                std::vector<JobHandle> children;
+                for (int i {}; i < 16; ++i) {
+                    children.push_back(jobs.submit([&jobs, &leaf_ct](){
+                        jobs.parallelFor(0, 64, 1, [&leaf_ct](std::size_t, std::size_t){
+                            ++leaf_ct;
+                        });
+                    }));
+                }
+                jobs.waitAll(children);
+            }) };
+            jobs.wait(root);
+            REQUIRE(leaf_ct == 16 * 64);
+        }
+        SECTION("exceptions are rethrown by wait")
+        {
+            bool dependent_ran {};
+            const JobHandle thrower { jobs.submit([](){
+                throw std::runtime_error("job failure");
+            }) };
+            const JobHandle dependent { jobs.submit([&dependent_ran](){
+                dependent_ran = true;
+            }, { thrower }) };
+            REQUIRE_THROWS_AS(jobs.wait(thrower), std::runtime_error);
+            jobs.wait(dependent);
+            REQUIRE(dependent_ran);
+        }
+    }
+
+    SECTION("destruction runs remaining jobs")
+    {
+        std::atomic<int> run_ct {};
+        {
+            JobSystem jobs { 2 };
+            for (int i {}; i < 100; ++i)
+                jobs.submit([&run_ct](){ ++run_ct; });
+        }
+        REQUIRE(run_ct == 100);
+    }
+
+    SDL_Quit();
+}
+
+TEST_CASE("SDL core work-stealing jobs throughput: JobSystem",
+    "[.][benchmark][sdl2_thread_util][SDL2][core][JobSystem]")
+{
+    if (SDL_Init(0) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    {
+        JobSystem jobs;
+        std::vector<float> values(1 << 22, 2.0f);
+        auto kernel { [&values](std::size_t begin, std::size_t end){
+            for (std::size_t i { begin }; i < end; ++i)
+                values[i] = std::sqrt(values[i] * values[i] + 1.0f);
+        } };
+
+        BENCHMARK("4M element kernel, serial") {
+            kernel(0, values.size());
+            return values[0];
+        };
+        BENCHMARK("4M element kernel, parallelFor on " +
+                  std::to_string(jobs.workerCount()) + " workers") {
+            jobs.parallelFor(0, values.size(), 0, kernel);
+            return values[0];
+        };
+        BENCHMARK("10000 empty jobs") {
+            std::vector<JobHandle> handles;
+            handles.reserve(10000);
+            for (int i {}; i < 10000; ++i)
+                handles.push_back(jobs.submit([](){}));
+            jobs.waitAll(handles);
+            return handles.size();
+        };
+    }
+
+    SDL_Quit();
+}
@@ -0,0 +1,208 @@
+#include <catch2/catch_version_macros.hpp>               // CATCH_VERSION_MAJOR
+#if (CATCH_VERSION_MAJOR != 3)
+  #error "tests currently only support Catch2 v3.x"
+#endif
+#include <catch2/catch_test_macros.hpp>                  // TEST_CASE, SECTION, REQUIRE
+#include <catch2/benchmark/catch_benchmark.hpp>          // BENCHMARK
+
+#include "lock_free_queue.hh"
+#include "sdl2_mutex_lock.hh"
+
+#include <SDL.h>
+
+#include <atomic>
+#include <cstdint>  // uint64_t
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+static std::string collectErrorQuitSdl(const std::string& func_name) {
+    std::string err { SDL_GetError() };
+    SDL_ClearError();
+    if (err.size() == 0) {
+        err = "failure without setting SDL error";
+    }
+    SDL_Quit();
+    return func_name + ": " + err;
+}
+
+using namespace sdl2_thread_util;
+using namespace sdl2_smart_ptr;
+
+// mutex + condition variable baseline for benchmarks
+template<typename T>
+class LockedQueue {
+public:
+    explicit LockedQueue(std::size_t capacity) : capacity_(capacity) {}
+
+    void push(const T item) {
+        MutexLock lock { mutex_ };
+        while (items_.size() == capacity_)
+            lock.wait(not_full_.get());
+        items_.push_back(item);
+        SDL_CondSignal(not_empty_.get());
+    }
+
+    void pop(T& item) {
+        MutexLock lock { mutex_ };
+        while (items_.empty())
+            lock.wait(not_empty_.get());
+        item = items_.front();
+        items_.pop_front();
+        SDL_CondSignal(not_full_.get());
+    }
+
+private:
+    std::size_t capacity_;
+    std::deque<T> items_;
+    unique::Mutex mutex_ { make_unique(SDL_CreateMutex()) };
+    unique::CondVar not_empty_ { make_unique(SDL_CreateCond()) };
+    unique::CondVar not_full_ { make_unique(SDL_CreateCond()) };
+};
+
+// each of pair_ct producers pushes item_ct values, which are popped by
+//   pair_ct consumers; returns sum of popped values
+template<typename Queue>
+static std::uint64_t runProducersConsumers(Queue& queue, const int pair_ct,
+                                           const std::uint64_t item_ct) {
+    std::atomic<std::uint64_t> sum {};
+    std::vector<std::thread> threads;
+    for (int i {}; i < pair_ct; ++i) {
+        threads.emplace_back([&queue, item_ct](){
+            for (std::uint64_t value { 1 }; value <= item_ct; ++value)
+                queue.push(value);
+        });
+        threads.emplace_back([&queue, &sum, item_ct](){
+            std::uint64_t local_sum {}, value {};
+            for (std::uint64_t j {}; j < item_ct; ++j) {
+                queue.pop(value);
+                local_sum += value;
+            }
+            sum += local_sum;
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    return sum;
+}
+
+TEST_CASE("SDL core lock-free queue: SpscQueue",
+    "[sdl2_thread_util][SDL2][core][SpscQueue]")
+{
+    if (SDL_Init(0) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    {
+        SpscQueue<int> queue { 5 };
+        REQUIRE(queue.capacity() == 8);
+
+        SECTION("bounded FIFO")
+        {
+            int i {};
+            while (queue.tryPush(i))
+                ++i;
+            REQUIRE(i == 8);
+            REQUIRE(queue.sizeApprox() == 8);
+            int item {};
+            for (int j {}; j < 8; ++j) {
+                REQUIRE(queue.tryPop(item));
+                REQUIRE(item == j);
+            }
+            REQUIRE_FALSE(queue.tryPop(item));
+            REQUIRE_FALSE(queue.popTimeout(item, 1));
+        }
+        SECTION("parked consumer receives all items in order")
+        {
+            constexpr int item_ct { 100000 };
+            bool in_order { true };
+            std::thread consumer { [&queue, &in_order](){
+                int item {};
+                for (int i {}; i < item_ct; ++i) {
+                    queue.pop(item);
+                    in_order = in_order && (item == i);
+                }
+            } };
+            for (int i {}; i < item_ct; ++i)
+                queue.push(i);
+            consumer.join();
+            REQUIRE(in_order);
+            REQUIRE(queue.sizeApprox() == 0);
+        }
+    }
+
+    SDL_Quit();
+}
+
+TEST_CASE("SDL core lock-free queue: MpmcQueue",
+    "[sdl2_thread_util][SDL2][core][MpmcQueue]")
+{
+    if (SDL_Init(0) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    {
+        MpmcQueue<std::uint64_t> queue { 64 };
+        REQUIRE(queue.capacity() == 64);
+
+        SECTION("bounded FIFO")
+        {
+            std::uint64_t i {};
+            while (queue.tryPush(i))
+                ++i;
+            REQUIRE(i == 64);
+            std::uint64_t item {};
+            for (std::uint64_t j {}; j < 64; ++j) {
+                REQUIRE(queue.tryPop(item));
+                REQUIRE(item == j);
+            }
+            REQUIRE_FALSE(queue.tryPop(item));
+            REQUIRE_FALSE(queue.popTimeout(item, 1));
+        }
+        SECTION("many producers and consumers")
+        {
+            constexpr std::uint64_t item_ct { 20000 };
+            constexpr int pair_ct { 4 };
+            REQUIRE(runProducersConsumers(queue, pair_ct, item_ct) ==
+                    pair_ct * item_ct * (item_ct + 1) / 2);
+            REQUIRE(queue.sizeApprox() == 0);
+        }
+    }
+
+    SDL_Quit();
+}
+
+TEST_CASE("SDL core lock-free queue throughput: SpscQueue, MpmcQueue",
+    "[.][benchmark][sdl2_thread_util][SDL2][core][SpscQueue][MpmcQueue]")
+{
+    if (SDL_Init(0) != 0) {
+        FAIL(collectErrorQuitSdl("SDL_Init"));
+    }
+
+    {
+        constexpr std::size_t capacity { 1024 };
+        constexpr std::uint64_t item_ct { 100000 };
+
+        BENCHMARK("SpscQueue, 2 threads") {
+            SpscQueue<std::uint64_t> queue { capacity };
+            return runProducersConsumers(queue, 1, item_ct);
+        };
+        for (const int pair_ct : { 1, 2, 4, 8 }) {
+            const std::string threads {
+                ", " + std::to_string(pair_ct * 2) + " threads"
+            };
+            BENCHMARK("MpmcQueue" + threads) {
+                MpmcQueue<std::uint64_t> queue { capacity };
+                return runProducersConsumers(queue, pair_ct, item_ct);
+            };
+            BENCHMARK("mutex + condition variable" + threads) {
+                LockedQueue<std::uint64_t> queue { capacity };
+                return runProducersConsumers(queue, pair_ct, item_ct);
+            };
+        }
+    }
+
+    SDL_Quit();
+}
@@ -0,0 +1,45 @@
+#include <catch2/catch_version_macros.hpp>               // CATCH_VERSION_MAJOR
+#if (CATCH_VERSION_MAJOR != 3)
+  #error "tests currently only support Catch2 v3.x"
+#endif
+#include <catch2/catch_test_macros.hpp>                  // TEST_CASE, REQUIRE
+
+#include "simd_level.hh"
+
+#include <SDL.h>
+
+#include <string>
+
+
+using namespace sdl2_thread_util;
+
+static const SimdLevel ALL_SIMD_LEVELS[SIMD_LEVEL_CT] {
+    SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Sse41, SimdLevel::Avx2
+};
+
+TEST_CASE("SDL core runtime instruction set choice: SimdLevel",
+    "[sdl2_thread_util][SDL2][core][SimdLevel]")
+{
+    unsigned all_built {};
+    for (const SimdLevel level : ALL_SIMD_LEVELS)
+        all_built |= simdLevelBit(level);
+
+    REQUIRE(cpuSupports(SimdLevel::Scalar));
+    REQUIRE(cpuSupports(SimdLevel::Sse2) == (SDL_HasSSE2() == SDL_TRUE));
+    REQUIRE(cpuSupports(SimdLevel::Sse41) == (SDL_HasSSE41() == SDL_TRUE));
+    REQUIRE(cpuSupports(SimdLevel::Avx2) == (SDL_HasAVX2() == SDL_TRUE));
+
+    // levels not built are never supported
+    REQUIRE(bestSimdLevel(simdLevelBit(SimdLevel::Scalar)) == SimdLevel::Scalar);
+    REQUIRE_FALSE(simdLevelSupported(SimdLevel::Sse2, simdLevelBit(SimdLevel::Scalar)));
+    REQUIRE(simdLevelSupported(bestSimdLevel(all_built), all_built));
+    for (const SimdLevel level : ALL_SIMD_LEVELS) {
+        REQUIRE(simdLevelSupported(level, all_built) == cpuSupports(level));
+        if (cpuSupports(level)) {
+            REQUIRE(int(bestSimdLevel(all_built)) >= int(level));
+            REQUIRE(bestSimdLevel(simdLevelBit(SimdLevel::Scalar) | simdLevelBit(level)) ==
+                    level);
+        }
+        REQUIRE(std::string(simdLevelName(level)) != "unknown");
+    }
+}